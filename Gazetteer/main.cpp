@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Build the offline gazetteer index shipped next to ITN Converter
+ */
+
+#include "GeoServices/GeoGazetteer.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void Usage()
+	{
+		std::cout <<
+			"Usage: Gazetteer [options]\n"
+			"  --places <file>     GeoNames dump (cities500.txt, allCountries.txt, ...)\n"
+			"  --countries <file>  GeoJSON FeatureCollection of the country borders\n"
+			"  --output <file>     Index file (gazetteer.idx)\n";
+	}
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+	std::filesystem::path placesPath;
+	std::filesystem::path countriesPath;
+	std::filesystem::path outputPath = L"gazetteer.idx";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::wstring strOption = argv[i];
+		bool bValue = i + 1 < argc;
+
+		if (strOption == L"--places" && bValue)
+			placesPath = argv[++i];
+		else if (strOption == L"--countries" && bValue)
+			countriesPath = argv[++i];
+		else if (strOption == L"--output" && bValue)
+			outputPath = argv[++i];
+		else
+		{
+			Usage();
+			return strOption == L"--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (placesPath.empty() && countriesPath.empty())
+	{
+		Usage();
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream isPlaces;
+	if (!placesPath.empty())
+	{
+		isPlaces.open(placesPath, std::ios::binary);
+		if (!isPlaces.is_open())
+		{
+			std::cerr << "Cannot open " << placesPath.u8string() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::ifstream isCountries;
+	if (!countriesPath.empty())
+	{
+		isCountries.open(countriesPath, std::ios::binary);
+		if (!isCountries.is_open())
+		{
+			std::cerr << "Cannot open " << countriesPath.u8string() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!geo::CGeoGazetteer::build(outputPath.wstring(), isPlaces.is_open() ? &isPlaces : nullptr, isCountries.is_open() ? &isCountries : nullptr))
+	{
+		std::cerr << "Cannot build " << outputPath.u8string() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Check the result the way the application opens it
+	geo::CGeoGazetteer gazetteer;
+	if (!gazetteer.open(outputPath.wstring()))
+	{
+		std::cerr << "Invalid index " << outputPath.u8string() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Gazetteer written to " << outputPath.u8string() << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -28,6 +28,7 @@
 #include <sstream>
 #include "BingApiGeocoder.h"
 #include "BingTools.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -66,7 +67,7 @@ E_GEO_STATUS_CODE CBingApiGeocoder::Load(const std::string& strAddress)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
 		{
 			// Read status
 			m_eStatus = CBingTools::GetStatusCode(jsParser("statusCode"));
@@ -48,6 +48,7 @@ namespace geo
 		E_GEO_UNKNOWN_ERROR,          // indicates a directions request could not be processed due to a server error. The request may succeed if you try again.
 		E_GEO_BAD_ARGUMENTS,
 		E_GEO_TIMEOUT,                // 
+		E_GEO_APPROXIMATE,            // indicates that the service is unreachable, the result is the nearest place known offline.
 
 		E_HTTP_ERROR = 100            // Windows HTTP errors
 	} E_GEO_STATUS_CODE;
@@ -27,13 +27,13 @@
 
 #include <algorithm>
 #include "GeoBaseDirections.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/HttpClient.h"
 
 using namespace geo;
 
 CGeoBaseDirections::CGeoBaseDirections() :
 	m_eStatus(E_GEO_INVALID_REQUEST),
-	m_HttpSession(new CInternetHttpSession),
 	m_vehicleType(GeoVehicleType::Default)
 {
 }
@@ -83,6 +83,9 @@ void CGeoBaseDirections::Load(const CGeoLatLngs& cgLatLngs, GeoVehicleType::type
 	m_vehicleType = vehicleType;
 	m_cgOptions = cgOptions;
 
+	if (!m_HttpSession) // The provider is known once constructed
+		m_HttpSession = std::make_unique<CInternetHttpSession>(CGeoClientRegistry::instance().get(getProvider()));
+
 	m_HttpSession->setEndCallback([&](CInternetHttpSession&, const CInternetException& inetException)
 	{
 		if (inetException.code() != ERROR_SUCCESS)
@@ -92,7 +95,7 @@ void CGeoBaseDirections::Load(const CGeoLatLngs& cgLatLngs, GeoVehicleType::type
 			return;
 		}
 
-		m_eStatus = parseRequest(m_oss.str(), m_vehicleType, *m_cgOptions, m_vecRoutes);
+		m_eStatus = parseRequest(m_strResponse, m_vehicleType, *m_cgOptions, m_vecRoutes);
 		if (m_eStatus != E_GEO_OK)
 		{
 			callEndCallback();
@@ -108,7 +111,8 @@ void CGeoBaseDirections::Load(const CGeoLatLngs& cgLatLngs, GeoVehicleType::type
 
 void CGeoBaseDirections::cancel()
 {
-	m_HttpSession->cancel();
+	if (m_HttpSession)
+		m_HttpSession->cancel();
 }
 
 const GeoRoutes& CGeoBaseDirections::getRoutes() const
@@ -120,7 +124,7 @@ E_GEO_STATUS_CODE CGeoBaseDirections::getStatus(size_t msTimeOut) const
 {
 	try
 	{
-		if (!m_HttpSession->wait(msTimeOut))
+		if (m_HttpSession && !m_HttpSession->wait(msTimeOut))
 			m_eStatus = E_GEO_TIMEOUT;
 	}
 	catch (CInternetException& inetException)
@@ -163,8 +167,8 @@ void CGeoBaseDirections::sendNextRequest()
 
 	try
 	{
-		m_oss.str(std::string());
-		m_HttpSession->send(m_oss, request.strUrl, request.strPostData, request.strReferrer);
+		m_strResponse.clear();
+		m_HttpSession->send(m_strResponse, request.strUrl, request.strPostData, request.strReferrer);
 	}
 	catch (CInternetException& inetException)
 	{
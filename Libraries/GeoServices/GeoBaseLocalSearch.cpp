@@ -27,14 +27,14 @@
 
 #include <algorithm>
 #include "GeoBaseLocalSearch.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/HttpClient.h"
 #include "stdx/guard.h"
 
 using namespace geo;
 
 CGeoBaseLocalSearch::CGeoBaseLocalSearch() :
-	m_eStatus(E_GEO_INVALID_REQUEST),
-	m_HttpSession(new CInternetHttpSession)
+	m_eStatus(E_GEO_INVALID_REQUEST)
 {
 }
 
@@ -48,12 +48,15 @@ void CGeoBaseLocalSearch::Load(const std::string& strText, const CGeoLatLng& gLo
 	m_eStatus = E_GEO_UNKNOWN_ERROR;
 	m_GeoLocations.clear();
 
+	if (!m_HttpSession) // The provider is known once constructed
+		m_HttpSession = std::make_unique<CInternetHttpSession>(CGeoClientRegistry::instance().get(getProvider()));
+
 	m_HttpSession->setEndCallback([&](CInternetHttpSession&, const CInternetException& inetException)
 	{
 		if (inetException.code() != ERROR_SUCCESS)
 			m_eStatus = static_cast<E_GEO_STATUS_CODE>(E_HTTP_ERROR + inetException.code());
 		else
-			m_eStatus = parseRequest(m_oss.str(), m_GeoLocations);
+			m_eStatus = parseRequest(m_strResponse, m_GeoLocations);
 
 		callEndCallback();
 	});
@@ -68,8 +71,8 @@ void CGeoBaseLocalSearch::Load(const std::string& strText, const CGeoLatLng& gLo
 
 	try
 	{
-		m_oss.str(std::string());
-		m_HttpSession->send(m_oss, request.strUrl, request.strPostData, request.strReferrer);
+		m_strResponse.clear();
+		m_HttpSession->send(m_strResponse, request.strUrl, request.strPostData, request.strReferrer);
 	}
 	catch (CInternetException& inetException)
 	{
@@ -80,7 +83,8 @@ void CGeoBaseLocalSearch::Load(const std::string& strText, const CGeoLatLng& gLo
 
 void CGeoBaseLocalSearch::cancel()
 {
-	m_HttpSession->cancel();
+	if (m_HttpSession)
+		m_HttpSession->cancel();
 }
 
 const CGeoLocations& CGeoBaseLocalSearch::getLocations() const
@@ -92,7 +96,7 @@ E_GEO_STATUS_CODE CGeoBaseLocalSearch::getStatus(size_t msTimeOut) const
 {
 	try
 	{
-		if (!m_HttpSession->wait(msTimeOut))
+		if (m_HttpSession && !m_HttpSession->wait(msTimeOut))
 			m_eStatus = E_GEO_TIMEOUT;
 	}
 	catch (CInternetException& inetException)
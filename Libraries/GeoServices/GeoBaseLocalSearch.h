@@ -69,7 +69,7 @@ namespace geo
 		mutable E_GEO_STATUS_CODE m_eStatus;
 		CallbackFunction m_EndCallback;
 		std::unique_ptr<CInternetHttpSession> m_HttpSession;
-		std::ostringstream m_oss;
+		std::string m_strResponse;
 		CGeoLocations m_GeoLocations;
 	};
 } // namespace geo
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_BATCH_H_INCLUDED_
+#define _GEO_BATCH_H_INCLUDED_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace geo
+{
+	// Resolve groups of equivalent requests on ulWorkers threads, the calling thread being one of them.
+	// makeResolver() is called once per worker and returns a function filling the result of the first index of a group,
+	// the result is then copied to the other indexes of the group. The callback is called for each index.
+	template <class R, class M>
+	std::vector<R> GeoRunBatch(size_t ulSize, const std::vector<std::vector<size_t>>& vecGroups, size_t ulWorkers, const R& rDefault, const M& makeResolver, const std::function<void(size_t, const R&)>& callback)
+	{
+		std::vector<R> vecResults(ulSize, rDefault);
+		std::atomic<size_t> ulNextGroup(0);
+
+		auto worker = [&]()
+		{
+			auto resolve = makeResolver();
+
+			for (size_t ulGroup = ulNextGroup++; ulGroup < vecGroups.size(); ulGroup = ulNextGroup++)
+			{
+				const std::vector<size_t>& vecIndexes = vecGroups[ulGroup];
+				R& rFirst = vecResults[vecIndexes.front()];
+
+				try
+				{
+					resolve(vecIndexes.front(), rFirst);
+				}
+				catch (...)
+				{
+					rFirst = rDefault;
+				}
+
+				for (size_t ulIndex : vecIndexes)
+				{
+					if (ulIndex != vecIndexes.front())
+						vecResults[ulIndex] = rFirst;
+
+					if (callback)
+					{
+						try
+						{
+							callback(ulIndex, vecResults[ulIndex]);
+						}
+						catch (...)
+						{
+						}
+					}
+				}
+			}
+		};
+
+		ulWorkers = std::min(ulWorkers, vecGroups.size());
+		std::vector<std::future<void>> vecWorkers;
+
+		for (size_t i = 1; i < ulWorkers; ++i)
+			vecWorkers.push_back(std::async(std::launch::async, worker));
+
+		if (ulWorkers)
+			worker();
+
+		for (auto& future : vecWorkers)
+			future.get();
+
+		return vecResults;
+	}
+} // namespace geo
+
+#endif // _GEO_BATCH_H_INCLUDED_
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GeoClientRegistry.h"
+
+using namespace geo;
+
+CGeoClientRegistry& CGeoClientRegistry::instance()
+{
+	static CGeoClientRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<CHttpSessionPool> CGeoClientRegistry::get(E_GEO_PROVIDER eGeoProvider)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::shared_ptr<CHttpSessionPool>& pClient = m_mapClients[eGeoProvider];
+	if (!pClient)
+		pClient = std::make_shared<CHttpSessionPool>();
+
+	return pClient;
+}
+
+void CGeoClientRegistry::configure(E_GEO_PROVIDER eGeoProvider, size_t ulMaxConcurrent, std::chrono::milliseconds msIdleTimeout)
+{
+	get(eGeoProvider)->configure(ulMaxConcurrent, msIdleTimeout);
+}
+
+size_t CGeoClientRegistry::reap()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	size_t ulReaped = 0;
+	for (const auto& client : m_mapClients)
+		ulReaped += client.second->reap();
+
+	return ulReaped;
+}
+
+std::map<E_GEO_PROVIDER, CHttpSessionPool::Metrics> CGeoClientRegistry::getMetrics() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::map<E_GEO_PROVIDER, CHttpSessionPool::Metrics> mapMetrics;
+	for (const auto& client : m_mapClients)
+		mapMetrics[client.first] = client.second->getMetrics();
+
+	return mapMetrics;
+}
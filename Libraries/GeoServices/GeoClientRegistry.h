@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_CLIENT_REGISTRY_H_INCLUDED_
+#define _GEO_CLIENT_REGISTRY_H_INCLUDED_
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "GeoApi.h"
+#include "ToolsLibrary/HttpSessionPool.h"
+
+namespace geo
+{
+	// Process wide HTTP clients of the providers: the requests sent to a provider
+	// share its sessions, one by host, and the idle ones are closed.
+	class CGeoClientRegistry
+	{
+	public:
+		static CGeoClientRegistry& instance();
+
+		std::shared_ptr<CHttpSessionPool> get(E_GEO_PROVIDER eGeoProvider);
+		void configure(E_GEO_PROVIDER eGeoProvider, size_t ulMaxConcurrent, std::chrono::milliseconds msIdleTimeout);
+
+		size_t reap(); // Close the idle sessions of all the providers
+		std::map<E_GEO_PROVIDER, CHttpSessionPool::Metrics> getMetrics() const;
+
+		CGeoClientRegistry(const CGeoClientRegistry&) = delete;
+		CGeoClientRegistry& operator=(const CGeoClientRegistry&) = delete;
+
+	private:
+		CGeoClientRegistry() = default;
+		~CGeoClientRegistry() = default;
+
+	private:
+		mutable std::mutex m_Mutex;
+		std::map<E_GEO_PROVIDER, std::shared_ptr<CHttpSessionPool>> m_mapClients;
+	};
+} // namespace geo
+
+#endif // _GEO_CLIENT_REGISTRY_H_INCLUDED_
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GeoCoordinates.h"
+
+using namespace geo;
+
+void geo::toCoordinates(const CGeoLatLngs& gLatLngs, GeoCoordinates& gCoordinates)
+{
+	gCoordinates.clear();
+	gCoordinates.reserve(gLatLngs.size());
+
+	for (CGeoLatLngs::const_iterator cit = gLatLngs.begin(); cit != gLatLngs.end(); ++cit)
+		gCoordinates.push_back({ cit->lat(), cit->lng(), cit->alt() });
+}
+
+void geo::toLatLngs(const GeoCoordinate* pgCoordinates, size_t ulSize, CGeoLatLngs& gLatLngs)
+{
+	for (size_t i = 0; i < ulSize; ++i)
+		gLatLngs.push_back(CGeoLatLng(pgCoordinates[i].lat, pgCoordinates[i].lng, pgCoordinates[i].alt));
+}
+
+void geo::toLatLngs(const GeoCoordinates& gCoordinates, CGeoLatLngs& gLatLngs)
+{
+	toLatLngs(gCoordinates.data(), gCoordinates.size(), gLatLngs);
+}
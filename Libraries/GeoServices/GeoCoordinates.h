@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_COORDINATES_H_INCLUDED_
+#define _GEO_COORDINATES_H_INCLUDED_
+
+#include <vector>
+#include "GeoLatLngs.h"
+
+namespace geo
+{
+	// Plain coordinate, stored contiguously for bulk algorithms (codecs, simplification, ...)
+	struct GeoCoordinate
+	{
+		double lat;
+		double lng;
+		double alt;
+	};
+
+	typedef std::vector<GeoCoordinate> GeoCoordinates;
+
+	void toCoordinates(const CGeoLatLngs& gLatLngs, GeoCoordinates& gCoordinates);
+	void toLatLngs(const GeoCoordinate* pgCoordinates, size_t ulSize, CGeoLatLngs& gLatLngs);
+	void toLatLngs(const GeoCoordinates& gCoordinates, CGeoLatLngs& gLatLngs);
+} // namespace geo
+
+#endif // _GEO_COORDINATES_H_INCLUDED_
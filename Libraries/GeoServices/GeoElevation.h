@@ -41,6 +41,8 @@ namespace geo
 		virtual ~IGeoElevation() = default;
 
 		virtual E_GEO_STATUS_CODE Load(const CGeoLatLng& gLatLng) = 0;
+		// Results are in the order of the locations, a location without elevation keeps its altitude
+		virtual E_GEO_STATUS_CODE Load(const CGeoLatLngs& gLatLngs) = 0;
 
 		virtual E_GEO_STATUS_CODE getStatus() const = 0;
 		virtual const CGeoLatLngs& getResults() const = 0;
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include "GeoFlexiblePolyline.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr unsigned long long FORMAT_VERSION = 1;
+	constexpr unsigned int MORE = 0x20;
+	constexpr unsigned int MASK = 0x1F;
+	constexpr size_t MAX_CHUNKS = 13; // 64 bits / 5 bits
+	constexpr char ENCODING_TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+	struct DecodingTable
+	{
+		signed char values[256];
+
+		DecodingTable()
+		{
+			for (size_t i = 0; i < sizeof(values); ++i)
+				values[i] = -1;
+			for (size_t i = 0; i < sizeof(ENCODING_TABLE) - 1; ++i)
+				values[static_cast<unsigned char>(ENCODING_TABLE[i])] = static_cast<signed char>(i);
+		}
+	};
+
+	const DecodingTable DECODING_TABLE;
+
+	char* encodeUnsigned(unsigned long long ullValue, char* pszOut)
+	{
+		while (ullValue >= MORE)
+		{
+			*pszOut++ = ENCODING_TABLE[(ullValue & MASK) | MORE];
+			ullValue >>= 5;
+		}
+
+		*pszOut++ = ENCODING_TABLE[ullValue];
+		return pszOut;
+	}
+
+	inline char* encodeSigned(long long llValue, char* pszOut)
+	{
+		return encodeUnsigned((static_cast<unsigned long long>(llValue) << 1) ^ static_cast<unsigned long long>(llValue >> 63), pszOut);
+	}
+
+	bool decodeUnsigned(const unsigned char*& pszIn, const unsigned char* pszEnd, unsigned long long& ullValue)
+	{
+		unsigned int uiShift = 0;
+		ullValue = 0;
+
+		while (pszIn != pszEnd && uiShift < 64)
+		{
+			int nChunk = DECODING_TABLE.values[*pszIn++];
+			if (nChunk < 0)
+				return false;
+
+			ullValue |= static_cast<unsigned long long>(nChunk & MASK) << uiShift;
+			if (!(nChunk & MORE))
+				return true;
+
+			uiShift += 5;
+		}
+
+		return false;
+	}
+
+	inline bool decodeSigned(const unsigned char*& pszIn, const unsigned char* pszEnd, long long& llValue)
+	{
+		unsigned long long ullValue;
+		if (!decodeUnsigned(pszIn, pszEnd, ullValue))
+			return false;
+
+		llValue = static_cast<long long>(ullValue >> 1) ^ -static_cast<long long>(ullValue & 1);
+		return true;
+	}
+
+	inline double factor(size_t precision)
+	{
+		return std::pow(10.0, static_cast<double>(precision));
+	}
+}
+
+CGeoFlexiblePolyline::CGeoFlexiblePolyline() :
+	m_precision(5),
+	m_thirdDim(E_THIRD_DIM_ABSENT),
+	m_thirdDimPrecision(0)
+{
+}
+
+CGeoFlexiblePolyline::CGeoFlexiblePolyline(size_t precision, E_THIRD_DIM thirdDim, size_t thirdDimPrecision) :
+	m_precision(precision & 0x0F),
+	m_thirdDim(thirdDim),
+	m_thirdDimPrecision(thirdDimPrecision & 0x0F)
+{
+}
+
+bool CGeoFlexiblePolyline::decode(const char* pszEncoded, size_t ulSize, GeoCoordinates& gCoordinates)
+{
+	const unsigned char* pszIn = reinterpret_cast<const unsigned char*>(pszEncoded);
+	const unsigned char* pszEnd = pszIn + ulSize;
+
+	// Read header
+	unsigned long long ullVersion;
+	unsigned long long ullHeader;
+
+	if (!decodeUnsigned(pszIn, pszEnd, ullVersion) || ullVersion != FORMAT_VERSION)
+		return false;
+
+	if (!decodeUnsigned(pszIn, pszEnd, ullHeader))
+		return false;
+
+	m_precision = static_cast<size_t>(ullHeader & 0x0F);
+	m_thirdDim = static_cast<E_THIRD_DIM>((ullHeader >> 4) & 0x07);
+	m_thirdDimPrecision = static_cast<size_t>((ullHeader >> 7) & 0x0F);
+
+	// Read coordinates, a coordinate takes at least 2 or 3 characters
+	const double dFactor = factor(m_precision);
+	const double dThirdDimFactor = factor(m_thirdDimPrecision);
+	const bool bThirdDim = (m_thirdDim != E_THIRD_DIM_ABSENT);
+
+	gCoordinates.reserve(gCoordinates.size() + static_cast<size_t>(pszEnd - pszIn) / (bThirdDim ? 3 : 2));
+
+	long long llLatitude = 0;
+	long long llLongitude = 0;
+	long long llThirdDim = 0;
+
+	while (pszIn != pszEnd)
+	{
+		long long llDelta;
+
+		if (!decodeSigned(pszIn, pszEnd, llDelta))
+			return false;
+		llLatitude += llDelta;
+
+		if (!decodeSigned(pszIn, pszEnd, llDelta))
+			return false;
+		llLongitude += llDelta;
+
+		if (bThirdDim)
+		{
+			if (!decodeSigned(pszIn, pszEnd, llDelta))
+				return false;
+			llThirdDim += llDelta;
+		}
+
+		gCoordinates.push_back({
+			static_cast<double>(llLatitude) / dFactor,
+			static_cast<double>(llLongitude) / dFactor,
+			bThirdDim ? static_cast<double>(llThirdDim) / dThirdDimFactor : 0 });
+	}
+
+	return true;
+}
+
+bool CGeoFlexiblePolyline::decode(const std::string& strEncoded, GeoCoordinates& gCoordinates)
+{
+	return decode(strEncoded.data(), strEncoded.size(), gCoordinates);
+}
+
+void CGeoFlexiblePolyline::encode(const GeoCoordinate* pgCoordinates, size_t ulSize, std::string& strEncoded) const
+{
+	const double dFactor = factor(m_precision);
+	const double dThirdDimFactor = factor(m_thirdDimPrecision);
+	const bool bThirdDim = (m_thirdDim != E_THIRD_DIM_ABSENT);
+
+	size_t ulFirst = strEncoded.size();
+	strEncoded.resize(ulFirst + (ulSize + 1) * 3 * MAX_CHUNKS);
+
+	char* pszOut = &strEncoded[0] + ulFirst;
+
+	// Write header
+	pszOut = encodeUnsigned(FORMAT_VERSION, pszOut);
+	pszOut = encodeUnsigned(m_precision | (static_cast<unsigned long long>(m_thirdDim) << 4) | (m_thirdDimPrecision << 7), pszOut);
+
+	// Write coordinates
+	long long llLatitude = 0;
+	long long llLongitude = 0;
+	long long llThirdDim = 0;
+
+	for (size_t i = 0; i < ulSize; ++i)
+	{
+		long long llValue = std::llround(pgCoordinates[i].lat * dFactor);
+		pszOut = encodeSigned(llValue - llLatitude, pszOut);
+		llLatitude = llValue;
+
+		llValue = std::llround(pgCoordinates[i].lng * dFactor);
+		pszOut = encodeSigned(llValue - llLongitude, pszOut);
+		llLongitude = llValue;
+
+		if (bThirdDim)
+		{
+			llValue = std::llround(pgCoordinates[i].alt * dThirdDimFactor);
+			pszOut = encodeSigned(llValue - llThirdDim, pszOut);
+			llThirdDim = llValue;
+		}
+	}
+
+	strEncoded.resize(static_cast<size_t>(pszOut - strEncoded.data()));
+}
+
+std::string CGeoFlexiblePolyline::encode(const GeoCoordinates& gCoordinates) const
+{
+	std::string strEncoded;
+	encode(gCoordinates.data(), gCoordinates.size(), strEncoded);
+	return strEncoded;
+}
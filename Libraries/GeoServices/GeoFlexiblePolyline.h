@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_FLEXIBLE_POLYLINE_H_INCLUDED_
+#define _GEO_FLEXIBLE_POLYLINE_H_INCLUDED_
+
+#include <string>
+#include "GeoCoordinates.h"
+
+namespace geo
+{
+	// HERE flexible polyline format, https://github.com/heremaps/flexible-polyline
+	// The third dimension, if any, is stored in GeoCoordinate::alt.
+	class CGeoFlexiblePolyline
+	{
+	public:
+		typedef enum
+		{
+			E_THIRD_DIM_ABSENT = 0,
+			E_THIRD_DIM_LEVEL = 1,
+			E_THIRD_DIM_ALTITUDE = 2,
+			E_THIRD_DIM_ELEVATION = 3,
+			E_THIRD_DIM_CUSTOM1 = 6,
+			E_THIRD_DIM_CUSTOM2 = 7
+		} E_THIRD_DIM;
+
+		CGeoFlexiblePolyline();
+		CGeoFlexiblePolyline(size_t precision, E_THIRD_DIM thirdDim = E_THIRD_DIM_ABSENT, size_t thirdDimPrecision = 0);
+		virtual ~CGeoFlexiblePolyline() = default;
+
+		inline size_t precision() const throw() { return m_precision; }
+		inline E_THIRD_DIM thirdDim() const throw() { return m_thirdDim; }
+		inline size_t thirdDimPrecision() const throw() { return m_thirdDimPrecision; }
+
+		// Append decoded coordinates and read the header, return false if the encoded string is malformed
+		bool decode(const char* pszEncoded, size_t ulSize, GeoCoordinates& gCoordinates);
+		bool decode(const std::string& strEncoded, GeoCoordinates& gCoordinates);
+
+		// Encode with the current header
+		void encode(const GeoCoordinate* pgCoordinates, size_t ulSize, std::string& strEncoded) const;
+		std::string encode(const GeoCoordinates& gCoordinates) const;
+
+	private:
+		size_t m_precision;
+		E_THIRD_DIM m_thirdDim;
+		size_t m_thirdDimPrecision;
+	};
+} // namespace geo
+
+#endif // _GEO_FLEXIBLE_POLYLINE_H_INCLUDED_
@@ -0,0 +1,622 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "GeoGazetteer.h"
+#include "GeoLocation.h"
+#include "GeoPolygone.h"
+#include "ToolsLibrary/fmstream.h"
+#include "jsonParser/JsonParser.h"
+
+using namespace geo;
+
+namespace
+{
+	const char GAZETTEER_MAGIC[4] = { 'I', 'G', 'Z', 'T' };
+	constexpr uint32_t GAZETTEER_VERSION = 1;
+
+	constexpr uint32_t GRID_COLS = 360; // One degree cells
+	constexpr uint32_t GRID_ROWS = 180;
+	constexpr uint32_t GRID_CELLS = GRID_COLS * GRID_ROWS;
+	constexpr uint32_t NO_COUNTRY = 0xFFFFFFFF;
+	constexpr double METERS_PER_DEGREE = 111195;
+	constexpr double DEG2RAD = 3.14159265358979323846 / 180;
+
+	inline uint32_t CellCol(double dLng)
+	{
+		int nCol = static_cast<int>(std::floor(dLng + 180));
+		return static_cast<uint32_t>(std::min(std::max(nCol, 0), static_cast<int>(GRID_COLS) - 1));
+	}
+
+	inline uint32_t CellRow(double dLat)
+	{
+		int nRow = static_cast<int>(std::floor(dLat + 90));
+		return static_cast<uint32_t>(std::min(std::max(nRow, 0), static_cast<int>(GRID_ROWS) - 1));
+	}
+
+	inline uint32_t Cell(uint32_t ulCol, uint32_t ulRow)
+	{
+		return ulRow * GRID_COLS + ulCol;
+	}
+
+	void SplitTabs(const std::string& strLine, std::vector<std::string>& vecFields)
+	{
+		vecFields.clear();
+
+		size_t ulStart = 0;
+		for (;;)
+		{
+			size_t ulPos = strLine.find('\t', ulStart);
+			vecFields.push_back(strLine.substr(ulStart, ulPos == std::string::npos ? std::string::npos : ulPos - ulStart));
+			if (ulPos == std::string::npos)
+				break;
+
+			ulStart = ulPos + 1;
+		}
+	}
+
+	template <class T>
+	void WriteArray(std::ostream& os, const std::vector<T>& vec)
+	{
+		if (!vec.empty())
+			os.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
+	}
+}
+
+struct CGeoGazetteer::Header
+{
+	char szMagic[4];
+	uint32_t ulVersion;
+	uint32_t ulCountries;
+	uint32_t ulPolygons;
+	uint32_t ulPoints;
+	uint32_t ulPlaces;
+	uint32_t ulPolygonRefs;
+	uint32_t ulStrings;
+};
+
+struct CGeoGazetteer::Country
+{
+	char szCode[4];
+	uint32_t ulName;
+};
+
+struct CGeoGazetteer::Polygon
+{
+	uint32_t ulCountry;
+	uint32_t ulFirstPoint;
+	uint32_t ulPoints;
+	float fSouth;
+	float fWest;
+	float fNorth;
+	float fEast;
+};
+
+struct CGeoGazetteer::Point
+{
+	float fLat;
+	float fLng;
+};
+
+struct CGeoGazetteer::Place
+{
+	float fLat;
+	float fLng;
+	uint32_t ulName;
+	uint32_t ulCountry;
+};
+
+// File layout, all sections are 4 bytes aligned:
+// Header, Country[ulCountries], Polygon[ulPolygons], Point[ulPoints], Place[ulPlaces] sorted by cell,
+// uint32_t[GRID_CELLS + 1] polygon cell offsets, uint32_t[ulPolygonRefs] polygon indexes,
+// uint32_t[GRID_CELLS + 1] place cell offsets, char[ulStrings] null terminated UTF-8 strings.
+
+CGeoGazetteer& CGeoGazetteer::instance()
+{
+	static CGeoGazetteer gGazetteer;
+	return gGazetteer;
+}
+
+CGeoGazetteer::CGeoGazetteer() :
+	m_pHeader(nullptr),
+	m_pCountries(nullptr),
+	m_pPolygons(nullptr),
+	m_pPoints(nullptr),
+	m_pPlaces(nullptr),
+	m_pPolygonCells(nullptr),
+	m_pPolygonRefs(nullptr),
+	m_pPlaceCells(nullptr),
+	m_pStrings(nullptr)
+{
+}
+
+CGeoGazetteer::~CGeoGazetteer()
+{
+	close();
+}
+
+bool CGeoGazetteer::build(const std::wstring& strIndexPath, std::istream* pisPlaces, std::istream* pisCountries)
+{
+	std::vector<Country> vecCountries;
+	std::vector<Polygon> vecPolygons;
+	std::vector<Point> vecPoints;
+	std::vector<Place> vecPlaces;
+	std::string strStrings(1, '\0'); // Offset 0 is the empty string
+
+	auto addString = [&](const std::string& str)
+	{
+		if (str.empty())
+			return static_cast<uint32_t>(0);
+
+		uint32_t ulOffset = static_cast<uint32_t>(strStrings.size());
+		strStrings += str;
+		strStrings += '\0';
+		return ulOffset;
+	};
+
+	auto findCountry = [&](const std::string& strCode, const std::string& strName)
+	{
+		if (strCode.size() != 2)
+			return NO_COUNTRY;
+
+		for (size_t i = 0; i < vecCountries.size(); ++i)
+		{
+			if (!strncmp(vecCountries[i].szCode, strCode.c_str(), 2))
+			{
+				if (!vecCountries[i].ulName && !strName.empty())
+					vecCountries[i].ulName = addString(strName);
+
+				return static_cast<uint32_t>(i);
+			}
+		}
+
+		Country country = { { strCode[0], strCode[1], 0, 0 }, addString(strName) };
+		vecCountries.push_back(country);
+		return static_cast<uint32_t>(vecCountries.size() - 1);
+	};
+
+	// Countries
+	if (pisCountries)
+	{
+		CJsonParser jsParser;
+		std::string strJson((std::istreambuf_iterator<char>(*pisCountries)), std::istreambuf_iterator<char>());
+
+		try
+		{
+			if (jsParser.parse(strJson) != CJsonParser::JSON_SUCCESS)
+				return false;
+
+			const CJsonArray& jsFeatures = jsParser("features");
+			for (size_t i = 0; i < jsFeatures.size(); ++i)
+			{
+				const CJsonObject& jsFeature = jsFeatures[i];
+				const CJsonObject& jsProperties = jsFeature("properties");
+
+				std::string strCode;
+				for (const char* szKey : { "ISO_A2_EH", "ISO_A2", "iso_a2", "ISO3166-1-Alpha-2" })
+				{
+					if (jsProperties.exist(szKey) && jsProperties(szKey).getType() == CJsonValue::JSON_TYPE_STRING)
+					{
+						strCode = static_cast<const std::string&>(jsProperties(szKey));
+						if (strCode.size() == 2)
+							break;
+					}
+				}
+
+				std::string strName;
+				for (const char* szKey : { "ADMIN", "NAME", "name" })
+				{
+					if (jsProperties.exist(szKey) && jsProperties(szKey).getType() == CJsonValue::JSON_TYPE_STRING)
+					{
+						strName = static_cast<const std::string&>(jsProperties(szKey));
+						break;
+					}
+				}
+
+				uint32_t ulCountry = findCountry(strCode, strName);
+				if (ulCountry == NO_COUNTRY || !jsFeature.exist("geometry") || jsFeature("geometry").getType() != CJsonValue::JSON_TYPE_OBJECT)
+					continue;
+
+				const CJsonObject& jsGeometry = jsFeature("geometry");
+				const std::string& strType = jsGeometry("type");
+				const CJsonArray& jsCoordinates = jsGeometry("coordinates");
+
+				std::vector<const CJsonArray*> vecRings;
+				if (strType == "Polygon" && jsCoordinates.size())
+				{
+					vecRings.push_back(&static_cast<const CJsonArray&>(jsCoordinates[0]));
+				}
+				else if (strType == "MultiPolygon")
+				{
+					for (size_t j = 0; j < jsCoordinates.size(); ++j)
+					{
+						const CJsonArray& jsPolygon = jsCoordinates[j];
+						if (jsPolygon.size())
+							vecRings.push_back(&static_cast<const CJsonArray&>(jsPolygon[0]));
+					}
+				}
+
+				for (const CJsonArray* pjsRing : vecRings)
+				{
+					if (pjsRing->size() < 3)
+						continue;
+
+					Polygon polygon = { ulCountry, static_cast<uint32_t>(vecPoints.size()), static_cast<uint32_t>(pjsRing->size()), 90, 180, -90, -180 };
+					for (size_t k = 0; k < pjsRing->size(); ++k)
+					{
+						const CJsonArray& jsPoint = (*pjsRing)[k];
+						Point point = { static_cast<float>(static_cast<double>(jsPoint[1])), static_cast<float>(static_cast<double>(jsPoint[0])) };
+
+						polygon.fSouth = std::min(polygon.fSouth, point.fLat);
+						polygon.fNorth = std::max(polygon.fNorth, point.fLat);
+						polygon.fWest = std::min(polygon.fWest, point.fLng);
+						polygon.fEast = std::max(polygon.fEast, point.fLng);
+						vecPoints.push_back(point);
+					}
+
+					vecPolygons.push_back(polygon);
+				}
+			}
+		}
+		catch (CJsonException&)
+		{
+			return false;
+		}
+	}
+
+	// Places, GeoNames tab separated dump:
+	// geonameid, name, asciiname, alternatenames, latitude, longitude, feature class, feature code, country code, ...
+	if (pisPlaces)
+	{
+		std::string strLine;
+		std::vector<std::string> vecFields;
+
+		while (std::getline(*pisPlaces, strLine))
+		{
+			if (strLine.empty() || strLine[0] == '#')
+				continue;
+
+			SplitTabs(strLine, vecFields);
+			if (vecFields.size() < 9 || vecFields[1].empty() || (!vecFields[6].empty() && vecFields[6] != "P"))
+				continue;
+
+			Place place = { std::strtof(vecFields[4].c_str(), nullptr), std::strtof(vecFields[5].c_str(), nullptr), addString(vecFields[1]), findCountry(vecFields[8], std::string()) };
+			if (std::fabs(place.fLat) > 90 || std::fabs(place.fLng) > 180)
+				continue;
+
+			vecPlaces.push_back(place);
+		}
+	}
+
+	// Place grid, places are sorted by cell
+	std::stable_sort(vecPlaces.begin(), vecPlaces.end(), [](const Place& lhs, const Place& rhs)
+	{
+		return Cell(CellCol(lhs.fLng), CellRow(lhs.fLat)) < Cell(CellCol(rhs.fLng), CellRow(rhs.fLat));
+	});
+
+	std::vector<uint32_t> vecPlaceCells(GRID_CELLS + 1, 0);
+	for (const Place& place : vecPlaces)
+		++vecPlaceCells[Cell(CellCol(place.fLng), CellRow(place.fLat)) + 1];
+
+	for (uint32_t i = 1; i <= GRID_CELLS; ++i)
+		vecPlaceCells[i] += vecPlaceCells[i - 1];
+
+	// Polygon grid, each polygon is registered in all the cells of its bounds
+	std::vector<std::vector<uint32_t>> vecCellPolygons(GRID_CELLS);
+	for (uint32_t i = 0; i < vecPolygons.size(); ++i)
+	{
+		const Polygon& polygon = vecPolygons[i];
+		for (uint32_t ulRow = CellRow(polygon.fSouth); ulRow <= CellRow(polygon.fNorth); ++ulRow)
+		{
+			for (uint32_t ulCol = CellCol(polygon.fWest); ulCol <= CellCol(polygon.fEast); ++ulCol)
+				vecCellPolygons[Cell(ulCol, ulRow)].push_back(i);
+		}
+	}
+
+	std::vector<uint32_t> vecPolygonCells(GRID_CELLS + 1, 0);
+	std::vector<uint32_t> vecPolygonRefs;
+	for (uint32_t i = 0; i < GRID_CELLS; ++i)
+	{
+		vecPolygonRefs.insert(vecPolygonRefs.end(), vecCellPolygons[i].begin(), vecCellPolygons[i].end());
+		vecPolygonCells[i + 1] = static_cast<uint32_t>(vecPolygonRefs.size());
+	}
+
+	strStrings.resize((strStrings.size() + 3) & ~static_cast<size_t>(3), '\0');
+
+	Header header;
+	memcpy(header.szMagic, GAZETTEER_MAGIC, sizeof(header.szMagic));
+	header.ulVersion = GAZETTEER_VERSION;
+	header.ulCountries = static_cast<uint32_t>(vecCountries.size());
+	header.ulPolygons = static_cast<uint32_t>(vecPolygons.size());
+	header.ulPoints = static_cast<uint32_t>(vecPoints.size());
+	header.ulPlaces = static_cast<uint32_t>(vecPlaces.size());
+	header.ulPolygonRefs = static_cast<uint32_t>(vecPolygonRefs.size());
+	header.ulStrings = static_cast<uint32_t>(strStrings.size());
+
+#ifdef _WIN32
+	std::ofstream ofsFile(strIndexPath.c_str(), std::ios::binary | std::ios::trunc);
+#else
+	std::ofstream ofsFile(std::string(strIndexPath.begin(), strIndexPath.end()).c_str(), std::ios::binary | std::ios::trunc);
+#endif
+	if (!ofsFile)
+		return false;
+
+	ofsFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	WriteArray(ofsFile, vecCountries);
+	WriteArray(ofsFile, vecPolygons);
+	WriteArray(ofsFile, vecPoints);
+	WriteArray(ofsFile, vecPlaces);
+	WriteArray(ofsFile, vecPolygonCells);
+	WriteArray(ofsFile, vecPolygonRefs);
+	WriteArray(ofsFile, vecPlaceCells);
+	ofsFile.write(strStrings.data(), strStrings.size());
+
+	return static_cast<bool>(ofsFile);
+}
+
+bool CGeoGazetteer::open(const std::wstring& strIndexPath)
+{
+	close();
+
+	std::unique_ptr<ifmstream> pFile = std::make_unique<ifmstream>(strIndexPath.c_str());
+	if (!pFile->is_open() || static_cast<size_t>(pFile->size()) < sizeof(Header))
+		return false;
+
+	const char* pData = static_cast<const char*>(pFile->data());
+	size_t ulSize = static_cast<size_t>(pFile->size());
+
+	const Header* pHeader = reinterpret_cast<const Header*>(pData);
+	if (memcmp(pHeader->szMagic, GAZETTEER_MAGIC, sizeof(pHeader->szMagic)) || pHeader->ulVersion != GAZETTEER_VERSION)
+		return false;
+
+	// Check the file size before trusting any offset
+	unsigned long long ullExpected = sizeof(Header)
+		+ static_cast<unsigned long long>(pHeader->ulCountries) * sizeof(Country)
+		+ static_cast<unsigned long long>(pHeader->ulPolygons) * sizeof(Polygon)
+		+ static_cast<unsigned long long>(pHeader->ulPoints) * sizeof(Point)
+		+ static_cast<unsigned long long>(pHeader->ulPlaces) * sizeof(Place)
+		+ static_cast<unsigned long long>(GRID_CELLS + 1) * sizeof(uint32_t) * 2
+		+ static_cast<unsigned long long>(pHeader->ulPolygonRefs) * sizeof(uint32_t)
+		+ pHeader->ulStrings;
+
+	if (ullExpected != ulSize || !pHeader->ulStrings || pData[ulSize - 1] != '\0')
+		return false;
+
+	const char* pCursor = pData + sizeof(Header);
+	auto section = [&](size_t ulBytes)
+	{
+		const char* pSection = pCursor;
+		pCursor += ulBytes;
+		return pSection;
+	};
+
+	const Country* pCountries = reinterpret_cast<const Country*>(section(pHeader->ulCountries * sizeof(Country)));
+	const Polygon* pPolygons = reinterpret_cast<const Polygon*>(section(pHeader->ulPolygons * sizeof(Polygon)));
+	const Point* pPoints = reinterpret_cast<const Point*>(section(pHeader->ulPoints * sizeof(Point)));
+	const Place* pPlaces = reinterpret_cast<const Place*>(section(pHeader->ulPlaces * sizeof(Place)));
+	const uint32_t* pPolygonCells = reinterpret_cast<const uint32_t*>(section((GRID_CELLS + 1) * sizeof(uint32_t)));
+	const uint32_t* pPolygonRefs = reinterpret_cast<const uint32_t*>(section(pHeader->ulPolygonRefs * sizeof(uint32_t)));
+	const uint32_t* pPlaceCells = reinterpret_cast<const uint32_t*>(section((GRID_CELLS + 1) * sizeof(uint32_t)));
+	const char* pStrings = section(pHeader->ulStrings);
+
+	// Validate the references once, queries don't check them
+	if (pPolygonCells[GRID_CELLS] != pHeader->ulPolygonRefs || pPlaceCells[GRID_CELLS] != pHeader->ulPlaces)
+		return false;
+
+	for (uint32_t i = 0; i < GRID_CELLS; ++i)
+	{
+		if (pPolygonCells[i] > pPolygonCells[i + 1] || pPlaceCells[i] > pPlaceCells[i + 1])
+			return false;
+	}
+
+	for (uint32_t i = 0; i < pHeader->ulPolygonRefs; ++i)
+	{
+		if (pPolygonRefs[i] >= pHeader->ulPolygons)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < pHeader->ulPolygons; ++i)
+	{
+		const Polygon& polygon = pPolygons[i];
+		if (polygon.ulCountry >= pHeader->ulCountries || polygon.ulFirstPoint > pHeader->ulPoints || polygon.ulPoints > pHeader->ulPoints - polygon.ulFirstPoint)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < pHeader->ulPlaces; ++i)
+	{
+		if ((pPlaces[i].ulCountry != NO_COUNTRY && pPlaces[i].ulCountry >= pHeader->ulCountries) || pPlaces[i].ulName >= pHeader->ulStrings)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < pHeader->ulCountries; ++i)
+	{
+		if (pCountries[i].ulName >= pHeader->ulStrings)
+			return false;
+	}
+
+	m_pFile = std::move(pFile);
+	m_pHeader = pHeader;
+	m_pCountries = pCountries;
+	m_pPolygons = pPolygons;
+	m_pPoints = pPoints;
+	m_pPlaces = pPlaces;
+	m_pPolygonCells = pPolygonCells;
+	m_pPolygonRefs = pPolygonRefs;
+	m_pPlaceCells = pPlaceCells;
+	m_pStrings = pStrings;
+	m_vecPolygons.resize(pHeader->ulPolygons);
+
+	return true;
+}
+
+void CGeoGazetteer::close()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_vecPolygons.clear();
+	m_pHeader = nullptr;
+	m_pCountries = nullptr;
+	m_pPolygons = nullptr;
+	m_pPoints = nullptr;
+	m_pPlaces = nullptr;
+	m_pPolygonCells = nullptr;
+	m_pPolygonRefs = nullptr;
+	m_pPlaceCells = nullptr;
+	m_pStrings = nullptr;
+	m_pFile.reset();
+}
+
+bool CGeoGazetteer::is_open() const
+{
+	return m_pHeader != nullptr;
+}
+
+const char* CGeoGazetteer::string(uint32_t ulOffset) const
+{
+	return m_pStrings + ulOffset;
+}
+
+const CGeoPolygone& CGeoGazetteer::polygon(uint32_t ulPolygon) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::unique_ptr<CGeoPolygone>& pPolygone = m_vecPolygons[ulPolygon];
+	if (!pPolygone)
+	{
+		const Polygon& polygon = m_pPolygons[ulPolygon];
+
+		CGeoLatLngs gLatLngs;
+		for (uint32_t i = 0; i < polygon.ulPoints; ++i)
+		{
+			const Point& point = m_pPoints[polygon.ulFirstPoint + i];
+			gLatLngs.push_back(CGeoLatLng(point.fLat, point.fLng));
+		}
+
+		pPolygone = std::make_unique<CGeoPolygone>(std::move(gLatLngs));
+	}
+
+	return *pPolygone;
+}
+
+bool CGeoGazetteer::findCountry(const CGeoLatLng& gLatLng, std::string& strCountryCode, std::string& strCountryName) const
+{
+	if (!is_open())
+		return false;
+
+	uint32_t ulCell = Cell(CellCol(gLatLng.lng()), CellRow(gLatLng.lat()));
+	for (uint32_t i = m_pPolygonCells[ulCell]; i < m_pPolygonCells[ulCell + 1]; ++i)
+	{
+		uint32_t ulPolygon = m_pPolygonRefs[i];
+		const Polygon& polygon = m_pPolygons[ulPolygon];
+
+		if (gLatLng.lat() < polygon.fSouth || gLatLng.lat() > polygon.fNorth || gLatLng.lng() < polygon.fWest || gLatLng.lng() > polygon.fEast)
+			continue;
+
+		if (this->polygon(ulPolygon).contains(gLatLng))
+		{
+			const Country& country = m_pCountries[polygon.ulCountry];
+			strCountryCode.assign(country.szCode, 2);
+			strCountryName = string(country.ulName);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CGeoGazetteer::findNearestPlace(const CGeoLatLng& gLatLng, CGeoLocation& gLocation, std::string* pstrCountryCode, size_t ulMaxDistance) const
+{
+	if (!is_open())
+		return false;
+
+	const Place* pBest = nullptr;
+	size_t ulBest = ulMaxDistance;
+
+	int nCol = static_cast<int>(CellCol(gLatLng.lng()));
+	int nRow = static_cast<int>(CellRow(gLatLng.lat()));
+
+	// Visit rings of cells around the coordinate until they can't hold a closer place
+	for (int nRing = 0; nRing <= static_cast<int>(GRID_ROWS); ++nRing)
+	{
+		double dMinLat = std::min(std::fabs(gLatLng.lat()) + nRing, 90.0);
+		double dRingDistance = (nRing - 1) * METERS_PER_DEGREE * std::max(std::cos(dMinLat * DEG2RAD), 0.0);
+		if (nRing > 1 && dRingDistance > static_cast<double>(ulBest))
+			break;
+
+		for (int nDRow = -nRing; nDRow <= nRing; ++nDRow)
+		{
+			int nCellRow = nRow + nDRow;
+			if (nCellRow < 0 || nCellRow >= static_cast<int>(GRID_ROWS))
+				continue;
+
+			// Only the border of the ring
+			int nStep = (nDRow == -nRing || nDRow == nRing) ? 1 : 2 * nRing;
+			for (int nDCol = -nRing; nDCol <= nRing; nDCol += std::max(nStep, 1))
+			{
+				uint32_t ulCol = static_cast<uint32_t>((nCol + nDCol + static_cast<int>(GRID_COLS) * 2) % static_cast<int>(GRID_COLS));
+				uint32_t ulCell = Cell(ulCol, static_cast<uint32_t>(nCellRow));
+
+				for (uint32_t i = m_pPlaceCells[ulCell]; i < m_pPlaceCells[ulCell + 1]; ++i)
+				{
+					const Place& place = m_pPlaces[i];
+					size_t ulDistance = gLatLng.distanceFrom(CGeoLatLng(place.fLat, place.fLng));
+
+					if (ulDistance <= ulBest)
+					{
+						ulBest = ulDistance;
+						pBest = &place;
+					}
+				}
+			}
+		}
+
+		if (nRing * 2 + 1 >= static_cast<int>(GRID_COLS))
+			break; // Whole latitude band visited
+	}
+
+	if (!pBest)
+		return false;
+
+	gLocation.coords(pBest->fLat, pBest->fLng);
+	gLocation.name(string(pBest->ulName));
+	gLocation.comment(std::string());
+
+	if (pstrCountryCode)
+	{
+		if (pBest->ulCountry != NO_COUNTRY)
+			pstrCountryCode->assign(m_pCountries[pBest->ulCountry].szCode, 2);
+		else
+			pstrCountryCode->clear();
+	}
+
+	return true;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_GAZETTEER_H_INCLUDED_
+#define _GEO_GAZETTEER_H_INCLUDED_
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "GeoApi.h"
+
+class ifmstream;
+
+namespace geo
+{
+	class CGeoLatLng;
+	class CGeoLocation;
+	class CGeoPolygone;
+
+	// Offline lookup of the country and of the nearest named place of a coordinate.
+	// The index is a compact binary file, memory-mapped and read in place:
+	// country polygons and places are registered in a grid of one degree cells.
+	class CGeoGazetteer
+	{
+	public:
+		static CGeoGazetteer& instance();
+
+		CGeoGazetteer();
+		~CGeoGazetteer();
+
+		// Build an index from a GeoNames dump (cities500.txt, allCountries.txt, ...) and a GeoJSON FeatureCollection of countries.
+		// Either input may be null. Polygon holes are ignored.
+		static bool build(const std::wstring& strIndexPath, std::istream* pisPlaces, std::istream* pisCountries);
+
+		bool open(const std::wstring& strIndexPath);
+		void close();
+		bool is_open() const;
+
+		bool findCountry(const CGeoLatLng& gLatLng, std::string& strCountryCode, std::string& strCountryName) const;
+		bool findNearestPlace(const CGeoLatLng& gLatLng, CGeoLocation& gLocation, std::string* pstrCountryCode = nullptr, size_t ulMaxDistance = 50000) const;
+
+		CGeoGazetteer(const CGeoGazetteer&) = delete;
+		CGeoGazetteer& operator=(const CGeoGazetteer&) = delete;
+
+	private:
+		struct Header;
+		struct Country;
+		struct Polygon;
+		struct Point;
+		struct Place;
+
+		const CGeoPolygone& polygon(uint32_t ulPolygon) const;
+		const char* string(uint32_t ulOffset) const;
+
+		std::unique_ptr<ifmstream> m_pFile;
+		const Header* m_pHeader;
+		const Country* m_pCountries;
+		const Polygon* m_pPolygons;
+		const Point* m_pPoints;
+		const Place* m_pPlaces;
+		const uint32_t* m_pPolygonCells;
+		const uint32_t* m_pPolygonRefs;
+		const uint32_t* m_pPlaceCells;
+		const char* m_pStrings;
+
+		// Polygons are built on first use
+		mutable std::mutex m_Mutex;
+		mutable std::vector<std::unique_ptr<CGeoPolygone>> m_vecPolygons;
+	};
+} // namespace geo
+
+#endif // _GEO_GAZETTEER_H_INCLUDED_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unordered_map>
+#include "GeoGeocoder.h"
+#include "GeoGeocoderFactory.h"
+#include "GeoGeocoderCache.h"
+#include "GeoRateLimiter.h"
+#include "GeoBatch.h"
+
+using namespace geo;
+
+namespace
+{
+	GeoGeocoderResults LoadBatchWorker(E_GEO_PROVIDER eGeoProvider, const std::vector<std::string>& vecAddresses, const GeoGeocoderCallback& callback)
+	{
+		CGeoGeocoderCache& gCache = CGeoGeocoderCache::instance();
+
+		// Group identical addresses, each group is resolved once
+		std::vector<std::vector<size_t>> vecGroups;
+		{
+			std::unordered_map<std::string, size_t> mapGroups;
+
+			for (size_t i = 0; i < vecAddresses.size(); ++i)
+			{
+				auto it = mapGroups.emplace(CGeoGeocoderCache::normalize(vecAddresses[i]), vecGroups.size());
+				if (it.second)
+					vecGroups.emplace_back();
+
+				vecGroups[it.first->second].push_back(i);
+			}
+		}
+
+		auto makeResolver = [&]()
+		{
+			std::shared_ptr<IGeoGeocoder> pGeocoder = CGeoGeocoderFactory::Get(eGeoProvider, std::nothrow);
+
+			return [&gCache, &vecAddresses, pGeocoder](size_t ulIndex, GeoGeocoderResult& gResult)
+			{
+				if (pGeocoder)
+					gResult.eStatus = gCache.Load(*pGeocoder, vecAddresses[ulIndex], gResult.gLocations);
+			};
+		};
+
+		return GeoRunBatch<GeoGeocoderResult>(vecAddresses.size(), vecGroups, CGeoRateLimiter::instance(eGeoProvider).maxConcurrent(), { E_GEO_UNKNOWN_ERROR, CGeoLocations() }, makeResolver, callback);
+	}
+}
+
+std::future<GeoGeocoderResults> IGeoGeocoder::LoadBatch(const std::string* pstrAddresses, size_t ulSize, const GeoGeocoderCallback& callback) const
+{
+	std::vector<std::string> vecAddresses(pstrAddresses, pstrAddresses + ulSize);
+	return std::async(std::launch::async, LoadBatchWorker, getProvider(), std::move(vecAddresses), callback);
+}
@@ -28,11 +28,22 @@
 #ifndef _GEO_GEOCODER_H_INCLUDED_
 #define _GEO_GEOCODER_H_INCLUDED_
 
+#include <functional>
+#include <future>
+#include <vector>
 #include "GeoApi.h"
+#include "GeoLocations.h"
 
 namespace geo
 {
-	class CGeoLocations;
+	struct GeoGeocoderResult
+	{
+		E_GEO_STATUS_CODE eStatus;
+		CGeoLocations gLocations;
+	};
+
+	typedef std::vector<GeoGeocoderResult> GeoGeocoderResults;
+	typedef std::function<void(size_t, const GeoGeocoderResult&)> GeoGeocoderCallback;
 
 	class IGeoGeocoder
 	{
@@ -41,6 +52,11 @@ namespace geo
 
 		virtual E_GEO_STATUS_CODE Load(const std::string& strAddress) = 0;
 
+		// Resolve all the addresses concurrently, results are in input order.
+		// Identical addresses are resolved once, requests go through the shared cache and the provider rate limiter.
+		// The callback is called from worker threads as soon as each item is resolved.
+		virtual std::future<GeoGeocoderResults> LoadBatch(const std::string* pstrAddresses, size_t ulSize, const GeoGeocoderCallback& callback = nullptr) const;
+
 		virtual E_GEO_PROVIDER getProvider() const noexcept = 0;
 		virtual E_GEO_STATUS_CODE getStatus() const noexcept = 0;
 		virtual const CGeoLocations& getResults() const = 0;
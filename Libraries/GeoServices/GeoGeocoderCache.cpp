@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cctype>
+#include "GeoGeocoderCache.h"
+#include "GeoRateLimiter.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr size_t DEFAULT_CAPACITY = 4096;
+}
+
+CGeoGeocoderCache& CGeoGeocoderCache::instance()
+{
+	static CGeoGeocoderCache gCache;
+	return gCache;
+}
+
+CGeoGeocoderCache::CGeoGeocoderCache() :
+	m_Cache(DEFAULT_CAPACITY)
+{
+}
+
+std::string CGeoGeocoderCache::normalize(const std::string& strAddress)
+{
+	std::string strResult;
+	strResult.reserve(strAddress.size());
+
+	bool bSpace = false;
+	for (char c : strAddress)
+	{
+		unsigned char uc = static_cast<unsigned char>(c);
+		if (std::isspace(uc))
+		{
+			bSpace = !strResult.empty();
+			continue;
+		}
+
+		if (bSpace)
+			strResult += ' ';
+
+		bSpace = false;
+		strResult += (uc < 0x80) ? static_cast<char>(std::tolower(uc)) : c; // UTF-8 sequences are kept as is
+	}
+
+	return strResult;
+}
+
+void CGeoGeocoderCache::setCapacity(size_t ulCapacity)
+{
+	m_Cache.setCapacity(ulCapacity);
+}
+
+size_t CGeoGeocoderCache::capacity() const
+{
+	return m_Cache.capacity();
+}
+
+bool CGeoGeocoderCache::find(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, CGeoLocations& gLocations)
+{
+	return m_Cache.find({ eGeoProvider, normalize(strAddress) }, gLocations);
+}
+
+void CGeoGeocoderCache::insert(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, const CGeoLocations& gLocations)
+{
+	m_Cache.insert({ eGeoProvider, normalize(strAddress) }, gLocations);
+}
+
+void CGeoGeocoderCache::clear()
+{
+	m_Cache.clear();
+}
+
+E_GEO_STATUS_CODE CGeoGeocoderCache::Load(IGeoGeocoder& gGeocoder, const std::string& strAddress, CGeoLocations& gLocations)
+{
+	E_GEO_PROVIDER eGeoProvider = gGeocoder.getProvider();
+
+	if (find(eGeoProvider, strAddress, gLocations))
+		return gLocations.empty() ? E_GEO_ZERO_RESULTS : E_GEO_OK;
+
+	E_GEO_STATUS_CODE eStatus;
+	{
+		CGeoRateLimiter::CScopedRequest request(CGeoRateLimiter::instance(eGeoProvider));
+		eStatus = gGeocoder.Load(strAddress);
+	}
+
+	gLocations.clear();
+	if (eStatus == E_GEO_OK)
+		gLocations = gGeocoder.getResults();
+
+	// Errors are not cached, the request may succeed later
+	if (eStatus == E_GEO_OK || eStatus == E_GEO_ZERO_RESULTS)
+		insert(eGeoProvider, strAddress, gLocations);
+
+	return eStatus;
+}
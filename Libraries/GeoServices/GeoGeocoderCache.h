@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_GEOCODER_CACHE_H_INCLUDED_
+#define _GEO_GEOCODER_CACHE_H_INCLUDED_
+
+#include <string>
+#include "GeoGeocoder.h"
+#include "GeoLocations.h"
+#include "GeoLruCache.h"
+
+namespace geo
+{
+	// Process wide LRU cache of geocoding results.
+	// Addresses are compared case insensitively, ignoring extra spaces, results are shared per provider.
+	class CGeoGeocoderCache
+	{
+	public:
+		static CGeoGeocoderCache& instance();
+
+		static std::string normalize(const std::string& strAddress);
+
+		void setCapacity(size_t ulCapacity);
+		size_t capacity() const;
+
+		bool find(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, CGeoLocations& gLocations);
+		void insert(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, const CGeoLocations& gLocations);
+		void clear();
+
+		// Load through the cache, requests are limited by the provider rate limiter
+		E_GEO_STATUS_CODE Load(IGeoGeocoder& gGeocoder, const std::string& strAddress, CGeoLocations& gLocations);
+
+		CGeoGeocoderCache(const CGeoGeocoderCache&) = delete;
+		CGeoGeocoderCache& operator=(const CGeoGeocoderCache&) = delete;
+
+	private:
+		CGeoGeocoderCache();
+		~CGeoGeocoderCache() = default;
+
+		struct Key
+		{
+			E_GEO_PROVIDER eGeoProvider;
+			std::string strAddress;
+
+			bool operator==(const Key& key) const { return eGeoProvider == key.eGeoProvider && strAddress == key.strAddress; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const { return std::hash<std::string>()(key.strAddress) ^ static_cast<size_t>(key.eGeoProvider); }
+		};
+
+		TGeoLruCache<Key, CGeoLocations, KeyHash> m_Cache;
+	};
+} // namespace geo
+
+#endif // _GEO_GEOCODER_CACHE_H_INCLUDED_
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <limits>
+#include "GeoLatLngSet.h"
+
+using namespace geo;
+
+namespace
+{
+	inline long long quantize(double dValue, double dPrecision)
+	{
+		return static_cast<long long>(std::floor(dValue / dPrecision));
+	}
+
+	inline bool isEquals(double d1, double d2, double dPrecision)
+	{
+		return (((d2 - dPrecision) < d1) && ((d2 + dPrecision) > d1));
+	}
+}
+
+CGeoLatLngKey::CGeoLatLngKey() :
+	m_llLatitude(0),
+	m_llLongitude(0)
+{
+}
+
+CGeoLatLngKey::CGeoLatLngKey(const CGeoLatLng& gLatLng, double dPrecision) :
+	m_llLatitude(quantize(gLatLng.lat(), dPrecision)),
+	m_llLongitude(quantize(gLatLng.lng(), dPrecision))
+{
+}
+
+CGeoLatLngKey::CGeoLatLngKey(double dLatitude, double dLongitude, double dPrecision) :
+	m_llLatitude(quantize(dLatitude, dPrecision)),
+	m_llLongitude(quantize(dLongitude, dPrecision))
+{
+}
+
+bool CGeoLatLngKey::operator==(const CGeoLatLngKey& gLatLngKey) const throw()
+{
+	return m_llLatitude == gLatLngKey.m_llLatitude && m_llLongitude == gLatLngKey.m_llLongitude;
+}
+
+bool CGeoLatLngKey::operator!=(const CGeoLatLngKey& gLatLngKey) const throw()
+{
+	return !operator==(gLatLngKey);
+}
+
+CGeoLatLngKey CGeoLatLngKey::neighbour(int nLatitude, int nLongitude) const
+{
+	CGeoLatLngKey gLatLngKey(*this);
+	gLatLngKey.m_llLatitude += nLatitude;
+	gLatLngKey.m_llLongitude += nLongitude;
+	return gLatLngKey;
+}
+
+size_t CGeoLatLngKey::hash::operator()(const CGeoLatLngKey& gLatLngKey) const throw()
+{
+	// 64-bit mix of both cell indexes (splitmix64 finalizer)
+	unsigned long long ullHash = static_cast<unsigned long long>(gLatLngKey.m_llLatitude) * 0x9E3779B97F4A7C15ULL;
+	ullHash ^= static_cast<unsigned long long>(gLatLngKey.m_llLongitude) + 0x632BE59BD9B4E019ULL + (ullHash << 6) + (ullHash >> 2);
+	ullHash ^= ullHash >> 31;
+	ullHash *= 0xBF58476D1CE4E5B9ULL;
+	ullHash ^= ullHash >> 27;
+	return static_cast<size_t>(ullHash);
+}
+
+CGeoLatLngSet::CGeoLatLngSet(double dPrecision, size_t ulReserve) :
+	m_dPrecision(dPrecision > 0 ? dPrecision : std::numeric_limits<double>::epsilon())
+{
+	if (ulReserve)
+		reserve(ulReserve);
+}
+
+bool CGeoLatLngSet::insert(const CGeoLatLng& gLatLng)
+{
+	if (contains(gLatLng))
+		return false;
+
+	m_mapCells.emplace(CGeoLatLngKey(gLatLng, m_dPrecision), std::make_pair(gLatLng.lat(), gLatLng.lng()));
+	return true;
+}
+
+bool CGeoLatLngSet::contains(const CGeoLatLng& gLatLng) const
+{
+	CGeoLatLngKey gLatLngKey(gLatLng, m_dPrecision);
+
+	// An equivalent coordinate is at most one cell away
+	for (int nLatitude = -1; nLatitude <= 1; ++nLatitude)
+	{
+		for (int nLongitude = -1; nLongitude <= 1; ++nLongitude)
+		{
+			auto range = m_mapCells.equal_range(gLatLngKey.neighbour(nLatitude, nLongitude));
+			for (CellMap::const_iterator cit = range.first; cit != range.second; ++cit)
+			{
+				if (isEquals(gLatLng.lat(), cit->second.first, m_dPrecision) && isEquals(gLatLng.lng(), cit->second.second, m_dPrecision))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void CGeoLatLngSet::clear()
+{
+	m_mapCells.clear();
+}
+
+void CGeoLatLngSet::reserve(size_t ulSize)
+{
+	m_mapCells.reserve(ulSize);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_LATLNGSET_H_INCLUDED_
+#define _GEO_LATLNGSET_H_INCLUDED_
+
+#include <unordered_map>
+#include "GeoLatLng.h"
+
+namespace geo
+{
+	// Quantized coordinates: cell of a regular grid of dPrecision degrees
+	class CGeoLatLngKey
+	{
+	public:
+		CGeoLatLngKey();
+		CGeoLatLngKey(const CGeoLatLng& gLatLng, double dPrecision);
+		CGeoLatLngKey(double dLatitude, double dLongitude, double dPrecision);
+		~CGeoLatLngKey() = default;
+
+		bool operator==(const CGeoLatLngKey& gLatLngKey) const throw();
+		bool operator!=(const CGeoLatLngKey& gLatLngKey) const throw();
+
+		inline long long lat() const throw() { return m_llLatitude; }
+		inline long long lng() const throw() { return m_llLongitude; }
+
+		CGeoLatLngKey neighbour(int nLatitude, int nLongitude) const;
+
+		struct hash
+		{
+			size_t operator()(const CGeoLatLngKey& gLatLngKey) const throw();
+		};
+
+	private:
+		long long m_llLatitude;
+		long long m_llLongitude;
+	};
+
+	// Set of coordinates, two coordinates are equivalent if they are closer than dPrecision.
+	// Insertion and lookup are O(1), only the 3x3 neighbour cells are tested.
+	class CGeoLatLngSet
+	{
+	public:
+		explicit CGeoLatLngSet(double dPrecision, size_t ulReserve = 0);
+		virtual ~CGeoLatLngSet() = default;
+
+		// Return false if an equivalent coordinate is already in the set
+		virtual bool insert(const CGeoLatLng& gLatLng);
+		virtual bool contains(const CGeoLatLng& gLatLng) const;
+
+		virtual void clear();
+		virtual void reserve(size_t ulSize);
+
+		inline size_t size() const throw() { return m_mapCells.size(); }
+		inline bool empty() const throw() { return m_mapCells.empty(); }
+		inline double precision() const throw() { return m_dPrecision; }
+
+	private:
+		typedef std::unordered_multimap<CGeoLatLngKey, std::pair<double, double>, CGeoLatLngKey::hash> CellMap;
+
+		double m_dPrecision;
+		CellMap m_mapCells;
+	};
+} // namespace geo
+
+#endif // _GEO_LATLNGSET_H_INCLUDED_
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include "GeoLatLngs.h"
+#include "GeoLatLngSet.h"
 
 using namespace geo;
 
@@ -127,13 +128,43 @@ const CGeoLatLng& CGeoLatLngs::at(size_t n) const
 	return *it;
 }
 
-void CGeoLatLngs::removeDuplicates()
+size_t CGeoLatLngs::removeDuplicates(double dPrecision, std::vector<size_t>* pvecRemoved)
 {
-	sort();
-	unique();
+	CGeoLatLngSet gLatLngSet(dPrecision > 0 ? dPrecision : precision(), size());
+	size_t ulIndex = 0;
+	size_t ulRemoved = 0;
+
+	GeoLatLngs::iterator it = GeoLatLngs::begin();
+	while (it != GeoLatLngs::end())
+	{
+		if (gLatLngSet.insert(*it))
+		{
+			++it;
+		}
+		else
+		{
+			it = GeoLatLngs::erase(it);
+			if (pvecRemoved)
+				pvecRemoved->push_back(ulIndex);
+			++ulRemoved;
+		}
+
+		++ulIndex;
+	}
+
+	return ulRemoved;
 }
 
 void CGeoLatLngs::removeEmpties()
 {
 	remove_if(removePred);
 }
+
+double CGeoLatLngs::precision() const
+{
+	double dPrecision = 0;
+	for (const_iterator cit = begin(); cit != end(); ++cit)
+		dPrecision = std::max(dPrecision, cit->precision());
+
+	return dPrecision;
+}
@@ -30,6 +30,7 @@
 
 #include <deque>
 #include <list>
+#include <vector>
 #include "GeoLatLng.h"
 #include "stdx/iterator.h"
 
@@ -94,9 +95,13 @@ namespace geo
 
 		virtual size_t upper_bound() const;
 
-		virtual void removeDuplicates();
+		// Keep the first occurrence of each coordinate and the original order.
+		// A null precision means the largest precision of the coordinates.
+		virtual size_t removeDuplicates(double dPrecision = 0, std::vector<size_t>* pvecRemoved = nullptr);
 		virtual void removeEmpties();
 
+		virtual double precision() const;
+
 		CGeoLatLngs& operator=(const CGeoLatLngs& gLatLngs);
 		CGeoLatLngs& operator=(CGeoLatLngs&& gLatLngs);
 		CGeoLatLngs& operator+=(const CGeoLatLngs& gLatLngs);
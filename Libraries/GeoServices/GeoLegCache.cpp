@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdexcept>
+#include <unordered_map>
+#include "GeoLegCache.h"
+#include "GeoDirectionsFactory.h"
+#include "GeoRateLimiter.h"
+#include "GeoBatch.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr size_t DEFAULT_CAPACITY = 1024;
+	constexpr std::chrono::seconds DEFAULT_TIME_TO_LIVE = std::chrono::hours(1);
+	constexpr double LEG_PRECISION = 0.000001; // Degrees, about 10 cm
+}
+
+bool CGeoLegCache::CKey::operator==(const CKey& key) const
+{
+	return eGeoProvider == key.eGeoProvider && vehicleType == key.vehicleType && gFrom == key.gFrom && gTo == key.gTo && strOptions == key.strOptions;
+}
+
+size_t CGeoLegCache::CKey::hash::operator()(const CKey& key) const
+{
+	CGeoLatLngKey::hash hasher;
+
+	size_t ulHash = hasher(key.gFrom);
+	ulHash ^= hasher(key.gTo) + 0x9e3779b9 + (ulHash << 6) + (ulHash >> 2);
+	ulHash ^= std::hash<std::string>()(key.strOptions) + 0x9e3779b9 + (ulHash << 6) + (ulHash >> 2);
+	ulHash ^= (static_cast<size_t>(key.eGeoProvider) << 8) | static_cast<size_t>(key.vehicleType);
+	return ulHash;
+}
+
+CGeoLegCache& CGeoLegCache::instance()
+{
+	static CGeoLegCache gCache;
+	return gCache;
+}
+
+CGeoLegCache::CGeoLegCache() :
+	m_llTimeToLive(DEFAULT_TIME_TO_LIVE.count()),
+	m_Routes(DEFAULT_CAPACITY)
+{
+}
+
+void CGeoLegCache::setCapacity(size_t ulCapacity)
+{
+	m_Routes.setCapacity(ulCapacity);
+}
+
+void CGeoLegCache::setTimeToLive(std::chrono::seconds ttl)
+{
+	if (ttl.count() < 0)
+		throw std::invalid_argument("Bad time to live");
+
+	m_llTimeToLive = ttl.count();
+}
+
+std::chrono::seconds CGeoLegCache::timeToLive() const
+{
+	return std::chrono::seconds(m_llTimeToLive);
+}
+
+void CGeoLegCache::clear()
+{
+	m_Routes.clear();
+}
+
+CGeoLegCache::CKey CGeoLegCache::makeKey(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions)
+{
+	return { eGeoProvider, vehicleType, cgOptions.key(), CGeoLatLngKey(gLeg.gFrom, LEG_PRECISION), CGeoLatLngKey(gLeg.gTo, LEG_PRECISION) };
+}
+
+bool CGeoLegCache::find(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, CGeoRoute& gRoute)
+{
+	CKey key = makeKey(eGeoProvider, gLeg, vehicleType, cgOptions);
+	CEntry entry;
+
+	if (!m_Routes.find(key, entry))
+		return false;
+
+	if (std::chrono::steady_clock::now() >= entry.tpExpiry)
+	{
+		m_Routes.erase(key);
+		return false;
+	}
+
+	gRoute = std::move(entry.gRoute);
+	return true;
+}
+
+void CGeoLegCache::insert(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, const CGeoRoute& gRoute)
+{
+	m_Routes.insert(makeKey(eGeoProvider, gLeg, vehicleType, cgOptions), { gRoute, std::chrono::steady_clock::now() + timeToLive() });
+}
+
+void CGeoLegCache::erase(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions)
+{
+	m_Routes.erase(makeKey(eGeoProvider, gLeg, vehicleType, cgOptions));
+}
+
+E_GEO_STATUS_CODE CGeoLegCache::Load(IGeoDirections& gDirections, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, CGeoRoute& gRoute)
+{
+	E_GEO_PROVIDER eGeoProvider = gDirections.getProvider();
+	if (find(eGeoProvider, gLeg, vehicleType, cgOptions, gRoute))
+		return E_GEO_OK;
+
+	E_GEO_STATUS_CODE eStatus;
+	{
+		CGeoRateLimiter::CScopedRequest request(CGeoRateLimiter::instance(eGeoProvider));
+
+		gDirections.Load(gLeg.gFrom, gLeg.gTo, vehicleType, cgOptions);
+		eStatus = gDirections.getStatus();
+	}
+
+	if (eStatus == E_GEO_OK && !gDirections.getRoutes().empty())
+	{
+		gRoute = gDirections.getRoutes().front();
+		insert(eGeoProvider, gLeg, vehicleType, cgOptions, gRoute);
+	}
+	else if (eStatus == E_GEO_OK)
+	{
+		eStatus = E_GEO_ZERO_RESULTS;
+	}
+
+	return eStatus;
+}
+
+GeoLegResults CGeoLegCache::LoadBatch(E_GEO_PROVIDER eGeoProvider, const GeoLegs& gLegs, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, const std::atomic<bool>* pbCancel, const GeoLegCallback& callback)
+{
+	// Group identical legs, each group is resolved once
+	std::vector<std::vector<size_t>> vecGroups;
+	{
+		std::unordered_map<CKey, size_t, CKey::hash> mapGroups;
+
+		for (size_t i = 0; i < gLegs.size(); ++i)
+		{
+			auto it = mapGroups.emplace(makeKey(eGeoProvider, gLegs[i], vehicleType, cgOptions), vecGroups.size());
+			if (it.second)
+				vecGroups.emplace_back();
+
+			vecGroups[it.first->second].push_back(i);
+		}
+	}
+
+	auto makeResolver = [&]()
+	{
+		std::shared_ptr<IGeoDirections> pDirections = CGeoDirectionsFactory::Get(eGeoProvider, std::nothrow);
+
+		return [this, &gLegs, &vehicleType, &cgOptions, pbCancel, pDirections](size_t ulIndex, GeoLegResult& gResult)
+		{
+			if (pDirections && !(pbCancel && *pbCancel))
+				gResult.eStatus = Load(*pDirections, gLegs[ulIndex], vehicleType, cgOptions, gResult.gRoute);
+		};
+	};
+
+	return GeoRunBatch<GeoLegResult>(gLegs.size(), vecGroups, CGeoRateLimiter::instance(eGeoProvider).maxConcurrent(), { E_GEO_UNKNOWN_ERROR, CGeoRoute() }, makeResolver, callback);
+}
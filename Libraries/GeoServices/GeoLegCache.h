@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_LEG_CACHE_H_INCLUDED_
+#define _GEO_LEG_CACHE_H_INCLUDED_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "GeoApi.h"
+#include "GeoRoute.h"
+#include "GeoLatLngSet.h"
+#include "GeoLruCache.h"
+
+namespace geo
+{
+	class IGeoDirections;
+
+	struct GeoLeg
+	{
+		CGeoLatLng gFrom;
+		CGeoLatLng gTo;
+	};
+
+	typedef std::vector<GeoLeg> GeoLegs;
+
+	struct GeoLegResult
+	{
+		E_GEO_STATUS_CODE eStatus;
+		CGeoRoute gRoute;
+	};
+
+	typedef std::vector<GeoLegResult> GeoLegResults;
+	typedef std::function<void(size_t, const GeoLegResult&)> GeoLegCallback;
+
+	// Process wide cache of the routes between two waypoints, keyed by provider, vehicle and options.
+	// Only the legs changed by an edit of an itinerary have to be requested again.
+	// Routes expire after timeToLive(), traffic and road works make them stale.
+	class CGeoLegCache
+	{
+	public:
+		static CGeoLegCache& instance();
+
+		void setCapacity(size_t ulCapacity);
+		void setTimeToLive(std::chrono::seconds ttl);
+		std::chrono::seconds timeToLive() const;
+		void clear();
+
+		bool find(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, CGeoRoute& gRoute);
+		void insert(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, const CGeoRoute& gRoute);
+		void erase(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions);
+
+		// Cache lookup, then request through gDirections. Only successful routes are cached
+		E_GEO_STATUS_CODE Load(IGeoDirections& gDirections, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, CGeoRoute& gRoute);
+
+		// Resolve all the legs, the missing ones concurrently within the provider rate limit and identical legs once.
+		// The callback is called from the worker threads, the legs not yet started when bCancel is set end with E_GEO_UNKNOWN_ERROR
+		GeoLegResults LoadBatch(E_GEO_PROVIDER eGeoProvider, const GeoLegs& gLegs, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions, const std::atomic<bool>* pbCancel = nullptr, const GeoLegCallback& callback = nullptr);
+
+		CGeoLegCache(const CGeoLegCache&) = delete;
+		CGeoLegCache& operator=(const CGeoLegCache&) = delete;
+
+	private:
+		CGeoLegCache();
+		~CGeoLegCache() = default;
+
+		struct CKey
+		{
+			E_GEO_PROVIDER eGeoProvider;
+			GeoVehicleType::type_t vehicleType;
+			std::string strOptions;
+			CGeoLatLngKey gFrom;
+			CGeoLatLngKey gTo;
+
+			bool operator==(const CKey& key) const;
+
+			struct hash
+			{
+				size_t operator()(const CKey& key) const;
+			};
+		};
+
+		struct CEntry
+		{
+			CGeoRoute gRoute;
+			std::chrono::steady_clock::time_point tpExpiry;
+		};
+
+		static CKey makeKey(E_GEO_PROVIDER eGeoProvider, const GeoLeg& gLeg, GeoVehicleType::type_t vehicleType, const CGeoRouteOptions& cgOptions);
+
+		std::atomic<std::chrono::seconds::rep> m_llTimeToLive;
+		TGeoLruCache<CKey, CEntry, CKey::hash> m_Routes;
+	};
+} // namespace geo
+
+#endif // _GEO_LEG_CACHE_H_INCLUDED_
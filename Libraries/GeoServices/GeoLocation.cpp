@@ -45,7 +45,7 @@ m_strComment(std::move(gLocation.m_strComment))
 {
 }
 
-CGeoLocation::CGeoLocation(const CGeoLatLng& gLatLng, const std::string& strName, const std::string& strComment) : CGeoLatLng(gLatLng),
+CGeoLocation::CGeoLocation(const CGeoLatLng& gLatLng, std::string_view strName, std::string_view strComment) : CGeoLatLng(gLatLng),
 m_strName(strName),
 m_strComment(strComment)
 {
@@ -29,7 +29,9 @@
 #define _GEO_LOCATION_H_INCLUDED_
 
 #include <string>
+#include <string_view>
 #include "GeoLatLng.h"
+#include "GeoString.h"
 
 namespace geo
 {
@@ -41,7 +43,7 @@ namespace geo
 		CGeoLocation();
 		CGeoLocation(const CGeoLocation& gLocation);
 		CGeoLocation(CGeoLocation&& gLocation);
-		CGeoLocation(const CGeoLatLng& gLatLng, const std::string& strName = std::string(), const std::string& strComment = std::string());
+		CGeoLocation(const CGeoLatLng& gLatLng, std::string_view strName = std::string_view(), std::string_view strComment = std::string_view());
 		virtual ~CGeoLocation();
 
 		virtual bool operator==(const CGeoLocation& gLocation) const;
@@ -53,15 +55,18 @@ namespace geo
 
 		virtual void clear() override;
 
-		const std::string& name() const noexcept { return m_strName; }
-		void name(const std::string& strName) noexcept { m_strName = strName; }
+		// Texts are interned, copies of a location and identical texts share their storage
+		const std::string& name() const noexcept { return m_strName.str(); }
+		void name(std::string_view strName) { m_strName = CGeoStringPool::instance().intern(strName); }
+		void name(const CGeoString& strName) noexcept { m_strName = strName; }
 
-		const std::string& comment() const noexcept { return m_strComment; }
-		void comment(const std::string& strComment) noexcept { m_strComment = strComment; }
+		const std::string& comment() const noexcept { return m_strComment.str(); }
+		void comment(std::string_view strComment) { m_strComment = CGeoStringPool::instance().intern(strComment); }
+		void comment(const CGeoString& strComment) noexcept { m_strComment = strComment; }
 
 	private:
-		std::string m_strName;
-		std::string m_strComment;
+		CGeoString m_strName;
+		CGeoString m_strComment;
 	};
 } // namespace geo
 
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_LRU_CACHE_H_INCLUDED_
+#define _GEO_LRU_CACHE_H_INCLUDED_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace geo
+{
+	// Thread-safe least recently used cache
+	template <class K, class V, class H = std::hash<K>>
+	class TGeoLruCache
+	{
+	public:
+		explicit TGeoLruCache(size_t ulCapacity) : m_ulCapacity(ulCapacity) {}
+		~TGeoLruCache() = default;
+
+		void setCapacity(size_t ulCapacity)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_ulCapacity = ulCapacity;
+			shrink();
+		}
+
+		size_t capacity() const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_ulCapacity;
+		}
+
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Entries.size();
+		}
+
+		bool find(const K& key, V& value)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			auto it = m_mapEntries.find(key);
+			if (it == m_mapEntries.end())
+				return false;
+
+			m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+			value = it->second->second;
+			return true;
+		}
+
+		void insert(const K& key, const V& value)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_ulCapacity)
+				return;
+
+			auto it = m_mapEntries.find(key);
+			if (it != m_mapEntries.end())
+			{
+				it->second->second = value;
+				m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+				return;
+			}
+
+			m_Entries.emplace_front(key, value);
+			m_mapEntries[key] = m_Entries.begin();
+			shrink();
+		}
+
+		void erase(const K& key)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			auto it = m_mapEntries.find(key);
+			if (it == m_mapEntries.end())
+				return;
+
+			m_Entries.erase(it->second);
+			m_mapEntries.erase(it);
+		}
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Entries.clear();
+			m_mapEntries.clear();
+		}
+
+		TGeoLruCache(const TGeoLruCache&) = delete;
+		TGeoLruCache& operator=(const TGeoLruCache&) = delete;
+
+	private:
+		typedef std::list<std::pair<K, V>> Entries;
+
+		void shrink()
+		{
+			while (m_Entries.size() > m_ulCapacity)
+			{
+				m_mapEntries.erase(m_Entries.back().first);
+				m_Entries.pop_back();
+			}
+		}
+
+		mutable std::mutex m_Mutex;
+		size_t m_ulCapacity;
+		Entries m_Entries; // Most recently used first
+		std::unordered_map<K, typename Entries::iterator, H> m_mapEntries;
+	};
+} // namespace geo
+
+#endif // _GEO_LRU_CACHE_H_INCLUDED_
@@ -29,6 +29,8 @@
 #include "GeoNamesCountryCode.h"
 #include "GeoNamesTools.h"
 #include "GeoLatLng.h"
+#include "GeoGazetteer.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
 #include "jsonParser/JsonParser.h"
@@ -61,6 +63,13 @@ E_GEO_STATUS_CODE CGeoNamesCountryCode::Load(const CGeoLatLng& gLatLng)
 	m_strCountryName.clear();
 	m_strCountryCode.clear();
 
+	// Offline first, the web service is only a fallback
+	if (CGeoGazetteer::instance().findCountry(gLatLng, m_strCountryCode, m_strCountryName))
+	{
+		m_eStatus = E_GEO_OK;
+		return m_eStatus;
+	}
+
 	const CGeoProvider& providerApi = CGeoProviders::instance().get(getProvider());
 
 	// Build request
@@ -72,7 +81,7 @@ E_GEO_STATUS_CODE CGeoNamesCountryCode::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str())) == CJsonParser::JSON_SUCCESS)
 		{
 			if (jsParser.exist("status"))
 			{
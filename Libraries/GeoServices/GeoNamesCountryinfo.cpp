@@ -29,6 +29,7 @@
 #include <map>
 #include "GeoNamesCountryinfo.h"
 #include "GeoNamesTools.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
 #include "jsonParser/JsonParser.h"
@@ -85,7 +86,7 @@ E_GEO_STATUS_CODE CGeoNamesCountryInfo::Load(const std::string& strCountryCode)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str())) == CJsonParser::JSON_SUCCESS)
 		{
 			if (jsParser.exist("status"))
 			{
@@ -25,35 +25,8 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <cmath>
 #include "GeoPolyline.h"
-
-namespace
-{
-	int DecodeNumber(const std::string& strEncoded, size_t& index)
-	{
-		char car;
-		int iDecode = 0;
-		int iNum = 0;
-
-		do
-		{
-			car = static_cast<char>(strEncoded[index] - 63);
-			iDecode |= (car & 0x1f) << iNum;
-			iNum += 5;
-
-			index++;
-		} while (car >= 0x20);
-
-		return iDecode;
-	}
-
-	int DecodeSignedNumber(const std::string& strEncoded, size_t& index)
-	{
-		int iDecode = DecodeNumber(strEncoded, index);
-		return (iDecode & 1) ? ~(iDecode >> 1) : (iDecode >> 1);
-	}
-}
+#include "GeoPolylineCodec.h"
 
 using namespace geo;
 
@@ -150,26 +123,24 @@ void CGeoPolyline::setColor(unsigned int uiColor) throw()
 	m_uiRGBA = (m_uiRGBA & 0xFF000000) | (uiColor & 0x00FFFFFF);
 }
 
-void CGeoPolyline::fromEncoded(const std::string& strEncodedPolyline, size_t precision)
+bool CGeoPolyline::fromEncoded(const std::string& strEncodedPolyline, size_t precision)
 {
 	m_geoLatLngs.clear();
 
-	size_t len = strEncodedPolyline.size(); // Decode path
-	size_t index = 0;
-	double dPres = 1;
-	int iLate = 0;
-	int	iLnge = 0;
+	GeoCoordinates gCoordinates;
+	if (!decodePolyline(strEncodedPolyline, precision, gCoordinates))
+		return false;
 
-	for (size_t i = 0; i < precision; ++i)
-		dPres *= 10;
+	toLatLngs(gCoordinates, m_geoLatLngs);
+	return true;
+}
 
-	while (index < len)
-	{
-		iLate += DecodeSignedNumber(strEncodedPolyline, index);
-		iLnge += DecodeSignedNumber(strEncodedPolyline, index);
+std::string CGeoPolyline::toEncoded(size_t precision) const
+{
+	GeoCoordinates gCoordinates;
+	toCoordinates(m_geoLatLngs, gCoordinates);
 
-		m_geoLatLngs.push_back(CGeoLatLng(iLate / dPres, iLnge / dPres));
-	}
+	return encodePolyline(gCoordinates, precision);
 }
 
 CGeoPolyline geo::operator+(const CGeoPolyline& gPolyline1, const CGeoPolyline& gPolyline2)
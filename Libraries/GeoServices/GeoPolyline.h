@@ -59,7 +59,8 @@ namespace geo
 		unsigned int getColor() const throw();
 		void setColor(unsigned int uiColor) throw();
 
-		void fromEncoded(const std::string& strEncodedPolyline, size_t precision = 5);
+		bool fromEncoded(const std::string& strEncodedPolyline, size_t precision = 5);
+		std::string toEncoded(size_t precision = 5) const;
 
 	private:
 		CGeoLatLngs m_geoLatLngs;
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GeoPolylineCodec.h"
+
+using namespace geo;
+
+bool geo::decodePolyline(const char* pszEncoded, size_t ulSize, size_t precision, GeoCoordinates& gCoordinates)
+{
+	switch (precision)
+	{
+	case 5:
+		return CGeoPolylineCodec5::decode(pszEncoded, ulSize, gCoordinates);
+	case 6:
+		return CGeoPolylineCodec6::decode(pszEncoded, ulSize, gCoordinates);
+	case 7:
+		return CGeoPolylineCodec7::decode(pszEncoded, ulSize, gCoordinates);
+	default:
+		return internal::polylineDecode(pszEncoded, ulSize, std::pow(10.0, static_cast<double>(precision)), gCoordinates);
+	}
+}
+
+bool geo::decodePolyline(const std::string& strEncoded, size_t precision, GeoCoordinates& gCoordinates)
+{
+	return decodePolyline(strEncoded.data(), strEncoded.size(), precision, gCoordinates);
+}
+
+void geo::encodePolyline(const GeoCoordinate* pgCoordinates, size_t ulSize, size_t precision, std::string& strEncoded)
+{
+	switch (precision)
+	{
+	case 5:
+		CGeoPolylineCodec5::encode(pgCoordinates, ulSize, strEncoded);
+		break;
+	case 6:
+		CGeoPolylineCodec6::encode(pgCoordinates, ulSize, strEncoded);
+		break;
+	case 7:
+		CGeoPolylineCodec7::encode(pgCoordinates, ulSize, strEncoded);
+		break;
+	default:
+		internal::polylineEncode(pgCoordinates, ulSize, std::pow(10.0, static_cast<double>(precision)), strEncoded);
+		break;
+	}
+}
+
+std::string geo::encodePolyline(const GeoCoordinates& gCoordinates, size_t precision)
+{
+	std::string strEncoded;
+	encodePolyline(gCoordinates.data(), gCoordinates.size(), precision, strEncoded);
+	return strEncoded;
+}
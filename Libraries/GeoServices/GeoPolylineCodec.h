@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_POLYLINE_CODEC_H_INCLUDED_
+#define _GEO_POLYLINE_CODEC_H_INCLUDED_
+
+#include <cmath>
+#include <string>
+#include "GeoCoordinates.h"
+
+namespace geo
+{
+	namespace internal
+	{
+		template <unsigned int N> struct pow10 { static constexpr double value = 10.0 * pow10<N - 1>::value; };
+		template <> struct pow10<0> { static constexpr double value = 1.0; };
+
+		constexpr unsigned char polylineOffset = 63;
+		constexpr unsigned char polylineMore = 0x20;
+		constexpr unsigned char polylineMask = 0x1F;
+		constexpr size_t polylineMaxChunks = 13; // 64 bits / 5 bits
+
+		inline long long polylineScale(double dValue, double dFactor)
+		{
+			return std::llround(dValue * dFactor);
+		}
+
+		inline char* polylineEncodeValue(long long llValue, char* pszOut)
+		{
+			unsigned long long ullValue = (static_cast<unsigned long long>(llValue) << 1) ^ static_cast<unsigned long long>(llValue >> 63); // ZigZag
+
+			while (ullValue >= polylineMore)
+			{
+				*pszOut++ = static_cast<char>((polylineMore | (ullValue & polylineMask)) + polylineOffset);
+				ullValue >>= 5;
+			}
+
+			*pszOut++ = static_cast<char>(ullValue + polylineOffset);
+			return pszOut;
+		}
+
+		// Must only be called on a validated buffer, the last chunk of the value is not checked against the end of the buffer
+		inline long long polylineDecodeValue(const unsigned char*& pszIn)
+		{
+			unsigned long long ullValue = 0;
+			unsigned int uiShift = 0;
+			unsigned int uiChunk;
+
+			do
+			{
+				uiChunk = static_cast<unsigned int>(*pszIn++ - polylineOffset);
+				ullValue |= static_cast<unsigned long long>(uiChunk & polylineMask) << uiShift;
+				uiShift += (uiShift < 60) ? 5 : 0; // Malformed values are truncated, not overflowed
+			} while (uiChunk & polylineMore);
+
+			return static_cast<long long>(ullValue >> 1) ^ -static_cast<long long>(ullValue & 1); // ZigZag
+		}
+
+		// Count encoded values, and check all characters. Branchless, so the compiler can vectorize it.
+		inline size_t polylineCount(const unsigned char* pszIn, size_t ulSize, bool& bValid)
+		{
+			size_t ulCount = 0;
+			unsigned int uiInvalid = 0;
+
+			for (size_t i = 0; i < ulSize; ++i)
+			{
+				unsigned int uiChunk = static_cast<unsigned int>(static_cast<unsigned char>(pszIn[i] - polylineOffset));
+				ulCount += (uiChunk < polylineMore);
+				uiInvalid |= (uiChunk > 0x3F);
+			}
+
+			bValid = !uiInvalid && (!ulSize || static_cast<unsigned char>(pszIn[ulSize - 1] - polylineOffset) < polylineMore);
+			return ulCount;
+		}
+
+		inline bool polylineDecode(const char* pszEncoded, size_t ulSize, double dFactor, GeoCoordinates& gCoordinates)
+		{
+			const unsigned char* pszIn = reinterpret_cast<const unsigned char*>(pszEncoded);
+			bool bValid = false;
+			size_t ulValues = polylineCount(pszIn, ulSize, bValid);
+
+			if (!bValid || (ulValues & 1))
+				return false;
+
+			size_t ulFirst = gCoordinates.size();
+			gCoordinates.resize(ulFirst + ulValues / 2);
+
+			GeoCoordinate* pgCoordinate = gCoordinates.data() + ulFirst;
+			long long llLatitude = 0;
+			long long llLongitude = 0;
+
+			for (size_t i = 0; i < ulValues; i += 2, ++pgCoordinate)
+			{
+				llLatitude += polylineDecodeValue(pszIn);
+				llLongitude += polylineDecodeValue(pszIn);
+
+				pgCoordinate->lat = static_cast<double>(llLatitude) / dFactor;
+				pgCoordinate->lng = static_cast<double>(llLongitude) / dFactor;
+				pgCoordinate->alt = 0;
+			}
+
+			return true;
+		}
+
+		inline void polylineEncode(const GeoCoordinate* pgCoordinates, size_t ulSize, double dFactor, std::string& strEncoded)
+		{
+			size_t ulFirst = strEncoded.size();
+			strEncoded.resize(ulFirst + ulSize * 2 * polylineMaxChunks);
+
+			char* pszOut = &strEncoded[0] + ulFirst;
+			long long llLatitude = 0;
+			long long llLongitude = 0;
+
+			for (size_t i = 0; i < ulSize; ++i)
+			{
+				long long llNextLatitude = polylineScale(pgCoordinates[i].lat, dFactor);
+				long long llNextLongitude = polylineScale(pgCoordinates[i].lng, dFactor);
+
+				pszOut = polylineEncodeValue(llNextLatitude - llLatitude, pszOut);
+				pszOut = polylineEncodeValue(llNextLongitude - llLongitude, pszOut);
+
+				llLatitude = llNextLatitude;
+				llLongitude = llNextLongitude;
+			}
+
+			strEncoded.resize(static_cast<size_t>(pszOut - strEncoded.data()));
+		}
+	}
+
+	// Google encoded polyline algorithm format, https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+	// The precision (number of decimals) is a compile time constant: 5 for Google, 6 for OSRM/Valhalla, 7 for high resolution tracks.
+	template <unsigned int Precision>
+	class CGeoPolylineCodec
+	{
+	public:
+		static_assert(Precision <= 9, "Polyline precision must be lower than 10");
+		static constexpr double factor = internal::pow10<Precision>::value;
+
+		// Append decoded coordinates, return false if the encoded string is malformed
+		static bool decode(const char* pszEncoded, size_t ulSize, GeoCoordinates& gCoordinates)
+		{
+			return internal::polylineDecode(pszEncoded, ulSize, factor, gCoordinates);
+		}
+
+		static bool decode(const std::string& strEncoded, GeoCoordinates& gCoordinates)
+		{
+			return decode(strEncoded.data(), strEncoded.size(), gCoordinates);
+		}
+
+		// Append encoded coordinates
+		static void encode(const GeoCoordinate* pgCoordinates, size_t ulSize, std::string& strEncoded)
+		{
+			internal::polylineEncode(pgCoordinates, ulSize, factor, strEncoded);
+		}
+
+		static std::string encode(const GeoCoordinates& gCoordinates)
+		{
+			std::string strEncoded;
+			encode(gCoordinates.data(), gCoordinates.size(), strEncoded);
+			return strEncoded;
+		}
+	};
+
+	typedef CGeoPolylineCodec<5> CGeoPolylineCodec5;
+	typedef CGeoPolylineCodec<6> CGeoPolylineCodec6;
+	typedef CGeoPolylineCodec<7> CGeoPolylineCodec7;
+
+	// Runtime precision, dispatch to the specialized codecs when possible
+	bool decodePolyline(const char* pszEncoded, size_t ulSize, size_t precision, GeoCoordinates& gCoordinates);
+	bool decodePolyline(const std::string& strEncoded, size_t precision, GeoCoordinates& gCoordinates);
+	void encodePolyline(const GeoCoordinate* pgCoordinates, size_t ulSize, size_t precision, std::string& strEncoded);
+	std::string encodePolyline(const GeoCoordinates& gCoordinates, size_t precision);
+} // namespace geo
+
+#endif // _GEO_POLYLINE_CODEC_H_INCLUDED_
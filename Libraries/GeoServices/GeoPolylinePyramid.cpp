@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "GeoPolylinePyramid.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr double PI = 3.14159265358979323846;
+	constexpr double MAX_LATITUDE = 85.05112878;
+	constexpr double TILE_SIZE = 256;
+	constexpr int64_t MAX_TILE_SPAN = 4; // A segment spanning more tiles is tested against the viewport instead
+	constexpr size_t MAX_QUERY_TILES = 4096;
+	constexpr unsigned char HIDDEN = std::numeric_limits<unsigned char>::max();
+
+	struct Pixel
+	{
+		double x;
+		double y;
+	};
+
+	// Web Mercator pixel coordinates at zoom 0 (the world is a 256 x 256 tile)
+	Pixel toPixel(double lat, double lng)
+	{
+		double sinLat = std::sin(std::max(-MAX_LATITUDE, std::min(MAX_LATITUDE, lat)) * PI / 180);
+		return { (lng + 180) / 360 * TILE_SIZE, (0.5 - std::log((1 + sinLat) / (1 - sinLat)) / (4 * PI)) * TILE_SIZE };
+	}
+
+	Pixel toPixel(const GeoCoordinate& gCoordinate)
+	{
+		return toPixel(gCoordinate.lat, gCoordinate.lng);
+	}
+
+	int64_t toTile(double dPixel, unsigned int uiZoom)
+	{
+		int64_t llMax = (static_cast<int64_t>(1) << uiZoom) - 1;
+		return std::max<int64_t>(0, std::min(llMax, static_cast<int64_t>(std::floor(dPixel * std::ldexp(1, uiZoom) / TILE_SIZE))));
+	}
+
+	uint64_t tileKey(int64_t x, int64_t y)
+	{
+		return (static_cast<uint64_t>(x) << 32) | static_cast<uint64_t>(y);
+	}
+
+	double segmentDistance2(const Pixel& p, const Pixel& a, const Pixel& b)
+	{
+		double dx = b.x - a.x;
+		double dy = b.y - a.y;
+		double px = p.x - a.x;
+		double py = p.y - a.y;
+		double len2 = dx * dx + dy * dy;
+
+		if (len2 > 0)
+		{
+			double t = std::min(1.0, std::max(0.0, (px * dx + py * dy) / len2));
+			px -= t * dx;
+			py -= t * dy;
+		}
+
+		return px * px + py * py;
+	}
+
+	void appendRange(std::vector<std::pair<size_t, size_t>>& vecRanges, size_t ulFrom, size_t ulTo)
+	{
+		if (!vecRanges.empty() && vecRanges.back().second >= ulFrom)
+			vecRanges.back().second = std::max(vecRanges.back().second, ulTo);
+		else
+			vecRanges.emplace_back(ulFrom, ulTo);
+	}
+} // namespace
+
+CGeoPolylinePyramid::CGeoPolylinePyramid()
+{
+}
+
+CGeoPolylinePyramid::CGeoPolylinePyramid(const GeoCoordinate* pgCoordinates, size_t ulSize, double dPixelTolerance)
+{
+	build(pgCoordinates, ulSize, dPixelTolerance);
+}
+
+CGeoPolylinePyramid::CGeoPolylinePyramid(const CGeoLatLngs& gLatLngs, double dPixelTolerance)
+{
+	GeoCoordinates gCoordinates;
+	toCoordinates(gLatLngs, gCoordinates);
+	build(gCoordinates.data(), gCoordinates.size(), dPixelTolerance);
+}
+
+void CGeoPolylinePyramid::clear()
+{
+	m_gCoordinates.clear();
+	m_vecMinZoom.clear();
+	m_vecLevels.clear();
+}
+
+void CGeoPolylinePyramid::build(const GeoCoordinate* pgCoordinates, size_t ulSize, double dPixelTolerance)
+{
+	clear();
+	if (!ulSize)
+		return;
+
+	m_gCoordinates.assign(pgCoordinates, pgCoordinates + ulSize);
+
+	std::vector<Pixel> vecPixels(ulSize);
+	for (size_t i = 0; i < ulSize; ++i)
+		vecPixels[i] = toPixel(pgCoordinates[i]);
+
+	// Douglas-Peucker significance, a vertex is never more significant than the vertex which split its range,
+	// so that each level is included in the next one.
+	std::vector<double> vecSignificance(ulSize, 0);
+	vecSignificance.front() = vecSignificance.back() = std::numeric_limits<double>::max();
+
+	struct Split
+	{
+		size_t first;
+		size_t last;
+		double significance;
+	};
+
+	std::vector<Split> vecStack;
+	if (ulSize > 2)
+		vecStack.push_back({ 0, ulSize - 1, std::numeric_limits<double>::max() });
+
+	while (!vecStack.empty())
+	{
+		Split split = vecStack.back();
+		vecStack.pop_back();
+
+		size_t ulFarthest = split.first;
+		double dMaxDist2 = -1;
+
+		for (size_t i = split.first + 1; i < split.last; ++i)
+		{
+			double dDist2 = segmentDistance2(vecPixels[i], vecPixels[split.first], vecPixels[split.last]);
+			if (dDist2 > dMaxDist2)
+			{
+				dMaxDist2 = dDist2;
+				ulFarthest = i;
+			}
+		}
+
+		double dSignificance = std::min(std::sqrt(dMaxDist2), split.significance);
+		vecSignificance[ulFarthest] = dSignificance;
+
+		if (ulFarthest - split.first > 1)
+			vecStack.push_back({ split.first, ulFarthest, dSignificance });
+		if (split.last - ulFarthest > 1)
+			vecStack.push_back({ ulFarthest, split.last, dSignificance });
+	}
+
+	// Vertex is visible at zoom z when its significance exceeds the tolerance, that is when significance * 2^z > tolerance
+	if (dPixelTolerance <= 0)
+		dPixelTolerance = 1;
+
+	m_vecMinZoom.assign(ulSize, 0);
+	unsigned int uiLastZoom = 0;
+
+	for (size_t i = 0; i < ulSize; ++i)
+	{
+		double dSignificance = vecSignificance[i];
+		if (dSignificance <= 0)
+		{
+			m_vecMinZoom[i] = HIDDEN;
+			continue;
+		}
+
+		double dMinZoom = std::floor(std::log2(dPixelTolerance / dSignificance)) + 1;
+		if (dMinZoom > MAX_ZOOM)
+		{
+			m_vecMinZoom[i] = HIDDEN;
+			continue;
+		}
+
+		m_vecMinZoom[i] = static_cast<unsigned char>(std::max(0.0, dMinZoom));
+		uiLastZoom = std::max<unsigned int>(uiLastZoom, m_vecMinZoom[i]);
+	}
+
+	m_vecLevels.resize(uiLastZoom + 1);
+	for (unsigned int uiZoom = 0; uiZoom <= uiLastZoom; ++uiZoom)
+		buildLevel(uiZoom, m_vecLevels[uiZoom]);
+}
+
+void CGeoPolylinePyramid::buildLevel(unsigned int uiZoom, Level& level) const
+{
+	// Vertices of a level are not stored, the segments join the consecutive visible vertices
+	size_t ulFrom = m_vecMinZoom.size();
+	Pixel pixelFrom = {};
+
+	for (size_t ulTo = 0; ulTo < m_vecMinZoom.size(); ++ulTo)
+	{
+		if (!isVisible(ulTo, uiZoom))
+			continue;
+
+		++level.ulVertices;
+		Pixel pixelTo = toPixel(m_gCoordinates[ulTo]);
+		if (ulFrom == m_vecMinZoom.size())
+		{
+			ulFrom = ulTo;
+			pixelFrom = pixelTo;
+			continue;
+		}
+
+		int64_t llMinX = toTile(std::min(pixelFrom.x, pixelTo.x), uiZoom);
+		int64_t llMaxX = toTile(std::max(pixelFrom.x, pixelTo.x), uiZoom);
+		int64_t llMinY = toTile(std::min(pixelFrom.y, pixelTo.y), uiZoom);
+		int64_t llMaxY = toTile(std::max(pixelFrom.y, pixelTo.y), uiZoom);
+
+		if (llMaxX - llMinX > MAX_TILE_SPAN || llMaxY - llMinY > MAX_TILE_SPAN)
+		{
+			level.vecLongSegments.emplace_back(ulFrom, ulTo);
+		}
+		else
+		{
+			for (int64_t x = llMinX; x <= llMaxX; ++x)
+			{
+				for (int64_t y = llMinY; y <= llMaxY; ++y)
+					appendRange(level.mapTiles[tileKey(x, y)], ulFrom, ulTo);
+			}
+		}
+
+		ulFrom = ulTo;
+		pixelFrom = pixelTo;
+	}
+}
+
+unsigned int CGeoPolylinePyramid::getZoom(unsigned int uiZoom) const
+{
+	if (m_vecLevels.empty())
+		throw std::out_of_range("CGeoPolylinePyramid::getZoom");
+
+	return static_cast<unsigned int>(std::min<size_t>(uiZoom, m_vecLevels.size() - 1));
+}
+
+CGeoPolylinePyramid::Indexes CGeoPolylinePyramid::level(unsigned int uiZoom) const
+{
+	uiZoom = getZoom(uiZoom);
+
+	Indexes vecIndexes;
+	for (size_t i = 0; i < m_vecMinZoom.size(); ++i)
+	{
+		if (isVisible(i, uiZoom))
+			vecIndexes.push_back(i);
+	}
+
+	return vecIndexes;
+}
+
+void CGeoPolylinePyramid::query(unsigned int uiZoom, const CGeoLatLng& gSouthWest, const CGeoLatLng& gNorthEast, std::vector<GeoCoordinates>& vecRuns) const
+{
+	vecRuns.clear();
+	if (m_vecLevels.empty())
+		return;
+
+	// The tiles of the levels above the last one are looked up at the zoom of the last one
+	uiZoom = getZoom(uiZoom);
+	const Level& level = m_vecLevels[uiZoom];
+
+	auto addRun = [&](size_t ulFirst, size_t ulLast)
+	{
+		vecRuns.emplace_back();
+		for (size_t i = ulFirst; i <= ulLast; ++i)
+		{
+			if (isVisible(i, uiZoom))
+				vecRuns.back().push_back(m_gCoordinates[i]);
+		}
+	};
+
+	if (level.ulVertices < 2)
+	{
+		for (size_t i = 0; i < m_vecMinZoom.size(); ++i)
+		{
+			if (isVisible(i, uiZoom))
+			{
+				addRun(i, i);
+				break;
+			}
+		}
+		return;
+	}
+
+	Pixel pixelSW = toPixel(gSouthWest.lat(), gSouthWest.lng());
+	Pixel pixelNE = toPixel(gNorthEast.lat(), gNorthEast.lng());
+
+	// Viewport crossing the antimeridian is split in two columns of tiles
+	std::vector<std::pair<double, double>> vecColumns;
+	if (pixelSW.x <= pixelNE.x)
+	{
+		vecColumns.emplace_back(pixelSW.x, pixelNE.x);
+	}
+	else
+	{
+		vecColumns.emplace_back(pixelSW.x, TILE_SIZE);
+		vecColumns.emplace_back(0, pixelNE.x);
+	}
+
+	int64_t llMinY = toTile(pixelNE.y, uiZoom);
+	int64_t llMaxY = toTile(pixelSW.y, uiZoom);
+
+	auto intersects = [&](size_t ulFrom, size_t ulTo)
+	{
+		Pixel pixelFrom = toPixel(m_gCoordinates[ulFrom]);
+		Pixel pixelTo = toPixel(m_gCoordinates[ulTo]);
+
+		if (std::max(pixelFrom.y, pixelTo.y) < pixelNE.y || std::min(pixelFrom.y, pixelTo.y) > pixelSW.y)
+			return false;
+
+		for (const std::pair<double, double>& column : vecColumns)
+		{
+			if (std::max(pixelFrom.x, pixelTo.x) >= column.first && std::min(pixelFrom.x, pixelTo.x) <= column.second)
+				return true;
+		}
+
+		return false;
+	};
+
+	size_t ulTiles = 0;
+	for (const std::pair<double, double>& column : vecColumns)
+		ulTiles += static_cast<size_t>((toTile(column.second, uiZoom) - toTile(column.first, uiZoom) + 1) * (llMaxY - llMinY + 1));
+
+	std::vector<Range> vecRanges;
+	if (ulTiles > MAX_QUERY_TILES)
+	{
+		// Viewport much larger than the screen, tiles lookup would be slower than a scan of the level
+		size_t ulFrom = m_vecMinZoom.size();
+		for (size_t ulTo = 0; ulTo < m_vecMinZoom.size(); ++ulTo)
+		{
+			if (!isVisible(ulTo, uiZoom))
+				continue;
+
+			if (ulFrom != m_vecMinZoom.size() && intersects(ulFrom, ulTo))
+				appendRange(vecRanges, ulFrom, ulTo);
+			ulFrom = ulTo;
+		}
+	}
+	else
+	{
+		for (const std::pair<double, double>& column : vecColumns)
+		{
+			for (int64_t x = toTile(column.first, uiZoom); x <= toTile(column.second, uiZoom); ++x)
+			{
+				for (int64_t y = llMinY; y <= llMaxY; ++y)
+				{
+					auto it = level.mapTiles.find(tileKey(x, y));
+					if (it != level.mapTiles.end())
+						vecRanges.insert(vecRanges.end(), it->second.begin(), it->second.end());
+				}
+			}
+		}
+
+		for (const Range& segment : level.vecLongSegments)
+		{
+			if (intersects(segment.first, segment.second))
+				vecRanges.push_back(segment);
+		}
+	}
+
+	if (vecRanges.empty())
+		return;
+
+	std::sort(vecRanges.begin(), vecRanges.end());
+
+	// Contiguous segments share a vertex and are drawn as a single run
+	Range current = vecRanges.front();
+	for (const Range& range : vecRanges)
+	{
+		if (range.first <= current.second)
+		{
+			current.second = std::max(current.second, range.second);
+		}
+		else
+		{
+			addRun(current.first, current.second);
+			current = range;
+		}
+	}
+
+	addRun(current.first, current.second);
+}
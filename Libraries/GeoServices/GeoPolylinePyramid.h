@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_POLYLINE_PYRAMID_H_INCLUDED_
+#define _GEO_POLYLINE_PYRAMID_H_INCLUDED_
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GeoCoordinates.h"
+
+namespace geo
+{
+	// Level of detail pyramid of a polyline for map display.
+	// Each vertex keeps the first zoom level at which it is visible (significance computed in Web Mercator pixels),
+	// and each zoom level indexes its segments by map tiles so that only the geometry of the viewport is returned.
+	class CGeoPolylinePyramid
+	{
+	public:
+		static constexpr unsigned int MAX_ZOOM = 21;
+
+		typedef std::vector<size_t> Indexes;
+
+		CGeoPolylinePyramid();
+		CGeoPolylinePyramid(const GeoCoordinate* pgCoordinates, size_t ulSize, double dPixelTolerance = 1);
+		CGeoPolylinePyramid(const CGeoLatLngs& gLatLngs, double dPixelTolerance = 1);
+		virtual ~CGeoPolylinePyramid() = default;
+
+		void build(const GeoCoordinate* pgCoordinates, size_t ulSize, double dPixelTolerance = 1);
+		void clear();
+
+		size_t size() const throw() { return m_gCoordinates.size(); }
+		bool empty() const throw() { return m_gCoordinates.empty(); }
+
+		// Indexes of the source coordinates displayed at a zoom level
+		Indexes level(unsigned int uiZoom) const;
+
+		// Runs of coordinates intersecting the bounds at a zoom level, each run must be drawn as a separate polyline
+		void query(unsigned int uiZoom, const CGeoLatLng& gSouthWest, const CGeoLatLng& gNorthEast, std::vector<GeoCoordinates>& vecRuns) const;
+
+	private:
+		typedef std::pair<size_t, size_t> Range; // First and last vertices of contiguous segments, in source indexes
+
+		struct Level
+		{
+			size_t ulVertices = 0;
+			std::unordered_map<uint64_t, std::vector<Range>> mapTiles;
+			std::vector<Range> vecLongSegments; // Segments spanning too many tiles to be indexed
+		};
+
+		unsigned int getZoom(unsigned int uiZoom) const;
+		bool isVisible(size_t ulIndex, unsigned int uiZoom) const throw() { return m_vecMinZoom[ulIndex] <= uiZoom; }
+		void buildLevel(unsigned int uiZoom, Level& level) const;
+
+	private:
+		GeoCoordinates m_gCoordinates;
+		std::vector<unsigned char> m_vecMinZoom; // First zoom level displaying each vertex
+		std::vector<Level> m_vecLevels; // Levels above the last one are identical to the last one
+	};
+} // namespace geo
+
+#endif // _GEO_POLYLINE_PYRAMID_H_INCLUDED_
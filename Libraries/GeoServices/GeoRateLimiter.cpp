@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+#include "GeoRateLimiter.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr size_t DEFAULT_MAX_CONCURRENT = 4;
+	constexpr std::chrono::milliseconds DEFAULT_INTERVAL(50);
+}
+
+CGeoRateLimiter& CGeoRateLimiter::instance(E_GEO_PROVIDER eGeoProvider)
+{
+	static std::mutex mutex;
+	static std::map<E_GEO_PROVIDER, std::unique_ptr<CGeoRateLimiter>> mapRateLimiters;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::unique_ptr<CGeoRateLimiter>& pRateLimiter = mapRateLimiters[eGeoProvider];
+	if (!pRateLimiter)
+		pRateLimiter = std::make_unique<CGeoRateLimiter>();
+
+	return *pRateLimiter;
+}
+
+CGeoRateLimiter::CGeoRateLimiter() :
+	m_ulMaxConcurrent(DEFAULT_MAX_CONCURRENT),
+	m_ulRunning(0),
+	m_msInterval(DEFAULT_INTERVAL),
+	m_tpNextStart(std::chrono::steady_clock::now())
+{
+}
+
+void CGeoRateLimiter::configure(size_t ulMaxConcurrent, std::chrono::milliseconds msInterval)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_ulMaxConcurrent = ulMaxConcurrent ? ulMaxConcurrent : 1;
+		m_msInterval = msInterval;
+	}
+
+	m_Condition.notify_all();
+}
+
+size_t CGeoRateLimiter::maxConcurrent() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_ulMaxConcurrent;
+}
+
+void CGeoRateLimiter::acquire()
+{
+	std::chrono::steady_clock::time_point tpStart;
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_ulRunning < m_ulMaxConcurrent; });
+
+		++m_ulRunning;
+		tpStart = std::max(std::chrono::steady_clock::now(), m_tpNextStart);
+		m_tpNextStart = tpStart + m_msInterval;
+	}
+
+	std::this_thread::sleep_until(tpStart);
+}
+
+void CGeoRateLimiter::release()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_ulRunning)
+			--m_ulRunning;
+	}
+
+	m_Condition.notify_one();
+}
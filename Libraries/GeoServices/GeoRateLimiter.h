@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_RATE_LIMITER_H_INCLUDED_
+#define _GEO_RATE_LIMITER_H_INCLUDED_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "GeoApi.h"
+
+namespace geo
+{
+	// Process wide limit of the requests sent to a provider:
+	// a maximum of concurrent requests, and a minimum interval between two request starts.
+	class CGeoRateLimiter
+	{
+	public:
+		static CGeoRateLimiter& instance(E_GEO_PROVIDER eGeoProvider);
+
+		void configure(size_t ulMaxConcurrent, std::chrono::milliseconds msInterval);
+		size_t maxConcurrent() const;
+
+		void acquire(); // Wait for a free slot
+		void release();
+
+		class CScopedRequest
+		{
+		public:
+			CScopedRequest(CGeoRateLimiter& gRateLimiter) : m_gRateLimiter(gRateLimiter) { m_gRateLimiter.acquire(); }
+			~CScopedRequest() { m_gRateLimiter.release(); }
+
+			CScopedRequest(const CScopedRequest&) = delete;
+			CScopedRequest& operator=(const CScopedRequest&) = delete;
+
+		private:
+			CGeoRateLimiter& m_gRateLimiter;
+		};
+
+		CGeoRateLimiter();
+		~CGeoRateLimiter() = default;
+
+		CGeoRateLimiter(const CGeoRateLimiter&) = delete;
+		CGeoRateLimiter& operator=(const CGeoRateLimiter&) = delete;
+
+	private:
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		size_t m_ulMaxConcurrent;
+		size_t m_ulRunning;
+		std::chrono::milliseconds m_msInterval;
+		std::chrono::steady_clock::time_point m_tpNextStart;
+	};
+} // namespace geo
+
+#endif // _GEO_RATE_LIMITER_H_INCLUDED_
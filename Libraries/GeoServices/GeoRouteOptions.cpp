@@ -25,6 +25,7 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <sstream>
 #include "GeoRouteOptions.h"
 
 namespace geo
@@ -47,6 +48,13 @@ namespace geo
 		m_bLinked |= other.m_bLinked;
 	}
 
+	std::string CGeoRouteOptions::key() const
+	{
+		std::ostringstream oss;
+		oss << type() << ',' << m_itiType << ',' << m_bLinked;
+		return oss.str();
+	}
+
 	std::unique_ptr<CGeoRouteOptions> CGeoRouteOptions::getFromType(GeoRouteOptionsType::type_t optionsType)
 	{
 		switch (optionsType)
@@ -132,6 +140,13 @@ namespace geo
 		}
 	}
 
+	std::string CGeoRoadRouteOptions::key() const
+	{
+		std::ostringstream oss;
+		oss << CGeoRouteOptions::key() << ',' << m_bHighway << m_bTolls << m_bBoatFerry << m_bRailFerry << m_bTunnel << m_bDirtRoad;
+		return oss.str();
+	}
+
 	CGeoTruckRouteOptions::CGeoTruckRouteOptions()
 		: m_category(GeoTruckCategoryType::no_catory)
 		, m_bTractor(false)
@@ -179,6 +194,14 @@ namespace geo
 		}
 	}
 
+	std::string CGeoTruckRouteOptions::key() const
+	{
+		std::ostringstream oss;
+		oss << CGeoRoadRouteOptions::key() << ',' << m_category << ',' << m_bTractor << ',' << m_trailersCount << ',' << m_axleCount
+			<< ',' << m_limitedWeight << ',' << m_weightPerAxle << ',' << m_height << ',' << m_width << ',' << m_length;
+		return oss.str();
+	}
+
 	CGeoThrillingRouteOptions::CGeoThrillingRouteOptions()
 		: m_bAlreadyUsedRoads(true)
 		, m_hilliness(CGeoAcceptedThrillingRouteOptions::degree_normal)
@@ -210,6 +233,13 @@ namespace geo
 		}
 	}
 
+	std::string CGeoThrillingRouteOptions::key() const
+	{
+		std::ostringstream oss;
+		oss << CGeoRoadRouteOptions::key() << ',' << m_bAlreadyUsedRoads << ',' << m_hilliness << ',' << m_windingness;
+		return oss.str();
+	}
+
 	CGeoPedestrianRouteOptions::CGeoPedestrianRouteOptions()
 		: m_bPark(false)
 	{}
@@ -229,5 +259,12 @@ namespace geo
 			m_bPark |= opt.m_bPark;
 		}
 	}
+
+	std::string CGeoPedestrianRouteOptions::key() const
+	{
+		std::ostringstream oss;
+		oss << CGeoRouteOptions::key() << ',' << m_bPark;
+		return oss.str();
+	}
 } // namespace geo
 
@@ -29,6 +29,7 @@
 #define _GEO_ROUTE_OPTIONS_H_INCLUDED_
 
 #include <set>
+#include <string>
 #include <algorithm>
 #include "stdx/prototype.h"
 
@@ -263,6 +264,7 @@ namespace geo
 		void setItineraryType(GeoItineraryType::type_t itiType) { m_itiType = itiType; }
 
 		virtual void merge(const CGeoRouteOptions& other);
+		virtual std::string key() const; // Equal for options giving the same itineraries
 
 		static std::unique_ptr<CGeoRouteOptions> getFromType(GeoRouteOptionsType::type_t optionsType);
 		static std::unique_ptr<CGeoRouteOptions> getFromVehicleType(GeoVehicleType::type_t vehicleType);
@@ -302,6 +304,7 @@ namespace geo
 		void setDirtRoad(bool b) { m_bDirtRoad = b; }
 
 		void merge(const CGeoRouteOptions& other) override;
+		std::string key() const override;
 
 	private:
 		bool m_bHighway;
@@ -351,6 +354,7 @@ namespace geo
 		void setLength(size_t n) { m_length = n; }
 
 		virtual void merge(const CGeoRouteOptions& other) override;
+		std::string key() const override;
 
 	private:
 		GeoTruckCategoryType::type_t m_category;
@@ -385,6 +389,7 @@ namespace geo
 		void setWindingness(CGeoAcceptedThrillingRouteOptions::level_t level) { m_windingness = level; }
 
 		void merge(const CGeoRouteOptions& other) override;
+		std::string key() const override;
 
 	private:
 		bool m_bAlreadyUsedRoads;
@@ -419,6 +424,7 @@ namespace geo
 		void setPark(bool b) { m_bPark = b; }
 
 		void merge(const CGeoRouteOptions& other) override;
+		std::string key() const override;
 
 	private:
 		bool m_bPark;
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unordered_map>
+#include "GeoRvsGeocoder.h"
+#include "GeoRvsGeocoderFactory.h"
+#include "GeoRvsGeocoderCache.h"
+#include "GeoRateLimiter.h"
+#include "GeoBatch.h"
+
+using namespace geo;
+
+namespace
+{
+	GeoRvsGeocoderResults LoadBatchWorker(E_GEO_PROVIDER eGeoProvider, const std::vector<CGeoLatLng>& vecLatLngs, const GeoRvsGeocoderCallback& callback)
+	{
+		CGeoRvsGeocoderCache& gCache = CGeoRvsGeocoderCache::instance();
+
+		// Group close coordinates, each group is resolved once
+		std::vector<std::vector<size_t>> vecGroups;
+		{
+			std::unordered_map<CGeoLatLngKey, size_t, CGeoLatLngKey::hash> mapGroups;
+			double dPrecision = gCache.precision();
+
+			for (size_t i = 0; i < vecLatLngs.size(); ++i)
+			{
+				auto it = mapGroups.emplace(CGeoLatLngKey(vecLatLngs[i], dPrecision), vecGroups.size());
+				if (it.second)
+					vecGroups.emplace_back();
+
+				vecGroups[it.first->second].push_back(i);
+			}
+		}
+
+		auto makeResolver = [&]()
+		{
+			std::shared_ptr<IGeoRvsGeocoder> pGeocoder = CGeoRvsGeocoderFactory::Get(eGeoProvider, std::nothrow);
+
+			return [&gCache, &vecLatLngs, pGeocoder](size_t ulIndex, GeoRvsGeocoderResult& gResult)
+			{
+				if (pGeocoder)
+					gResult.eStatus = gCache.Load(*pGeocoder, vecLatLngs[ulIndex], gResult.gLocations);
+			};
+		};
+
+		return GeoRunBatch<GeoRvsGeocoderResult>(vecLatLngs.size(), vecGroups, CGeoRateLimiter::instance(eGeoProvider).maxConcurrent(), { E_GEO_UNKNOWN_ERROR, CGeoLocations() }, makeResolver, callback);
+	}
+}
+
+std::future<GeoRvsGeocoderResults> IGeoRvsGeocoder::LoadBatch(const CGeoLatLng* pgLatLngs, size_t ulSize, const GeoRvsGeocoderCallback& callback) const
+{
+	std::vector<CGeoLatLng> vecLatLngs(pgLatLngs, pgLatLngs + ulSize);
+	return std::async(std::launch::async, LoadBatchWorker, getProvider(), std::move(vecLatLngs), callback);
+}
@@ -28,11 +28,23 @@
 #ifndef _GEO_RVS_GEOCODER_H_INCLUDED_
 #define _GEO_RVS_GEOCODER_H_INCLUDED_
 
+#include <functional>
+#include <future>
+#include <vector>
 #include "GeoApi.h"
 #include "GeoLocations.h"
 
 namespace geo
 {
+	struct GeoRvsGeocoderResult
+	{
+		E_GEO_STATUS_CODE eStatus;
+		CGeoLocations gLocations;
+	};
+
+	typedef std::vector<GeoRvsGeocoderResult> GeoRvsGeocoderResults;
+	typedef std::function<void(size_t, const GeoRvsGeocoderResult&)> GeoRvsGeocoderCallback;
+
 	class IGeoRvsGeocoder
 	{
 	public:
@@ -40,6 +52,11 @@ namespace geo
 
 		virtual E_GEO_STATUS_CODE Load(const CGeoLatLng& gLatLng) = 0;
 
+		// Resolve all the coordinates concurrently, results are in input order.
+		// Close coordinates are resolved once, requests go through the shared cache and the provider rate limiter.
+		// The callback is called from worker threads as soon as each item is resolved.
+		virtual std::future<GeoRvsGeocoderResults> LoadBatch(const CGeoLatLng* pgLatLngs, size_t ulSize, const GeoRvsGeocoderCallback& callback = nullptr) const;
+
 		virtual E_GEO_PROVIDER getProvider() const noexcept = 0;
 		virtual E_GEO_STATUS_CODE getStatus() const noexcept = 0;
 		virtual const CGeoLocations& getResults() const = 0;
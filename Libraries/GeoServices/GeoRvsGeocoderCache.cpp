@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "GeoRvsGeocoderCache.h"
+#include "GeoRateLimiter.h"
+#include "GeoGazetteer.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr double DEFAULT_PRECISION = 1e-4; // About 10 meters
+	constexpr size_t DEFAULT_CAPACITY = 4096;
+	constexpr int INTERNET_ERROR_BASE = 12000; // WinInet errors, HTTP status codes are below
+
+	// The service could not be reached, as opposed to a service answering with an error
+	bool IsNetworkFailure(E_GEO_STATUS_CODE eStatus)
+	{
+		return eStatus == E_GEO_TIMEOUT || eStatus == E_HTTP_ERROR || eStatus >= E_HTTP_ERROR + INTERNET_ERROR_BASE;
+	}
+}
+
+CGeoRvsGeocoderCache& CGeoRvsGeocoderCache::instance()
+{
+	static CGeoRvsGeocoderCache gCache;
+	return gCache;
+}
+
+CGeoRvsGeocoderCache::CGeoRvsGeocoderCache() :
+	m_dPrecision(DEFAULT_PRECISION),
+	m_Cache(DEFAULT_CAPACITY)
+{
+}
+
+void CGeoRvsGeocoderCache::setPrecision(double dPrecision)
+{
+	if (dPrecision <= 0)
+		throw std::invalid_argument("Bad precision");
+
+	m_dPrecision = dPrecision;
+	m_Cache.clear();
+}
+
+double CGeoRvsGeocoderCache::precision() const
+{
+	return m_dPrecision;
+}
+
+void CGeoRvsGeocoderCache::setCapacity(size_t ulCapacity)
+{
+	m_Cache.setCapacity(ulCapacity);
+}
+
+size_t CGeoRvsGeocoderCache::capacity() const
+{
+	return m_Cache.capacity();
+}
+
+bool CGeoRvsGeocoderCache::find(E_GEO_PROVIDER eGeoProvider, const CGeoLatLng& gLatLng, CGeoLocations& gLocations)
+{
+	return m_Cache.find({ eGeoProvider, CGeoLatLngKey(gLatLng, m_dPrecision) }, gLocations);
+}
+
+void CGeoRvsGeocoderCache::insert(E_GEO_PROVIDER eGeoProvider, const CGeoLatLng& gLatLng, const CGeoLocations& gLocations)
+{
+	m_Cache.insert({ eGeoProvider, CGeoLatLngKey(gLatLng, m_dPrecision) }, gLocations);
+}
+
+void CGeoRvsGeocoderCache::clear()
+{
+	m_Cache.clear();
+}
+
+E_GEO_STATUS_CODE CGeoRvsGeocoderCache::Load(IGeoRvsGeocoder& gGeocoder, const CGeoLatLng& gLatLng, CGeoLocations& gLocations)
+{
+	E_GEO_PROVIDER eGeoProvider = gGeocoder.getProvider();
+
+	if (find(eGeoProvider, gLatLng, gLocations))
+		return gLocations.empty() ? E_GEO_ZERO_RESULTS : E_GEO_OK;
+
+	E_GEO_STATUS_CODE eStatus;
+	{
+		CGeoRateLimiter::CScopedRequest request(CGeoRateLimiter::instance(eGeoProvider));
+		eStatus = gGeocoder.Load(gLatLng);
+	}
+
+	gLocations.clear();
+	if (eStatus == E_GEO_OK)
+	{
+		gLocations = gGeocoder.getResults();
+	}
+	else if (IsNetworkFailure(eStatus))
+	{
+		// Service unreachable, the nearest known place is better than nothing
+		CGeoLocation gLocation;
+		if (CGeoGazetteer::instance().findNearestPlace(gLatLng, gLocation))
+		{
+			gLocations.push_back(gLocation);
+			return E_GEO_APPROXIMATE; // Not cached, the service may answer later
+		}
+	}
+
+	// Errors are not cached, the request may succeed later
+	if (eStatus == E_GEO_OK || eStatus == E_GEO_ZERO_RESULTS)
+		insert(eGeoProvider, gLatLng, gLocations);
+
+	return eStatus;
+}
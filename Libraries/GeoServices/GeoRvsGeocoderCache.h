@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_RVS_GEOCODER_CACHE_H_INCLUDED_
+#define _GEO_RVS_GEOCODER_CACHE_H_INCLUDED_
+
+#include <atomic>
+#include "GeoRvsGeocoder.h"
+#include "GeoLatLngSet.h"
+#include "GeoLruCache.h"
+
+namespace geo
+{
+	// Process wide LRU cache of reverse geocoding results.
+	// Coordinates are quantized on a grid of precision() degrees, results are shared per provider.
+	class CGeoRvsGeocoderCache
+	{
+	public:
+		static CGeoRvsGeocoderCache& instance();
+
+		void setPrecision(double dPrecision); // Clear the cache
+		double precision() const;
+
+		void setCapacity(size_t ulCapacity);
+		size_t capacity() const;
+
+		bool find(E_GEO_PROVIDER eGeoProvider, const CGeoLatLng& gLatLng, CGeoLocations& gLocations);
+		void insert(E_GEO_PROVIDER eGeoProvider, const CGeoLatLng& gLatLng, const CGeoLocations& gLocations);
+		void clear();
+
+		// Load through the cache, requests are limited by the provider rate limiter.
+		// Return E_GEO_APPROXIMATE with the nearest gazetteer place when the service is unreachable.
+		E_GEO_STATUS_CODE Load(IGeoRvsGeocoder& gGeocoder, const CGeoLatLng& gLatLng, CGeoLocations& gLocations);
+
+		CGeoRvsGeocoderCache(const CGeoRvsGeocoderCache&) = delete;
+		CGeoRvsGeocoderCache& operator=(const CGeoRvsGeocoderCache&) = delete;
+
+	private:
+		CGeoRvsGeocoderCache();
+		~CGeoRvsGeocoderCache() = default;
+
+		struct Key
+		{
+			E_GEO_PROVIDER eGeoProvider;
+			CGeoLatLngKey gLatLngKey;
+
+			bool operator==(const Key& key) const throw() { return eGeoProvider == key.eGeoProvider && gLatLngKey == key.gLatLngKey; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const throw() { return CGeoLatLngKey::hash()(key.gLatLngKey) ^ static_cast<size_t>(key.eGeoProvider); }
+		};
+
+		std::atomic<double> m_dPrecision;
+		TGeoLruCache<Key, CGeoLocations, KeyHash> m_Cache;
+	};
+} // namespace geo
+
+#endif // _GEO_RVS_GEOCODER_CACHE_H_INCLUDED_
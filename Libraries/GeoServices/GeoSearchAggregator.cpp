@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include "GeoSearchAggregator.h"
+#include "GeoGeocoderFactory.h"
+#include "GeoLocalSearchFactory.h"
+#include "ToolsLibrary/HttpClient.h"
+
+using namespace geo;
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	bool IsTransient(E_GEO_STATUS_CODE eStatus)
+	{
+		return eStatus == E_GEO_UNKNOWN_ERROR || eStatus == E_GEO_TIMEOUT || eStatus >= E_HTTP_ERROR;
+	}
+}
+
+CGeoSearchAggregator::CGeoSearchAggregator(double dPrecision) :
+	m_dPrecision(dPrecision)
+{
+}
+
+CGeoSearchAggregator::~CGeoSearchAggregator()
+{
+	joinAttempts();
+}
+
+void CGeoSearchAggregator::startAttempt(const std::shared_ptr<AnswerQueue>& pQueue, size_t ulSource)
+{
+	// A late answer is pushed to a queue that nobody reads any more
+	m_vecAttempts.emplace_back([pQueue, ulSource, search = m_vecSources[ulSource].search]()
+	{
+		Answer answer = { ulSource, E_GEO_UNKNOWN_ERROR, CGeoLocations() };
+
+		try
+		{
+			answer.eStatus = search(answer.gLocations);
+		}
+		catch (CInternetException& inetException)
+		{
+			answer.eStatus = static_cast<E_GEO_STATUS_CODE>(E_HTTP_ERROR + inetException.code());
+		}
+		catch (...)
+		{
+			answer.eStatus = E_GEO_UNKNOWN_ERROR;
+		}
+
+		pQueue->push_back(answer);
+	});
+}
+
+void CGeoSearchAggregator::joinAttempts()
+{
+	for (std::thread& attempt : m_vecAttempts)
+		attempt.join();
+
+	m_vecAttempts.clear();
+}
+
+void CGeoSearchAggregator::addSource(E_GEO_PROVIDER eGeoProvider, const SearchFunction& search, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge)
+{
+	if (!search)
+		throw std::invalid_argument("Bad search function");
+
+	m_vecSources.push_back({ eGeoProvider, search, msDeadline, msHedge, E_GEO_INVALID_REQUEST, CGeoLocations() });
+}
+
+void CGeoSearchAggregator::addGeocoder(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge)
+{
+	addSource(eGeoProvider, [eGeoProvider, strAddress](CGeoLocations& gLocations)
+	{
+		CGeoGeocoder gGeocoder(eGeoProvider);
+
+		E_GEO_STATUS_CODE eStatus = gGeocoder->Load(strAddress);
+		if (eStatus == E_GEO_OK)
+			gLocations = gGeocoder->getResults();
+
+		return eStatus;
+	}, msDeadline, msHedge);
+}
+
+void CGeoSearchAggregator::addLocalSearch(E_GEO_PROVIDER eGeoProvider, const std::string& strText, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge)
+{
+	addSource(eGeoProvider, [eGeoProvider, strText](CGeoLocations& gLocations)
+	{
+		CGeoLocalSearch gLocalSearch(eGeoProvider);
+
+		gLocalSearch->Load(strText);
+		E_GEO_STATUS_CODE eStatus = gLocalSearch->getStatus();
+		if (eStatus == E_GEO_OK)
+			gLocations = gLocalSearch->getLocations();
+
+		return eStatus;
+	}, msDeadline, msHedge);
+}
+
+E_GEO_STATUS_CODE CGeoSearchAggregator::run(const ResultFunction& callback)
+{
+	std::shared_ptr<AnswerQueue> pQueue = std::make_shared<AnswerQueue>();
+	Clock::time_point tpStart = Clock::now();
+
+	// Number of attempts still running per source, 0 once the source is settled
+	std::vector<size_t> vecPending(m_vecSources.size(), 1);
+	std::vector<bool> vecHedged(m_vecSources.size(), false);
+	size_t ulRemaining = m_vecSources.size();
+
+	joinAttempts();
+	m_gResults.clear();
+
+	for (size_t i = 0; i < m_vecSources.size(); ++i)
+	{
+		m_vecSources[i].eStatus = E_GEO_UNKNOWN_ERROR;
+		m_vecSources[i].gLocations.clear();
+		vecHedged[i] = m_vecSources[i].msHedge <= std::chrono::milliseconds::zero();
+		startAttempt(pQueue, i);
+	}
+
+	auto settle = [&](size_t ulSource, E_GEO_STATUS_CODE eStatus, CGeoLocations&& gLocations)
+	{
+		Source& source = m_vecSources[ulSource];
+		source.eStatus = eStatus;
+		source.gLocations = std::move(gLocations);
+		vecPending[ulSource] = 0;
+		--ulRemaining;
+
+		merge();
+		if (callback)
+			callback(source.eGeoProvider, eStatus, m_gResults);
+	};
+
+	while (ulRemaining)
+	{
+		// Next hedge or deadline
+		Clock::time_point tpNow = Clock::now();
+		Clock::time_point tpNext = Clock::time_point::max();
+
+		for (size_t i = 0; i < m_vecSources.size(); ++i)
+		{
+			if (!vecPending[i])
+				continue;
+
+			Clock::time_point tpDeadline = m_vecSources[i].msDeadline > std::chrono::milliseconds::zero() ? tpStart + m_vecSources[i].msDeadline : Clock::time_point::max();
+			if (tpDeadline <= tpNow)
+			{
+				settle(i, E_GEO_TIMEOUT, CGeoLocations());
+				continue;
+			}
+
+			Clock::time_point tpHedge = tpStart + m_vecSources[i].msHedge;
+			if (!vecHedged[i] && tpHedge <= tpNow)
+			{
+				vecHedged[i] = true;
+				++vecPending[i];
+				startAttempt(pQueue, i);
+			}
+			else if (!vecHedged[i])
+			{
+				tpNext = std::min(tpNext, tpHedge);
+			}
+
+			tpNext = std::min(tpNext, tpDeadline);
+		}
+
+		if (!ulRemaining)
+			break;
+
+		Answer answer;
+		if (tpNext == Clock::time_point::max())
+			pQueue->pop_front(answer);
+		else if (pQueue->pop_front(answer, tpNext - Clock::now()) == stdx::cq_status::timeout)
+			continue;
+
+		if (!vecPending[answer.ulSource])
+			continue; // Already settled, late hedged answer
+
+		// A transient failure is retried once, or waits for the other attempt of the same source
+		size_t& ulPending = vecPending[answer.ulSource];
+		--ulPending;
+
+		if (IsTransient(answer.eStatus))
+		{
+			if (!vecHedged[answer.ulSource])
+			{
+				vecHedged[answer.ulSource] = true;
+				++ulPending;
+				startAttempt(pQueue, answer.ulSource);
+			}
+
+			if (ulPending)
+				continue;
+		}
+
+		settle(answer.ulSource, answer.eStatus, std::move(answer.gLocations));
+	}
+
+	for (const Source& source : m_vecSources)
+	{
+		if (source.eStatus == E_GEO_OK)
+			return E_GEO_OK;
+	}
+
+	// Network failures are reported first so that the caller can offer a retry
+	for (const Source& source : m_vecSources)
+	{
+		if (source.eStatus > E_HTTP_ERROR)
+			return source.eStatus;
+	}
+
+	return m_vecSources.empty() ? E_GEO_INVALID_REQUEST : m_vecSources.front().eStatus;
+}
+
+void CGeoSearchAggregator::merge()
+{
+	// Sources are merged in declaration order whatever the answer order, so that results don't jump around
+	m_gResults.clear();
+	for (const Source& source : m_vecSources)
+	{
+		if (source.eStatus == E_GEO_OK)
+			m_gResults += source.gLocations;
+	}
+
+	m_gResults.removeDuplicates(m_dPrecision);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_SEARCH_AGGREGATOR_H_INCLUDED_
+#define _GEO_SEARCH_AGGREGATOR_H_INCLUDED_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GeoApi.h"
+#include "GeoLocations.h"
+#include "stdx/concurrent_queue.h"
+
+namespace geo
+{
+	// Send a search to several providers at once and merge the answers as they arrive.
+	// A source which has not answered after its hedge delay is requested a second time, the first answer wins.
+	// A source which has not answered before its deadline is given up with E_GEO_TIMEOUT, a null deadline never expires.
+	// Requests can't be interrupted, the attempts still running are joined by the next run or the destructor.
+	class CGeoSearchAggregator
+	{
+	public:
+		typedef std::function<E_GEO_STATUS_CODE(CGeoLocations&)> SearchFunction;
+		typedef std::function<void(E_GEO_PROVIDER, E_GEO_STATUS_CODE, const CGeoLocations&)> ResultFunction;
+
+		explicit CGeoSearchAggregator(double dPrecision = 0); // Merge precision in degrees, see CGeoLatLngs::removeDuplicates
+		~CGeoSearchAggregator();
+
+		// The search function is called from a worker thread and must own all its data
+		void addSource(E_GEO_PROVIDER eGeoProvider, const SearchFunction& search, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge = std::chrono::milliseconds::zero());
+		void addGeocoder(E_GEO_PROVIDER eGeoProvider, const std::string& strAddress, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge = std::chrono::milliseconds::zero());
+		void addLocalSearch(E_GEO_PROVIDER eGeoProvider, const std::string& strText, std::chrono::milliseconds msDeadline, std::chrono::milliseconds msHedge = std::chrono::milliseconds::zero());
+
+		// Block until all the sources have answered or expired.
+		// The callback is called from the calling thread after each answer with the merged results so far.
+		// Return E_GEO_OK if at least one source succeeded, otherwise the first HTTP error (E_HTTP_ERROR + code)
+		// or else the status of the first source.
+		E_GEO_STATUS_CODE run(const ResultFunction& callback = nullptr);
+
+		E_GEO_STATUS_CODE getStatus(size_t ulSource) const { return m_vecSources.at(ulSource).eStatus; }
+		const CGeoLocations& getResults() const noexcept { return m_gResults; }
+
+		CGeoSearchAggregator(const CGeoSearchAggregator&) = delete;
+		CGeoSearchAggregator& operator=(const CGeoSearchAggregator&) = delete;
+
+	private:
+		struct Source
+		{
+			E_GEO_PROVIDER eGeoProvider;
+			SearchFunction search;
+			std::chrono::milliseconds msDeadline;
+			std::chrono::milliseconds msHedge;
+			E_GEO_STATUS_CODE eStatus;
+			CGeoLocations gLocations;
+		};
+
+		struct Answer
+		{
+			size_t ulSource;
+			E_GEO_STATUS_CODE eStatus;
+			CGeoLocations gLocations;
+		};
+
+		typedef stdx::concurrent_queue<Answer> AnswerQueue;
+
+		void startAttempt(const std::shared_ptr<AnswerQueue>& pQueue, size_t ulSource);
+		void joinAttempts();
+		void merge();
+
+		double m_dPrecision;
+		std::vector<Source> m_vecSources;
+		CGeoLocations m_gResults;
+		std::vector<std::thread> m_vecAttempts;
+	};
+} // namespace geo
+
+#endif // _GEO_SEARCH_AGGREGATOR_H_INCLUDED_
@@ -31,9 +31,11 @@
 #include "HereApi.h"
 #include "GeoLocations.h"
 #include "GeoDirectionsFactory.h"
+#include "GeoLegCache.h"
 #include "GeoGeocoderFactory.h"
 #include "GeoRvsGeocoderFactory.h"
 #include "GeoLocalSearchFactory.h"
+#include "GeoSearchAggregator.h"
 #include "GeoMercatorXY.h"
 #include "GoogleUrl.h"
 #include "HereUrl.h"
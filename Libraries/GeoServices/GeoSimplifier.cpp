@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include "GeoSimplifier.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr double EARTH_RADIUS = 6378137; // Earth radius in meter
+	constexpr double DEG2RAD = 3.14159265358979323846 / 180;
+	constexpr size_t MIN_CHUNK_SIZE = 8192; // Below this size, a polyline is not split for parallel simplification
+
+	struct Point
+	{
+		double x;
+		double y;
+	};
+
+	// Local equirectangular projection, in meters
+	class CProjection
+	{
+	public:
+		CProjection(double dRefLatitude) : m_dCos(std::cos(dRefLatitude * DEG2RAD)) {}
+
+		Point operator()(const GeoCoordinate& gCoordinate) const
+		{
+			return { gCoordinate.lng * DEG2RAD * EARTH_RADIUS * m_dCos, gCoordinate.lat * DEG2RAD * EARTH_RADIUS };
+		}
+
+	private:
+		double m_dCos;
+	};
+
+	// Squared distance between p and the segment [a, b]
+	double segmentDistance2(const Point& p, const Point& a, const Point& b)
+	{
+		double dx = b.x - a.x;
+		double dy = b.y - a.y;
+		double px = p.x - a.x;
+		double py = p.y - a.y;
+		double len2 = dx * dx + dy * dy;
+
+		if (len2 > 0)
+		{
+			double t = std::min(1.0, std::max(0.0, (px * dx + py * dy) / len2));
+			px -= t * dx;
+			py -= t * dy;
+		}
+
+		return px * px + py * py;
+	}
+
+	// Twice the area of the triangle (a, b, c)
+	double triangleArea2(const Point& a, const Point& b, const Point& c)
+	{
+		return std::fabs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+	}
+
+	void project(const GeoCoordinate* pgCoordinates, size_t ulFirst, size_t ulLast, std::vector<Point>& vecPoints)
+	{
+		CProjection projection((pgCoordinates[ulFirst].lat + pgCoordinates[ulLast].lat) / 2);
+
+		vecPoints.resize(ulLast - ulFirst + 1);
+		for (size_t i = ulFirst; i <= ulLast; ++i)
+			vecPoints[i - ulFirst] = projection(pgCoordinates[i]);
+	}
+
+	// Douglas-Peucker, ranges are refined by decreasing deviation so that a point budget can be honoured
+	void douglasPeucker(const std::vector<Point>& vecPoints, double dTolerance, size_t ulMaxPoints, std::vector<bool>& vecKeep)
+	{
+		struct Range
+		{
+			size_t first;
+			size_t last;
+			size_t farthest;
+			double dist2;
+
+			bool operator<(const Range& r) const { return dist2 < r.dist2; }
+		};
+
+		auto makeRange = [&](size_t first, size_t last)
+		{
+			Range range = { first, last, first, -1 };
+			for (size_t i = first + 1; i < last; ++i)
+			{
+				double dist2 = segmentDistance2(vecPoints[i], vecPoints[first], vecPoints[last]);
+				if (dist2 > range.dist2)
+				{
+					range.dist2 = dist2;
+					range.farthest = i;
+				}
+			}
+			return range;
+		};
+
+		double dTolerance2 = dTolerance * dTolerance;
+		size_t ulKept = 2;
+		std::priority_queue<Range> queue;
+
+		if (vecPoints.size() > 2)
+			queue.push(makeRange(0, vecPoints.size() - 1));
+
+		while (!queue.empty() && (!ulMaxPoints || ulKept < ulMaxPoints))
+		{
+			Range range = queue.top();
+			if (range.dist2 <= dTolerance2)
+				break;
+
+			queue.pop();
+			vecKeep[range.farthest] = true;
+			++ulKept;
+
+			if (range.farthest - range.first > 1)
+				queue.push(makeRange(range.first, range.farthest));
+			if (range.last - range.farthest > 1)
+				queue.push(makeRange(range.farthest, range.last));
+		}
+	}
+
+	// Visvalingam-Whyatt, the point with the smallest effective area is removed first
+	void visvalingam(const std::vector<Point>& vecPoints, double dTolerance, size_t ulMaxPoints, std::vector<bool>& vecKeep)
+	{
+		struct Area
+		{
+			double area;
+			size_t index;
+
+			bool operator<(const Area& a) const { return area > a.area; }
+		};
+
+		size_t ulSize = vecPoints.size();
+		std::vector<size_t> vecPrev(ulSize);
+		std::vector<size_t> vecNext(ulSize);
+		std::vector<double> vecArea(ulSize, 0);
+		std::priority_queue<Area> queue;
+
+		for (size_t i = 0; i < ulSize; ++i)
+		{
+			vecPrev[i] = i - 1;
+			vecNext[i] = i + 1;
+			vecKeep[i] = true;
+		}
+
+		for (size_t i = 1; i + 1 < ulSize; ++i)
+		{
+			vecArea[i] = triangleArea2(vecPoints[i - 1], vecPoints[i], vecPoints[i + 1]);
+			queue.push({ vecArea[i], i });
+		}
+
+		double dThreshold = dTolerance * dTolerance * 2;
+		double dLastArea = 0;
+		size_t ulKept = ulSize;
+
+		auto update = [&](size_t i)
+		{
+			if (i == 0 || i + 1 == ulSize)
+				return;
+
+			// Effective areas never decrease, removing a point must not make a neighbour cheaper than itself
+			vecArea[i] = std::max(dLastArea, triangleArea2(vecPoints[vecPrev[i]], vecPoints[i], vecPoints[vecNext[i]]));
+			queue.push({ vecArea[i], i });
+		};
+
+		while (!queue.empty() && ulKept > 2)
+		{
+			Area area = queue.top();
+			if (!vecKeep[area.index] || area.area != vecArea[area.index])
+			{
+				queue.pop(); // Stale entry
+				continue;
+			}
+
+			if (area.area >= dThreshold && (!ulMaxPoints || ulKept <= ulMaxPoints))
+				break;
+
+			queue.pop();
+			vecKeep[area.index] = false;
+			--ulKept;
+			dLastArea = area.area;
+
+			size_t prev = vecPrev[area.index];
+			size_t next = vecNext[area.index];
+			vecNext[prev] = next;
+			vecPrev[next] = prev;
+
+			update(prev);
+			update(next);
+		}
+	}
+} // namespace
+
+CGeoSimplifier::CGeoSimplifier(E_SIMPLIFY_ALGORITHM algorithm, double dTolerance, size_t ulMaxPoints) :
+	m_algorithm(E_SIMPLIFY_DOUGLAS_PEUCKER),
+	m_dTolerance(dTolerance),
+	m_ulMaxPoints(ulMaxPoints),
+	m_ulThreads(0)
+{
+	this->algorithm(algorithm);
+}
+
+void CGeoSimplifier::algorithm(E_SIMPLIFY_ALGORITHM algorithm)
+{
+	if (algorithm != E_SIMPLIFY_DOUGLAS_PEUCKER && algorithm != E_SIMPLIFY_VISVALINGAM)
+		throw std::invalid_argument("Bad simplification algorithm");
+
+	m_algorithm = algorithm;
+}
+
+void CGeoSimplifier::simplifySegment(const GeoCoordinate* pgCoordinates, size_t ulFirst, size_t ulLast, size_t ulMaxPoints, Indexes& vecKept) const
+{
+	vecKept.clear();
+
+	if (ulLast - ulFirst < 2)
+	{
+		for (size_t i = ulFirst; i <= ulLast; ++i)
+			vecKept.push_back(i);
+		return;
+	}
+
+	std::vector<Point> vecPoints;
+	project(pgCoordinates, ulFirst, ulLast, vecPoints);
+
+	std::vector<bool> vecKeep(vecPoints.size(), false);
+	vecKeep.front() = true;
+	vecKeep.back() = true;
+
+	if (m_algorithm == E_SIMPLIFY_VISVALINGAM)
+		visvalingam(vecPoints, m_dTolerance, ulMaxPoints, vecKeep);
+	else
+		douglasPeucker(vecPoints, m_dTolerance, ulMaxPoints, vecKeep);
+
+	for (size_t i = 0; i < vecKeep.size(); ++i)
+	{
+		if (vecKeep[i])
+			vecKept.push_back(ulFirst + i);
+	}
+}
+
+void CGeoSimplifier::simplify(const GeoCoordinate* pgCoordinates, size_t ulSize, Indexes& vecKept, const Indexes& vecAnchors) const
+{
+	vecKept.clear();
+
+	if (!ulSize)
+		return;
+
+	if (!enabled() || ulSize < 3 || (m_ulMaxPoints && ulSize <= m_ulMaxPoints && m_dTolerance <= 0))
+	{
+		vecKept.resize(ulSize);
+		for (size_t i = 0; i < ulSize; ++i)
+			vecKept[i] = i;
+		return;
+	}
+
+	size_t ulThreads = m_ulThreads ? m_ulThreads : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	// Cut points: anchors, then regular chunks when the polyline is large enough to be worth splitting
+	Indexes vecCuts;
+	vecCuts.push_back(0);
+	for (size_t anchor : vecAnchors)
+	{
+		if (anchor > 0 && anchor < ulSize - 1)
+			vecCuts.push_back(anchor);
+	}
+
+	if (ulThreads > 1 && ulSize >= 2 * MIN_CHUNK_SIZE)
+	{
+		size_t ulChunk = std::max(MIN_CHUNK_SIZE, (ulSize + ulThreads - 1) / ulThreads);
+
+		// Cut points are always kept, they must not use more than half of the budget left by the anchors
+		if (m_ulMaxPoints)
+		{
+			size_t ulFree = m_ulMaxPoints > vecCuts.size() + 1 ? m_ulMaxPoints - vecCuts.size() - 1 : 0;
+			ulChunk = ulFree >= 2 ? std::max(ulChunk, 2 * ulSize / ulFree + 1) : ulSize;
+		}
+
+		for (size_t i = ulChunk; i < ulSize - 1; i += ulChunk)
+			vecCuts.push_back(i);
+	}
+
+	vecCuts.push_back(ulSize - 1);
+	std::sort(vecCuts.begin(), vecCuts.end());
+	vecCuts.erase(std::unique(vecCuts.begin(), vecCuts.end()), vecCuts.end());
+
+	size_t ulSegments = vecCuts.size() - 1;
+	std::vector<Indexes> vecResults(ulSegments);
+
+	// The point budget left after the cut points is shared between the inner points of the segments,
+	// proportionally to their count. Shares are rounded on the cumulated count so that they sum up
+	// exactly to the budget, only the anchors themselves can go over it.
+	size_t ulInnerPoints = ulSize - vecCuts.size();
+	size_t ulInnerBudget = m_ulMaxPoints > vecCuts.size() ? m_ulMaxPoints - vecCuts.size() : 0;
+
+	auto segmentBudget = [&](size_t ulSegment)
+	{
+		if (!m_ulMaxPoints)
+			return static_cast<size_t>(0);
+
+		if (!ulInnerPoints)
+			return static_cast<size_t>(2);
+
+		// Inner points before the segment begin and end
+		unsigned long long ullBegin = vecCuts[ulSegment] - ulSegment;
+		unsigned long long ullEnd = vecCuts[ulSegment + 1] - ulSegment - 1;
+
+		// Segment ends are counted in the segment budget
+		return 2 + static_cast<size_t>((ulInnerBudget * ullEnd) / ulInnerPoints - (ulInnerBudget * ullBegin) / ulInnerPoints);
+	};
+
+	std::atomic<size_t> ulNext(0);
+	auto worker = [&]()
+	{
+		for (size_t ulSegment = ulNext++; ulSegment < ulSegments; ulSegment = ulNext++)
+			simplifySegment(pgCoordinates, vecCuts[ulSegment], vecCuts[ulSegment + 1], segmentBudget(ulSegment), vecResults[ulSegment]);
+	};
+
+	ulThreads = std::min(ulThreads, ulSegments);
+	if (ulThreads > 1 && ulSize >= MIN_CHUNK_SIZE)
+	{
+		std::vector< std::future<void> > vecFutures;
+		for (size_t i = 1; i < ulThreads; ++i)
+			vecFutures.push_back(std::async(std::launch::async, worker));
+
+		worker();
+		for (std::future<void>& future : vecFutures)
+			future.get();
+	}
+	else
+	{
+		worker();
+	}
+
+	// Segments share their boundary point
+	for (const Indexes& vecResult : vecResults)
+	{
+		Indexes::const_iterator cit = vecResult.begin();
+		if (!vecKept.empty() && cit != vecResult.end() && *cit == vecKept.back())
+			++cit;
+
+		vecKept.insert(vecKept.end(), cit, vecResult.end());
+	}
+}
+
+void CGeoSimplifier::simplify(const GeoCoordinates& gCoordinates, GeoCoordinates& gSimplified) const
+{
+	Indexes vecKept;
+	simplify(gCoordinates.data(), gCoordinates.size(), vecKept);
+
+	gSimplified.clear();
+	gSimplified.reserve(vecKept.size());
+	for (size_t i : vecKept)
+		gSimplified.push_back(gCoordinates[i]);
+}
+
+void CGeoSimplifier::simplify(CGeoLatLngs& gLatLngs) const
+{
+	GeoCoordinates gCoordinates;
+	toCoordinates(gLatLngs, gCoordinates);
+
+	Indexes vecKept;
+	simplify(gCoordinates.data(), gCoordinates.size(), vecKept);
+
+	Indexes::const_iterator citKept = vecKept.begin();
+	size_t ulIndex = 0;
+
+	for (CGeoLatLngs::iterator it = gLatLngs.begin(); it != gLatLngs.end(); ++ulIndex)
+	{
+		if (citKept != vecKept.end() && *citKept == ulIndex)
+		{
+			++citKept;
+			++it;
+		}
+		else
+		{
+			it = gLatLngs.erase(it);
+		}
+	}
+}
+
+CGeoStreamSimplifier::CGeoStreamSimplifier(double dTolerance, const OutputFunction& output, size_t ulWindow) :
+	m_dTolerance(dTolerance),
+	m_ulWindow(std::max<size_t>(2, ulWindow)),
+	m_Output(output),
+	m_bAnchor(false),
+	m_gAnchor()
+{
+}
+
+void CGeoStreamSimplifier::emit(const GeoCoordinate& gCoordinate)
+{
+	m_gAnchor = gCoordinate;
+	m_bAnchor = true;
+
+	if (m_Output)
+		m_Output(gCoordinate);
+}
+
+bool CGeoStreamSimplifier::fits(const GeoCoordinate& gCoordinate) const
+{
+	CProjection projection(m_gAnchor.lat);
+	Point a = projection(m_gAnchor);
+	Point b = projection(gCoordinate);
+	double dTolerance2 = m_dTolerance * m_dTolerance;
+
+	for (const GeoCoordinate& gPending : m_Window)
+	{
+		if (segmentDistance2(projection(gPending), a, b) > dTolerance2)
+			return false;
+	}
+
+	return true;
+}
+
+void CGeoStreamSimplifier::push(const GeoCoordinate& gCoordinate)
+{
+	if (!m_bAnchor)
+	{
+		emit(gCoordinate);
+		return;
+	}
+
+	// The last pending coordinate becomes the new anchor when the window can no longer be replaced by a single segment
+	if (!m_Window.empty() && (m_Window.size() >= m_ulWindow || !fits(gCoordinate)))
+	{
+		emit(m_Window.back());
+		m_Window.clear();
+	}
+
+	m_Window.push_back(gCoordinate);
+}
+
+void CGeoStreamSimplifier::flush()
+{
+	if (!m_Window.empty())
+		emit(m_Window.back());
+
+	m_Window.clear();
+	m_bAnchor = false;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_SIMPLIFIER_H_INCLUDED_
+#define _GEO_SIMPLIFIER_H_INCLUDED_
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include "GeoCoordinates.h"
+
+namespace geo
+{
+	// Polyline simplification on contiguous coordinates.
+	// The result is the sorted list of kept indexes, first and last coordinates are always kept.
+	// Distances are computed in meters on a local equirectangular projection.
+	class CGeoSimplifier
+	{
+	public:
+		typedef enum
+		{
+			E_SIMPLIFY_DOUGLAS_PEUCKER, // Tolerance = maximum distance to the simplified polyline
+			E_SIMPLIFY_VISVALINGAM      // Tolerance = square root of the minimum effective area
+		} E_SIMPLIFY_ALGORITHM;
+
+		typedef std::vector<size_t> Indexes;
+
+		// Throws std::invalid_argument for an unknown algorithm
+		CGeoSimplifier(E_SIMPLIFY_ALGORITHM algorithm = E_SIMPLIFY_DOUGLAS_PEUCKER, double dTolerance = 0, size_t ulMaxPoints = 0);
+		virtual ~CGeoSimplifier() = default;
+
+		inline E_SIMPLIFY_ALGORITHM algorithm() const throw() { return m_algorithm; }
+		void algorithm(E_SIMPLIFY_ALGORITHM algorithm); // Throws std::invalid_argument for an unknown algorithm
+
+		// In meters, 0 for none
+		inline double tolerance() const throw() { return m_dTolerance; }
+		inline void tolerance(double dTolerance) throw() { m_dTolerance = dTolerance; }
+
+		// 0 for unlimited, the budget covers the whole polyline but never drops an anchor
+		inline size_t maxPoints() const throw() { return m_ulMaxPoints; }
+		inline void maxPoints(size_t ulMaxPoints) throw() { m_ulMaxPoints = ulMaxPoints; }
+
+		// 0 for the number of hardware threads
+		inline size_t threads() const throw() { return m_ulThreads; }
+		inline void threads(size_t ulThreads) throw() { m_ulThreads = ulThreads; }
+
+		bool enabled() const throw() { return m_dTolerance > 0 || m_ulMaxPoints > 0; }
+
+		// Anchors are indexes which must be kept (waypoints of a route for example).
+		// The polyline is cut at anchors and at regular intervals, and segments are simplified in parallel.
+		virtual void simplify(const GeoCoordinate* pgCoordinates, size_t ulSize, Indexes& vecKept, const Indexes& vecAnchors = Indexes()) const;
+		virtual void simplify(const GeoCoordinates& gCoordinates, GeoCoordinates& gSimplified) const;
+		virtual void simplify(CGeoLatLngs& gLatLngs) const;
+
+	private:
+		void simplifySegment(const GeoCoordinate* pgCoordinates, size_t ulFirst, size_t ulLast, size_t ulMaxPoints, Indexes& vecKept) const;
+
+	private:
+		E_SIMPLIFY_ALGORITHM m_algorithm;
+		double m_dTolerance;
+		size_t m_ulMaxPoints;
+		size_t m_ulThreads;
+	};
+
+	// Single pass simplification for unbounded inputs (opening window algorithm).
+	// A coordinate is emitted as soon as it is known to be kept, memory is bounded by the window size.
+	class CGeoStreamSimplifier
+	{
+	public:
+		typedef std::function<void(const GeoCoordinate&)> OutputFunction;
+
+		CGeoStreamSimplifier(double dTolerance, const OutputFunction& output, size_t ulWindow = 256);
+		virtual ~CGeoStreamSimplifier() = default;
+
+		void push(const GeoCoordinate& gCoordinate);
+		void flush(); // Emit the last pending coordinate
+
+	private:
+		bool fits(const GeoCoordinate& gCoordinate) const;
+		void emit(const GeoCoordinate& gCoordinate);
+
+	private:
+		double m_dTolerance;
+		size_t m_ulWindow;
+		OutputFunction m_Output;
+		bool m_bAnchor;
+		GeoCoordinate m_gAnchor;
+		std::deque<GeoCoordinate> m_Window;
+	};
+} // namespace geo
+
+#endif // _GEO_SIMPLIFIER_H_INCLUDED_
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include "GeoString.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr size_t MIN_PURGE_SIZE = 4096;
+	const std::string c_strEmpty;
+}
+
+CGeoString::CGeoString() noexcept :
+	m_pEntry(nullptr)
+{
+}
+
+CGeoString::CGeoString(std::string_view strValue) :
+	CGeoString(CGeoStringPool::instance().intern(strValue))
+{
+}
+
+CGeoString::CGeoString(const CGeoString& gString) noexcept :
+	m_pEntry(gString.m_pEntry)
+{
+	if (m_pEntry)
+		m_pEntry->ulRefs.fetch_add(1, std::memory_order_relaxed);
+}
+
+CGeoString::CGeoString(CGeoString&& gString) noexcept :
+	m_pEntry(gString.m_pEntry)
+{
+	gString.m_pEntry = nullptr;
+}
+
+CGeoString::~CGeoString()
+{
+	clear();
+}
+
+CGeoString& CGeoString::operator= (const CGeoString& gString) noexcept
+{
+	if (gString.m_pEntry != m_pEntry)
+	{
+		if (gString.m_pEntry)
+			gString.m_pEntry->ulRefs.fetch_add(1, std::memory_order_relaxed);
+
+		clear();
+		m_pEntry = gString.m_pEntry;
+	}
+
+	return *this;
+}
+
+CGeoString& CGeoString::operator= (CGeoString&& gString) noexcept
+{
+	if (&gString != this)
+	{
+		clear();
+		std::swap(m_pEntry, gString.m_pEntry);
+	}
+
+	return *this;
+}
+
+const std::string& CGeoString::str() const noexcept
+{
+	return m_pEntry ? m_pEntry->strValue : c_strEmpty;
+}
+
+void CGeoString::clear() noexcept
+{
+	// The entry itself is released by the pool purge
+	if (m_pEntry)
+		m_pEntry->ulRefs.fetch_sub(1, std::memory_order_release);
+
+	m_pEntry = nullptr;
+}
+
+CGeoStringPool& CGeoStringPool::instance()
+{
+	static CGeoStringPool gPool;
+	return gPool;
+}
+
+CGeoStringPool::CGeoStringPool() :
+	m_ulPurgeSize(MIN_PURGE_SIZE)
+{
+}
+
+CGeoString CGeoStringPool::intern(std::string_view strValue)
+{
+	if (strValue.empty())
+		return CGeoString();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_mapEntries.find(strValue);
+	if (it == m_mapEntries.end())
+	{
+		if (m_mapEntries.size() >= m_ulPurgeSize)
+		{
+			purgeLocked();
+			m_ulPurgeSize = std::max(MIN_PURGE_SIZE, m_mapEntries.size() * 2);
+		}
+
+		std::unique_ptr<CGeoString::CEntry> pEntry(new CGeoString::CEntry{ {0}, std::string(strValue) });
+		std::string_view strKey(pEntry->strValue);
+		it = m_mapEntries.emplace(strKey, std::move(pEntry)).first;
+	}
+
+	// Under the lock, so a purge cannot release an entry being referenced again
+	it->second->ulRefs.fetch_add(1, std::memory_order_relaxed);
+	return CGeoString(it->second.get());
+}
+
+size_t CGeoStringPool::purge()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return purgeLocked();
+}
+
+size_t CGeoStringPool::purgeLocked()
+{
+	size_t ulPurged = 0;
+
+	for (auto it = m_mapEntries.begin(); it != m_mapEntries.end();)
+	{
+		if (it->second->ulRefs.load(std::memory_order_acquire) == 0)
+		{
+			it = m_mapEntries.erase(it);
+			++ulPurged;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	return ulPurged;
+}
+
+size_t CGeoStringPool::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_mapEntries.size();
+}
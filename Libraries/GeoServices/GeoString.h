@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GEO_STRING_H_INCLUDED_
+#define _GEO_STRING_H_INCLUDED_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace geo
+{
+	class CGeoStringPool;
+
+	// Handle on an immutable string interned in CGeoStringPool.
+	// Identical texts share the same storage, which stays valid as long as a handle references it.
+	class CGeoString
+	{
+	public:
+		CGeoString() noexcept;
+		CGeoString(std::string_view strValue);
+		CGeoString(const CGeoString& gString) noexcept;
+		CGeoString(CGeoString&& gString) noexcept;
+		~CGeoString();
+
+		CGeoString& operator= (const CGeoString& gString) noexcept;
+		CGeoString& operator= (CGeoString&& gString) noexcept;
+
+		// Interned strings are compared by identity
+		bool operator==(const CGeoString& gString) const noexcept { return m_pEntry == gString.m_pEntry; }
+		bool operator!=(const CGeoString& gString) const noexcept { return m_pEntry != gString.m_pEntry; }
+
+		const std::string& str() const noexcept;
+		std::string_view view() const noexcept { return str(); }
+		operator const std::string& () const noexcept { return str(); }
+
+		bool empty() const noexcept { return !m_pEntry; }
+		void clear() noexcept;
+
+	private:
+		friend class CGeoStringPool;
+
+		struct CEntry
+		{
+			std::atomic<size_t> ulRefs;
+			const std::string strValue;
+		};
+
+		explicit CGeoString(CEntry* pEntry) noexcept : m_pEntry(pEntry) {}
+
+		CEntry* m_pEntry; // Null for an empty string
+	};
+
+	// Process wide pool of the point names and comments, a text read a million times is stored once.
+	// Unreferenced strings are released by purge(), which also runs each time the pool doubles.
+	class CGeoStringPool
+	{
+	public:
+		static CGeoStringPool& instance();
+
+		CGeoString intern(std::string_view strValue);
+		size_t purge();
+
+		size_t size() const;
+
+	private:
+		CGeoStringPool();
+
+		CGeoStringPool(const CGeoStringPool&) = delete;
+		CGeoStringPool& operator=(const CGeoStringPool&) = delete;
+
+		size_t purgeLocked();
+
+	private:
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::string_view, std::unique_ptr<CGeoString::CEntry>> m_mapEntries; // Keys view the entry values
+		size_t m_ulPurgeSize;
+	};
+} // namespace geo
+
+#endif // _GEO_STRING_H_INCLUDED_
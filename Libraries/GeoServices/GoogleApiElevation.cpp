@@ -29,6 +29,8 @@
 #include "GoogleApiElevation.h"
 #include "GoogleTools.h"
 #include "GeoLocation.h"
+#include "GeoPolylineCodec.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -36,6 +38,12 @@
 using namespace geo;
 
 #define GEOCODER_URL		"https://maps.googleapis.com/maps/api/elevation/json?sensor=false&locations="
+#define ENCODED_PREFIX		"enc:"
+
+namespace
+{
+	constexpr size_t MAX_LOCATIONS = 256; // Per request, keeps the url far below the 16k limit
+}
 
 CGoogleApiElevation::CGoogleApiElevation() :
 	m_eStatus(E_GEO_INVALID_REQUEST)
@@ -60,7 +68,7 @@ E_GEO_STATUS_CODE CGoogleApiElevation::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(E_GEO_PROVIDER_GOOGLE_API), ossUrl.str())) == CJsonParser::JSON_SUCCESS)
 		{
 			// Read status
 			m_eStatus = CGoogleTools::GetStatusCode(jsParser("status"));
@@ -93,3 +101,67 @@ E_GEO_STATUS_CODE CGoogleApiElevation::Load(const CGeoLatLng& gLatLng)
 
 	return m_eStatus;
 }
+
+E_GEO_STATUS_CODE CGoogleApiElevation::Load(const CGeoLatLngs& gLatLngs)
+{
+	m_eStatus = E_GEO_ZERO_RESULTS;
+	m_ElvResults = gLatLngs;
+
+	CGeoLatLngs::iterator it = m_ElvResults.begin();
+	while (it != m_ElvResults.end())
+	{
+		CGeoLatLngs::iterator itFirst = it;
+		GeoCoordinates gCoordinates;
+		gCoordinates.reserve(MAX_LOCATIONS);
+
+		for (; it != m_ElvResults.end() && gCoordinates.size() < MAX_LOCATIONS; ++it)
+			gCoordinates.push_back({ it->lat(), it->lng(), it->alt() });
+
+		E_GEO_STATUS_CODE eStatus = LoadChunk(gCoordinates, itFirst);
+		if (eStatus == E_GEO_OK)
+			m_eStatus = E_GEO_OK;
+		else if (eStatus != E_GEO_ZERO_RESULTS)
+			return (m_eStatus = eStatus);
+	}
+
+	return m_eStatus;
+}
+
+E_GEO_STATUS_CODE CGoogleApiElevation::LoadChunk(const GeoCoordinates& gCoordinates, CGeoLatLngs::iterator itResult)
+{
+	std::ostringstream ossUrl;
+	CJsonParser jsParser;
+
+	// Build request
+	ossUrl << GEOCODER_URL << ENCODED_PREFIX << encodePolyline(gCoordinates, 5);
+
+	try
+	{
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(E_GEO_PROVIDER_GOOGLE_API), ossUrl.str())) != CJsonParser::JSON_SUCCESS)
+			return E_GEO_UNKNOWN_ERROR;
+
+		// Read status
+		E_GEO_STATUS_CODE eStatus = CGoogleTools::GetStatusCode(jsParser("status"));
+		if (eStatus != E_GEO_OK)
+			return eStatus;
+
+		// Read results, one per location and in the same order
+		const CJsonArray& jsArray = jsParser("results");
+		for (size_t i = 0; i < jsArray.size() && i < gCoordinates.size(); i++, ++itResult)
+		{
+			const CJsonObject& jsObject = jsArray[i];
+			if (jsObject.exist("elevation"))
+				itResult->alt(jsObject("elevation"));
+		}
+
+		return E_GEO_OK;
+	}
+	catch (CJsonException&)
+	{
+		return E_GEO_INVALID_REQUEST;
+	}
+	catch (CInternetException&)
+	{
+		return E_HTTP_ERROR;
+	}
+}
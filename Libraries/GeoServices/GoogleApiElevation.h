@@ -30,6 +30,7 @@
 
 #include "GeoElevation.h"
 #include "GeoLatLngs.h"
+#include "GeoCoordinates.h"
 
 namespace geo
 {
@@ -41,11 +42,14 @@ namespace geo
 		~CGoogleApiElevation() final = default;
 
 		E_GEO_STATUS_CODE Load(const CGeoLatLng& gLatLng) final;
+		E_GEO_STATUS_CODE Load(const CGeoLatLngs& gLatLngs) final; // Locations are sent as encoded polylines, in chunks
 
 		E_GEO_STATUS_CODE getStatus() const final { return m_eStatus; }
 		const CGeoLatLngs& getResults() const final { return m_ElvResults; }
 
 	private:
+		E_GEO_STATUS_CODE LoadChunk(const GeoCoordinates& gCoordinates, CGeoLatLngs::iterator itResult);
+
 		CGeoLatLngs m_ElvResults;
 		E_GEO_STATUS_CODE m_eStatus;
 	};
@@ -28,6 +28,7 @@
 #include <sstream>
 #include "GoogleApiGeocoder.h"
 #include "GoogleTools.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -75,7 +76,7 @@ E_GEO_STATUS_CODE CGoogleApiGeocoder::Load(const std::string& strAddress)
 
 		ossUrl << geocoderKey << providerApi.getKey();
 
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
 		{
 			// Read status
 			m_eStatus = CGoogleTools::GetStatusCode(jsParser("status"));
@@ -28,6 +28,7 @@
 #include <sstream>
 #include "GoogleApiRvsGeocoder.h"
 #include "GoogleTools.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
 #include "jsonParser/JsonParser.h"
@@ -71,7 +72,7 @@ E_GEO_STATUS_CODE CGoogleApiRvsGeocoder::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
 		{
 			// Read status
 			m_eStatus = CGoogleTools::GetStatusCode(jsParser("status"));
@@ -220,11 +220,8 @@ void CGoogleUrl::UrlToLocations(const std::string& strUrl, CGeoLocations& glocat
 			{
 				for (it = spltGeocode.begin(); it != spltGeocode.end(); ++it)
 				{
-					// Transfrom from base64 (MIME) to base64url (RFC 4648)
-					stdx::string_helper::replace(*it, '-', '+');
-					stdx::string_helper::replace(*it, '_', '/');
-
-					std::string strGeocode = CBase64::Decode(*it);
+					// base64url (RFC 4648)
+					std::string strGeocode = CBase64::Decode(*it, CBase64::Alphabet::Url);
 
 					if (strGeocode.size() >= 10)
 					{
@@ -28,6 +28,7 @@
 #include <sstream>
 #include "HereApiGeocoder.h"
 #include "HereApi.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -69,13 +70,13 @@ E_GEO_STATUS_CODE CHereApiGeocoder::Load(const std::string& strAddress)
 
 	try
 	{
-		std::ostringstream oss;
-		CInternetHttpSession httpSession;
-		httpSession.send(oss, ossUrl.str());
+		std::string strResponse;
+		CInternetHttpSession httpSession(CGeoClientRegistry::instance().get(getProvider()));
+		httpSession.send(strResponse, ossUrl.str());
 		httpSession.wait();
 
 		CJsonParser jsParser;
-		if (jsParser.parse(oss.str()) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(strResponse) == CJsonParser::JSON_SUCCESS)
 		{
 			const CJsonArray& jsArray = jsParser("Response")("View")[0]("Result");
 			for (size_t i = 0; i < jsArray.size(); ++i)
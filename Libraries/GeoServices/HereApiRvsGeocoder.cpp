@@ -28,6 +28,7 @@
 #include <sstream>
 #include "HereApiRvsGeocoder.h"
 #include "HereApi.h"
+#include "GeoClientRegistry.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
 #include "jsonParser/JsonParser.h"
@@ -69,13 +70,13 @@ E_GEO_STATUS_CODE CHereApiRvsGeocoder::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		std::ostringstream oss;
-		CInternetHttpSession httpSession;
-		httpSession.send(oss, ossUrl.str());
+		std::string strResponse;
+		CInternetHttpSession httpSession(CGeoClientRegistry::instance().get(getProvider()));
+		httpSession.send(strResponse, ossUrl.str());
 		httpSession.wait();
 
 		CJsonParser jsParser;
-		if (jsParser.parse(oss.str()) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(strResponse) == CJsonParser::JSON_SUCCESS)
 		{
 			const CJsonObject& jsLocation = jsParser("Response")("View")[0]("Result")[0]("Location");
 
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include "SrtmElevation.h"
+#include "GeoLruCache.h"
+#include "ToolsLibrary/fmstream.h"
+
+using namespace geo;
+
+namespace
+{
+	constexpr size_t DEFAULT_CACHE_SIZE = 16; // Tiles of 25 MB at most
+	constexpr int16_t SRTM_VOID = -32768;
+
+	class CSrtmTile
+	{
+	public:
+		explicit CSrtmTile(const std::wstring& strPath) :
+			m_ifmsFile(strPath.c_str()),
+			m_pData(nullptr),
+			m_nSamples(0)
+		{
+			if (!m_ifmsFile.is_open())
+				return;
+
+			// Square grid of big endian 16 bits samples
+			size_t ulSamples = static_cast<size_t>(std::sqrt(static_cast<double>(m_ifmsFile.size() / 2)) + 0.5);
+			if (ulSamples < 2 || ulSamples * ulSamples * 2 != static_cast<size_t>(m_ifmsFile.size()))
+				return;
+
+			m_pData = static_cast<const unsigned char*>(m_ifmsFile.data());
+			m_nSamples = static_cast<int>(ulSamples);
+		}
+
+		bool valid() const { return m_pData != nullptr; }
+
+		// dRow and dCol are in [0, 1] from the north west corner
+		bool elevation(double dRow, double dCol, double& dElevation) const
+		{
+			double dY = dRow * (m_nSamples - 1);
+			double dX = dCol * (m_nSamples - 1);
+
+			int nY = std::min(static_cast<int>(dY), m_nSamples - 2);
+			int nX = std::min(static_cast<int>(dX), m_nSamples - 2);
+			double dFy = dY - nY;
+			double dFx = dX - nX;
+
+			double dWeights[4] = { (1 - dFx) * (1 - dFy), dFx * (1 - dFy), (1 - dFx) * dFy, dFx * dFy };
+			int16_t nSamples[4] = { sample(nY, nX), sample(nY, nX + 1), sample(nY + 1, nX), sample(nY + 1, nX + 1) };
+
+			// Voids are ignored, the other samples are reweighted
+			double dSum = 0;
+			double dWeight = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				if (nSamples[i] != SRTM_VOID)
+				{
+					dSum += nSamples[i] * dWeights[i];
+					dWeight += dWeights[i];
+				}
+			}
+
+			if (dWeight <= 0)
+				return false;
+
+			dElevation = dSum / dWeight;
+			return true;
+		}
+
+	private:
+		int16_t sample(int nRow, int nCol) const
+		{
+			const unsigned char* p = m_pData + (static_cast<size_t>(nRow) * m_nSamples + nCol) * 2;
+			return static_cast<int16_t>((p[0] << 8) | p[1]);
+		}
+
+		ifmstream m_ifmsFile;
+		const unsigned char* m_pData;
+		int m_nSamples;
+	};
+
+	class CSrtmTiles
+	{
+	public:
+		static CSrtmTiles& instance()
+		{
+			static CSrtmTiles tiles;
+			return tiles;
+		}
+
+		void setDirectory(const std::wstring& strDirectory)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_strDirectory = strDirectory;
+				if (!m_strDirectory.empty() && m_strDirectory.back() != L'\\' && m_strDirectory.back() != L'/')
+					m_strDirectory += L'/';
+			}
+
+			m_Tiles.clear();
+		}
+
+		std::wstring directory() const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_strDirectory;
+		}
+
+		void setCacheSize(size_t ulTiles) { m_Tiles.setCapacity(ulTiles); }
+
+		// Missing tiles are cached too, as null pointers
+		std::shared_ptr<const CSrtmTile> get(int nLat, int nLng)
+		{
+			long lKey = (nLat + 90) * 360 + (nLng + 180);
+
+			std::shared_ptr<const CSrtmTile> pTile;
+			if (m_Tiles.find(lKey, pTile))
+				return pTile;
+
+			std::wstring strDirectory = directory();
+			if (strDirectory.empty())
+				return pTile;
+
+			std::wostringstream wossPath;
+			wossPath << strDirectory << std::setfill(L'0')
+				<< (nLat < 0 ? L'S' : L'N') << std::setw(2) << std::abs(nLat)
+				<< (nLng < 0 ? L'W' : L'E') << std::setw(3) << std::abs(nLng) << L".hgt";
+
+			std::shared_ptr<CSrtmTile> pNewTile = std::make_shared<CSrtmTile>(wossPath.str());
+			if (pNewTile->valid())
+				pTile = pNewTile;
+
+			m_Tiles.insert(lKey, pTile);
+			return pTile;
+		}
+
+	private:
+		CSrtmTiles() : m_Tiles(DEFAULT_CACHE_SIZE) {}
+
+		mutable std::mutex m_Mutex;
+		std::wstring m_strDirectory;
+		TGeoLruCache<long, std::shared_ptr<const CSrtmTile>> m_Tiles;
+	};
+
+	bool GetElevation(const std::shared_ptr<const CSrtmTile>& pTile, int nLat, int nLng, const CGeoLatLng& gLatLng, double& dElevation)
+	{
+		if (!pTile)
+			return false;
+
+		// Rows start at the north edge of the tile
+		return pTile->elevation(1 - (gLatLng.lat() - nLat), gLatLng.lng() - nLng, dElevation);
+	}
+}
+
+CSrtmElevation::CSrtmElevation() :
+	m_eStatus(E_GEO_INVALID_REQUEST)
+{
+}
+
+CSrtmElevation::CSrtmElevation(const CGeoLatLng& gLatLng)
+{
+	Load(gLatLng);
+}
+
+void CSrtmElevation::setDirectory(const std::wstring& strDirectory)
+{
+	CSrtmTiles::instance().setDirectory(strDirectory);
+}
+
+void CSrtmElevation::setCacheSize(size_t ulTiles)
+{
+	CSrtmTiles::instance().setCacheSize(ulTiles);
+}
+
+bool CSrtmElevation::available()
+{
+	return !CSrtmTiles::instance().directory().empty();
+}
+
+E_GEO_STATUS_CODE CSrtmElevation::Load(const CGeoLatLng& gLatLng)
+{
+	CGeoLatLngs gLatLngs;
+	gLatLngs.push_back(gLatLng);
+	return Load(gLatLngs);
+}
+
+E_GEO_STATUS_CODE CSrtmElevation::Load(const CGeoLatLngs& gLatLngs)
+{
+	m_ElvResults = gLatLngs;
+	m_vecFound.assign(gLatLngs.size(), false);
+	m_eStatus = E_GEO_ZERO_RESULTS;
+
+	CSrtmTiles& tiles = CSrtmTiles::instance();
+
+	// Consecutive points of a track are usually in the same tile, avoid the cache lookup
+	std::shared_ptr<const CSrtmTile> pTile;
+	int nTileLat = 1000;
+	int nTileLng = 1000;
+
+	size_t i = 0;
+	for (CGeoLatLngs::iterator it = m_ElvResults.begin(); it != m_ElvResults.end(); ++it, ++i)
+	{
+		CGeoLatLng& gLatLng = *it;
+		if (std::fabs(gLatLng.lat()) > 90 || std::fabs(gLatLng.lng()) > 180)
+			continue;
+
+		int nLat = static_cast<int>(std::floor(gLatLng.lat()));
+		int nLng = static_cast<int>(std::floor(gLatLng.lng()));
+		if (nLat == 90)
+			nLat = 89;
+		if (nLng == 180)
+			nLng = 179;
+
+		if (nLat != nTileLat || nLng != nTileLng)
+		{
+			pTile = tiles.get(nLat, nLng);
+			nTileLat = nLat;
+			nTileLng = nLng;
+		}
+
+		double dElevation;
+		if (GetElevation(pTile, nLat, nLng, gLatLng, dElevation))
+		{
+			gLatLng.alt(dElevation);
+			m_vecFound[i] = true;
+			m_eStatus = E_GEO_OK;
+		}
+	}
+
+	return m_eStatus;
+}
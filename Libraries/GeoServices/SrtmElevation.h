@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _SRTM_ELEVATION_H_INCLUDED_
+#define _SRTM_ELEVATION_H_INCLUDED_
+
+#include <string>
+#include "GeoElevation.h"
+#include "GeoLatLngs.h"
+
+namespace geo
+{
+	// Offline elevation from SRTM tiles (N45E006.hgt, 1 or 3 arc-second), stored in a local directory.
+	// Tiles are memory-mapped on demand and kept in a process wide LRU, values are bilinearly interpolated.
+	class CSrtmElevation : public IGeoElevation
+	{
+	public:
+		CSrtmElevation();
+		CSrtmElevation(const CGeoLatLng& gLatLng);
+		~CSrtmElevation() final = default;
+
+		static void setDirectory(const std::wstring& strDirectory); // Clear the tile cache
+		static void setCacheSize(size_t ulTiles);
+		static bool available();
+
+		E_GEO_STATUS_CODE Load(const CGeoLatLng& gLatLng) final;
+		E_GEO_STATUS_CODE Load(const CGeoLatLngs& gLatLngs) final;
+
+		E_GEO_STATUS_CODE getStatus() const final { return m_eStatus; }
+		const CGeoLatLngs& getResults() const final { return m_ElvResults; }
+
+		// Flags of the last Load, false for the locations without tile
+		const std::vector<bool>& getFound() const { return m_vecFound; }
+
+	private:
+		CGeoLatLngs m_ElvResults;
+		std::vector<bool> m_vecFound;
+		E_GEO_STATUS_CODE m_eStatus;
+	};
+}
+
+#endif /*_SRTM_ELEVATION_H_INCLUDED_*/
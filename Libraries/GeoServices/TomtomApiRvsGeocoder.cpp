@@ -29,6 +29,7 @@
 #include "TomtomApiRvsGeocoder.h"
 #include "TomtomTools.h"
 #include "GeoLocation.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -67,7 +68,7 @@ E_GEO_STATUS_CODE CTomtomApiRvsGeocoder::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str(), providerApi.getReferer())) == CJsonParser::JSON_SUCCESS)
 		{
 			// Read results
 			const CJsonArray& results = jsParser("addresses");
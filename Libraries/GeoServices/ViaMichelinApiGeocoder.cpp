@@ -28,6 +28,7 @@
 #include <sstream>
 #include "ViaMichelinApiGeocoder.h"
 #include "ViaMichelinTools.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -68,7 +69,7 @@ E_GEO_STATUS_CODE CViaMichelinApiGeocoder::Load(const std::string& strAddress)
 
 	try
 	{
-		std::string strResponse = CInternet::AjaxHttpRequest(ossUrl.str());
+		std::string strResponse = CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str());
 		size_t pos = strResponse.find(geocoderCallback);
 		if (pos == std::string::npos)
 			return E_GEO_INVALID_REQUEST;
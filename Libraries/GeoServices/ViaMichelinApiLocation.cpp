@@ -28,6 +28,7 @@
 #include <sstream>
 #include "ViaMichelinApiLocation.h"
 #include "ViaMichelinTools.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -68,7 +69,7 @@ E_GEO_STATUS_CODE CViaMichelinApiLocation::Load(const std::string& strId)
 
 	try
 	{
-		std::string strResponse = CInternet::AjaxHttpRequest(ossUrl.str());
+		std::string strResponse = CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str());
 		size_t pos = strResponse.find(geocoderCallback);
 		if (pos == std::string::npos)
 			return E_GEO_INVALID_REQUEST;
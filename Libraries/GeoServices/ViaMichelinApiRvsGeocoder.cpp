@@ -28,6 +28,7 @@
 #include <sstream>
 #include "ViaMichelinApiRvsGeocoder.h"
 #include "ViaMichelinTools.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -67,7 +68,7 @@ E_GEO_STATUS_CODE CViaMichelinApiRvsGeocoder::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		std::string strResponse = CInternet::AjaxHttpRequest(ossUrl.str());
+		std::string strResponse = CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str());
 		size_t pos = strResponse.find(geocoderCallback);
 		if (pos == std::string::npos)
 			return E_GEO_INVALID_REQUEST;
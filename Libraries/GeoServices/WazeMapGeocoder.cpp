@@ -27,6 +27,7 @@
 
 #include <sstream>
 #include "WazeMapGeocoder.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -64,7 +65,7 @@ E_GEO_STATUS_CODE CWazeMapGeocoder::Load(const std::string& strAddress)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str())) == CJsonParser::JSON_SUCCESS)
 		{
 			const CJsonArray& jsResults = jsParser;
 
@@ -27,6 +27,7 @@
 
 #include <sstream>
 #include "WazeMapRvsGeocoder.h"
+#include "GeoClientRegistry.h"
 #include "jsonParser/JsonParser.h"
 #include "ToolsLibrary/Internet.h"
 #include "ToolsLibrary/HttpClient.h"
@@ -60,7 +61,7 @@ E_GEO_STATUS_CODE CWazeMapRvsGeocoder::Load(const CGeoLatLng& gLatLng)
 
 	try
 	{
-		if (jsParser.parse(CInternet::AjaxHttpRequest(ossUrl.str())) == CJsonParser::JSON_SUCCESS)
+		if (jsParser.parse(CInternet::AjaxHttpRequest(CGeoClientRegistry::instance().get(getProvider()), ossUrl.str())) == CJsonParser::JSON_SUCCESS)
 		{
 			const CJsonArray& jsResults = jsParser;
 			if (!jsResults.empty())
@@ -29,9 +29,9 @@
 
 namespace
 {
-	void escape_content(std::ostream& os, const std::string& tag_content)
+	void escape_content(std::ostream& os, std::string_view tag_content)
 	{
-		for (std::string::const_iterator cit = tag_content.begin(); cit != tag_content.end(); ++cit)
+		for (std::string_view::const_iterator cit = tag_content.begin(); cit != tag_content.end(); ++cit)
 		{
 			switch (*cit)
 			{
@@ -103,7 +103,7 @@ SAXWriter::Tag& SAXWriter::Tag::operator=(Tag&& tag)
 	return *this;
 }
 
-SAXWriter::Tag& SAXWriter::Tag::attribute(const std::string& att_name, const std::string& att_value)
+SAXWriter::Tag& SAXWriter::Tag::attribute(const std::string& att_name, std::string_view att_value)
 {
 	if (!m_bEmpty)
 		throw std::invalid_argument("Not empty");
@@ -124,7 +124,7 @@ SAXWriter::Tag& SAXWriter::Tag::attributes(const std::map<std::string, std::stri
 	return *this;
 }
 
-SAXWriter::Tag& SAXWriter::Tag::content(const std::string& tag_content)
+SAXWriter::Tag& SAXWriter::Tag::content(std::string_view tag_content)
 {
 	if (m_bEmpty)
 	{
@@ -136,7 +136,7 @@ SAXWriter::Tag& SAXWriter::Tag::content(const std::string& tag_content)
 	return *this;
 }
 
-SAXWriter::Tag& SAXWriter::Tag::cdata(const std::string& cdata_content)
+SAXWriter::Tag& SAXWriter::Tag::cdata(std::string_view cdata_content)
 {
 	if (!m_bEmpty)
 		throw std::invalid_argument("Not empty");
@@ -30,6 +30,7 @@
 
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <map>
 
 class SAXWriter
@@ -43,10 +44,10 @@ public:
 
 		Tag& operator=(Tag&& tag);
 
-		Tag& attribute(const std::string& att_name, const std::string& att_value);
+		Tag& attribute(const std::string& att_name, std::string_view att_value);
 		Tag& attributes(const std::map<std::string, std::string>& tag_attributes);
-		Tag& content(const std::string& tag_content);
-		Tag& cdata(const std::string& cdata_content); // <![CDATA[ and ]]>
+		Tag& content(std::string_view tag_content);
+		Tag& cdata(std::string_view cdata_content); // <![CDATA[ and ]]>
 		Tag tag(const std::string& name);
 
 		Tag(const Tag& tag) = delete;
@@ -26,93 +26,258 @@
  */
 
 #include "Base64.h"
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BASE64_SSSE3
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BASE64_TARGET_SSSE3
+#else
+#define BASE64_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
 
 namespace
 {
 	constexpr char fillchar = '=';
-}
 
-std::string CBase64::Encode(const std::string& data)
-{
-	std::string ret;
-	Encode(data, ret);
-	return ret;
-}
+	const char* GetTable(CBase64::Alphabet alphabet)
+	{
+		static constexpr char standard[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		static constexpr char url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
-void CBase64::Encode(const std::string& data, std::string& result)
-{
-	const std::string cvt("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
-	std::string::size_type len = data.length();
+		return alphabet == CBase64::Alphabet::Url ? url : standard;
+	}
 
-	for (std::string::size_type i = 0; i < len; ++i)
+	// Reverse tables, 0xFF for characters out of the alphabet
+	struct DecodeTable
 	{
-		char c = (data[i] >> 2) & 0x3f;
-		result.append(1, cvt[c]);
-		c = (data[i] << 4) & 0x3f;
-		if (++i < len)
-			c |= (data[i] >> 4) & 0x0f;
-		result.append(1, cvt[c]);
-		if (i < len)
+		uint8_t values[256];
+
+		explicit DecodeTable(const char* table)
 		{
-			c = (data[i] << 2) & 0x3f;
-			if (++i < len)
-				c |= (data[i] >> 6) & 0x03;
-			result.append(1, cvt[c]);
+			for (uint8_t& v : values)
+				v = 0xFF;
+
+			for (uint8_t i = 0; i < 64; ++i)
+				values[static_cast<uint8_t>(table[i])] = i;
 		}
-		else
+	};
+
+	const DecodeTable& GetDecodeTable(CBase64::Alphabet alphabet)
+	{
+		static const DecodeTable standard(GetTable(CBase64::Alphabet::Standard));
+		static const DecodeTable url(GetTable(CBase64::Alphabet::Url));
+
+		return alphabet == CBase64::Alphabet::Url ? url : standard;
+	}
+
+#ifdef BASE64_SSSE3
+	bool HasSSSE3()
+	{
+#ifdef _MSC_VER
+		static const bool bSSSE3 = []()
 		{
-			++i;
-			result.append(1, fillchar);
-		}
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 9)) != 0;
+		}();
+		return bSSSE3;
+#else
+		static const bool bSSSE3 = __builtin_cpu_supports("ssse3") != 0;
+		return bSSSE3;
+#endif
+	}
 
-		if (i < len)
+	// 12 bytes in, 16 characters out, the input must be readable for 16 bytes
+	BASE64_TARGET_SSSE3 size_t EncodeSSSE3(const uint8_t* src, size_t size, char* dst, CBase64::Alphabet alphabet)
+	{
+		const char c62 = alphabet == CBase64::Alphabet::Url ? '-' : '+';
+		const char c63 = alphabet == CBase64::Alphabet::Url ? '_' : '/';
+
+		// Offset to add to each 6 bits index, selected by range
+		const __m128i shiftLUT = _mm_setr_epi8(
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+
+		size_t ulRead = 0;
+		for (; ulRead + 16 <= size; ulRead += 12, dst += 16)
 		{
-			c = data[i] & 0x3f;
-			result.append(1, cvt[c]);
+			__m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + ulRead));
+
+			// Spread each 3 bytes group over 4 bytes, then extract the 6 bits indices
+			in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			__m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+			__m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+			__m128i indices = _mm_or_si128(t0, t1);
+
+			// 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+			__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+			range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_add_epi8(indices, _mm_shuffle_epi8(shiftLUT, range)));
 		}
-		else
+
+		return ulRead;
+	}
+
+	// 16 characters in, 12 bytes out, 16 bytes are written to the output
+	BASE64_TARGET_SSSE3 size_t DecodeSSSE3(const char* src, size_t size, uint8_t* dst, CBase64::Alphabet alphabet)
+	{
+		const __m128i c62 = _mm_set1_epi8(alphabet == CBase64::Alphabet::Url ? '-' : '+');
+		const __m128i c63 = _mm_set1_epi8(alphabet == CBase64::Alphabet::Url ? '_' : '/');
+		const __m128i shift62 = _mm_sub_epi8(_mm_set1_epi8(62), c62);
+		const __m128i shift63 = _mm_sub_epi8(_mm_set1_epi8(63), c63);
+
+		size_t ulRead = 0;
+		for (; ulRead + 16 <= size; ulRead += 16, dst += 12)
 		{
-			result.append(1, fillchar);
+			__m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + ulRead));
+
+			// Signed compares, bytes above 0x7F fall out of every range
+			__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+			__m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+			__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+			__m128i is62 = _mm_cmpeq_epi8(in, c62);
+			__m128i is63 = _mm_cmpeq_epi8(in, c63);
+
+			__m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+			if (_mm_movemask_epi8(valid) != 0xFFFF) // Padding or invalid character, left to the scalar loop
+				break;
+
+			__m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+			shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+			shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+			shift = _mm_or_si128(shift, _mm_and_si128(is62, shift62));
+			shift = _mm_or_si128(shift, _mm_and_si128(is63, shift63));
+			__m128i values = _mm_add_epi8(in, shift);
+
+			// Merge 4 x 6 bits into 3 bytes
+			__m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+			merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+			merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), merged);
 		}
+
+		return ulRead;
+	}
+#endif
+}
+
+std::string CBase64::Encode(const std::string& data, Alphabet alphabet)
+{
+	std::string ret;
+	Encode(data, ret, alphabet);
+	return ret;
+}
+
+void CBase64::Encode(const std::string& data, std::string& result, Alphabet alphabet)
+{
+	size_t ulOffset = result.size();
+	result.resize(ulOffset + EncodedSize(data.size()));
+	Encode(data.data(), data.size(), &result[ulOffset], alphabet);
+}
+
+size_t CBase64::Encode(const char* src, size_t size, char* dst, Alphabet alphabet)
+{
+	const uint8_t* pSrc = reinterpret_cast<const uint8_t*>(src);
+	const char* cvt = GetTable(alphabet);
+	char* pDst = dst;
+	size_t i = 0;
+
+#ifdef BASE64_SSSE3
+	if (HasSSSE3())
+	{
+		i = EncodeSSSE3(pSrc, size, pDst, alphabet);
+		pDst += (i / 3) * 4;
+	}
+#endif
+
+	for (; i + 3 <= size; i += 3)
+	{
+		uint32_t triple = (pSrc[i] << 16) | (pSrc[i + 1] << 8) | pSrc[i + 2];
+		*pDst++ = cvt[(triple >> 18) & 0x3F];
+		*pDst++ = cvt[(triple >> 12) & 0x3F];
+		*pDst++ = cvt[(triple >> 6) & 0x3F];
+		*pDst++ = cvt[triple & 0x3F];
+	}
+
+	if (i < size)
+	{
+		uint32_t triple = pSrc[i] << 16;
+		if (i + 1 < size)
+			triple |= pSrc[i + 1] << 8;
+
+		*pDst++ = cvt[(triple >> 18) & 0x3F];
+		*pDst++ = cvt[(triple >> 12) & 0x3F];
+		*pDst++ = i + 1 < size ? cvt[(triple >> 6) & 0x3F] : fillchar;
+		*pDst++ = fillchar;
 	}
+
+	return pDst - dst;
 }
 
-std::string CBase64::Decode(const std::string& data)
+std::string CBase64::Decode(const std::string& data, Alphabet alphabet)
 {
 	std::string ret;
-	Decode(data, ret);
+	Decode(data, ret, alphabet);
 	return ret;
 }
 
-void CBase64::Decode(const std::string& data, std::string& result)
+void CBase64::Decode(const std::string& data, std::string& result, Alphabet alphabet)
+{
+	size_t ulOffset = result.size();
+	result.resize(ulOffset + MaxDecodedSize(data.size()));
+	result.resize(ulOffset + Decode(data.data(), data.size(), &result[ulOffset], alphabet));
+}
+
+size_t CBase64::Decode(const char* src, size_t size, char* dst, Alphabet alphabet)
 {
-	const std::string cvt("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
-	std::string::size_type len = data.length();
+	const DecodeTable& table = GetDecodeTable(alphabet);
+	uint8_t* pDst = reinterpret_cast<uint8_t*>(dst);
+	size_t i = 0;
 
-	for (std::string::size_type i = 0; i < len; ++i)
+#ifdef BASE64_SSSE3
+	// Each block writes 16 bytes for 12 decoded, keep 8 characters behind so they stay in dst
+	if (size >= 24 && HasSSSE3())
 	{
-		char c = static_cast<char>(cvt.find(data[i]));
-		++i;
-		char c1 = static_cast<char>(cvt.find(data[i]));
-		c = (c << 2) | ((c1 >> 4) & 0x3);
-		result.append(1, c);
-		if (++i < len)
-		{
-			c = data[i];
-			if (fillchar == c)
-				break;
-			c = static_cast<char>(cvt.find(c));
-			c1 = ((c1 << 4) & 0xf0) | ((c >> 2) & 0xf);
-			result.append(1, c1);
-		}
-		if (++i < len)
+		i = DecodeSSSE3(src, size - 8, pDst, alphabet);
+		pDst += (i / 4) * 3;
+	}
+#endif
+
+	uint32_t quad = 0;
+	size_t ulChars = 0;
+	for (; i < size; ++i)
+	{
+		uint8_t v = table.values[static_cast<uint8_t>(src[i])];
+		if (v == 0xFF) // Padding or invalid character
+			break;
+
+		quad = (quad << 6) | v;
+		if (++ulChars == 4)
 		{
-			c1 = data[i];
-			if (fillchar == c1)
-				break;
-			c1 = static_cast<char>(cvt.find(c1));
-			c = ((c << 6) & 0xc0) | c1;
-			result.append(1, c);
+			*pDst++ = static_cast<uint8_t>(quad >> 16);
+			*pDst++ = static_cast<uint8_t>(quad >> 8);
+			*pDst++ = static_cast<uint8_t>(quad);
+			quad = 0;
+			ulChars = 0;
 		}
 	}
+
+	// Unpadded or padded tail
+	if (ulChars == 2)
+	{
+		*pDst++ = static_cast<uint8_t>(quad >> 4);
+	}
+	else if (ulChars == 3)
+	{
+		*pDst++ = static_cast<uint8_t>(quad >> 10);
+		*pDst++ = static_cast<uint8_t>(quad >> 2);
+	}
+
+	return reinterpret_cast<char*>(pDst) - dst;
 }
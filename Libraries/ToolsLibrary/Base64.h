@@ -33,10 +33,25 @@
 class CBase64
 {
 public:
-	static std::string Encode(const std::string& data);
-	static void Encode(const std::string& data, std::string& result);
+	enum class Alphabet
+	{
+		Standard, // RFC 4648 base64, '+' and '/'
+		Url // RFC 4648 base64url, '-' and '_'
+	};
 
-	static std::string Decode(const std::string& data);
-	static void Decode(const std::string& data, std::string& result);
+	static constexpr size_t EncodedSize(size_t size) { return ((size + 2) / 3) * 4; }
+	static constexpr size_t MaxDecodedSize(size_t size) { return (size / 4) * 3 + (size % 4); }
+
+	// Encode and Decode append to result, padding is optional when decoding
+	static std::string Encode(const std::string& data, Alphabet alphabet = Alphabet::Standard);
+	static void Encode(const std::string& data, std::string& result, Alphabet alphabet = Alphabet::Standard);
+
+	static std::string Decode(const std::string& data, Alphabet alphabet = Alphabet::Standard);
+	static void Decode(const std::string& data, std::string& result, Alphabet alphabet = Alphabet::Standard);
+
+	// Buffer versions, dst must hold EncodedSize() or MaxDecodedSize() bytes.
+	// Decoding stops at the first padding or invalid character, they return the number of bytes written.
+	static size_t Encode(const char* src, size_t size, char* dst, Alphabet alphabet = Alphabet::Standard);
+	static size_t Decode(const char* src, size_t size, char* dst, Alphabet alphabet = Alphabet::Standard);
 };
 #endif // BASE64_H_INCLUDED
@@ -118,6 +118,24 @@ CHttpSession CInternetConnection::getHttpSession() const
 	return CHttpSession(*this);
 }
 
+void CInternetConnection::setMaxConnectionsPerServer(unsigned long ulMaxConnections)
+{
+	DWORD dwMaxConnections = ulMaxConnections;
+	if (InternetSetOption(nullptr, INTERNET_OPTION_MAX_CONNS_PER_SERVER, &dwMaxConnections, sizeof(dwMaxConnections)) == FALSE ||
+		InternetSetOption(nullptr, INTERNET_OPTION_MAX_CONNS_PER_1_0_SERVER, &dwMaxConnections, sizeof(dwMaxConnections)) == FALSE)
+		throw CInternetException(GetLastError());
+}
+
+unsigned long CInternetConnection::getMaxConnectionsPerServer()
+{
+	DWORD dwMaxConnections = 0;
+	DWORD dwLength = sizeof(dwMaxConnections);
+	if (InternetQueryOption(nullptr, INTERNET_OPTION_MAX_CONNS_PER_SERVER, &dwMaxConnections, &dwLength) == FALSE)
+		throw CInternetException(GetLastError());
+
+	return dwMaxConnections;
+}
+
 unsigned long CInternetConnection::getLastResponse() const
 {
 	DWORD dwError = 0;
@@ -202,12 +220,14 @@ CHttpRequest CHttpSession::getRequest() const
 /************************************************************************/
 
 CHttpRequest::CHttpRequest(const CHttpSession& Session) :
-	m_Session(Session),
+	m_pSession(&Session),
 	m_httpException(0),
 	m_lastNumberOfBytesRead(0),
 	m_totalNumberOfBytesRead(0),
 	m_tmpBuffer(SizeOfTempBuffer),
-	m_pStream(nullptr),
+	m_pResponse(nullptr),
+	m_ulResponseSize(0),
+	m_ulStatusCode(0),
 	m_hRequest(nullptr),
 	m_hCloseEvent(nullptr),
 	m_hEndEvent(nullptr),
@@ -250,6 +270,15 @@ void CHttpRequest::setBufferSize(size_t length)
 	m_tmpBuffer.resize(length);
 }
 
+void CHttpRequest::setSession(const CHttpSession& Session)
+{
+	CScopedCriticalSection scs(m_hCriticalSection);
+	if (m_hRequest)
+		throw CInternetException(ERROR_INVALID_HANDLE, "Already opened");
+
+	m_pSession = &Session;
+}
+
 void CHttpRequest::setEndCallback(const CallbackFunction& EndCallback)
 {
 	m_EndCallback = EndCallback;
@@ -264,13 +293,13 @@ void CHttpRequest::open(const std::string& strRequest, bool bSecure, const std::
 	LPCSTR lplpszAcceptTypes[2] = { "*/*", nullptr };
 
 	m_hRequest = HttpOpenRequest(
-		m_Session.m_hConnect,
+		m_pSession->m_hConnect,
 		strMethod.empty() ? nullptr : strMethod.c_str(),
 		strRequest.empty() ? nullptr : strRequest.c_str(),
 		nullptr,
 		strReferrer.empty() ? nullptr : strReferrer.c_str(),
 		lplpszAcceptTypes,
-		(bSecure ? INTERNET_FLAG_SECURE : INTERNET_FLAG_KEEP_CONNECTION) | INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_RELOAD,
+		(bSecure ? INTERNET_FLAG_SECURE : 0) | INTERNET_FLAG_KEEP_CONNECTION | INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_RELOAD,
 		reinterpret_cast<DWORD_PTR>(this));	// Pointer to a variable that contains an application-defined value for callback.
 	if (!m_hRequest)
 		throw CInternetException(GetLastError());
@@ -334,11 +363,34 @@ void CHttpRequest::setTimeout(timeout_t tTimeout, size_t msTimeOut)
 }
 
 void CHttpRequest::send(std::ostream& oss, const std::string& strPostData)
+{
+	send([&oss](const char* pData, size_t length) { oss.write(pData, length); }, strPostData);
+}
+
+void CHttpRequest::send(std::string& strResponse, const std::string& strPostData)
+{
+	CScopedCriticalSection scs(m_hCriticalSection);
+	m_Sink = nullptr;
+	m_pResponse = &strResponse;
+	m_ulResponseSize = strResponse.size();
+	sendRequest(strPostData);
+}
+
+void CHttpRequest::send(const SinkFunction& sink, const std::string& strPostData)
 {
 	CScopedCriticalSection scs(m_hCriticalSection);
+	m_Sink = sink;
+	m_pResponse = nullptr;
+	sendRequest(strPostData);
+}
+
+void CHttpRequest::sendRequest(const std::string& strPostData)
+{
+	m_lastNumberOfBytesRead = 0;
 	m_totalNumberOfBytesRead = 0;
 	m_strPostData = strPostData;
-	m_pStream = &oss;
+	m_ulStatusCode = 0;
+	m_strResponseHeaders.clear();
 
 	if (ResetEvent(m_hCloseEvent) == FALSE)
 		throw CInternetException(GetLastError());
@@ -387,6 +439,16 @@ size_t CHttpRequest::getNumberOfBytesRead() const
 	return m_totalNumberOfBytesRead;
 }
 
+unsigned long CHttpRequest::getStatusCode() const
+{
+	return m_ulStatusCode;
+}
+
+const std::string& CHttpRequest::getResponseHeaders() const
+{
+	return m_strResponseHeaders;
+}
+
 void CHttpRequest::signal(HINTERNET hRequest)
 {
 	{
@@ -394,6 +456,10 @@ void CHttpRequest::signal(HINTERNET hRequest)
 		InternetSetStatusCallback(hRequest, INTERNET_NO_CALLBACK);
 		m_bEndRequest = true;
 
+		if (m_pResponse) // Drop the unused part of the last chunk
+			m_pResponse->resize(m_ulResponseSize);
+		m_pResponse = nullptr;
+
 		if (SetEvent(m_hCloseEvent) == FALSE)
 			throw CInternetException(GetLastError());
 	}
@@ -415,19 +481,52 @@ void CHttpRequest::closeRequest(HINTERNET hRequest, const CInternetException& ht
 		m_hRequest = nullptr;
 }
 
+void CHttpRequest::readResponseHeaders(HINTERNET hRequest)
+{
+	DWORD dwStatusCode = 0;
+	DWORD dwLength = sizeof(dwStatusCode);
+	if (HttpQueryInfo(hRequest, HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER, &dwStatusCode, &dwLength, nullptr) == FALSE)
+		throw CInternetException(GetLastError());
+
+	m_ulStatusCode = dwStatusCode;
+
+	dwLength = 0;
+	if (HttpQueryInfo(hRequest, HTTP_QUERY_RAW_HEADERS_CRLF, nullptr, &dwLength, nullptr) == FALSE && GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+	{
+		std::vector<char> buffer(dwLength + 1);
+		if (HttpQueryInfo(hRequest, HTTP_QUERY_RAW_HEADERS_CRLF, buffer.data(), &dwLength, nullptr) == FALSE)
+			throw CInternetException(GetLastError());
+
+		m_strResponseHeaders.assign(buffer.data(), dwLength);
+	}
+}
+
 void CHttpRequest::processRequest(HINTERNET hRequest)
 {
+	if (!m_ulStatusCode) // First completion, the headers are there
+		readResponseHeaders(hRequest);
+
 	bool bRet = false;
 	do
 	{
 		if (m_lastNumberOfBytesRead > 0)
 		{	// Read previous buffer
-			m_pStream->write(m_tmpBuffer.data(), m_lastNumberOfBytesRead);
+			if (m_pResponse)
+				m_ulResponseSize += m_lastNumberOfBytesRead; // Already in place
+			else
+				m_Sink(m_tmpBuffer.data(), m_lastNumberOfBytesRead);
 			m_totalNumberOfBytesRead += m_lastNumberOfBytesRead;
 			m_lastNumberOfBytesRead = 0;
 		}
 
-		bRet = (InternetReadFile(hRequest, m_tmpBuffer.data(), static_cast<DWORD>(m_tmpBuffer.size()), &m_lastNumberOfBytesRead) == TRUE);
+		char* pBuffer = m_tmpBuffer.data();
+		if (m_pResponse)
+		{	// Grow the response and let WinInet write at its end
+			m_pResponse->resize(m_ulResponseSize + m_tmpBuffer.size());
+			pBuffer = &(*m_pResponse)[m_ulResponseSize];
+		}
+
+		bRet = (InternetReadFile(hRequest, pBuffer, static_cast<DWORD>(m_tmpBuffer.size()), &m_lastNumberOfBytesRead) == TRUE);
 		if (!bRet && GetLastError() != ERROR_IO_PENDING)
 			throw CInternetException(GetLastError());
 
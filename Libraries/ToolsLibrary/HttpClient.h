@@ -102,6 +102,9 @@ public:
 
 	CHttpSession getHttpSession() const;
 
+	static void setMaxConnectionsPerServer(unsigned long ulMaxConnections); // Process wide, WinInet keeps 2 (HTTP/1.1) by default
+	static unsigned long getMaxConnectionsPerServer();
+
 private:
 	friend class CHttpSession;
 
@@ -144,6 +147,7 @@ class CHttpRequest
 {
 public:
 	typedef std::function<void(CHttpRequest&, const CInternetException&)> CallbackFunction;
+	typedef std::function<void(const char*, size_t)> SinkFunction; // Called with each chunk of the response body
 	typedef enum
 	{
 		ConnectTimeout,
@@ -163,9 +167,13 @@ public:
 	void addHeaders(const std::map<std::string, std::string>& headers);
 	void setTimeout(timeout_t tTimeout, size_t msTimeOut);
 	void send(std::ostream& oss, const std::string& strPostData = std::string());
+	void send(std::string& strResponse, const std::string& strPostData = std::string()); // Read directly at the end of strResponse
+	void send(const SinkFunction& sink, const std::string& strPostData = std::string());
 	void cancel();
 	bool wait(size_t msTimeOut = static_cast<size_t>(-1));
 	size_t getNumberOfBytesRead() const;
+	unsigned long getStatusCode() const; // Available once the response headers are received
+	const std::string& getResponseHeaders() const; // Raw headers, CRLF separated
 
 	static const std::string MethodPost;
 	static const std::string MethodGet;
@@ -181,6 +189,9 @@ private:
 	void signal(void* hRequest);
 	void closeRequest(void* hRequest, const CInternetException& httpException);
 	void processRequest(void* hRequest);
+	void readResponseHeaders(void* hRequest);
+	void sendRequest(const std::string& strPostData);
+	void setSession(const CHttpSession& Session); // Between two requests, to reuse the request on a shared session
 
 	static VOID CALLBACK InternetStatusCallback(
 		void* hInternet,
@@ -190,14 +201,18 @@ private:
 		DWORD dwStatusInformationLength);
 
 private:
-	const CHttpSession& m_Session;
+	const CHttpSession* m_pSession;
 	CallbackFunction m_EndCallback;
 	CInternetException m_httpException;
 	unsigned long m_lastNumberOfBytesRead;
 	size_t m_totalNumberOfBytesRead;
 	std::vector<char> m_tmpBuffer;
 	std::string m_strPostData;
-	std::ostream* m_pStream;
+	SinkFunction m_Sink;
+	std::string* m_pResponse;
+	size_t m_ulResponseSize;
+	unsigned long m_ulStatusCode;
+	std::string m_strResponseHeaders;
 	mutable CRITICAL_SECTION m_hCriticalSection;
 	void* m_hRequest;
 	void* m_hCloseEvent;
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "windows.h"
+#include "wininet.h"
+#include "HttpSessionPool.h"
+#include "HttpClient.h"
+
+namespace
+{
+	std::shared_ptr<CInternetConnection> getSharedConnection()
+	{
+		static std::shared_ptr<CInternetConnection> pConnection(std::make_shared<CInternetConnection>());
+		return pConnection;
+	}
+
+	void raiseMaxConnectionsPerServer(size_t ulMaxConcurrent)
+	{
+		static std::mutex mutex;
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Process wide, never lowered below the WinInet setting
+		if (CInternetConnection::getMaxConnectionsPerServer() < ulMaxConcurrent)
+			CInternetConnection::setMaxConnectionsPerServer(static_cast<unsigned long>(ulMaxConcurrent));
+	}
+}
+
+const size_t CHttpSessionPool::DefaultMaxConcurrent = 6;
+const std::chrono::milliseconds CHttpSessionPool::DefaultIdleTimeout(30000);
+const std::chrono::milliseconds CHttpSessionPool::DefaultAcquireTimeout(60000);
+
+/************************************************************************/
+/* CHttpSessionPool::CLease                                             */
+/************************************************************************/
+
+CHttpSessionPool::CLease::CLease(CHttpSessionPool& pool, const std::string& strKey, const std::shared_ptr<CHttpSession>& pSession) :
+	m_pPool(&pool),
+	m_strKey(strKey),
+	m_pSession(pSession)
+{
+}
+
+CHttpSessionPool::CLease::CLease(CLease&& lease) :
+	m_pPool(lease.m_pPool.exchange(nullptr)),
+	m_strKey(std::move(lease.m_strKey)),
+	m_pSession(std::move(lease.m_pSession))
+{
+}
+
+CHttpSessionPool::CLease::~CLease()
+{
+	try
+	{
+		release();
+	}
+	catch (...) {}
+}
+
+void CHttpSessionPool::CLease::release(size_t ulBytes, bool bError)
+{
+	CHttpSessionPool* pPool = m_pPool.exchange(nullptr);
+	if (pPool)
+		pPool->release(m_strKey, ulBytes, bError);
+}
+
+/************************************************************************/
+/* CHttpSessionPool                                                     */
+/************************************************************************/
+
+CHttpSessionPool::CHttpSessionPool(size_t ulMaxConcurrent, std::chrono::milliseconds msIdleTimeout) :
+	m_pConnection(getSharedConnection()),
+	m_ulMaxConcurrent(ulMaxConcurrent ? ulMaxConcurrent : 1),
+	m_msIdleTimeout(msIdleTimeout),
+	m_Metrics()
+{
+	raiseMaxConnectionsPerServer(m_ulMaxConcurrent);
+}
+
+CHttpSessionPool::CLease CHttpSessionPool::acquire(const std::string& strHost, unsigned short usPort, std::chrono::milliseconds msTimeOut)
+{
+	std::string strKey = strHost + ':' + std::to_string(usPort);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	reap(std::chrono::steady_clock::now());
+
+	auto isFree = [&]() { return m_Hosts[strKey].ulActive < m_ulMaxConcurrent; };
+	if (!isFree())
+	{
+		m_Metrics.ullWaits++;
+		if (!m_Condition.wait_for(lock, msTimeOut, isFree))
+			throw CInternetException(ERROR_INTERNET_TIMEOUT, "Too many requests to " + strHost);
+	}
+
+	Host& host = m_Hosts[strKey];
+	if (!host.pSession)
+	{
+		std::unique_ptr<CHttpSession> pSession = std::make_unique<CHttpSession>(m_pConnection->getHttpSession());
+		pSession->open(strHost, usPort);
+
+		// The connection is kept alive by the sessions still used out of the pool
+		std::shared_ptr<CInternetConnection> pConnection = m_pConnection;
+		host.pSession = std::shared_ptr<CHttpSession>(pSession.release(), [pConnection](CHttpSession* p) { delete p; });
+		m_Metrics.ullSessionsOpened++;
+	}
+
+	++host.ulActive;
+	host.tpLastUsed = std::chrono::steady_clock::now();
+	m_Metrics.ullRequests++;
+
+	return CLease(*this, strKey, host.pSession);
+}
+
+void CHttpSessionPool::configure(size_t ulMaxConcurrent, std::chrono::milliseconds msIdleTimeout)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_ulMaxConcurrent = ulMaxConcurrent ? ulMaxConcurrent : 1;
+		m_msIdleTimeout = msIdleTimeout;
+		raiseMaxConnectionsPerServer(m_ulMaxConcurrent);
+	}
+
+	m_Condition.notify_all();
+}
+
+size_t CHttpSessionPool::reap()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return reap(std::chrono::steady_clock::now());
+}
+
+CHttpSessionPool::Metrics CHttpSessionPool::getMetrics() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	Metrics metrics = m_Metrics;
+	for (const auto& host : m_Hosts)
+	{
+		metrics.ulActive += host.second.ulActive;
+		if (host.second.pSession)
+			metrics.ulSessions++;
+	}
+
+	return metrics;
+}
+
+void CHttpSessionPool::release(const std::string& strKey, size_t ulBytes, bool bError)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Hosts.find(strKey);
+		if (it != m_Hosts.end() && it->second.ulActive)
+		{
+			--it->second.ulActive;
+			it->second.tpLastUsed = std::chrono::steady_clock::now();
+		}
+
+		m_Metrics.ullBytes += ulBytes;
+		if (bError)
+			m_Metrics.ullErrors++;
+	}
+
+	// The waiters can wait for another host
+	m_Condition.notify_all();
+}
+
+size_t CHttpSessionPool::reap(std::chrono::steady_clock::time_point tpNow)
+{
+	size_t ulReaped = 0;
+
+	for (auto it = m_Hosts.begin(); it != m_Hosts.end();)
+	{
+		if (!it->second.ulActive && tpNow - it->second.tpLastUsed >= m_msIdleTimeout)
+		{
+			if (it->second.pSession)
+				++ulReaped;
+			it = m_Hosts.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	m_Metrics.ullSessionsReaped += ulReaped;
+	return ulReaped;
+}
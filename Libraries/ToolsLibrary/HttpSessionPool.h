@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HTTP_SESSION_POOL_H_INCLUDED
+#define HTTP_SESSION_POOL_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class CInternetConnection;
+class CHttpSession;
+
+// Sessions shared by the requests of a client, one by host.
+// All the pools share the same process wide internet connection, the number
+// of concurrent requests by host is bounded and the idle sessions are closed.
+class CHttpSessionPool
+{
+public:
+	struct Metrics
+	{
+		unsigned long long ullRequests; // Granted leases
+		unsigned long long ullWaits; // Leases which waited for a free slot
+		unsigned long long ullSessionsOpened;
+		unsigned long long ullSessionsReaped;
+		unsigned long long ullErrors;
+		unsigned long long ullBytes;
+		size_t ulActive; // Requests in progress
+		size_t ulSessions; // Opened sessions
+	};
+
+	// A request slot on a shared session, given back on destruction
+	class CLease
+	{
+	public:
+		CLease(CLease&& lease);
+		~CLease();
+
+		const std::shared_ptr<CHttpSession>& session() const { return m_pSession; }
+		void release(size_t ulBytes = 0, bool bError = false); // Can be called once, from any thread
+
+	private:
+		friend class CHttpSessionPool;
+
+		CLease(CHttpSessionPool& pool, const std::string& strKey, const std::shared_ptr<CHttpSession>& pSession);
+		CLease(const CLease&) = delete;
+		CLease& operator=(const CLease&) = delete;
+		CLease& operator=(CLease&&) = delete;
+
+	private:
+		std::atomic<CHttpSessionPool*> m_pPool;
+		std::string m_strKey;
+		std::shared_ptr<CHttpSession> m_pSession;
+	};
+
+	static const size_t DefaultMaxConcurrent;
+	static const std::chrono::milliseconds DefaultIdleTimeout;
+	static const std::chrono::milliseconds DefaultAcquireTimeout;
+
+	CHttpSessionPool(size_t ulMaxConcurrent = DefaultMaxConcurrent, std::chrono::milliseconds msIdleTimeout = DefaultIdleTimeout);
+	~CHttpSessionPool() = default;
+
+	CLease acquire(const std::string& strHost, unsigned short usPort, std::chrono::milliseconds msTimeOut = DefaultAcquireTimeout);
+
+	void configure(size_t ulMaxConcurrent, std::chrono::milliseconds msIdleTimeout);
+	size_t reap(); // Close the sessions idle for longer than the idle timeout, returns the number of closed sessions
+	Metrics getMetrics() const;
+
+	CHttpSessionPool(const CHttpSessionPool&) = delete;
+	CHttpSessionPool& operator=(const CHttpSessionPool&) = delete;
+
+private:
+	struct Host
+	{
+		std::shared_ptr<CHttpSession> pSession;
+		size_t ulActive;
+		std::chrono::steady_clock::time_point tpLastUsed;
+	};
+
+	void release(const std::string& strKey, size_t ulBytes, bool bError);
+	size_t reap(std::chrono::steady_clock::time_point tpNow);
+
+private:
+	std::shared_ptr<CInternetConnection> m_pConnection;
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::map<std::string, Host> m_Hosts;
+	size_t m_ulMaxConcurrent;
+	std::chrono::milliseconds m_msIdleTimeout;
+	Metrics m_Metrics;
+};
+
+#endif // !HTTP_SESSION_POOL_H_INCLUDED
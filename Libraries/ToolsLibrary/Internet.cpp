@@ -26,9 +26,9 @@
  */
 
 #include "Internet.h"
-#include <sstream>
 #include <fstream>
 #include "HttpClient.h"
+#include "HttpSessionPool.h"
 #include "windows.h"
 #include "wininet.h"
 #include "stdx/uri_helper.h"
@@ -38,26 +38,41 @@
 #endif
 
 CInternetHttpSession::CInternetHttpSession() :
-	m_pInternetConnection(std::make_unique<CInternetConnection>()),
-	m_pHttpSession(new CHttpSession(*m_pInternetConnection)),
-	m_pHttpRequest(new CHttpRequest(*m_pHttpSession))
+	CInternetHttpSession(nullptr)
 {
+}
 
+CInternetHttpSession::CInternetHttpSession(const std::shared_ptr<CHttpSessionPool>& pSessionPool) :
+	m_pSessionPool(pSessionPool)
+{
+	if (!m_pSessionPool)
+	{	// Own connection
+		m_pInternetConnection = std::make_unique<CInternetConnection>();
+		m_pHttpSession.reset(new CHttpSession(*m_pInternetConnection));
+		m_pHttpRequest.reset(new CHttpRequest(*m_pHttpSession));
+		setRequestCallback();
+	}
 }
 
 CInternetHttpSession::CInternetHttpSession(CInternetHttpSession&& httpSession)
 {
 	std::swap(m_EndCallback, httpSession.m_EndCallback);
-	std::swap(m_pHttpRequest, httpSession.m_pHttpRequest);
-	std::swap(m_pHttpSession, httpSession.m_pHttpSession);
+	std::swap(m_pSessionPool, httpSession.m_pSessionPool);
 	std::swap(m_pInternetConnection, httpSession.m_pInternetConnection);
+	std::swap(m_pHttpSession, httpSession.m_pHttpSession);
+	m_pLease = std::atomic_exchange(&httpSession.m_pLease, m_pLease);
+	std::swap(m_pHttpRequest, httpSession.m_pHttpRequest);
+	setRequestCallback();
 }
 
 CInternetHttpSession::~CInternetHttpSession()
 {
 	try {
-		m_pHttpRequest->close();
-		m_pHttpSession->close();
+		if (m_pHttpRequest)
+			m_pHttpRequest->close();
+		if (m_pInternetConnection)
+			m_pHttpSession->close();
+		releaseLease(0, false);
 	}
 	catch (...) {}
 }
@@ -66,13 +81,20 @@ CInternetHttpSession& CInternetHttpSession::operator= (CInternetHttpSession&& ht
 {
 	if (&httpSession != this)
 	{
-		m_pHttpRequest->close();
-		m_pHttpSession->close();
+		if (m_pHttpRequest)
+			m_pHttpRequest->close();
+		if (m_pInternetConnection)
+			m_pHttpSession->close();
+		releaseLease(0, false);
 
 		std::swap(m_EndCallback, httpSession.m_EndCallback);
-		std::swap(m_pHttpRequest, httpSession.m_pHttpRequest);
-		std::swap(m_pHttpSession, httpSession.m_pHttpSession);
+		std::swap(m_pSessionPool, httpSession.m_pSessionPool);
 		std::swap(m_pInternetConnection, httpSession.m_pInternetConnection);
+		std::swap(m_pHttpSession, httpSession.m_pHttpSession);
+		m_pLease = std::atomic_exchange(&httpSession.m_pLease, m_pLease);
+		std::swap(m_pHttpRequest, httpSession.m_pHttpRequest);
+		setRequestCallback();
+		httpSession.setRequestCallback();
 	}
 
 	return *this;
@@ -83,6 +105,49 @@ void CInternetHttpSession::send(std::ostream& oss,
 	const std::string& strPostData,
 	const std::string& strReferrer,
 	const std::string& strHost)
+{
+	send([&oss](const char* pData, size_t length) { oss.write(pData, length); }, strUrl, strPostData, strReferrer, strHost);
+}
+
+void CInternetHttpSession::send(std::string& strResponse,
+	const std::string& strUrl,
+	const std::string& strPostData,
+	const std::string& strReferrer,
+	const std::string& strHost)
+{
+	open(strUrl, strPostData, strReferrer, strHost);
+
+	try
+	{
+		m_pHttpRequest->send(strResponse, strPostData);
+	}
+	catch (CInternetException&)
+	{
+		releaseLease(0, true);
+		throw;
+	}
+}
+
+void CInternetHttpSession::send(const SinkFunction& sink,
+	const std::string& strUrl,
+	const std::string& strPostData,
+	const std::string& strReferrer,
+	const std::string& strHost)
+{
+	open(strUrl, strPostData, strReferrer, strHost);
+
+	try
+	{
+		m_pHttpRequest->send(sink, strPostData);
+	}
+	catch (CInternetException&)
+	{
+		releaseLease(0, true);
+		throw;
+	}
+}
+
+void CInternetHttpSession::open(const std::string& strUrl, const std::string& strPostData, const std::string& strReferrer, const std::string& strHost)
 {
 	std::string strUrlHost;
 	unsigned short port;
@@ -101,42 +166,87 @@ void CInternetHttpSession::send(std::ostream& oss,
 
 	stdx::url_helper::split(strUrl, strUrlHost, port, strRequest, bSecure);
 
-	// Close previous session
-	m_pHttpRequest->close();
-	m_pHttpSession->close();
+	// Close previous request
+	if (m_pHttpRequest)
+		m_pHttpRequest->close();
 
-	// Open new session
-	m_pHttpSession->open(strUrlHost, port);
-	m_pHttpRequest->open(strRequest, bSecure, strReferrer, strPostData.empty() ? CHttpRequest::MethodGet : CHttpRequest::MethodPost);
+	if (m_pSessionPool)
+	{	// Shared session of the host, bounded by the pool
+		releaseLease(0, false);
+		std::shared_ptr<CHttpSessionPool::CLease> pLease = std::make_shared<CHttpSessionPool::CLease>(m_pSessionPool->acquire(strUrlHost, port));
 
-	m_pHttpRequest->addHeader("Host", strHost.empty() ? strUrlHost : strHost);
+		if (!m_pHttpRequest)
+		{
+			m_pHttpRequest.reset(new CHttpRequest(*pLease->session()));
+			setRequestCallback();
+		}
+		else if (pLease->session() != m_pHttpSession)
+		{
+			m_pHttpRequest->setSession(*pLease->session());
+		}
 
-	m_pHttpRequest->send(oss, strPostData);
+		m_pHttpSession = pLease->session();
+		std::atomic_store(&m_pLease, pLease);
+	}
+	else
+	{	// Open new session
+		m_pHttpSession->close();
+		m_pHttpSession->open(strUrlHost, port);
+	}
+
+	try
+	{
+		m_pHttpRequest->open(strRequest, bSecure, strReferrer, strPostData.empty() ? CHttpRequest::MethodGet : CHttpRequest::MethodPost);
+		m_pHttpRequest->addHeader("Host", strHost.empty() ? strUrlHost : strHost);
+	}
+	catch (CInternetException&)
+	{
+		releaseLease(0, true);
+		throw;
+	}
+}
+
+void CInternetHttpSession::releaseLease(size_t ulBytes, bool bError)
+{
+	std::shared_ptr<CHttpSessionPool::CLease> pLease = std::atomic_exchange(&m_pLease, std::shared_ptr<CHttpSessionPool::CLease>());
+	if (pLease)
+		pLease->release(ulBytes, bError);
+}
+
+void CInternetHttpSession::setRequestCallback()
+{
+	if (!m_pHttpRequest)
+		return;
+
+	m_pHttpRequest->setEndCallback([this](CHttpRequest& httpRequest, const CInternetException& inetException)
+		{
+			// Give the slot back first, the end callback can send the next request
+			releaseLease(httpRequest.getNumberOfBytesRead(), inetException.code() != ERROR_SUCCESS && inetException.code() != ERROR_INTERNET_OPERATION_CANCELLED);
+
+			if (m_EndCallback)
+				m_EndCallback(*this, inetException);
+		});
 }
 
 void CInternetHttpSession::cancel()
 {
-	m_pHttpRequest->cancel();
+	if (m_pHttpRequest)
+		m_pHttpRequest->cancel();
 }
 
 bool CInternetHttpSession::wait(size_t msTimeOut)
 {
-	return m_pHttpRequest->wait(msTimeOut);
+	return m_pHttpRequest ? m_pHttpRequest->wait(msTimeOut) : true;
 }
 
 size_t CInternetHttpSession::getNumberOfBytesRead() const
 {
-	return m_pHttpRequest->getNumberOfBytesRead();
+	return m_pHttpRequest ? m_pHttpRequest->getNumberOfBytesRead() : 0;
 }
 
 void CInternetHttpSession::setEndCallback(const CallbackFunction& EndCallback)
 {
 	m_EndCallback = EndCallback;
-	m_pHttpRequest->setEndCallback([&](CHttpRequest&, const CInternetException& inetException)
-		{
-			if (m_EndCallback)
-				m_EndCallback(*this, inetException);
-		});
 }
 
 size_t CInternet::HttpToStream(std::ostream& oss, const std::string& strRequest, const std::string& strPostData, const std::string& strReferrer, const std::string& strHost)
@@ -149,14 +259,21 @@ size_t CInternet::HttpToStream(std::ostream& oss, const std::string& strRequest,
 
 std::string CInternet::AjaxHttpRequest(const std::string& strRequest, const std::string& strReferrer, const std::string& strHost)
 {
-	std::ostringstream ossResponse;
-	HttpToStream(ossResponse, strRequest, std::string(), strReferrer, strHost);
+	return AjaxHttpRequest(nullptr, strRequest, strReferrer, strHost);
+}
+
+std::string CInternet::AjaxHttpRequest(const std::shared_ptr<CHttpSessionPool>& pSessionPool, const std::string& strRequest, const std::string& strReferrer, const std::string& strHost)
+{
+	std::string strResponse;
+	CInternetHttpSession httpSession(pSessionPool);
+	httpSession.send(strResponse, stdx::uri_helper::encode(strRequest), std::string(), strReferrer, strHost);
+	httpSession.wait();
 
 #if defined(_DEBUG) || defined(FORCE_LOG)
-	std::clog << ossResponse.str() << std::endl;
+	std::clog << strResponse << std::endl;
 #endif //_DEBUG
 
-	return ossResponse.str();
+	return strResponse;
 }
 
 std::wstring CInternet::HttpDownload(
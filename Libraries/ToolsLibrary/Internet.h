@@ -31,6 +31,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include "HttpSessionPool.h"
 
 class CInternetConnection;
 class CHttpSession;
@@ -41,8 +42,10 @@ class CInternetHttpSession
 {
 public:
 	typedef std::function<void(CInternetHttpSession&, const CInternetException&)> CallbackFunction;
+	typedef std::function<void(const char*, size_t)> SinkFunction; // Called with each chunk of the response body
 
 	CInternetHttpSession();
+	explicit CInternetHttpSession(const std::shared_ptr<CHttpSessionPool>& pSessionPool); // Requests sent on the sessions of the pool, own connection if null
 	CInternetHttpSession(CInternetHttpSession&& httpSession);
 	~CInternetHttpSession();
 
@@ -53,6 +56,16 @@ public:
 		const std::string& strPostData = std::string(),
 		const std::string& strReferrer = std::string(),
 		const std::string& strHost = std::string());
+	void send(std::string& strResponse, // The response is read directly at the end of strResponse
+		const std::string& strUrl,
+		const std::string& strPostData = std::string(),
+		const std::string& strReferrer = std::string(),
+		const std::string& strHost = std::string());
+	void send(const SinkFunction& sink,
+		const std::string& strUrl,
+		const std::string& strPostData = std::string(),
+		const std::string& strReferrer = std::string(),
+		const std::string& strHost = std::string());
 	void cancel();
 	bool wait(size_t msTimeOut = static_cast<size_t>(-1));
 	size_t getNumberOfBytesRead() const;
@@ -64,10 +77,16 @@ private:
 	CInternetHttpSession(const CInternetHttpSession&) = delete;
 	CInternetHttpSession& operator=(const CInternetHttpSession&) = delete;
 
+	void open(const std::string& strUrl, const std::string& strPostData, const std::string& strReferrer, const std::string& strHost);
+	void releaseLease(size_t ulBytes, bool bError);
+	void setRequestCallback();
+
 private:
 	CallbackFunction m_EndCallback;
+	std::shared_ptr<CHttpSessionPool> m_pSessionPool;
 	std::unique_ptr<CInternetConnection> m_pInternetConnection;
-	std::unique_ptr<CHttpSession> m_pHttpSession;
+	std::shared_ptr<CHttpSession> m_pHttpSession;
+	std::shared_ptr<CHttpSessionPool::CLease> m_pLease; // Accessed atomically, released by the end of the request
 	std::unique_ptr<CHttpRequest> m_pHttpRequest;
 };
 
@@ -84,6 +103,11 @@ public:
 		const std::string& strRequest,
 		const std::string& strReferrer = std::string(),
 		const std::string& strHost = std::string());
+	static std::string AjaxHttpRequest(
+		const std::shared_ptr<CHttpSessionPool>& pSessionPool,
+		const std::string& strRequest,
+		const std::string& strReferrer = std::string(),
+		const std::string& strHost = std::string());
 	static std::wstring HttpDownload(
 		const std::string& strRequest,
 		const std::string& strReferrer = std::string(),
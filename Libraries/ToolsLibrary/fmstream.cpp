@@ -27,6 +27,11 @@
  * Purpose: Provide read-write access to memory-mapped files on Windows and POSIX systems.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <string>
 #include "fmstream.h"
 
 class filemapping_base
@@ -38,6 +43,52 @@ public:
 	virtual std::streamsize open(const wchar_t* path_name, std::ios_base::openmode mode, std::streamsize max_length, std::streamoff offset, char*& pAddress, std::streamsize& map_length) = 0;
 	virtual int sync(char* pAddress, std::streamsize map_length) = 0;
 	virtual void close(char* pAddress, std::streamsize map_length) = 0;
+
+	// Windowed mode: the file is opened for input without any view, views are mapped on demand.
+	// map_view(), unmap_view() and advise() are also called from the read ahead thread.
+	virtual std::streamsize open_file(const char* path_name) = 0;
+	virtual std::streamsize open_file(const wchar_t* path_name) = 0;
+	virtual char* map_view(std::streamoff offset, std::streamsize length) const = 0;
+	virtual void unmap_view(char* pAddress, std::streamsize length) const = 0;
+	virtual void advise(char* pAddress, std::streamsize length, int advice) const = 0;
+
+	// Sink mode: a temporary file is mapped for writing, then renamed to path_name or removed
+	virtual bool open_sink(const char* path_name, std::streamsize length, char*& pAddress) = 0;
+	virtual bool open_sink(const wchar_t* path_name, std::streamsize length, char*& pAddress) = 0;
+	virtual bool resize_sink(char*& pAddress, std::streamsize map_length, std::streamsize length) = 0;
+	virtual bool close_sink(char* pAddress, std::streamsize map_length, std::streamsize length, bool commit) = 0;
+
+	void read_ahead(std::streamoff offset, std::streamsize length)
+	{
+		// Only one read ahead at a time
+		wait_read_ahead();
+
+		m_ReadAhead = std::async(std::launch::async, [this, offset, length]()
+		{
+			char* pAddress = map_view(offset, length);
+			if (!pAddress)
+				return;
+
+			advise(pAddress, length, filemapping::willneed);
+
+			// Touch a byte of each page to load it in the file cache
+			volatile char cPage = 0;
+			for (std::streamsize i = 0; i < length; i += 4096)
+				cPage = pAddress[i];
+			(void)cPage;
+
+			unmap_view(pAddress, length);
+		});
+	}
+
+	void wait_read_ahead()
+	{
+		if (m_ReadAhead.valid())
+			m_ReadAhead.wait();
+	}
+
+private:
+	std::future<void> m_ReadAhead;
 };
 
 #ifdef _WIN32
@@ -45,6 +96,8 @@ public:
 
 namespace
 {
+	const wchar_t SinkSuffix[] = L".part";
+
 	template<class T> HANDLE CreateFileT(const T*, DWORD, DWORD);
 
 	template<>
@@ -58,6 +111,22 @@ namespace
 	{
 		return CreateFileW(lpFileName, dwDesiredAccess, 0, nullptr, dwCreationDisposition, FILE_ATTRIBUTE_NORMAL, nullptr);
 	}
+
+	std::wstring WidePath(const char* lpFileName)
+	{
+		int nLength = MultiByteToWideChar(CP_ACP, 0, lpFileName, -1, nullptr, 0);
+		std::wstring strPathName(nLength > 0 ? nLength - 1 : 0, L'\0');
+
+		if (nLength > 1)
+			MultiByteToWideChar(CP_ACP, 0, lpFileName, -1, &strPathName[0], nLength);
+
+		return strPathName;
+	}
+
+	std::wstring WidePath(const wchar_t* lpFileName)
+	{
+		return lpFileName;
+	}
 }
 
 class filemapping_windows : public filemapping_base
@@ -119,6 +188,63 @@ class filemapping_windows : public filemapping_base
 		return FileSize;
 	}
 
+	template<class T>
+	std::streamsize open_file(const T* path_name)
+	{
+		std::streamsize FileSize = 0;
+		DWORD dwFileSizeHigh = 0;
+
+		m_pFile = CreateFileT(path_name, GENERIC_READ, OPEN_EXISTING);
+		if (m_pFile == INVALID_HANDLE_VALUE)
+			return FileSize;
+
+		// Windows are only used for reading, so the size is not limited by the address space
+		FileSize = GetFileSize(m_pFile, &dwFileSizeHigh);
+		FileSize |= static_cast<std::streamsize>(dwFileSizeHigh) << 32;
+
+		// An empty file cannot be mapped
+		if (FileSize)
+			m_pFileMapping = CreateFileMappingA(m_pFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		return m_pFileMapping ? FileSize : 0;
+	}
+
+	template<class T>
+	bool open_sink(const T* path_name, std::streamsize length, char*& pAddress)
+	{
+		m_strPathName = WidePath(path_name);
+		m_strTempName = m_strPathName + SinkSuffix;
+
+		m_pFile = CreateFileW(m_strTempName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_pFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		return map_sink(length, pAddress);
+	}
+
+	bool map_sink(std::streamsize length, char*& pAddress)
+	{
+		// The mapping object extends the file to its size
+		m_pFileMapping = CreateFileMappingA(m_pFile, nullptr, PAGE_READWRITE, static_cast<DWORD>(length >> 32), static_cast<DWORD>(length), nullptr);
+		if (!m_pFileMapping)
+			return false;
+
+		pAddress = static_cast<char*>(MapViewOfFile(m_pFileMapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(length)));
+		return pAddress != nullptr;
+	}
+
+	void unmap_sink(char* pAddress)
+	{
+		if (pAddress)
+			UnmapViewOfFile(pAddress);
+
+		if (m_pFileMapping)
+		{
+			CloseHandle(m_pFileMapping);
+			m_pFileMapping = nullptr;
+		}
+	}
+
 public:
 	filemapping_windows() : m_pFile(INVALID_HANDLE_VALUE), m_pFileMapping(nullptr) {}
 
@@ -132,6 +258,92 @@ public:
 		return open<wchar_t>(path_name, mode, max_length, offset, pAddress, map_length);
 	}
 
+	std::streamsize open_file(const char* path_name) override
+	{
+		return open_file<char>(path_name);
+	}
+
+	std::streamsize open_file(const wchar_t* path_name) override
+	{
+		return open_file<wchar_t>(path_name);
+	}
+
+	char* map_view(std::streamoff offset, std::streamsize length) const override
+	{
+		return static_cast<char*>(MapViewOfFile(m_pFileMapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), static_cast<SIZE_T>(length)));
+	}
+
+	void unmap_view(char* pAddress, std::streamsize) const override
+	{
+		UnmapViewOfFile(pAddress);
+	}
+
+	void advise(char* pAddress, std::streamsize length, int advice) const override
+	{
+		// Windows has no access pattern hint on a view, only the prefetch (Windows 8 and later)
+		if (!(advice & filemapping::willneed))
+			return;
+
+		struct MemoryRange
+		{
+			PVOID VirtualAddress;
+			SIZE_T NumberOfBytes;
+		};
+
+		typedef BOOL(WINAPI* PrefetchVirtualMemoryT)(HANDLE, ULONG_PTR, MemoryRange*, ULONG);
+		static const PrefetchVirtualMemoryT pPrefetchVirtualMemory = reinterpret_cast<PrefetchVirtualMemoryT>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory"));
+
+		if (pPrefetchVirtualMemory)
+		{
+			MemoryRange Range = { pAddress, static_cast<SIZE_T>(length) };
+			pPrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+		}
+	}
+
+	bool open_sink(const char* path_name, std::streamsize length, char*& pAddress) override
+	{
+		return open_sink<char>(path_name, length, pAddress);
+	}
+
+	bool open_sink(const wchar_t* path_name, std::streamsize length, char*& pAddress) override
+	{
+		return open_sink<wchar_t>(path_name, length, pAddress);
+	}
+
+	bool resize_sink(char*& pAddress, std::streamsize, std::streamsize length) override
+	{
+		unmap_sink(pAddress);
+		pAddress = nullptr;
+
+		return map_sink(length, pAddress);
+	}
+
+	bool close_sink(char* pAddress, std::streamsize, std::streamsize length, bool commit) override
+	{
+		unmap_sink(pAddress);
+
+		if (m_pFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		bool bCommitted = false;
+		if (commit)
+		{
+			LARGE_INTEGER liLength;
+			liLength.QuadPart = length;
+
+			bCommitted = SetFilePointerEx(m_pFile, liLength, nullptr, FILE_BEGIN) && SetEndOfFile(m_pFile) && FlushFileBuffers(m_pFile);
+		}
+
+		CloseHandle(m_pFile);
+		m_pFile = INVALID_HANDLE_VALUE;
+
+		if (bCommitted && MoveFileExW(m_strTempName.c_str(), m_strPathName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+			return true;
+
+		DeleteFileW(m_strTempName.c_str());
+		return !commit;
+	}
+
 	int sync(char* pAddress, std::streamsize map_length) override
 	{
 		return (FlushViewOfFile(pAddress, static_cast<SIZE_T>(map_length)) != FALSE) ? 0 : -1;
@@ -158,6 +370,8 @@ public:
 private:
 	HANDLE m_pFile;              //!< Windows handle to the file mapping object
 	HANDLE m_pFileMapping;       //!< Windows handle to the opened file
+	std::wstring m_strPathName;  //!< Final name of a sink
+	std::wstring m_strTempName;  //!< Temporary name of a sink
 };
 #else // If not Windows, this is a POSIX system !
 #include <stddef.h>
@@ -170,6 +384,31 @@ private:
 
 class  filemapping_posix : public filemapping_base
 {
+	static bool narrow_path(const wchar_t* path_name, std::vector<char>& to)
+	{
+		typedef std::codecvt<wchar_t, char, std::mbstate_t> converter_type;
+		std::setlocale(LC_ALL, "");
+
+		const converter_type& converter = std::use_facet<converter_type>(std::locale());
+		std::wstring ws(path_name);
+		to.assign(ws.length() * converter.max_length() + 1, '\0');
+
+		std::mbstate_t state = std::mbstate_t();
+		const wchar_t* from_next;
+		char* to_next;
+
+		converter_type::result result = converter.out(state, ws.data(), ws.data() + ws.length(), from_next, &to[0], &to[0] + to.size() - 1, to_next);
+		if (result == converter_type::noconv)
+			to.assign(ws.begin(), ws.end());
+		else if (result != converter_type::ok)
+			return false;
+		else
+			to.resize(to_next - &to[0]);
+
+		to.push_back('\0');
+		return true;
+	}
+
 public:
 	filemapping_posix() : m_fd(-1) {}
 
@@ -242,22 +481,128 @@ public:
 
 	std::streamsize open(const wchar_t* path_name, std::ios_base::openmode mode, std::streamsize max_length, std::streamoff offset, char*& pAddress, std::streamsize& map_length) override
 	{
-		typedef std::codecvt<wchar_t, char, std::mbstate_t> converter_type;
-		std::setlocale(LC_ALL, "");
+		std::vector<char> to;
+		if (!narrow_path(path_name, to))
+			return 0;
 
-		const converter_type& converter = std::use_facet<converter_type>(std::locale());
-		std::wstring ws(path_name);
-		std::vector<char> to(ws.length() * converter.max_length());
+		return open(&to[0], mode, max_length, offset, pAddress, map_length);
+	}
 
-		std::mbstate_t state;
-		const wchar_t* from_next;
-		char* to_next;
+	std::streamsize open_file(const char* path_name) override
+	{
+		m_fd = ::open(path_name, O_RDONLY);
+		if (m_fd == -1)
+			return 0;
+
+		struct stat statbuf;
 
-		converter_type::result result = converter.out(state, ws.data(), ws.data() + ws.length(), from_next, &to[0], &to[0] + to.size(), to_next);
-		if (result != converter_type::ok && result != converter_type::noconv)
+		// Get the file size
+		if (fstat(m_fd, &statbuf) != 0)
 			return 0;
 
-		return open(&to[0], mode, max_length, offset, pAddress, map_length);
+		return statbuf.st_size;
+	}
+
+	std::streamsize open_file(const wchar_t* path_name) override
+	{
+		std::vector<char> to;
+		if (!narrow_path(path_name, to))
+			return 0;
+
+		return open_file(&to[0]);
+	}
+
+	char* map_view(std::streamoff offset, std::streamsize length) const override
+	{
+		void* pAddress = mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_SHARED, m_fd, offset);
+		return (pAddress != MAP_FAILED) ? static_cast<char*>(pAddress) : nullptr;
+	}
+
+	void unmap_view(char* pAddress, std::streamsize length) const override
+	{
+		munmap(pAddress, static_cast<size_t>(length));
+	}
+
+	bool open_sink(const char* path_name, std::streamsize length, char*& pAddress) override
+	{
+		m_strPathName = path_name;
+		m_strTempName = m_strPathName + ".part";
+
+		m_fd = ::open(m_strTempName.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+		if (m_fd == -1)
+			return false;
+
+		return resize_sink(pAddress, 0, length);
+	}
+
+	bool open_sink(const wchar_t* path_name, std::streamsize length, char*& pAddress) override
+	{
+		std::vector<char> to;
+		if (!narrow_path(path_name, to))
+			return false;
+
+		return open_sink(&to[0], length, pAddress);
+	}
+
+	bool resize_sink(char*& pAddress, std::streamsize map_length, std::streamsize length) override
+	{
+		if (pAddress)
+			munmap(pAddress, static_cast<size_t>(map_length));
+
+		pAddress = nullptr;
+
+		// Reserve the blocks when possible, so that a full disk is detected here and not by a SIGBUS
+#ifdef __linux__
+		if (posix_fallocate(m_fd, 0, static_cast<off_t>(length)) != 0)
+#else
+		if (ftruncate(m_fd, static_cast<off_t>(length)) != 0)
+#endif
+			return false;
+
+		void* pMapping = mmap(nullptr, static_cast<size_t>(length), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+		if (pMapping == MAP_FAILED)
+			return false;
+
+		pAddress = static_cast<char*>(pMapping);
+		return true;
+	}
+
+	bool close_sink(char* pAddress, std::streamsize map_length, std::streamsize length, bool commit) override
+	{
+		if (pAddress && map_length)
+			munmap(pAddress, static_cast<size_t>(map_length));
+
+		if (m_fd == -1)
+			return false;
+
+		bool bCommitted = false;
+		if (commit)
+			bCommitted = ftruncate(m_fd, static_cast<off_t>(length)) == 0 && fsync(m_fd) == 0;
+
+		bCommitted = (::close(m_fd) == 0) && bCommitted;
+		m_fd = -1;
+
+		if (bCommitted && ::rename(m_strTempName.c_str(), m_strPathName.c_str()) == 0)
+			return true;
+
+		::unlink(m_strTempName.c_str());
+		return !commit;
+	}
+
+	void advise(char* pAddress, std::streamsize length, int advice) const override
+	{
+		if (advice & filemapping::sequential)
+			madvise(pAddress, static_cast<size_t>(length), MADV_SEQUENTIAL);
+		else if (advice & filemapping::random)
+			madvise(pAddress, static_cast<size_t>(length), MADV_RANDOM);
+
+		if (advice & filemapping::willneed)
+			madvise(pAddress, static_cast<size_t>(length), MADV_WILLNEED);
+
+#ifdef MADV_HUGEPAGE
+		if (advice & filemapping::huge_pages)
+			madvise(pAddress, static_cast<size_t>(length), MADV_HUGEPAGE);
+#endif
 	}
 
 	int sync(char* pAddress, std::streamsize map_length) override
@@ -279,6 +624,8 @@ public:
 
 private:
 	int m_fd;                    //!< File descriptor to the opened file
+	std::string m_strPathName;   //!< Final name of a sink
+	std::string m_strTempName;   //!< Temporary name of a sink
 };
 #endif
 
@@ -299,6 +646,11 @@ std::streamoff filemapping::offset_granularity()
 filemappingbuf::filemappingbuf() :
 	m_pAddress(nullptr),
 	m_MapLength(0),
+	m_FileSize(0),
+	m_WindowOffset(0),
+	m_WindowLength(0),
+	m_Advice(filemapping::normal),
+	m_bReadAhead(false),
 #ifdef _WIN32
 	m_pMapping(new filemapping_windows)
 #else // If not Windows, this is a POSIX system !
@@ -315,7 +667,12 @@ filemappingbuf::~filemappingbuf()
 #ifdef _HAS_CPP11_
 filemappingbuf::filemappingbuf(filemappingbuf&& rhs_buf) :
 	m_pAddress(nullptr),
-	m_MapLength(0)
+	m_MapLength(0),
+	m_FileSize(0),
+	m_WindowOffset(0),
+	m_WindowLength(0),
+	m_Advice(filemapping::normal),
+	m_bReadAhead(false)
 {
 	swap(rhs_buf);
 }
@@ -338,6 +695,11 @@ void filemappingbuf::swap(filemappingbuf& buf)
 		std::streambuf::swap(buf);
 		std::swap(m_pAddress, buf.m_pAddress);
 		std::swap(m_MapLength, buf.m_MapLength);
+		std::swap(m_FileSize, buf.m_FileSize);
+		std::swap(m_WindowOffset, buf.m_WindowOffset);
+		std::swap(m_WindowLength, buf.m_WindowLength);
+		std::swap(m_Advice, buf.m_Advice);
+		std::swap(m_bReadAhead, buf.m_bReadAhead);
 		std::swap(m_pMapping, buf.m_pMapping);
 	}
 }
@@ -363,6 +725,10 @@ void* filemappingbuf::pubseekptr(void* ptr, std::ios_base::openmode which)
 
 std::streampos filemappingbuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
 {
+	// In windowed mode, positions are file offsets
+	std::streamoff Base = m_WindowLength ? m_WindowOffset : 0;
+	std::streamsize Length = m_WindowLength ? m_FileSize : m_MapLength;
+
 	switch (way)
 	{
 	case std::ios_base::beg:
@@ -370,13 +736,13 @@ std::streampos filemappingbuf::seekoff(std::streamoff off, std::ios_base::seekdi
 
 	case std::ios_base::cur:
 		if (which & std::ios_base::in)
-			off += static_cast<std::streamoff>(gptr() - m_pAddress);
+			off += Base + static_cast<std::streamoff>(gptr() - m_pAddress);
 		else
-			off += static_cast<std::streamoff>(pptr() - m_pAddress);
+			off += Base + static_cast<std::streamoff>(pptr() - m_pAddress);
 		break;
 
 	case std::ios_base::end:
-		off = m_MapLength - off;
+		off = Length - off;
 		break;
 
 	default:
@@ -391,6 +757,14 @@ std::streampos filemappingbuf::seekoff(std::streamoff off, std::ios_base::seekdi
 
 std::streampos filemappingbuf::seekpos(std::streampos sp, std::ios_base::openmode which)
 {
+	if (m_WindowLength)
+	{
+		if (sp < 0 || (which & std::ios_base::out) || !map_window(sp, 0))
+			return -1;
+
+		return sp;
+	}
+
 	if (sp < 0 || !seekptr(m_pAddress + static_cast<ptrdiff_t>(sp), which))
 		return -1;
 
@@ -429,6 +803,8 @@ filemappingbuf* filemappingbuf::open(const char* path_name, std::ios_base::openm
 	if (!m_pAddress)
 		return nullptr;
 
+	m_FileSize = FileSize;
+
 	char* pEnd = m_pAddress + static_cast<ptrdiff_t>(m_MapLength);
 
 	setg(m_pAddress, m_pAddress, pEnd);
@@ -450,6 +826,8 @@ filemappingbuf* filemappingbuf::open(const wchar_t* path_name, std::ios_base::op
 	if (!m_pAddress)
 		return nullptr;
 
+	m_FileSize = FileSize;
+
 	char* pEnd = m_pAddress + static_cast<ptrdiff_t>(m_MapLength);
 
 	setg(m_pAddress, m_pAddress, pEnd);
@@ -462,6 +840,128 @@ filemappingbuf* filemappingbuf::open(const wchar_t* path_name, std::ios_base::op
 	return this;
 }
 
+filemappingbuf* filemappingbuf::open_window(const char* path_name, std::streamsize window_length, int advice, bool read_ahead)
+{
+	if (is_open() || window_length <= 0) // Check if a file is already opened and parameters
+		return nullptr;
+
+	m_FileSize = m_pMapping->open_file(path_name);
+	return start_window(window_length, advice, read_ahead);
+}
+
+filemappingbuf* filemappingbuf::open_window(const wchar_t* path_name, std::streamsize window_length, int advice, bool read_ahead)
+{
+	if (is_open() || window_length <= 0) // Check if a file is already opened and parameters
+		return nullptr;
+
+	m_FileSize = m_pMapping->open_file(path_name);
+	return start_window(window_length, advice, read_ahead);
+}
+
+filemappingbuf* filemappingbuf::start_window(std::streamsize window_length, int advice, bool read_ahead)
+{
+	std::streamoff Granularity = filemapping::offset_granularity();
+
+	m_WindowLength = ((window_length + Granularity - 1) / Granularity) * Granularity;
+	m_WindowOffset = 0;
+	m_Advice = advice;
+	m_bReadAhead = read_ahead;
+
+	// Windows are read only
+	setp(nullptr, nullptr);
+
+	if (m_FileSize <= 0 || !map_window(0, 0))
+	{
+		close();
+		return nullptr;
+	}
+
+	return this;
+}
+
+bool filemappingbuf::map_window(std::streamoff offset, std::streamsize length)
+{
+	if (offset < 0 || length < 0 || offset + length > m_FileSize)
+		return false;
+
+	// Already in the current window
+	if (m_pAddress && offset >= m_WindowOffset && offset + length <= m_WindowOffset + m_MapLength)
+	{
+		setg(m_pAddress, m_pAddress + static_cast<ptrdiff_t>(offset - m_WindowOffset), m_pAddress + static_cast<ptrdiff_t>(m_MapLength));
+		return true;
+	}
+
+	if (offset >= m_FileSize)
+		return false;
+
+	// The view must start on the allocation granularity, and contains at least the whole range
+	std::streamoff Granularity = filemapping::offset_granularity();
+	std::streamoff WindowOffset = offset - offset % Granularity;
+	std::streamsize WindowLength = std::max(m_WindowLength, static_cast<std::streamsize>(offset - WindowOffset) + length);
+
+	WindowLength = std::min(((WindowLength + Granularity - 1) / Granularity) * Granularity, static_cast<std::streamsize>(m_FileSize - WindowOffset));
+
+	if (m_pAddress)
+		m_pMapping->unmap_view(m_pAddress, m_MapLength);
+
+	m_pAddress = m_pMapping->map_view(WindowOffset, WindowLength);
+	if (!m_pAddress)
+	{
+		m_MapLength = 0;
+		setg(nullptr, nullptr, nullptr);
+		return false;
+	}
+
+	m_WindowOffset = WindowOffset;
+	m_MapLength = WindowLength;
+	m_pMapping->advise(m_pAddress, m_MapLength, m_Advice);
+
+	setg(m_pAddress, m_pAddress + static_cast<ptrdiff_t>(offset - m_WindowOffset), m_pAddress + static_cast<ptrdiff_t>(m_MapLength));
+
+	// Load the next window while this one is read
+	std::streamoff NextOffset = m_WindowOffset + m_MapLength;
+	if (m_bReadAhead && NextOffset < m_FileSize)
+		m_pMapping->read_ahead(NextOffset, std::min(m_WindowLength, static_cast<std::streamsize>(m_FileSize - NextOffset)));
+
+	return true;
+}
+
+filemappingbuf::int_type filemappingbuf::underflow()
+{
+	if (gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+
+	// In windowed mode, continue with the next window
+	if (!m_WindowLength || !m_pAddress || !map_window(m_WindowOffset + m_MapLength, 1))
+		return traits_type::eof();
+
+	return traits_type::to_int_type(*gptr());
+}
+
+const void* filemappingbuf::view(std::streamoff offset, std::streamsize length)
+{
+	if (!is_open() || offset < 0 || length < 0)
+		return nullptr;
+
+	if (m_WindowLength)
+		return map_window(offset, length) ? gptr() : nullptr;
+
+	if (offset + length > m_MapLength)
+		return nullptr;
+
+	return m_pAddress + static_cast<ptrdiff_t>(offset);
+}
+
+std::streamoff filemappingbuf::window_offset() const
+{
+	return m_WindowOffset;
+}
+
+std::streamsize filemappingbuf::file_size() const
+{
+	return m_FileSize;
+}
+
 int filemappingbuf::sync()
 {
 	if (m_pAddress && m_MapLength)
@@ -487,8 +987,13 @@ std::streamsize filemappingbuf::size() const
 
 filemappingbuf* filemappingbuf::close()
 {
+	m_pMapping->wait_read_ahead();
 	m_pMapping->close(m_pAddress, m_MapLength);
 
+	m_FileSize = 0;
+	m_WindowOffset = 0;
+	m_WindowLength = 0;
+
 	if (!is_open())
 		return nullptr;
 
@@ -579,11 +1084,42 @@ void ifmstream::close()
 		setstate(std::ios_base::failbit);
 }
 
+void ifmstream::open_window(const char* path_name, std::streamsize window_length, int advice, bool read_ahead)
+{
+	if (m_rdbuf.open_window(path_name, window_length, advice, read_ahead) == nullptr)
+		setstate(std::ios_base::failbit);
+	else
+		clear();
+}
+
+void ifmstream::open_window(const wchar_t* path_name, std::streamsize window_length, int advice, bool read_ahead)
+{
+	if (m_rdbuf.open_window(path_name, window_length, advice, read_ahead) == nullptr)
+		setstate(std::ios_base::failbit);
+	else
+		clear();
+}
+
+const void* ifmstream::view(std::streamoff offset, std::streamsize length)
+{
+	return (!fail()) ? m_rdbuf.view(offset, length) : nullptr;
+}
+
+std::streamoff ifmstream::window_offset() const
+{
+	return (!fail()) ? m_rdbuf.window_offset() : 0;
+}
+
+std::streamsize ifmstream::file_size() const
+{
+	return (!fail()) ? m_rdbuf.file_size() : 0;
+}
+
 const void* ifmstream::ptellg()
 {
 	// Return input stream position
 	if (!fail())
-		return static_cast<char*>(m_rdbuf.data()) + static_cast<ptrdiff_t>(m_rdbuf.pubseekoff(0, std::ios_base::cur, std::ios_base::in));
+		return static_cast<char*>(m_rdbuf.data()) + static_cast<ptrdiff_t>(m_rdbuf.pubseekoff(0, std::ios_base::cur, std::ios_base::in) - m_rdbuf.window_offset());
 	else
 		return nullptr;
 }
@@ -732,3 +1268,282 @@ std::streamsize fmstream::size() const
 {
 	return (!fail()) ? m_rdbuf.size() : 0;
 }
+
+/* filemappingsinkbuf class */
+namespace
+{
+	// A sink is mapped by multiple of the allocation granularity, and never empty
+	std::streamsize SinkLength(std::streamsize length)
+	{
+		std::streamoff Granularity = filemapping::offset_granularity();
+		return std::max(((length + Granularity - 1) / Granularity) * Granularity, static_cast<std::streamsize>(Granularity));
+	}
+}
+
+filemappingsinkbuf::filemappingsinkbuf() :
+	m_pAddress(nullptr),
+	m_MapLength(0),
+	m_Length(0),
+#ifdef _WIN32
+	m_pMapping(new filemapping_windows)
+#else // If not Windows, this is a POSIX system !
+	m_pMapping(new filemapping_posix)
+#endif
+{
+}
+
+filemappingsinkbuf::~filemappingsinkbuf()
+{
+	close();
+}
+
+bool filemappingsinkbuf::is_open() const
+{
+	return (m_pAddress && m_MapLength);
+}
+
+filemappingsinkbuf* filemappingsinkbuf::open(const char* path_name, std::streamsize size_hint)
+{
+	if (is_open() || size_hint < 0) // Check if a file is already opened and parameters
+		return nullptr;
+
+	std::streamsize MapLength = SinkLength(size_hint);
+	if (!m_pMapping->open_sink(path_name, MapLength, m_pAddress))
+	{
+		m_pMapping->close_sink(m_pAddress, MapLength, 0, false);
+		m_pAddress = nullptr;
+		return nullptr;
+	}
+
+	m_MapLength = MapLength;
+	m_Length = 0;
+	setp(m_pAddress, m_pAddress + static_cast<ptrdiff_t>(m_MapLength));
+
+	return this;
+}
+
+filemappingsinkbuf* filemappingsinkbuf::open(const wchar_t* path_name, std::streamsize size_hint)
+{
+	if (is_open() || size_hint < 0) // Check if a file is already opened and parameters
+		return nullptr;
+
+	std::streamsize MapLength = SinkLength(size_hint);
+	if (!m_pMapping->open_sink(path_name, MapLength, m_pAddress))
+	{
+		m_pMapping->close_sink(m_pAddress, MapLength, 0, false);
+		m_pAddress = nullptr;
+		return nullptr;
+	}
+
+	m_MapLength = MapLength;
+	m_Length = 0;
+	setp(m_pAddress, m_pAddress + static_cast<ptrdiff_t>(m_MapLength));
+
+	return this;
+}
+
+filemappingsinkbuf* filemappingsinkbuf::commit()
+{
+	if (!is_open())
+		return nullptr;
+
+	return finish(true) ? this : nullptr;
+}
+
+filemappingsinkbuf* filemappingsinkbuf::close()
+{
+	if (!is_open())
+		return nullptr;
+
+	return finish(false) ? this : nullptr;
+}
+
+std::streamsize filemappingsinkbuf::length() const
+{
+	if (!is_open())
+		return 0;
+
+	return std::max(m_Length, static_cast<std::streamsize>(pptr() - m_pAddress));
+}
+
+bool filemappingsinkbuf::finish(bool commit)
+{
+	bool bResult = m_pMapping->close_sink(m_pAddress, m_MapLength, length(), commit);
+
+	m_pAddress = nullptr;
+	m_MapLength = 0;
+	m_Length = 0;
+
+	setp(nullptr, nullptr);
+
+	return bResult;
+}
+
+bool filemappingsinkbuf::grow(std::streamsize length)
+{
+	if (!is_open())
+		return false;
+
+	std::streamoff Position = pptr() - m_pAddress;
+	std::streamsize MapLength = SinkLength(std::max(m_MapLength * 2, static_cast<std::streamsize>(Position + length)));
+
+	if (!m_pMapping->resize_sink(m_pAddress, m_MapLength, MapLength))
+	{
+		// The file cannot be completed, it is removed
+		m_pMapping->close_sink(m_pAddress, MapLength, 0, false);
+
+		m_pAddress = nullptr;
+		m_MapLength = 0;
+		m_Length = 0;
+
+		setp(nullptr, nullptr);
+		return false;
+	}
+
+	m_MapLength = MapLength;
+	setpos(Position);
+
+	return true;
+}
+
+void filemappingsinkbuf::setpos(std::streamoff position)
+{
+	setp(m_pAddress, m_pAddress + static_cast<ptrdiff_t>(m_MapLength));
+
+	// pbump() only takes an int
+	while (position > 0)
+	{
+		int nStep = static_cast<int>(std::min(position, static_cast<std::streamoff>(std::numeric_limits<int>::max())));
+		pbump(nStep);
+		position -= nStep;
+	}
+}
+
+int filemappingsinkbuf::sync()
+{
+	return is_open() ? 0 : -1;
+}
+
+filemappingsinkbuf::int_type filemappingsinkbuf::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	if (pptr() == epptr() && !grow(1))
+		return traits_type::eof();
+
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+
+	return c;
+}
+
+std::streamsize filemappingsinkbuf::xsputn(const char* s, std::streamsize n)
+{
+	if (n <= 0)
+		return 0;
+
+	if (epptr() - pptr() < n && !grow(n))
+		return 0;
+
+	memcpy(pptr(), s, static_cast<size_t>(n));
+
+	if (n <= std::numeric_limits<int>::max())
+		pbump(static_cast<int>(n));
+	else
+		setpos((pptr() - m_pAddress) + n);
+
+	return n;
+}
+
+std::streampos filemappingsinkbuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+	if (!is_open())
+		return -1;
+
+	switch (way)
+	{
+	case std::ios_base::beg:
+		break;
+
+	case std::ios_base::cur:
+		off += static_cast<std::streamoff>(pptr() - m_pAddress);
+		break;
+
+	case std::ios_base::end:
+		off += length();
+		break;
+
+	default:
+		return -1;
+	}
+
+	return seekpos(off, which);
+}
+
+std::streampos filemappingsinkbuf::seekpos(std::streampos sp, std::ios_base::openmode which)
+{
+	// The put pointer can only move inside what was written
+	if (!is_open() || !(which & std::ios_base::out) || sp < 0 || sp > length())
+		return -1;
+
+	m_Length = length();
+	setpos(sp);
+
+	return sp;
+}
+
+/* ofmstream class */
+ofmstream::ofmstream() : std::ostream(&m_rdbuf)
+{}
+
+ofmstream::ofmstream(const char* path_name, std::streamsize size_hint) : std::ostream(&m_rdbuf)
+{
+	open(path_name, size_hint);
+}
+
+ofmstream::ofmstream(const wchar_t* path_name, std::streamsize size_hint) : std::ostream(&m_rdbuf)
+{
+	open(path_name, size_hint);
+}
+
+filemappingsinkbuf* ofmstream::rdbuf() const
+{
+	return const_cast<filemappingsinkbuf*>(&m_rdbuf);
+}
+
+bool ofmstream::is_open() const
+{
+	return m_rdbuf.is_open();
+}
+
+void ofmstream::open(const char* path_name, std::streamsize size_hint)
+{
+	if (m_rdbuf.open(path_name, size_hint) == nullptr)
+		setstate(std::ios_base::failbit);
+	else
+		clear();
+}
+
+void ofmstream::open(const wchar_t* path_name, std::streamsize size_hint)
+{
+	if (m_rdbuf.open(path_name, size_hint) == nullptr)
+		setstate(std::ios_base::failbit);
+	else
+		clear();
+}
+
+void ofmstream::commit()
+{
+	// A file with a failed output is never published
+	if (fail())
+		m_rdbuf.close();
+	else if (m_rdbuf.commit() == nullptr)
+		setstate(std::ios_base::failbit);
+}
+
+void ofmstream::close()
+{
+	if (m_rdbuf.close() == nullptr)
+		setstate(std::ios_base::failbit);
+}
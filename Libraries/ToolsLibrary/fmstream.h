@@ -57,6 +57,19 @@ public:
 	 * @see fmstream::open()
 	 */
 	static std::streamoff offset_granularity();
+
+	/**
+	 * Access pattern hints of a mapping, can be combined.
+	 * @see filemappingbuf::open_window()
+	 */
+	enum advice
+	{
+		normal = 0,      //!< No particular access pattern
+		sequential = 1,  //!< Pages are read in order, the system may read ahead and release them early
+		random = 2,      //!< Pages are read in random order, read ahead is useless
+		willneed = 4,    //!< Pages will be needed soon, the system may start to load them
+		huge_pages = 8   //!< Back the mapping with huge pages if the system supports it (Linux only)
+	};
 };
 
 /**
@@ -160,6 +173,53 @@ public:
 	*/
 	filemappingbuf* open(const wchar_t* path_name, std::ios_base::openmode mode, std::streamsize max_length = 0, std::streamoff offset = 0);
 
+	/**
+	 * Open file in windowed mode.
+	 * Opens a file for input only and maps a window of window_length bytes at a time, so files larger than the memory or the address space can be read.
+	 * The window follows the get pointer: reading past its end or seeking outside of it maps the window containing the new position.
+	 * Positions used by seek and tell are file offsets. data() and size() describe the current window, window_offset() its position in the file.
+	 * If the object already has a file associated (open), this function fails.
+	 * @param path_name C-string contains the name of the file to be opened.
+	 * @param window_length Length of the window, rounded up to a multiple of filemapping::offset_granularity().
+	 * @param advice Access pattern hints applied to each window, a combination of filemapping::advice.
+	 * @param read_ahead If true, a thread touches the pages of the next window while the current one is read.
+	 * @return The function returns this if successful. In case of failure, close is called and a null pointer is returned.
+	 * @see view()
+	 * @see window_offset()
+	 * @see file_size()
+	 */
+	filemappingbuf* open_window(const char* path_name, std::streamsize window_length, int advice = filemapping::sequential, bool read_ahead = true);
+
+	/**
+	* Open file in windowed mode.
+	* Same as open_window(), but the path_name argument is a wide-character c-string.
+	* @see view()
+	*/
+	filemappingbuf* open_window(const wchar_t* path_name, std::streamsize window_length, int advice = filemapping::sequential, bool read_ahead = true);
+
+	/**
+	 * Get a range of the file.
+	 * In windowed mode, the window is moved, and enlarged if needed, so that it contains the whole range. The get pointer is set to offset.
+	 * Otherwise the range must be inside the mapping, and the get pointer is unchanged.
+	 * The returned address is valid until the window moves.
+	 * @param offset Position of the range, a file offset in windowed mode.
+	 * @param length Length of the range.
+	 * @return In case of success, returns the address of offset in the mapping. If the range is not inside the file, a null pointer is returned.
+	 */
+	const void* view(std::streamoff offset, std::streamsize length);
+
+	/**
+	 * Get the file offset of the mapping.
+	 * @return The offset of data() in the file in windowed mode, 0 otherwise.
+	 */
+	std::streamoff window_offset() const;
+
+	/**
+	 * Get the size of the file.
+	 * @return The size of the file when it was opened, or 0 if no file is open.
+	 */
+	std::streamsize file_size() const;
+
 	/**
 	 * Close file.
 	 * Closes the file currently associated with the object and disassociates it.
@@ -209,6 +269,7 @@ public:
 
 protected:
 	virtual int sync();
+	virtual int_type underflow();
 	virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which);
 	virtual std::streampos seekpos(std::streampos sp, std::ios_base::openmode which);
 	virtual void* seekptr(void* ptr, std::ios_base::openmode which);
@@ -224,9 +285,24 @@ private:
 	 */
 	filemappingbuf& operator=(const filemappingbuf&);
 
+	/**
+	 * Map the window containing the range [offset, offset + length) of the file, in windowed mode.
+	 */
+	bool map_window(std::streamoff offset, std::streamsize length);
+
+	/**
+	 * Map the first window of the file opened by open_window().
+	 */
+	filemappingbuf* start_window(std::streamsize window_length, int advice, bool read_ahead);
+
 private:
 	char* m_pAddress;                           //!< Base address of the mapping
 	std::streamsize m_MapLength;                //!< Length of the mapping
+	std::streamsize m_FileSize;                 //!< Size of the file
+	std::streamoff m_WindowOffset;              //!< File offset of the mapping in windowed mode
+	std::streamsize m_WindowLength;             //!< Length of the windows, 0 if not in windowed mode
+	int m_Advice;                               //!< Access pattern hints of the windows
+	bool m_bReadAhead;                          //!< Touch the next window in advance
 	std::unique_ptr<filemapping_base> m_pMapping; //!< File mapping implementation
 };
 
@@ -368,6 +444,48 @@ public:
 	 */
 	void close();
 
+	/**
+	 * Open file in windowed mode.
+	 * Opens a file whose name is path_name and maps a window of window_length bytes at a time, see filemappingbuf::open_window().
+	 * If the object already has a file associated (open), this function fails.
+	 * On failure, the failbit flag is set (which can be checked with member fail), and depending on the value set with exceptions an exception may be thrown.
+	 * @param path_name C-string contains the name of the file to be opened.
+	 * @param window_length Length of the window, rounded up to a multiple of filemapping::offset_granularity().
+	 * @param advice Access pattern hints applied to each window, a combination of filemapping::advice.
+	 * @param read_ahead If true, a thread touches the pages of the next window while the current one is read.
+	 * @see view()
+	 * @see close()
+	 */
+	void open_window(const char* path_name, std::streamsize window_length, int advice = filemapping::sequential, bool read_ahead = true);
+
+	/**
+	* Open file in windowed mode.
+	* Same as open_window(), but the path_name argument is a wide-character c-string.
+	* @see view()
+	*/
+	void open_window(const wchar_t* path_name, std::streamsize window_length, int advice = filemapping::sequential, bool read_ahead = true);
+
+	/**
+	 * Get a range of the file.
+	 * In windowed mode, the window is moved so that it contains the whole range, see filemappingbuf::view().
+	 * @param offset Position of the range, a file offset in windowed mode.
+	 * @param length Length of the range.
+	 * @return In case of success, returns the address of offset in the mapping. If the range is not inside the file, a null pointer is returned.
+	 */
+	const void* view(std::streamoff offset, std::streamsize length);
+
+	/**
+	 * Get the file offset of the mapping.
+	 * @return The offset of data() in the file in windowed mode, 0 otherwise.
+	 */
+	std::streamoff window_offset() const;
+
+	/**
+	 * Get the size of the file.
+	 * @return The size of the file when it was opened, or 0 if no file is open.
+	 */
+	std::streamsize file_size() const;
+
 	/**
 	 * Get position of the get pointer.
 	 * The get pointer determines the next location in the input sequence to be read by the next input operation.
@@ -649,6 +767,209 @@ private:
 	filemappingbuf m_rdbuf; //!< filemappingbuf object
 };
 
+/**
+ * filemappingsinkbuf writes a new file through a growing memory mapping.
+ * The file is written under a temporary name (the final name followed by ".part"), preallocated to a size hint and remapped twice as large when it is full.
+ * commit() truncates it to the written length and renames it to its final name, replacing an existing file, so a partially written file never appears under that name.
+ * A file which is closed without commit() is removed.
+ */
+class filemappingsinkbuf : public std::streambuf
+{
+public:
+	/**
+	 * Construct object.
+	 * A filemappingsinkbuf object is constructed, initializing all its pointers to null pointers.
+	 */
+	filemappingsinkbuf();
+
+	/**
+	 * Destructs the filemappingsinkbuf object.
+	 * A file which is not committed is removed.
+	 */
+	virtual ~filemappingsinkbuf();
+
+	/**
+	 * Check if a file is open.
+	 * @return true if a file is open, false otherwise.
+	 */
+	bool is_open() const;
+
+	/**
+	 * Create a file.
+	 * Creates the temporary file of path_name and maps it.
+	 * If the object already has a file associated (open), this function fails.
+	 * @param path_name C-string contains the name of the file to be written.
+	 * @param size_hint Expected length of the file. The file is grown if more is written, but a good estimate avoids any remapping.
+	 * @return The function returns this if successful. In case of failure, a null pointer is returned.
+	 * @see commit()
+	 * @see close()
+	 */
+	filemappingsinkbuf* open(const char* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Create a file.
+	 * Same as open(), but the path_name argument is a wide-character c-string.
+	 */
+	filemappingsinkbuf* open(const wchar_t* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Publish the file.
+	 * Unmaps the file, truncates it to length() bytes, flushes it to the disk and renames it to its final name.
+	 * @return The function returns this if successful. In case of failure, the temporary file is removed and a null pointer is returned.
+	 * @see close()
+	 */
+	filemappingsinkbuf* commit();
+
+	/**
+	 * Discard the file.
+	 * Unmaps and removes the temporary file. The final file, if any, is left untouched.
+	 * @return The function returns this if successful. In case of failure, a null pointer is returned.
+	 * @see commit()
+	 */
+	filemappingsinkbuf* close();
+
+	/**
+	 * Get the length of the file.
+	 * @return The highest position written, the length of the committed file.
+	 */
+	std::streamsize length() const;
+
+protected:
+	virtual int sync();
+	virtual int_type overflow(int_type c);
+	virtual std::streamsize xsputn(const char* s, std::streamsize n);
+	virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which);
+	virtual std::streampos seekpos(std::streampos sp, std::ios_base::openmode which);
+
+private:
+	/**
+	 * Copy constructor is private: this class is not copyable.
+	 */
+	filemappingsinkbuf(const filemappingsinkbuf&);
+
+	/**
+	 * Copy operator is private: this class is not copyable.
+	 */
+	filemappingsinkbuf& operator=(const filemappingsinkbuf&);
+
+	/**
+	 * Map the file with room for at least length more bytes at the put pointer.
+	 */
+	bool grow(std::streamsize length);
+
+	/**
+	 * Set the put pointer at position of the mapping.
+	 */
+	void setpos(std::streamoff position);
+
+	/**
+	 * Unmap the file, and publish or remove it.
+	 */
+	bool finish(bool commit);
+
+private:
+	char* m_pAddress;                           //!< Base address of the mapping
+	std::streamsize m_MapLength;                //!< Length of the mapping
+	std::streamsize m_Length;                   //!< Highest position written before the put pointer moved back
+	std::unique_ptr<filemapping_base> m_pMapping; //!< File mapping implementation
+};
+
+/**
+ * ofmstream provides an interface to write a new file through a memory mapping, as an output stream.
+ * The file is written under a temporary name and only appears under its final name when commit() succeeds, see filemappingsinkbuf.
+ * ofmstream can be used in place of std::ofstream, with a call to commit() instead of close().
+ */
+class ofmstream : public std::ostream
+{
+public:
+	/**
+	 * Construct object.
+	 * Constructs an object of the ofmstream class.
+	 */
+	ofmstream();
+
+	/**
+	 * Construct object and create a file.
+	 * The stream is associated with a temporary file as if a call to the member function open with the same parameters was made.
+	 * If the constructor is not successful in creating the file, the stream's failbit is set.
+	 * @param path_name C-string contains the name of the file to be written.
+	 * @param size_hint Expected length of the file.
+	 * @see open()
+	 * @see commit()
+	 */
+	explicit ofmstream(const char* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Construct object and create a file.
+	 * Same as ofmstream(const char* path_name, std::streamsize size_hint), but the path_name argument is a wide-character c-string.
+	 */
+	explicit ofmstream(const wchar_t* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Destructs the ofmstream object.
+	 * A file which is not committed is removed.
+	 */
+	virtual ~ofmstream() {}
+
+	/**
+	 * Get the associated filemappingsinkbuf object.
+	 * @return A pointer to the filemappingsinkbuf object associated with the stream.
+	 */
+	filemappingsinkbuf* rdbuf() const;
+
+	/**
+	 * Check if a file is open.
+	 * @return true if a file is open, i.e. associated to this stream object. false otherwise.
+	 */
+	bool is_open() const;
+
+	/**
+	 * Create a file.
+	 * If the object already has a file associated (open), this function fails.
+	 * On failure, the failbit flag is set (which can be checked with member fail), and depending on the value set with exceptions an exception may be thrown.
+	 * @param path_name C-string contains the name of the file to be written.
+	 * @param size_hint Expected length of the file. The file is grown if more is written, but a good estimate avoids any remapping.
+	 * @see commit()
+	 * @see close()
+	 */
+	void open(const char* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Create a file.
+	 * Same as open(), but the path_name argument is a wide-character c-string.
+	 */
+	void open(const wchar_t* path_name, std::streamsize size_hint = 0);
+
+	/**
+	 * Publish the file.
+	 * If an output operation failed, the file is discarded instead.
+	 * On failure, the failbit flag is set (which can be checked with member fail), and depending on the value set with exceptions an exception may be thrown.
+	 * @see filemappingsinkbuf::commit()
+	 */
+	void commit();
+
+	/**
+	 * Discard the file.
+	 * On failure, the failbit flag is set (which can be checked with member fail), and depending on the value set with exceptions an exception may be thrown.
+	 * @see filemappingsinkbuf::close()
+	 */
+	void close();
+
+private:
+	/**
+	 * Copy constructor is private: this class is not copyable.
+	 */
+	ofmstream(const ofmstream&);
+
+	/**
+	 * Copy operator is private: this class is not copyable.
+	 */
+	ofmstream& operator=(const ofmstream&);
+
+private:
+	filemappingsinkbuf m_rdbuf; //!< filemappingsinkbuf object
+};
+
 #ifdef _HAS_CPP11_
 /** @name C++11
  * The following methods requires some features introduced by the latest revision of the C++ standard (2011). Older compilers may not support it.
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose: printf-like format strings parsed at compile time, written with std::to_chars
+ */
+
+
+#ifndef STDX_STATIC_FORMAT_H_INCLUDED
+#define STDX_STATIC_FORMAT_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace stdx
+{
+	// One conversion of a static_format: %[flags][width][.precision][length]type
+	struct format_spec
+	{
+		size_t ulLiteralPos;   // Literal text written before the conversion
+		size_t ulLiteralLen;
+		bool bLeft;            // '-' flag
+		bool bPlus;            // '+' flag
+		bool bSpace;           // ' ' flag
+		bool bZero;            // '0' flag
+		int iWidth;
+		int iPrecision;        // -1 if not set
+		char cType;            // d, i, u, x, X, f, e, g, c or s
+	};
+
+	// Format string parsed at compile time, declare it static constexpr:
+	//   static constexpr stdx::static_format ITN_LINE("%06d|%07d|%s|%d|\r\n");
+	// and use it with stdx::format_to<ITN_LINE>() or stdx::format_append<ITN_LINE>().
+	// The length modifiers (l, h, ...) are ignored, the type of each argument is known.
+	template<size_t L>
+	class static_format
+	{
+	public:
+		constexpr static_format(const char(&szFormat)[L]) : m_szLiteral(), m_aSpecs(), m_ulSize(0), m_ulLiteralSize(0), m_ulTailPos(0)
+		{
+			size_t ulPos = 0;
+
+			while (ulPos < L - 1)
+			{
+				char c = szFormat[ulPos++];
+				if (c != '%')
+				{
+					m_szLiteral[m_ulLiteralSize++] = c;
+					continue;
+				}
+
+				if (szFormat[ulPos] == '%')
+				{
+					m_szLiteral[m_ulLiteralSize++] = '%';
+					++ulPos;
+					continue;
+				}
+
+				format_spec spec = {};
+				spec.ulLiteralPos = m_ulTailPos;
+				spec.ulLiteralLen = m_ulLiteralSize - m_ulTailPos;
+				spec.iPrecision = -1;
+
+				// Parse flags
+				for (bool bFlag = true; bFlag; )
+				{
+					switch (szFormat[ulPos])
+					{
+					case '-': spec.bLeft = true; ++ulPos; break;
+					case '+': spec.bPlus = true; ++ulPos; break;
+					case ' ': spec.bSpace = true; ++ulPos; break;
+					case '0': spec.bZero = true; ++ulPos; break;
+					default: bFlag = false; break;
+					}
+				}
+
+				// Parse width
+				while (szFormat[ulPos] >= '0' && szFormat[ulPos] <= '9')
+					spec.iWidth = spec.iWidth * 10 + (szFormat[ulPos++] - '0');
+
+				// Parse precision, "%.f" is a precision of 0
+				if (szFormat[ulPos] == '.')
+				{
+					spec.iPrecision = 0;
+					++ulPos;
+
+					while (szFormat[ulPos] >= '0' && szFormat[ulPos] <= '9')
+						spec.iPrecision = spec.iPrecision * 10 + (szFormat[ulPos++] - '0');
+				}
+
+				// Skip length modifiers
+				while (szFormat[ulPos] == 'l' || szFormat[ulPos] == 'L' || szFormat[ulPos] == 'h' || szFormat[ulPos] == 'I' || szFormat[ulPos] == 'z')
+					++ulPos;
+
+				// Parse type
+				switch (szFormat[ulPos])
+				{
+				case 'd':
+				case 'i':
+				case 'u':
+				case 'x':
+				case 'X':
+				case 'f':
+				case 'e':
+				case 'g':
+				case 'c':
+				case 's':
+					spec.cType = szFormat[ulPos++];
+					break;
+
+				default:
+					throw std::logic_error("stdx::static_format: unsupported conversion");
+				}
+
+				m_aSpecs[m_ulSize++] = spec;
+				m_ulTailPos = m_ulLiteralSize;
+			}
+		}
+
+		// Number of conversions
+		constexpr size_t size() const { return m_ulSize; }
+		constexpr const format_spec& spec(size_t ulIndex) const { return m_aSpecs[ulIndex]; }
+
+		// Literal text, without the conversions
+		constexpr std::string_view literal() const { return std::string_view(m_szLiteral, m_ulLiteralSize); }
+		// Literal text after the last conversion
+		constexpr std::string_view tail() const { return literal().substr(m_ulTailPos); }
+
+	private:
+		char m_szLiteral[L];
+		std::array<format_spec, L / 2 + 1> m_aSpecs;
+		size_t m_ulSize;
+		size_t m_ulLiteralSize;
+		size_t m_ulTailPos;
+	};
+
+	namespace internal
+	{
+		template<typename T> struct format_unsupported : std::false_type {};
+
+		inline std::to_chars_result format_write(char* first, char* last, const char* pText, size_t ulLen)
+		{
+			if (static_cast<size_t>(last - first) < ulLen)
+				return { last, std::errc::value_too_large };
+
+			memcpy(first, pText, ulLen);
+			return { first + ulLen, std::errc() };
+		}
+
+		// Write a converted text, padded to the width of the conversion
+		inline std::to_chars_result format_pad(char* first, char* last, const format_spec& spec, const char* pText, size_t ulLen, bool bNumeric)
+		{
+			size_t ulPad = (spec.iWidth > 0 && static_cast<size_t>(spec.iWidth) > ulLen) ? spec.iWidth - ulLen : 0;
+			if (static_cast<size_t>(last - first) < ulLen + ulPad)
+				return { last, std::errc::value_too_large };
+
+			if (spec.bLeft)
+			{
+				memcpy(first, pText, ulLen);
+				memset(first + ulLen, ' ', ulPad);
+			}
+			else if (spec.bZero && bNumeric)
+			{
+				// Zeros are inserted after the sign
+				size_t ulSign = (ulLen && (pText[0] == '-' || pText[0] == '+' || pText[0] == ' ')) ? 1 : 0;
+
+				memcpy(first, pText, ulSign);
+				memset(first + ulSign, '0', ulPad);
+				memcpy(first + ulSign + ulPad, pText + ulSign, ulLen - ulSign);
+			}
+			else
+			{
+				memset(first, ' ', ulPad);
+				memcpy(first + ulPad, pText, ulLen);
+			}
+
+			return { first + ulLen + ulPad, std::errc() };
+		}
+
+		template<typename T>
+		std::to_chars_result format_arg(char* first, char* last, const format_spec& spec, const T& value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				return format_arg(first, last, spec, static_cast<int>(value));
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				if (spec.cType == 'c')
+				{
+					char c = static_cast<char>(value);
+					return format_pad(first, last, spec, &c, 1, false);
+				}
+
+				if (spec.cType == 'f' || spec.cType == 'e' || spec.cType == 'g')
+					return format_arg(first, last, spec, static_cast<double>(value));
+
+				char szBuffer[72];
+				char* pText = szBuffer + 1; // Room for the sign
+				std::to_chars_result result;
+
+				if (spec.cType == 'x' || spec.cType == 'X')
+					result = std::to_chars(pText, std::end(szBuffer), static_cast<std::make_unsigned_t<T>>(value), 16);
+				else if (spec.cType == 'u')
+					result = std::to_chars(pText, std::end(szBuffer), static_cast<std::make_unsigned_t<T>>(value));
+				else
+					result = std::to_chars(pText, std::end(szBuffer), value);
+
+				if (result.ec != std::errc())
+					return { last, result.ec };
+
+				if (spec.cType == 'X')
+				{
+					for (char* p = pText; p != result.ptr; ++p)
+						if (*p >= 'a' && *p <= 'f')
+							*p -= 'a' - 'A';
+				}
+
+				if (*pText != '-' && (spec.bPlus || spec.bSpace))
+					*--pText = spec.bPlus ? '+' : ' ';
+
+				return format_pad(first, last, spec, pText, result.ptr - pText, true);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				if (spec.cType != 'f' && spec.cType != 'e' && spec.cType != 'g')
+					return format_arg(first, last, spec, static_cast<long long>(value));
+
+				char szBuffer[400]; // Longest fixed double
+				char* pText = szBuffer + 1; // Room for the sign
+				std::chars_format fmt = (spec.cType == 'f') ? std::chars_format::fixed : ((spec.cType == 'e') ? std::chars_format::scientific : std::chars_format::general);
+
+				std::to_chars_result result = std::to_chars(pText, std::end(szBuffer), value, fmt, (spec.iPrecision < 0) ? 6 : spec.iPrecision);
+				if (result.ec != std::errc())
+					return { last, result.ec };
+
+				if (*pText != '-' && (spec.bPlus || spec.bSpace))
+					*--pText = spec.bPlus ? '+' : ' ';
+
+				return format_pad(first, last, spec, pText, result.ptr - pText, true);
+			}
+			else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+			{
+				std::string_view strValue(value);
+				if (spec.iPrecision >= 0 && strValue.size() > static_cast<size_t>(spec.iPrecision))
+					strValue = strValue.substr(0, spec.iPrecision);
+
+				return format_pad(first, last, spec, strValue.data(), strValue.size(), false);
+			}
+			else
+			{
+				static_assert(format_unsupported<T>::value, "stdx::static_format: unsupported argument type");
+				return { last, std::errc::invalid_argument };
+			}
+		}
+
+		template<typename Format, size_t... I, typename... Args>
+		std::to_chars_result format_to(const Format& format, char* first, char* last, std::index_sequence<I...>, const Args&... args)
+		{
+			std::to_chars_result result = { first, std::errc() };
+
+			[[maybe_unused]] auto put = [&](const format_spec& spec, const auto& arg)
+			{
+				result = format_write(result.ptr, last, format.literal().data() + spec.ulLiteralPos, spec.ulLiteralLen);
+				if (result.ec == std::errc())
+					result = format_arg(result.ptr, last, spec, arg);
+
+				return result.ec == std::errc();
+			};
+
+			if ((put(format.spec(I), args) && ...))
+				result = format_write(result.ptr, last, format.tail().data(), format.tail().size());
+
+			return result;
+		}
+	}
+
+	// Write args formatted with Format in [first, last), without terminating null character.
+	// Returns the end of the written text, or std::errc::value_too_large if the buffer is too small.
+	template<const auto& Format, typename... Args>
+	std::to_chars_result format_to(char* first, char* last, const Args&... args)
+	{
+		static_assert(Format.size() == sizeof...(Args), "stdx::format_to: the number of arguments does not match the format string");
+		return internal::format_to(Format, first, last, std::index_sequence_for<Args...>(), args...);
+	}
+
+	// Append args formatted with Format to str, the buffer of str is reused
+	template<const auto& Format, typename... Args>
+	std::string& format_append(std::string& str, const Args&... args)
+	{
+		size_t ulSize = str.size();
+		size_t ulCapacity = std::max(str.capacity(), ulSize + Format.literal().size() + 16 * sizeof...(Args));
+
+		for (;;)
+		{
+			str.resize(ulCapacity);
+
+			std::to_chars_result result = format_to<Format>(&str[ulSize], &str[0] + str.size(), args...);
+			if (result.ec == std::errc())
+			{
+				str.resize(result.ptr - str.data());
+				return str;
+			}
+
+			if (result.ec != std::errc::value_too_large)
+			{
+				str.resize(ulSize);
+				return str;
+			}
+
+			ulCapacity *= 2;
+		}
+	}
+}
+#endif // STDX_STATIC_FORMAT_H_INCLUDED
@@ -40,7 +40,9 @@
 #include <array>
 #include <algorithm>
 #include <codecvt>
+#include <stdexcept>
 #include "predicate.h"
+#include "utf.h"
 
 #pragma warning(disable : 4996)
 
@@ -302,9 +304,15 @@ namespace stdx
 
 		static void narrow(const std::wstring& ws, std::string& s)
 		{
-			std::locale loc;
 			s.resize(ws.size());
-			std::use_facet< std::ctype<wchar_t> >(loc).narrow(&ws[0], &ws[ws.size()], '?', &s[0]);
+
+			// The locale is only needed past the ASCII prefix
+			size_t ulAscii = utf::copy_ascii(ws.data(), ws.size(), &s[0]);
+			if (ulAscii < ws.size())
+			{
+				std::locale loc;
+				std::use_facet< std::ctype<wchar_t> >(loc).narrow(ws.data() + ulAscii, ws.data() + ws.size(), '?', &s[ulAscii]);
+			}
 		}
 
 		static std::wstring widen(const std::string& s)
@@ -316,15 +324,25 @@ namespace stdx
 
 		static void widen(const std::string& s, std::wstring& ws)
 		{
-			std::locale loc;
 			ws.resize(s.size());
-			std::use_facet< std::ctype<wchar_t> >(loc).widen(&s[0], &s[s.size()], &ws[0]);
+
+			size_t ulAscii = utf::copy_ascii(s.data(), s.size(), &ws[0]);
+			if (ulAscii < s.size())
+			{
+				std::locale loc;
+				std::use_facet< std::ctype<wchar_t> >(loc).widen(s.data() + ulAscii, s.data() + s.size(), &ws[ulAscii]);
+			}
 		}
 
 		static void to_utf8(const std::basic_string<charT, Traits>& ws, std::string& utfs)
 		{
-			std::wstring_convert<std::codecvt_utf8<charT>, charT> cv;
-			utfs = cv.to_bytes(ws);
+			utfs.resize(utf::max_utf8_length<charT>(ws.size()));
+
+			utf::result res = utf::to_utf8(ws.data(), ws.size(), &utfs[0]);
+			if (!res.valid)
+				throw std::range_error("bad conversion");
+
+			utfs.resize(res.written);
 		}
 
 		static std::string to_utf8(const std::basic_string<charT, Traits>& ws)
@@ -336,8 +354,13 @@ namespace stdx
 
 		static void from_utf8(const std::string& utfs, std::basic_string<charT, Traits>& ws)
 		{
-			std::wstring_convert<std::codecvt_utf8<charT>, charT> cv;
-			ws = cv.from_bytes(utfs);
+			ws.resize(utfs.size());
+
+			utf::result res = utf::from_utf8(utfs.data(), utfs.size(), &ws[0]);
+			if (!res.valid)
+				throw std::range_error("bad conversion");
+
+			ws.resize(res.written);
 		}
 
 		static std::basic_string<charT, Traits> from_utf8(const std::string& utfs)
@@ -348,20 +371,23 @@ namespace stdx
 		}
 	};
 
-	template<> // Specialization for char
-	void basic_string_helper<char>::from_utf8(const std::string& utfs, std::string& s)
+	template<> // Specialization for char, Latin-1 like the classic locale narrow/widen
+	inline void basic_string_helper<char>::from_utf8(const std::string& utfs, std::string& s)
 	{
-		std::wstring ws;
-		basic_string_helper<wchar_t>::from_utf8(utfs, ws);
-		basic_string_helper<wchar_t>::narrow(ws, s);
+		s.resize(utfs.size());
+
+		utf::result res = utf::utf8_to_latin1(utfs.data(), utfs.size(), &s[0]);
+		if (!res.valid)
+			throw std::range_error("bad conversion");
+
+		s.resize(res.written);
 	}
 
 	template<> // Specialization for char
-	void basic_string_helper<char>::to_utf8(const std::string& s, std::string& utfs)
+	inline void basic_string_helper<char>::to_utf8(const std::string& s, std::string& utfs)
 	{
-		std::wstring ws;
-		basic_string_helper<wchar_t>::widen(s, ws);
-		basic_string_helper<wchar_t>::to_utf8(ws, utfs);
+		utfs.resize(utf::max_utf8_length<char>(s.size()));
+		utfs.resize(utf::latin1_to_utf8(s.data(), s.size(), &utfs[0]).written);
 	}
 
 	template<class charT, class Traits = std::char_traits<charT>>
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utf.h"
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define STDX_UTF_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace stdx
+{
+	namespace internal
+	{
+#ifdef STDX_UTF_SSE2
+		inline size_t first_bit(unsigned int mask)
+		{
+#ifdef _MSC_VER
+			unsigned long ulIndex;
+			_BitScanForward(&ulIndex, mask);
+			return ulIndex;
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		// Store 16 ASCII bytes as 16 units of the destination width
+		template<typename charT>
+		inline void store_ascii(charT* dst, __m128i v)
+		{
+			if constexpr (sizeof(charT) == 1)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+			}
+			else
+			{
+				const __m128i zero = _mm_setzero_si128();
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+				if constexpr (sizeof(charT) == 2)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lo);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), hi);
+				}
+				else
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(lo, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(lo, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpacklo_epi16(hi, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm_unpackhi_epi16(hi, zero));
+				}
+			}
+		}
+
+		// Load 16 units, returns false if one of them is not ASCII
+		template<typename charT>
+		inline bool load_ascii(const charT* src, __m128i& v)
+		{
+			if constexpr (sizeof(charT) == 1)
+			{
+				v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				return _mm_movemask_epi8(v) == 0;
+			}
+			else if constexpr (sizeof(charT) == 2)
+			{
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+				// Any unit above 0x7F has a bit under the 0xFF80 mask
+				__m128i high = _mm_or_si128(a, b);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(high, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) != 0xFFFF)
+					return false;
+				v = _mm_packus_epi16(a, b);
+				return true;
+			}
+			else
+			{
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+				__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+				__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+				__m128i high = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(high, _mm_set1_epi32(~0x7F)), _mm_setzero_si128())) != 0xFFFF)
+					return false;
+				v = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+				return true;
+			}
+		}
+#endif
+
+		template<typename charT>
+		inline uint32_t unit(charT c)
+		{
+			return static_cast<std::make_unsigned_t<charT>>(c);
+		}
+
+		// Copy the leading ASCII units from any width to any width
+		template<typename srcT, typename dstT>
+		size_t copy_ascii(const srcT* src, size_t size, dstT* dst)
+		{
+			size_t ulPos = 0;
+
+#ifdef STDX_UTF_SSE2
+			for (__m128i v; ulPos + 16 <= size; ulPos += 16)
+			{
+				if (!load_ascii(src + ulPos, v))
+				{
+					if constexpr (sizeof(srcT) == 1)
+					{
+						// The mask gives the exact length of the run
+						size_t ulRun = first_bit(static_cast<unsigned int>(_mm_movemask_epi8(v)));
+						for (size_t i = 0; i < ulRun; ++i)
+							dst[ulPos + i] = static_cast<dstT>(src[ulPos + i]);
+						return ulPos + ulRun;
+					}
+					break;
+				}
+
+				store_ascii(dst + ulPos, v);
+			}
+#endif
+
+			for (; ulPos < size && unit(src[ulPos]) < 0x80; ++ulPos)
+				dst[ulPos] = static_cast<dstT>(src[ulPos]);
+
+			return ulPos;
+		}
+
+		// Decode the sequence at src[ulPos], returns its length or 0 if invalid
+		inline size_t decode_utf8(const unsigned char* src, size_t size, size_t ulPos, uint32_t& cp)
+		{
+			uint32_t c = src[ulPos];
+			size_t ulLeft = size - ulPos;
+
+			if (c < 0x80)
+			{
+				cp = c;
+				return 1;
+			}
+
+			if (c < 0xC2) // Continuation byte or overlong 2 bytes form
+				return 0;
+
+			if (c < 0xE0)
+			{
+				if (ulLeft < 2 || (src[ulPos + 1] & 0xC0) != 0x80)
+					return 0;
+
+				cp = ((c & 0x1F) << 6) | (src[ulPos + 1] & 0x3F);
+				return 2;
+			}
+
+			if (c < 0xF0)
+			{
+				if (ulLeft < 3)
+					return 0;
+
+				uint32_t c1 = src[ulPos + 1];
+				uint32_t c2 = src[ulPos + 2];
+				if ((c1 & 0xC0) != 0x80 || (c2 & 0xC0) != 0x80 ||
+					(c == 0xE0 && c1 < 0xA0) || // Overlong
+					(c == 0xED && c1 > 0x9F)) // Surrogates
+					return 0;
+
+				cp = ((c & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (c2 & 0x3F);
+				return 3;
+			}
+
+			if (c < 0xF5)
+			{
+				if (ulLeft < 4)
+					return 0;
+
+				uint32_t c1 = src[ulPos + 1];
+				uint32_t c2 = src[ulPos + 2];
+				uint32_t c3 = src[ulPos + 3];
+				if ((c1 & 0xC0) != 0x80 || (c2 & 0xC0) != 0x80 || (c3 & 0xC0) != 0x80 ||
+					(c == 0xF0 && c1 < 0x90) || // Overlong
+					(c == 0xF4 && c1 > 0x8F)) // Above U+10FFFF
+					return 0;
+
+				cp = ((c & 0x07) << 18) | ((c1 & 0x3F) << 12) | ((c2 & 0x3F) << 6) | (c3 & 0x3F);
+				return 4;
+			}
+
+			return 0;
+		}
+
+		inline size_t encode_utf8(uint32_t cp, char* dst)
+		{
+			if (cp < 0x80)
+			{
+				dst[0] = static_cast<char>(cp);
+				return 1;
+			}
+
+			if (cp < 0x800)
+			{
+				dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+				dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+				return 2;
+			}
+
+			if (cp < 0x10000)
+			{
+				dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+				dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+				dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+				return 3;
+			}
+
+			dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+			dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+			dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+			return 4;
+		}
+
+		// UTF-8 to UTF-16 (surrogate pairs), UTF-32 or Latin-1 (replacement character)
+		template<typename charT>
+		utf::result from_utf8(const char* src, size_t size, charT* dst, charT replacement = charT())
+		{
+			const unsigned char* pSrc = reinterpret_cast<const unsigned char*>(src);
+			size_t ulRead = 0;
+			size_t ulWritten = 0;
+
+			while (ulRead < size)
+			{
+				if (pSrc[ulRead] < 0x80)
+				{
+					size_t ulRun = copy_ascii(src + ulRead, size - ulRead, dst + ulWritten);
+					ulRead += ulRun;
+					ulWritten += ulRun;
+					continue;
+				}
+
+				uint32_t cp;
+				size_t ulLength = decode_utf8(pSrc, size, ulRead, cp);
+				if (!ulLength)
+					return { ulRead, ulWritten, false };
+
+				if constexpr (sizeof(charT) == 1)
+				{
+					dst[ulWritten++] = cp < 0x100 ? static_cast<charT>(cp) : replacement;
+				}
+				else if constexpr (sizeof(charT) == 2)
+				{
+					if (cp < 0x10000)
+					{
+						dst[ulWritten++] = static_cast<charT>(cp);
+					}
+					else
+					{
+						cp -= 0x10000;
+						dst[ulWritten++] = static_cast<charT>(0xD800 | (cp >> 10));
+						dst[ulWritten++] = static_cast<charT>(0xDC00 | (cp & 0x3FF));
+					}
+				}
+				else
+				{
+					dst[ulWritten++] = static_cast<charT>(cp);
+				}
+
+				ulRead += ulLength;
+			}
+
+			return { ulRead, ulWritten, true };
+		}
+
+		// UTF-16, UTF-32 or Latin-1 to UTF-8
+		template<typename charT>
+		utf::result to_utf8(const charT* src, size_t size, char* dst)
+		{
+			size_t ulRead = 0;
+			size_t ulWritten = 0;
+
+			while (ulRead < size)
+			{
+				uint32_t cp = unit(src[ulRead]);
+				if (cp < 0x80)
+				{
+					size_t ulRun = copy_ascii(src + ulRead, size - ulRead, dst + ulWritten);
+					ulRead += ulRun;
+					ulWritten += ulRun;
+					continue;
+				}
+
+				size_t ulLength = 1;
+				if constexpr (sizeof(charT) == 2)
+				{
+					if (cp >= 0xD800 && cp < 0xE000)
+					{
+						uint32_t low = ulRead + 1 < size ? unit(src[ulRead + 1]) : 0;
+						if (cp >= 0xDC00 || low < 0xDC00 || low >= 0xE000) // Unpaired surrogate
+							return { ulRead, ulWritten, false };
+
+						cp = 0x10000 + (((cp & 0x3FF) << 10) | (low & 0x3FF));
+						ulLength = 2;
+					}
+				}
+				else if constexpr (sizeof(charT) == 4)
+				{
+					if (cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+						return { ulRead, ulWritten, false };
+				}
+
+				ulWritten += encode_utf8(cp, dst + ulWritten);
+				ulRead += ulLength;
+			}
+
+			return { ulRead, ulWritten, true };
+		}
+	}
+
+	size_t utf::copy_ascii(const char* src, size_t size, wchar_t* dst)
+	{
+		return internal::copy_ascii(src, size, dst);
+	}
+
+	size_t utf::copy_ascii(const wchar_t* src, size_t size, char* dst)
+	{
+		return internal::copy_ascii(src, size, dst);
+	}
+
+	size_t utf::ascii_length(const char* src, size_t size)
+	{
+		size_t ulPos = 0;
+
+#ifdef STDX_UTF_SSE2
+		for (; ulPos + 16 <= size; ulPos += 16)
+		{
+			int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + ulPos)));
+			if (mask)
+				return ulPos + internal::first_bit(static_cast<unsigned int>(mask));
+		}
+#endif
+
+		while (ulPos < size && static_cast<unsigned char>(src[ulPos]) < 0x80)
+			++ulPos;
+
+		return ulPos;
+	}
+
+	bool utf::validate_utf8(const char* src, size_t size)
+	{
+		const unsigned char* pSrc = reinterpret_cast<const unsigned char*>(src);
+		size_t ulPos = 0;
+
+		while (ulPos < size)
+		{
+			if (pSrc[ulPos] < 0x80)
+			{
+				ulPos += ascii_length(src + ulPos, size - ulPos);
+				continue;
+			}
+
+			uint32_t cp;
+			size_t ulLength = internal::decode_utf8(pSrc, size, ulPos, cp);
+			if (!ulLength)
+				return false;
+
+			ulPos += ulLength;
+		}
+
+		return true;
+	}
+
+	utf::result utf::to_utf8(const char16_t* src, size_t size, char* dst)
+	{
+		return internal::to_utf8(src, size, dst);
+	}
+
+	utf::result utf::to_utf8(const char32_t* src, size_t size, char* dst)
+	{
+		return internal::to_utf8(src, size, dst);
+	}
+
+	utf::result utf::to_utf8(const wchar_t* src, size_t size, char* dst)
+	{
+		return internal::to_utf8(src, size, dst);
+	}
+
+	utf::result utf::latin1_to_utf8(const char* src, size_t size, char* dst)
+	{
+		return internal::to_utf8(src, size, dst);
+	}
+
+	utf::result utf::from_utf8(const char* src, size_t size, char16_t* dst)
+	{
+		return internal::from_utf8(src, size, dst);
+	}
+
+	utf::result utf::from_utf8(const char* src, size_t size, char32_t* dst)
+	{
+		return internal::from_utf8(src, size, dst);
+	}
+
+	utf::result utf::from_utf8(const char* src, size_t size, wchar_t* dst)
+	{
+		return internal::from_utf8(src, size, dst);
+	}
+
+	utf::result utf::utf8_to_latin1(const char* src, size_t size, char* dst, char replacement)
+	{
+		return internal::from_utf8(src, size, dst, replacement);
+	}
+}
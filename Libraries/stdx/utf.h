@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose: UTF-8, UTF-16, UTF-32 and Latin-1 transcoding into caller buffers
+ */
+
+#ifndef STDX_UTF_H_INCLUDED
+#define STDX_UTF_H_INCLUDED
+
+#include <cstddef>
+
+namespace stdx
+{
+	// Conversions never allocate: the destination must hold at least max_utf8_length()
+	// bytes when encoding to UTF-8, and as many units as source bytes when decoding it.
+	// ASCII runs are copied with SSE2 when available, the remaining sequences are
+	// decoded strictly (no overlong forms, surrogates or code points above U+10FFFF).
+	struct utf
+	{
+		struct result
+		{
+			size_t read; // Source units consumed, position of the invalid sequence on failure
+			size_t written; // Destination units written
+			bool valid;
+		};
+
+		template<typename charT>
+		static constexpr size_t max_utf8_length(size_t size) { return size * (sizeof(charT) == 1 ? 2 : sizeof(charT) == 2 ? 3 : 4); }
+
+		// Copy the leading ASCII characters, returns their number
+		static size_t copy_ascii(const char* src, size_t size, wchar_t* dst);
+		static size_t copy_ascii(const wchar_t* src, size_t size, char* dst);
+
+		static size_t ascii_length(const char* src, size_t size);
+		static bool validate_utf8(const char* src, size_t size);
+
+		static result to_utf8(const char16_t* src, size_t size, char* dst);
+		static result to_utf8(const char32_t* src, size_t size, char* dst);
+		static result to_utf8(const wchar_t* src, size_t size, char* dst); // UTF-16 or UTF-32 depending on wchar_t
+		static result latin1_to_utf8(const char* src, size_t size, char* dst);
+
+		static result from_utf8(const char* src, size_t size, char16_t* dst);
+		static result from_utf8(const char* src, size_t size, char32_t* dst);
+		static result from_utf8(const char* src, size_t size, wchar_t* dst);
+		static result utf8_to_latin1(const char* src, size_t size, char* dst, char replacement = '?');
+	};
+}
+
+#endif // STDX_UTF_H_INCLUDED
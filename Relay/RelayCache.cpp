@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : On-disk content-addressed cache of the relay responses
+ */
+
+#include "RelayCache.h"
+#include "RelayMetrics.h"
+#include <windows.h>
+#include <bcrypt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "stdx/string_helper.h"
+
+#ifdef _MSC_VER
+#pragma comment(lib, "bcrypt.lib")
+#endif // _MSC_VER
+
+namespace
+{
+	constexpr long long MaxHeuristicLifetime = 24 * 3600; // One day
+	constexpr const char* TempExtension = ".tmp";
+
+	class CSha256Provider
+	{
+	public:
+		CSha256Provider() :
+			m_hAlgorithm(nullptr)
+		{
+			if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&m_hAlgorithm, BCRYPT_SHA256_ALGORITHM, nullptr, 0)))
+				throw std::runtime_error("SHA-256 provider not available");
+		}
+
+		~CSha256Provider()
+		{
+			BCryptCloseAlgorithmProvider(m_hAlgorithm, 0);
+		}
+
+		std::string hex(const std::string& strData) const
+		{
+			static constexpr char digits[] = "0123456789abcdef";
+			BCRYPT_HASH_HANDLE hHash = nullptr;
+			unsigned char digest[32];
+
+			bool bHashed = BCRYPT_SUCCESS(BCryptCreateHash(m_hAlgorithm, &hHash, nullptr, 0, nullptr, 0, 0)) &&
+				BCRYPT_SUCCESS(BCryptHashData(hHash, reinterpret_cast<PUCHAR>(const_cast<char*>(strData.data())), static_cast<ULONG>(strData.size()), 0)) &&
+				BCRYPT_SUCCESS(BCryptFinishHash(hHash, digest, sizeof(digest), 0));
+
+			if (hHash)
+				BCryptDestroyHash(hHash);
+
+			if (!bHashed)
+				throw std::runtime_error("SHA-256 failed");
+
+			std::string strHex(sizeof(digest) * 2, '0');
+			for (size_t i = 0; i < sizeof(digest); ++i)
+			{
+				strHex[i * 2] = digits[digest[i] >> 4];
+				strHex[i * 2 + 1] = digits[digest[i] & 0x0F];
+			}
+
+			return strHex;
+		}
+
+	private:
+		BCRYPT_ALG_HANDLE m_hAlgorithm;
+	};
+
+	std::string Sha256(const std::string& strData)
+	{
+		static const CSha256Provider provider;
+		return provider.hex(strData);
+	}
+
+	struct CCacheControl
+	{
+		bool bNoStore = false;
+		bool bNoCache = false;
+		bool bPrivate = false;
+		bool bMustRevalidate = false;
+		long long llMaxAge = -1;
+		long long llSMaxAge = -1;
+	};
+
+	long long ParseSeconds(const std::string& strValue)
+	{
+		if (strValue.empty() || strValue.find_first_not_of("0123456789") != std::string::npos)
+			return -1;
+
+		return std::stoll(strValue.substr(0, 18));
+	}
+
+	CCacheControl ParseCacheControl(const std::string& strCacheControl)
+	{
+		CCacheControl cc;
+		stdx::string_helper::vector directives;
+		stdx::string_helper::split(strCacheControl, directives, stdx::find_first(","), false);
+
+		for (std::string& strDirective : directives)
+		{
+			std::string strValue;
+			size_t ulEqual = strDirective.find('=');
+			if (ulEqual != std::string::npos)
+			{
+				strValue = strDirective.substr(ulEqual + 1);
+				strDirective.resize(ulEqual);
+				stdx::string_helper::trimleft(strValue, " \t\"");
+				stdx::string_helper::trimright(strValue, " \t\"");
+			}
+
+			stdx::string_helper::trimleft(strDirective, " \t");
+			stdx::string_helper::trimright(strDirective, " \t");
+			stdx::string_helper::tolower(strDirective);
+
+			if (strDirective == "no-store")
+				cc.bNoStore = true;
+			else if (strDirective == "no-cache") // With or without field names, always revalidate
+				cc.bNoCache = true;
+			else if (strDirective == "private")
+				cc.bPrivate = true;
+			else if (strDirective == "must-revalidate" || strDirective == "proxy-revalidate")
+				cc.bMustRevalidate = true;
+			else if (strDirective == "max-age")
+				cc.llMaxAge = ParseSeconds(strValue);
+			else if (strDirective == "s-maxage")
+				cc.llSMaxAge = ParseSeconds(strValue);
+		}
+
+		return cc;
+	}
+
+	bool IsCacheableStatus(unsigned long ulStatus)
+	{
+		return ulStatus == 200 || ulStatus == 203 || ulStatus == 300 || ulStatus == 301 || ulStatus == 404 || ulStatus == 410;
+	}
+
+	std::string Header(const CUpstreamResponse::headers_t& headers, const std::string& strName)
+	{
+		auto it = headers.find(strName);
+		return it != headers.end() ? it->second : std::string();
+	}
+
+	// Write then rename, readers never see a partial file
+	void WriteFile(const std::filesystem::path& file, const std::string& strData)
+	{
+		static std::atomic<unsigned long> ulTemp(0);
+
+		std::filesystem::create_directories(file.parent_path());
+		std::filesystem::path temp(file);
+		temp += "." + std::to_string(++ulTemp) + TempExtension;
+
+		{
+			std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+			ofs.write(strData.data(), strData.size());
+			if (!ofs.good())
+			{
+				ofs.close();
+				std::error_code ec;
+				std::filesystem::remove(temp, ec);
+				throw std::runtime_error("Cannot write " + temp.string());
+			}
+		}
+
+		std::filesystem::rename(temp, file);
+	}
+
+	long long DaysFromCivil(long long y, unsigned int m, unsigned int d)
+	{
+		y -= m <= 2;
+		const long long era = (y >= 0 ? y : y - 399) / 400;
+		const unsigned int yoe = static_cast<unsigned int>(y - era * 400);
+		const unsigned int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+		const unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + static_cast<long long>(doe) - 719468;
+	}
+}
+
+CRelayCache::CRelayCache(const std::filesystem::path& directory, unsigned long long ullMaxSize, long long llDefaultTtl, CRelayMetrics& metrics) :
+	m_Directory(directory),
+	m_ullMaxSize(ullMaxSize),
+	m_llDefaultTtl(llDefaultTtl),
+	m_Metrics(metrics),
+	m_ullSize(0)
+{
+	std::filesystem::create_directories(m_Directory / "index");
+	std::filesystem::create_directories(m_Directory / "objects");
+	loadIndex();
+}
+
+long long CRelayCache::now()
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+long long CRelayCache::parseHttpDate(const std::string& strDate)
+{
+	static const std::string strMonths("JanFebMarAprMayJunJulAugSepOctNovDec");
+
+	size_t ulComma = strDate.find(',');
+	if (ulComma == std::string::npos)
+		return -1;
+
+	std::istringstream iss(strDate.substr(ulComma + 1));
+	int iDay = 0, iYear = 0, iHour = 0, iMinute = 0, iSecond = 0;
+	char cSep1 = 0, cSep2 = 0;
+	std::string strMonth;
+
+	iss >> iDay >> strMonth >> iYear >> iHour >> cSep1 >> iMinute >> cSep2 >> iSecond;
+	size_t ulMonth = strMonths.find(strMonth);
+	if (iss.fail() || cSep1 != ':' || cSep2 != ':' || strMonth.size() != 3 || ulMonth == std::string::npos || ulMonth % 3 ||
+		iDay < 1 || iDay > 31 || iHour > 23 || iMinute > 59 || iSecond > 60)
+		return -1;
+
+	return DaysFromCivil(iYear, static_cast<unsigned int>(ulMonth / 3 + 1), static_cast<unsigned int>(iDay)) * 86400 + iHour * 3600 + iMinute * 60 + iSecond;
+}
+
+std::filesystem::path CRelayCache::objectPath(const std::string& strHash) const
+{
+	return m_Directory / "objects" / strHash.substr(0, 2) / strHash;
+}
+
+std::filesystem::path CRelayCache::indexPath(const std::string& strHash) const
+{
+	return m_Directory / "index" / strHash.substr(0, 2) / strHash;
+}
+
+void CRelayCache::updateFreshness(const CUpstreamResponse::headers_t& headers, long long llNow, CCacheEntry& entry) const
+{
+	CCacheControl cc = ParseCacheControl(Header(headers, "cache-control"));
+
+	long long llDate = parseHttpDate(Header(headers, "date"));
+	if (llDate < 0)
+		llDate = llNow;
+
+	// Corrected initial age, without the request delay we do not track
+	long long llAge = std::max(ParseSeconds(Header(headers, "age")), llNow - llDate);
+	entry.llStored = llNow - std::max(llAge, 0LL);
+
+	long long llLifetime = m_llDefaultTtl;
+	if (cc.bNoCache)
+	{
+		llLifetime = 0;
+	}
+	else if (cc.llSMaxAge >= 0)
+	{
+		llLifetime = cc.llSMaxAge;
+	}
+	else if (cc.llMaxAge >= 0)
+	{
+		llLifetime = cc.llMaxAge;
+	}
+	else if (!entry.strExpires.empty())
+	{
+		long long llExpires = parseHttpDate(entry.strExpires);
+		llLifetime = llExpires < 0 ? 0 : std::max(llExpires - llDate, 0LL);
+	}
+	else if (!entry.strLastModified.empty())
+	{
+		long long llLastModified = parseHttpDate(entry.strLastModified);
+		if (llLastModified >= 0 && llLastModified < llDate)
+			llLifetime = std::min((llDate - llLastModified) / 10, MaxHeuristicLifetime);
+	}
+
+	entry.llExpires = entry.llStored + llLifetime;
+	entry.bMustRevalidate = cc.bMustRevalidate || cc.bNoCache || cc.llSMaxAge >= 0;
+}
+
+bool CRelayCache::lookup(const std::string& strUrl, CCacheEntry& entry)
+{
+	std::string strKey = Sha256(strUrl);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Entries.find(strKey);
+	if (it == m_Entries.end() || it->second.strUrl != strUrl)
+		return false;
+
+	it->second.llLastAccess = now();
+	entry = it->second;
+	return true;
+}
+
+bool CRelayCache::load(const CCacheEntry& entry, std::string& strBody) const
+{
+	std::ifstream ifs(objectPath(entry.strObject), std::ios::binary);
+	if (!ifs.is_open())
+		return false;
+
+	strBody.resize(static_cast<size_t>(entry.ullSize));
+	ifs.read(&strBody[0], strBody.size());
+	return static_cast<unsigned long long>(ifs.gcount()) == entry.ullSize;
+}
+
+bool CRelayCache::store(const std::string& strUrl, const CUpstreamResponse& response, long long llNow)
+{
+	CCacheControl cc = ParseCacheControl(response.header("cache-control"));
+	if (!IsCacheableStatus(response.ulStatus) || cc.bNoStore || cc.bPrivate || response.header("vary") == "*")
+		return false;
+
+	CCacheEntry entry;
+	entry.strUrl = strUrl;
+	entry.ulStatus = response.ulStatus;
+	entry.strContentType = response.header("content-type");
+	entry.strCacheControl = response.header("cache-control");
+	entry.strETag = response.header("etag");
+	entry.strLastModified = response.header("last-modified");
+	entry.strExpires = response.header("expires");
+	entry.ullSize = response.strBody.size();
+	entry.llLastAccess = llNow;
+	updateFreshness(response.headers, llNow, entry);
+
+	if (!entry.fresh(llNow) && !entry.hasValidators()) // Could never be served
+		return false;
+
+	entry.strObject = Sha256(response.strBody);
+	std::string strKey = Sha256(strUrl);
+
+	// Reference the object first so that eviction cannot remove it while it is written
+	bool bWriteObject = false;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		size_t& ulReferences = m_Objects[entry.strObject];
+		if (!ulReferences++)
+		{
+			m_ullSize += entry.ullSize;
+			bWriteObject = true;
+		}
+	}
+
+	try
+	{
+		if (bWriteObject && !std::filesystem::exists(objectPath(entry.strObject)))
+			WriteFile(objectPath(entry.strObject), response.strBody);
+
+		writeIndex(strKey, entry);
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!--m_Objects[entry.strObject])
+		{
+			m_Objects.erase(entry.strObject);
+			m_ullSize -= entry.ullSize;
+		}
+		throw;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Entries.find(strKey);
+	if (it != m_Entries.end())
+	{
+		// Keep the reference just taken when the body did not change
+		std::string strOldObject = it->second.strObject;
+		unsigned long long ullOldSize = it->second.ullSize;
+		m_Entries.erase(it);
+
+		if (!--m_Objects[strOldObject])
+		{
+			m_Objects.erase(strOldObject);
+			m_ullSize -= ullOldSize;
+
+			std::error_code ec;
+			std::filesystem::remove(objectPath(strOldObject), ec);
+		}
+	}
+
+	m_Entries.emplace(strKey, entry);
+	m_Metrics.cacheStores++;
+	evict();
+
+	m_Metrics.cacheEntries = static_cast<long long>(m_Entries.size());
+	m_Metrics.cacheBytes = static_cast<long long>(m_ullSize);
+	return true;
+}
+
+bool CRelayCache::refresh(const std::string& strUrl, const CUpstreamResponse& response, long long llNow, CCacheEntry& entry)
+{
+	std::string strKey = Sha256(strUrl);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Entries.find(strKey);
+		if (it == m_Entries.end() || it->second.strUrl != strUrl)
+			return false;
+
+		CCacheEntry& cached = it->second;
+
+		// A 304 carries the headers that changed, the other ones are kept
+		CUpstreamResponse::headers_t headers = response.headers;
+		headers.emplace("cache-control", cached.strCacheControl);
+
+		if (!response.header("cache-control").empty())
+			cached.strCacheControl = response.header("cache-control");
+		if (!response.header("etag").empty())
+			cached.strETag = response.header("etag");
+		if (!response.header("last-modified").empty())
+			cached.strLastModified = response.header("last-modified");
+		if (!response.header("expires").empty())
+			cached.strExpires = response.header("expires");
+
+		cached.llLastAccess = llNow;
+		updateFreshness(headers, llNow, cached);
+		entry = cached;
+	}
+
+	writeIndex(strKey, entry);
+	return true;
+}
+
+void CRelayCache::writeIndex(const std::string& strKey, const CCacheEntry& entry) const
+{
+	std::ostringstream oss;
+	oss << "url: " << entry.strUrl << '\n'
+		<< "object: " << entry.strObject << '\n'
+		<< "status: " << entry.ulStatus << '\n'
+		<< "content-type: " << entry.strContentType << '\n'
+		<< "cache-control: " << entry.strCacheControl << '\n'
+		<< "etag: " << entry.strETag << '\n'
+		<< "last-modified: " << entry.strLastModified << '\n'
+		<< "expires: " << entry.strExpires << '\n'
+		<< "stored: " << entry.llStored << '\n'
+		<< "fresh-until: " << entry.llExpires << '\n'
+		<< "must-revalidate: " << entry.bMustRevalidate << '\n'
+		<< "size: " << entry.ullSize << '\n';
+
+	WriteFile(indexPath(strKey), oss.str());
+}
+
+bool CRelayCache::readIndex(const std::filesystem::path& file, CCacheEntry& entry) const
+{
+	std::ifstream ifs(file, std::ios::binary);
+	CUpstreamResponse::headers_t fields;
+	std::string strLine;
+
+	while (std::getline(ifs, strLine))
+	{
+		size_t ulColon = strLine.find(": ");
+		if (ulColon != std::string::npos)
+			fields[strLine.substr(0, ulColon)] = strLine.substr(ulColon + 2);
+	}
+
+	entry.strUrl = Header(fields, "url");
+	entry.strObject = Header(fields, "object");
+	entry.strContentType = Header(fields, "content-type");
+	entry.strCacheControl = Header(fields, "cache-control");
+	entry.strETag = Header(fields, "etag");
+	entry.strLastModified = Header(fields, "last-modified");
+	entry.strExpires = Header(fields, "expires");
+	entry.bMustRevalidate = Header(fields, "must-revalidate") == "1";
+
+	long long llStatus = ParseSeconds(Header(fields, "status"));
+	long long llSize = ParseSeconds(Header(fields, "size"));
+	long long llStored = ParseSeconds(Header(fields, "stored"));
+	long long llExpires = ParseSeconds(Header(fields, "fresh-until"));
+	if (entry.strUrl.empty() || entry.strObject.size() != 64 || llStatus < 0 || llSize < 0 || llStored < 0 || llExpires < 0)
+		return false;
+
+	entry.ulStatus = static_cast<unsigned long>(llStatus);
+	entry.ullSize = static_cast<unsigned long long>(llSize);
+	entry.llStored = llStored;
+	entry.llExpires = llExpires;
+	entry.llLastAccess = llStored;
+	return true;
+}
+
+void CRelayCache::loadIndex()
+{
+	std::error_code ec;
+	std::vector<std::filesystem::path> invalids;
+
+	for (auto it = std::filesystem::recursive_directory_iterator(m_Directory / "index", ec); it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+	{
+		if (ec)
+			break;
+		if (!it->is_regular_file())
+			continue;
+
+		CCacheEntry entry;
+		const std::filesystem::path& file = it->path();
+		std::error_code ecSize;
+		if (file.extension() == TempExtension || !readIndex(file, entry) ||
+			std::filesystem::file_size(objectPath(entry.strObject), ecSize) != entry.ullSize || ecSize)
+		{
+			invalids.push_back(file);
+			continue;
+		}
+
+		if (!m_Objects[entry.strObject]++)
+			m_ullSize += entry.ullSize;
+
+		m_Entries.emplace(file.filename().string(), entry);
+	}
+
+	// Objects left by an interrupted store or an eviction that could not remove them
+	for (auto it = std::filesystem::recursive_directory_iterator(m_Directory / "objects", ec); it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+	{
+		if (ec)
+			break;
+		if (it->is_regular_file() && !m_Objects.count(it->path().filename().string()))
+			invalids.push_back(it->path());
+	}
+
+	for (const std::filesystem::path& invalid : invalids)
+		std::filesystem::remove(invalid, ec);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	evict();
+	m_Metrics.cacheEntries = static_cast<long long>(m_Entries.size());
+	m_Metrics.cacheBytes = static_cast<long long>(m_ullSize);
+}
+
+void CRelayCache::removeEntry(const std::string& strKey)
+{
+	auto it = m_Entries.find(strKey);
+	if (it == m_Entries.end())
+		return;
+
+	std::error_code ec;
+	std::filesystem::remove(indexPath(strKey), ec);
+
+	auto itObject = m_Objects.find(it->second.strObject);
+	if (itObject != m_Objects.end() && !--itObject->second)
+	{
+		m_ullSize -= it->second.ullSize;
+		std::filesystem::remove(objectPath(it->second.strObject), ec);
+		m_Objects.erase(itObject);
+	}
+
+	m_Entries.erase(it);
+	m_Metrics.cacheEvictions++;
+}
+
+void CRelayCache::evict()
+{
+	if (m_ullSize <= m_ullMaxSize)
+		return;
+
+	// Least recently used first, down to 90% to not evict on every store
+	std::vector<std::pair<long long, std::string>> lru;
+	lru.reserve(m_Entries.size());
+	for (const auto& entry : m_Entries)
+		lru.emplace_back(entry.second.llLastAccess, entry.first);
+
+	std::sort(lru.begin(), lru.end());
+
+	unsigned long long ullTarget = m_ullMaxSize / 10 * 9;
+	for (auto it = lru.begin(); it != lru.end() && m_ullSize > ullTarget; ++it)
+		removeEntry(it->second);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : On-disk content-addressed cache of the relay responses
+ */
+
+#ifndef RELAY_CACHE_H_INCLUDED
+#define RELAY_CACHE_H_INCLUDED
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "UpstreamPool.h"
+
+class CRelayMetrics;
+
+struct CCacheEntry
+{
+	std::string strUrl;
+	std::string strObject; // SHA-256 of the body, name of the object file
+	unsigned long ulStatus = 0;
+	std::string strContentType;
+	std::string strCacheControl;
+	std::string strETag;
+	std::string strLastModified;
+	std::string strExpires;
+	long long llStored = 0; // Response time minus its Age, seconds since epoch
+	long long llExpires = 0; // End of the freshness lifetime
+	bool bMustRevalidate = false;
+	unsigned long long ullSize = 0;
+	long long llLastAccess = 0;
+
+	bool fresh(long long llNow) const { return llNow < llExpires; }
+	long long age(long long llNow) const { return llNow > llStored ? llNow - llStored : 0; }
+	bool hasValidators() const { return !strETag.empty() || !strLastModified.empty(); }
+};
+
+// Bodies are stored once under objects/ by their hash, so identical tiles share a file.
+// The index/ entries map a URL hash to its object and HTTP caching metadata.
+class CRelayCache
+{
+public:
+	CRelayCache(const std::filesystem::path& directory, unsigned long long ullMaxSize, long long llDefaultTtl, CRelayMetrics& metrics);
+
+	bool lookup(const std::string& strUrl, CCacheEntry& entry);
+	bool load(const CCacheEntry& entry, std::string& strBody) const;
+
+	// Returns false when the response must not be cached
+	bool store(const std::string& strUrl, const CUpstreamResponse& response, long long llNow);
+	// Updates the metadata of an entry after a 304 Not Modified
+	bool refresh(const std::string& strUrl, const CUpstreamResponse& response, long long llNow, CCacheEntry& entry);
+
+	static long long now();
+	static long long parseHttpDate(const std::string& strDate); // IMF-fixdate, -1 if invalid
+
+private:
+	void updateFreshness(const CUpstreamResponse::headers_t& headers, long long llNow, CCacheEntry& entry) const;
+	void writeIndex(const std::string& strKey, const CCacheEntry& entry) const;
+	bool readIndex(const std::filesystem::path& file, CCacheEntry& entry) const;
+	void removeEntry(const std::string& strKey);
+	void evict();
+	void loadIndex();
+
+	std::filesystem::path objectPath(const std::string& strHash) const;
+	std::filesystem::path indexPath(const std::string& strHash) const;
+
+	CRelayCache(const CRelayCache&) = delete;
+	CRelayCache& operator=(const CRelayCache&) = delete;
+
+private:
+	std::filesystem::path m_Directory;
+	unsigned long long m_ullMaxSize;
+	long long m_llDefaultTtl;
+	CRelayMetrics& m_Metrics;
+
+	std::mutex m_Mutex;
+	std::unordered_map<std::string, CCacheEntry> m_Entries; // By URL hash
+	std::unordered_map<std::string, size_t> m_Objects; // References by object hash
+	unsigned long long m_ullSize;
+};
+
+#endif // !RELAY_CACHE_H_INCLUDED
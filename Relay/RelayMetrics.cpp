@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Prometheus style counters of the relay
+ */
+
+#include "RelayMetrics.h"
+
+namespace
+{
+	template<typename T>
+	void WriteMetric(std::ostream& os, const char* name, const char* type, const char* help, const T& value)
+	{
+		os << "# HELP " << name << ' ' << help << '\n';
+		os << "# TYPE " << name << ' ' << type << '\n';
+		os << name << ' ' << value.load(std::memory_order_relaxed) << '\n';
+	}
+}
+
+void CRelayMetrics::write(std::ostream& os) const
+{
+	WriteMetric(os, "relay_requests_total", "counter", "Relay requests received.", requests);
+	WriteMetric(os, "relay_cache_hits_total", "counter", "Responses served fresh from the cache.", cacheHits);
+	WriteMetric(os, "relay_cache_misses_total", "counter", "Responses fetched from upstream.", cacheMisses);
+	WriteMetric(os, "relay_cache_revalidated_total", "counter", "Cached responses revalidated by upstream.", cacheRevalidated);
+	WriteMetric(os, "relay_cache_stale_total", "counter", "Stale responses served because upstream failed.", cacheStale);
+	WriteMetric(os, "relay_cache_stores_total", "counter", "Responses written to the cache.", cacheStores);
+	WriteMetric(os, "relay_cache_evictions_total", "counter", "Cache entries evicted.", cacheEvictions);
+	WriteMetric(os, "relay_coalesced_total", "counter", "Requests served by an identical in-flight request.", coalesced);
+	WriteMetric(os, "relay_upstream_requests_total", "counter", "Requests sent upstream.", upstreamRequests);
+	WriteMetric(os, "relay_upstream_errors_total", "counter", "Upstream requests that failed.", upstreamErrors);
+	WriteMetric(os, "relay_upstream_bytes_total", "counter", "Body bytes received from upstream.", upstreamBytes);
+	WriteMetric(os, "relay_upstream_sessions_opened_total", "counter", "Upstream sessions opened.", upstreamSessionsOpened);
+	WriteMetric(os, "relay_upstream_sessions_reused_total", "counter", "Upstream requests sent on a pooled session.", upstreamSessionsReused);
+	WriteMetric(os, "relay_response_bytes_total", "counter", "Body bytes sent to clients.", responseBytes);
+	WriteMetric(os, "relay_inflight_requests", "gauge", "Relay requests being processed.", inflight);
+	WriteMetric(os, "relay_cache_entries", "gauge", "Entries in the cache index.", cacheEntries);
+	WriteMetric(os, "relay_cache_bytes", "gauge", "Bytes of cached bodies.", cacheBytes);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Prometheus style counters of the relay
+ */
+
+#ifndef RELAY_METRICS_H_INCLUDED
+#define RELAY_METRICS_H_INCLUDED
+
+#include <atomic>
+#include <ostream>
+
+class CRelayMetrics
+{
+public:
+	typedef std::atomic<unsigned long long> counter_t;
+	typedef std::atomic<long long> gauge_t;
+
+	counter_t requests{ 0 }; // Relay requests received
+	counter_t cacheHits{ 0 }; // Served fresh from the cache
+	counter_t cacheMisses{ 0 }; // Fetched from upstream
+	counter_t cacheRevalidated{ 0 }; // Upstream answered 304 Not Modified
+	counter_t cacheStale{ 0 }; // Served stale because upstream failed
+	counter_t cacheStores{ 0 };
+	counter_t cacheEvictions{ 0 };
+	counter_t coalesced{ 0 }; // Waited for an identical in-flight request
+	counter_t upstreamRequests{ 0 };
+	counter_t upstreamErrors{ 0 };
+	counter_t upstreamBytes{ 0 };
+	counter_t upstreamSessionsOpened{ 0 };
+	counter_t upstreamSessionsReused{ 0 };
+	counter_t responseBytes{ 0 };
+
+	gauge_t inflight{ 0 };
+	gauge_t cacheEntries{ 0 };
+	gauge_t cacheBytes{ 0 };
+
+	void write(std::ostream& os) const; // Text exposition format
+};
+
+#endif // !RELAY_METRICS_H_INCLUDED
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Offline check of the relay against its own stub upstream
+ */
+
+#include "RelaySelfTest.h"
+#include "RelayServer.h"
+#include <ws2tcpip.h>
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "UpstreamPool.h"
+#include "stdx/guard.h"
+
+namespace
+{
+	struct CReply
+	{
+		unsigned long ulStatus = 0;
+		CUpstreamResponse::headers_t headers; // Lower case names
+		std::string strBody;
+
+		std::string header(const std::string& strName) const
+		{
+			auto it = headers.find(strName);
+			return it != headers.end() ? it->second : std::string();
+		}
+	};
+
+	// One request per connection, the body ends with it
+	CReply Get(unsigned short usPort, const std::string& strTarget, const std::string& strHeaders = std::string())
+	{
+		SOCKET hSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (hSocket == INVALID_SOCKET)
+			throw std::system_error(WSAGetLastError(), std::system_category(), "socket");
+
+		stdx::function_guard closeGuard([&]() { closesocket(hSocket); });
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(usPort);
+		inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+		if (connect(hSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR)
+			throw std::system_error(WSAGetLastError(), std::system_category(), "connect");
+
+		std::string strRequest = "GET " + strTarget + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n" + strHeaders + "\r\n";
+		if (send(hSocket, strRequest.data(), static_cast<int>(strRequest.size()), 0) != static_cast<int>(strRequest.size()))
+			throw std::system_error(WSAGetLastError(), std::system_category(), "send");
+
+		std::string strResponse;
+		char buffer[4096];
+		int iReceived;
+		while ((iReceived = recv(hSocket, buffer, sizeof(buffer), 0)) > 0)
+			strResponse.append(buffer, iReceived);
+
+		size_t ulHeaderEnd = strResponse.find("\r\n\r\n");
+		if (strResponse.compare(0, 9, "HTTP/1.1 ") || ulHeaderEnd == std::string::npos)
+			throw std::runtime_error("Bad response to " + strTarget);
+
+		CReply reply;
+		reply.ulStatus = std::stoul(strResponse.substr(9, 3));
+		CUpstreamResponse::parseHeaders(strResponse.substr(0, ulHeaderEnd), reply.headers);
+		reply.strBody = strResponse.substr(ulHeaderEnd + 4);
+		return reply;
+	}
+
+	// Value of a counter or gauge in the /metrics text
+	unsigned long long Metric(unsigned short usPort, const std::string& strName)
+	{
+		std::istringstream iss(Get(usPort, "/metrics").strBody);
+		std::string strLine;
+		while (std::getline(iss, strLine))
+		{
+			if (!strLine.compare(0, strName.size() + 1, strName + ' '))
+				return std::stoull(strLine.substr(strName.size() + 1));
+		}
+
+		throw std::runtime_error("Missing metric " + strName);
+	}
+
+	class CServerThread
+	{
+	public:
+		explicit CServerThread(const CRelayOptions& options) :
+			m_Server(options),
+			m_usPort(options.usPort)
+		{
+			m_Future = std::async(std::launch::async, &CRelayServer::run, &m_Server);
+		}
+
+		~CServerThread()
+		{
+			m_Server.stop();
+		}
+
+		// run() listens asynchronously, wait for it
+		void waitReady()
+		{
+			for (int i = 0; ; ++i)
+			{
+				if (m_Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+					m_Future.get(); // Rethrows why run() failed
+
+				try
+				{
+					Get(m_usPort, "/metrics");
+					return;
+				}
+				catch (const std::system_error&)
+				{
+					if (i == 50)
+						throw;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+		}
+
+	private:
+		CRelayServer m_Server;
+		unsigned short m_usPort;
+		std::future<void> m_Future;
+	};
+
+	class CChecker
+	{
+	public:
+		void operator()(bool bPassed, const std::string& strCheck)
+		{
+			std::cout << (bPassed ? "PASS " : "FAIL ") << strCheck << std::endl;
+			if (!bPassed)
+				m_iFailed++;
+		}
+
+		int failed() const { return m_iFailed; }
+
+	private:
+		int m_iFailed = 0;
+	};
+}
+
+int RunSelfTest(const CRelayOptions& options)
+{
+	WSADATA wsaData;
+	int iError = WSAStartup(MAKEWORD(2, 2), &wsaData);
+	if (iError)
+		throw std::system_error(iError, std::system_category(), "WSAStartup");
+
+	stdx::function_guard cleanupGuard([]() { WSACleanup(); });
+
+	CRelayOptions stubOptions;
+	stubOptions.strBind = "127.0.0.1";
+	stubOptions.usPort = options.usPort + 1;
+	stubOptions.bStub = true;
+
+	CRelayOptions relayOptions = options;
+	relayOptions.strBind = "127.0.0.1";
+	relayOptions.bStub = false;
+	relayOptions.strUpstream = "127.0.0.1:" + std::to_string(stubOptions.usPort);
+	relayOptions.cacheDirectory = std::filesystem::temp_directory_path() / ("RelaySelfTest" + std::to_string(options.usPort));
+
+	std::error_code ec;
+	std::filesystem::remove_all(relayOptions.cacheDirectory, ec);
+	stdx::function_guard cacheGuard([&]() { std::filesystem::remove_all(relayOptions.cacheDirectory, ec); });
+
+	unsigned short usRelay = relayOptions.usPort;
+	unsigned short usStub = stubOptions.usPort;
+	CChecker check;
+	{
+		CServerThread stub(stubOptions);
+		CServerThread relay(relayOptions);
+		stub.waitReady();
+		relay.waitReady();
+
+		CReply reply = Get(usRelay, "/?url=http://tiles.test/a?id=1&max-age=60");
+		check(reply.ulStatus == 200 && reply.header("x-cache") == "MISS", "First request is fetched upstream");
+		check(reply.strBody == "stub tiles.test/a?id=1&max-age=60\n", "Upstream receives the relayed host and query");
+
+		reply = Get(usRelay, "/?url=http://tiles.test/a?id=1&max-age=60");
+		check(reply.header("x-cache") == "HIT" && reply.strBody == "stub tiles.test/a?id=1&max-age=60\n", "Fresh response is served from the cache");
+
+		Get(usRelay, "/?url=http://tiles.test/b?id=2&max-age=0");
+		reply = Get(usRelay, "/?url=http://tiles.test/b?id=2&max-age=0");
+		check(reply.header("x-cache") == "REVALIDATED" && reply.strBody == "stub tiles.test/b?id=2&max-age=0\n", "Expired response is revalidated");
+
+		reply = Get(usRelay, "/?url=http://tiles.test/missing?id=3&status=404");
+		check(reply.ulStatus == 404, "Upstream status is relayed");
+
+		// Identical requests in flight share the upstream request
+		unsigned long long ullBefore = Metric(usStub, "relay_requests_total");
+		std::vector<std::thread> clients;
+		std::vector<CReply> replies(4);
+		for (CReply& concurrent : replies)
+			clients.emplace_back([&]() { concurrent = Get(usRelay, "/?url=http://tiles.test/slow?id=4&max-age=60&delay=500"); });
+		for (std::thread& client : clients)
+			client.join();
+
+		bool bSameBody = std::all_of(replies.begin(), replies.end(), [](const CReply& r) { return r.strBody == "stub tiles.test/slow?id=4&max-age=60&delay=500\n"; });
+		check(bSameBody && Metric(usStub, "relay_requests_total") - ullBefore == 1, "Concurrent misses are coalesced");
+		check(Metric(usRelay, "relay_coalesced_total") == 3, "Coalesced requests are counted");
+
+		reply = Get(usStub, "/?max-age=1%0D%0AX-Injected:%201");
+		check(reply.header("cache-control").empty() && reply.header("x-injected").empty(), "Stub ignores a max-age that is not a number");
+
+		reply = Get(usRelay, "/", "X-Check: <script>\r\n");
+		check(reply.strBody.find("<script>") == std::string::npos && reply.strBody.find("&lt;script&gt;") != std::string::npos, "Diagnostic page escapes the request headers");
+	}
+
+	std::cout << (check.failed() ? "Self test failed" : "Self test passed") << std::endl;
+	return check.failed();
+}
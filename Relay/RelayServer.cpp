@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : HTTP front end of the relay, same query contract as web/src/relay.php
+ */
+
+#include "RelayServer.h"
+#include <ws2tcpip.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include "RelayCache.h"
+#include "UpstreamPool.h"
+#include "stdx/guard.h"
+#include "stdx/string_helper.h"
+#if defined(_DEBUG) || defined(FORCE_LOG)
+#include <iostream>
+#endif
+
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif // _MSC_VER
+
+namespace
+{
+	constexpr size_t MaxHeaderSize = 64 * 1024;
+	constexpr size_t MaxBodySize = 1024 * 1024;
+	constexpr DWORD IdleTimeout = 5 * 1000; // Wait for the next request of a connection, ms
+	constexpr size_t MaxRequestsPerConnection = 100;
+	constexpr auto MaxConnectionTime = std::chrono::seconds(60); // A worker serves other clients past this
+	constexpr DWORD AcceptBackoff = 1000; // Longest wait after failed accepts, ms
+	constexpr const char* StubLastModified = "Mon, 01 Jan 2024 00:00:00 GMT";
+
+	std::system_error SocketError(const char* what)
+	{
+		return std::system_error(WSAGetLastError(), std::system_category(), what);
+	}
+
+	bool SendAll(SOCKET hSocket, const char* pData, size_t ulSize)
+	{
+		while (ulSize)
+		{
+			int iSent = send(hSocket, pData, static_cast<int>(std::min<size_t>(ulSize, 1 << 20)), 0);
+			if (iSent <= 0)
+				return false;
+
+			pData += iSent;
+			ulSize -= iSent;
+		}
+
+		return true;
+	}
+
+	bool IsNumber(const std::string& strValue, size_t ulMaxDigits)
+	{
+		return !strValue.empty() && strValue.size() <= ulMaxDigits && strValue.find_first_not_of("0123456789") == std::string::npos;
+	}
+
+	std::string EscapeHtml(const std::string& strValue)
+	{
+		std::string strResult;
+		strResult.reserve(strValue.size());
+
+		for (char c : strValue)
+		{
+			switch (c)
+			{
+			case '&': strResult += "&amp;"; break;
+			case '<': strResult += "&lt;"; break;
+			case '>': strResult += "&gt;"; break;
+			case '"': strResult += "&quot;"; break;
+			case '\'': strResult += "&#39;"; break;
+			default: strResult += c; break;
+			}
+		}
+
+		return strResult;
+	}
+
+	const char* ReasonPhrase(unsigned long ulStatus)
+	{
+		switch (ulStatus)
+		{
+		case 200: return "OK";
+		case 203: return "Non-Authoritative Information";
+		case 204: return "No Content";
+		case 300: return "Multiple Choices";
+		case 301: return "Moved Permanently";
+		case 302: return "Found";
+		case 304: return "Not Modified";
+		case 400: return "Bad Request";
+		case 403: return "Forbidden";
+		case 404: return "Not Found";
+		case 410: return "Gone";
+		case 500: return "Internal Server Error";
+		case 502: return "Bad Gateway";
+		case 503: return "Service Unavailable";
+		default: return "Unknown";
+		}
+	}
+
+	int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return -1;
+	}
+
+	// application/x-www-form-urlencoded, as PHP decodes $_GET
+	std::string DecodeComponent(const std::string& strValue)
+	{
+		std::string strResult;
+		strResult.reserve(strValue.size());
+
+		for (size_t i = 0; i < strValue.size(); ++i)
+		{
+			if (strValue[i] == '+')
+			{
+				strResult += ' ';
+			}
+			else if (strValue[i] == '%' && i + 2 < strValue.size() && HexValue(strValue[i + 1]) >= 0 && HexValue(strValue[i + 2]) >= 0)
+			{
+				strResult += static_cast<char>(HexValue(strValue[i + 1]) * 16 + HexValue(strValue[i + 2]));
+				i += 2;
+			}
+			else
+			{
+				strResult += strValue[i];
+			}
+		}
+
+		return strResult;
+	}
+
+	// The decoded values are sent as is by relay.php, only escape what cannot go on a request line
+	std::string EscapeUnsafe(const std::string& strUrl)
+	{
+		static constexpr char digits[] = "0123456789ABCDEF";
+		static const std::string strUnsafe("\"<>\\^`{|}");
+		std::string strResult;
+		strResult.reserve(strUrl.size());
+
+		for (char c : strUrl)
+		{
+			unsigned char uc = static_cast<unsigned char>(c);
+			if (uc <= 0x20 || uc >= 0x7F || strUnsafe.find(c) != std::string::npos)
+			{
+				strResult += '%';
+				strResult += digits[uc >> 4];
+				strResult += digits[uc & 0x0F];
+			}
+			else
+			{
+				strResult += c;
+			}
+		}
+
+		return strResult;
+	}
+
+	void ParseQuery(const std::string& strQuery, std::vector<std::pair<std::string, std::string>>& params)
+	{
+		stdx::string_helper::vector parts;
+		stdx::string_helper::split(strQuery, parts, stdx::find_first("&"), false);
+
+		for (const std::string& strPart : parts)
+		{
+			size_t ulEqual = strPart.find('=');
+			if (ulEqual == std::string::npos)
+				params.emplace_back(DecodeComponent(strPart), std::string());
+			else
+				params.emplace_back(DecodeComponent(strPart.substr(0, ulEqual)), DecodeComponent(strPart.substr(ulEqual + 1)));
+		}
+	}
+
+	const std::string* FindParam(const std::vector<std::pair<std::string, std::string>>& params, const std::string& strName)
+	{
+		// PHP keeps the last value of a repeated name
+		for (auto it = params.rbegin(); it != params.rend(); ++it)
+		{
+			if (it->first == strName)
+				return &it->second;
+		}
+
+		return nullptr;
+	}
+
+	std::string FindHeader(const std::map<std::string, std::string>& headers, const std::string& strName)
+	{
+		auto it = headers.find(strName);
+		return it != headers.end() ? it->second : std::string();
+	}
+
+	void AddHeader(std::vector<std::pair<std::string, std::string>>& headers, const char* pszName, const std::string& strValue)
+	{
+		if (!strValue.empty())
+			headers.emplace_back(pszName, strValue);
+	}
+}
+
+CRelayServer::CRelayServer(const CRelayOptions& options) :
+	m_Options(options),
+	m_hListen(INVALID_SOCKET),
+	m_bRunning(false)
+{
+	if (!m_Options.ulThreads)
+		m_Options.ulThreads = std::max(std::thread::hardware_concurrency(), 1U) * 4;
+
+	if (!m_Options.bStub)
+	{
+		m_pCache = std::make_unique<CRelayCache>(m_Options.cacheDirectory, m_Options.ullCacheSize, m_Options.llDefaultTtl, m_Metrics);
+		m_pUpstream = std::make_unique<CUpstreamPool>(m_Metrics, m_Options.ulMaxPerOrigin, m_Options.strUpstream);
+	}
+}
+
+CRelayServer::~CRelayServer()
+{
+	stop();
+}
+
+void CRelayServer::run()
+{
+	WSADATA wsaData;
+	int iError = WSAStartup(MAKEWORD(2, 2), &wsaData);
+	if (iError)
+		throw std::system_error(iError, std::system_category(), "WSAStartup");
+
+	stdx::function_guard cleanupGuard([]() { WSACleanup(); });
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(m_Options.usPort);
+	if (inet_pton(AF_INET, m_Options.strBind.c_str(), &address.sin_addr) != 1)
+		throw std::invalid_argument("Invalid bind address: " + m_Options.strBind);
+
+	m_hListen = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (m_hListen == INVALID_SOCKET)
+		throw SocketError("socket");
+
+	if (bind(m_hListen, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR || listen(m_hListen, SOMAXCONN) == SOCKET_ERROR)
+	{
+		std::system_error error = SocketError("bind");
+		closesocket(m_hListen);
+		m_hListen = INVALID_SOCKET;
+		throw error;
+	}
+
+	m_bRunning = true;
+
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < m_Options.ulThreads; ++i)
+		workers.emplace_back(&CRelayServer::worker, this);
+
+	DWORD dwBackoff = 0;
+	while (m_bRunning)
+	{
+		SOCKET hClient = accept(m_hListen, nullptr, nullptr);
+		if (hClient == INVALID_SOCKET)
+		{
+			// Closed by stop(), or out of resources: do not spin until it recovers
+			if (m_bRunning)
+			{
+				dwBackoff = std::min(dwBackoff ? dwBackoff * 2 : 10, AcceptBackoff);
+				std::this_thread::sleep_for(std::chrono::milliseconds(dwBackoff));
+			}
+			continue;
+		}
+
+		dwBackoff = 0;
+
+		DWORD dwTimeout = IdleTimeout;
+		BOOL bNoDelay = TRUE;
+		setsockopt(hClient, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&dwTimeout), sizeof(dwTimeout));
+		setsockopt(hClient, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&bNoDelay), sizeof(bNoDelay));
+		m_Connections.push_back(hClient);
+	}
+
+	for (size_t i = 0; i < workers.size(); ++i)
+		m_Connections.push_back(INVALID_SOCKET);
+
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+void CRelayServer::stop()
+{
+	if (m_bRunning.exchange(false) && m_hListen != INVALID_SOCKET)
+	{
+		closesocket(m_hListen);
+		m_hListen = INVALID_SOCKET;
+	}
+}
+
+void CRelayServer::worker()
+{
+	for (;;)
+	{
+		SOCKET hSocket;
+		if (m_Connections.pop_front(hSocket, std::chrono::seconds(1)) == stdx::cq_status::timeout)
+			continue;
+
+		if (hSocket == INVALID_SOCKET) // Pushed by run() once stopped
+			break;
+
+		serveConnection(hSocket);
+	}
+}
+
+void CRelayServer::serveConnection(SOCKET hSocket)
+{
+	// A worker is held by its connection, bound what an idle or chatty client can keep
+	auto tpDeadline = std::chrono::steady_clock::now() + MaxConnectionTime;
+	std::string strBuffer;
+	CRequest request;
+
+	for (size_t ulRequests = 1; m_bRunning && readRequest(hSocket, strBuffer, request, tpDeadline); ++ulRequests)
+	{
+		bool bKeepAlive = request.strVersion == "HTTP/1.1" ?
+			FindHeader(request.headers, "connection") != "close" :
+			FindHeader(request.headers, "connection") == "keep-alive";
+
+		// Hand the worker over when clients are waiting for one
+		if (ulRequests >= MaxRequestsPerConnection || std::chrono::steady_clock::now() >= tpDeadline || !m_Connections.empty())
+			bKeepAlive = false;
+
+		CResponse response;
+		try
+		{
+			handle(request, response);
+		}
+		catch (const std::exception& e)
+		{
+			response = CResponse();
+			response.ulStatus = 500;
+			response.headers.emplace_back("Content-Type", "text/plain");
+			response.strBody = e.what();
+		}
+
+#if defined(_DEBUG) || defined(FORCE_LOG)
+		std::clog << request.strMethod << ' ' << request.strTarget << ' ' << response.ulStatus << ' ' << response.strBody.size() << std::endl;
+#endif
+
+		if (!writeResponse(hSocket, request, response, bKeepAlive) || !bKeepAlive)
+			break;
+	}
+
+	shutdown(hSocket, SD_BOTH);
+	closesocket(hSocket);
+}
+
+bool CRelayServer::readRequest(SOCKET hSocket, std::string& strBuffer, CRequest& request, std::chrono::steady_clock::time_point tpDeadline) const
+{
+	char buffer[4096];
+	size_t ulHeaderEnd;
+
+	while ((ulHeaderEnd = strBuffer.find("\r\n\r\n")) == std::string::npos)
+	{
+		if (strBuffer.size() > MaxHeaderSize || std::chrono::steady_clock::now() >= tpDeadline)
+			return false;
+
+		int iReceived = recv(hSocket, buffer, sizeof(buffer), 0);
+		if (iReceived <= 0)
+			return false;
+
+		strBuffer.append(buffer, iReceived);
+	}
+
+	std::istringstream iss(strBuffer.substr(0, ulHeaderEnd + 2));
+	strBuffer.erase(0, ulHeaderEnd + 4);
+
+	std::string strLine;
+	std::getline(iss, strLine);
+	std::istringstream issRequestLine(strLine);
+	request = CRequest();
+	issRequestLine >> request.strMethod >> request.strTarget >> request.strVersion;
+	if (request.strMethod.empty() || request.strTarget.empty() || request.strVersion.compare(0, 5, "HTTP/"))
+		return false;
+
+	while (std::getline(iss, strLine))
+	{
+		size_t ulColon = strLine.find(':');
+		if (ulColon == std::string::npos)
+			continue;
+
+		std::string strName = strLine.substr(0, ulColon);
+		std::string strValue = strLine.substr(ulColon + 1);
+		stdx::string_helper::tolower(strName);
+		stdx::string_helper::trimleft(strValue, " \t");
+		stdx::string_helper::trimright(strValue, " \t\r");
+		request.headers[strName] = strValue;
+	}
+
+	// relay.php only reads the query, a body is received and dropped
+	std::string strLength = FindHeader(request.headers, "content-length");
+	if (!strLength.empty())
+	{
+		if (!IsNumber(strLength, 7))
+			return false;
+
+		size_t ulLength = std::stoul(strLength);
+		if (ulLength > MaxBodySize)
+			return false;
+
+		while (strBuffer.size() < ulLength)
+		{
+			if (std::chrono::steady_clock::now() >= tpDeadline)
+				return false;
+
+			int iReceived = recv(hSocket, buffer, sizeof(buffer), 0);
+			if (iReceived <= 0)
+				return false;
+
+			strBuffer.append(buffer, iReceived);
+		}
+
+		strBuffer.erase(0, ulLength);
+	}
+	else if (!FindHeader(request.headers, "transfer-encoding").empty())
+	{
+		return false; // Chunked uploads are not supported
+	}
+
+	return true;
+}
+
+bool CRelayServer::writeResponse(SOCKET hSocket, const CRequest& request, const CResponse& response, bool bKeepAlive) const
+{
+	std::ostringstream oss;
+	oss << "HTTP/1.1 " << response.ulStatus << ' ' << ReasonPhrase(response.ulStatus) << "\r\n";
+	for (const auto& header : response.headers)
+		oss << header.first << ": " << header.second << "\r\n";
+
+	bool bBody = response.ulStatus != 304 && response.ulStatus != 204 && request.strMethod != "HEAD";
+	if (response.ulStatus != 304 && response.ulStatus != 204)
+		oss << "Content-Length: " << response.strBody.size() << "\r\n";
+	oss << "Connection: " << (bKeepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+
+	std::string strHeader = oss.str();
+	if (!SendAll(hSocket, strHeader.data(), strHeader.size()))
+		return false;
+
+	if (!bBody)
+		return true;
+
+	m_Metrics.responseBytes += response.strBody.size();
+	return SendAll(hSocket, response.strBody.data(), response.strBody.size());
+}
+
+void CRelayServer::handle(const CRequest& request, CResponse& response)
+{
+	size_t ulQuery = request.strTarget.find('?');
+	std::string strPath = request.strTarget.substr(0, ulQuery);
+
+	params_t params;
+	if (ulQuery != std::string::npos)
+		ParseQuery(request.strTarget.substr(ulQuery + 1), params);
+
+	if (strPath == "/metrics")
+		return handleMetrics(response);
+
+	if (m_Options.bStub)
+		return handleStub(request, params, response);
+
+	// Same resolution of the referrer as relay.php
+	const std::string* pRef = FindParam(params, "ref");
+	const std::string* pHost = FindParam(params, "host");
+	std::string strReferrer = pRef ? *pRef : std::string();
+	std::string strHost = pHost ? *pHost : std::string();
+
+	if (strReferrer.empty() && !strHost.empty())
+		strReferrer = "http://" + strHost;
+	if (strReferrer.empty())
+		strReferrer = FindHeader(request.headers, "referer");
+	if (strHost.empty())
+		strHost = FindHeader(request.headers, "host");
+
+	const std::string* pUrl = FindParam(params, "url");
+	if (!pUrl)
+		return handleInfo(request, strHost, strReferrer, response);
+
+	// The query parameters of the relayed URL come unescaped as our own
+	std::string strUrl = *pUrl;
+	for (const auto& param : params)
+	{
+		if (param.first != "url" && param.first != "ref" && param.first != "host")
+			strUrl += '&' + param.first + '=' + param.second;
+	}
+
+	handleRelay(EscapeUnsafe(strUrl), strReferrer, response);
+}
+
+void CRelayServer::handleRelay(const std::string& strUrl, const std::string& strReferrer, CResponse& response)
+{
+	m_Metrics.requests++;
+	m_Metrics.inflight++;
+	stdx::function_guard inflightGuard([&]() { m_Metrics.inflight--; });
+
+	CCacheEntry entry;
+	std::string strBody;
+	bool bCached = m_pCache->lookup(strUrl, entry);
+	if (bCached && entry.fresh(CRelayCache::now()) && m_pCache->load(entry, strBody))
+	{
+		m_Metrics.cacheHits++;
+		response.ulStatus = entry.ulStatus;
+		AddHeader(response.headers, "Content-Type", entry.strContentType);
+		AddHeader(response.headers, "Cache-Control", entry.strCacheControl);
+		AddHeader(response.headers, "ETag", entry.strETag);
+		AddHeader(response.headers, "Last-Modified", entry.strLastModified);
+		AddHeader(response.headers, "Age", std::to_string(entry.age(CRelayCache::now())));
+		AddHeader(response.headers, "X-Cache", "HIT");
+		response.strBody = std::move(strBody);
+		return;
+	}
+
+	std::shared_ptr<CFlight> pFlight;
+	bool bLeader = false;
+	{
+		std::lock_guard<std::mutex> lock(m_FlightsMutex);
+		std::shared_ptr<CFlight>& pInFlight = m_Flights[strUrl];
+		if (!pInFlight)
+		{
+			pInFlight = std::make_shared<CFlight>();
+			bLeader = true;
+		}
+
+		pFlight = pInFlight;
+	}
+
+	if (!bLeader)
+	{
+		m_Metrics.coalesced++;
+		std::unique_lock<std::mutex> lock(pFlight->mutex);
+		pFlight->cv.wait(lock, [&]() { return pFlight->bDone; });
+		response = pFlight->response;
+		return;
+	}
+
+	// Whatever happens, the waiting clients get the leader response
+	stdx::function_guard flightGuard([&]()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_FlightsMutex);
+				m_Flights.erase(strUrl);
+			}
+
+			std::lock_guard<std::mutex> lock(pFlight->mutex);
+			pFlight->response = response;
+			pFlight->bDone = true;
+			pFlight->cv.notify_all();
+		});
+
+	fetchUpstream(strUrl, strReferrer, bCached ? &entry : nullptr, response);
+}
+
+void CRelayServer::fetchUpstream(const std::string& strUrl, const std::string& strReferrer, const CCacheEntry* pEntry, CResponse& response)
+{
+	std::map<std::string, std::string> conditionals;
+	if (pEntry && !pEntry->strETag.empty())
+		conditionals["If-None-Match"] = pEntry->strETag;
+	if (pEntry && !pEntry->strLastModified.empty())
+		conditionals["If-Modified-Since"] = pEntry->strLastModified;
+
+	CUpstreamResponse upstream;
+	std::string strBody;
+	try
+	{
+		upstream = m_pUpstream->fetch(strUrl, strReferrer, conditionals);
+	}
+	catch (const std::exception& e)
+	{
+		if (pEntry && !pEntry->bMustRevalidate && m_pCache->load(*pEntry, strBody))
+		{
+			m_Metrics.cacheStale++;
+			response.ulStatus = pEntry->ulStatus;
+			AddHeader(response.headers, "Content-Type", pEntry->strContentType);
+			AddHeader(response.headers, "Age", std::to_string(pEntry->age(CRelayCache::now())));
+			AddHeader(response.headers, "X-Cache", "STALE");
+			response.strBody = std::move(strBody);
+			return;
+		}
+
+		response.ulStatus = 502;
+		response.headers.emplace_back("Content-Type", "text/plain");
+		response.strBody = e.what();
+		return;
+	}
+
+	long long llNow = CRelayCache::now();
+	if (upstream.ulStatus == 304 && pEntry)
+	{
+		CCacheEntry refreshed;
+		if (m_pCache->refresh(strUrl, upstream, llNow, refreshed) && m_pCache->load(refreshed, strBody))
+		{
+			m_Metrics.cacheRevalidated++;
+			response.ulStatus = refreshed.ulStatus;
+			AddHeader(response.headers, "Content-Type", refreshed.strContentType);
+			AddHeader(response.headers, "Cache-Control", refreshed.strCacheControl);
+			AddHeader(response.headers, "ETag", refreshed.strETag);
+			AddHeader(response.headers, "Last-Modified", refreshed.strLastModified);
+			AddHeader(response.headers, "Age", std::to_string(refreshed.age(llNow)));
+			AddHeader(response.headers, "X-Cache", "REVALIDATED");
+			response.strBody = std::move(strBody);
+			return;
+		}
+
+		// The cached body is gone, ask again without validators
+		return fetchUpstream(strUrl, strReferrer, nullptr, response);
+	}
+
+	m_Metrics.cacheMisses++;
+	try
+	{
+		m_pCache->store(strUrl, upstream, llNow);
+	}
+	catch (const std::exception&)
+	{
+		// A cache write failure does not fail the request
+	}
+
+	response.ulStatus = upstream.ulStatus;
+	AddHeader(response.headers, "Content-Type", upstream.header("content-type"));
+	AddHeader(response.headers, "Cache-Control", upstream.header("cache-control"));
+	AddHeader(response.headers, "Expires", upstream.header("expires"));
+	AddHeader(response.headers, "ETag", upstream.header("etag"));
+	AddHeader(response.headers, "Last-Modified", upstream.header("last-modified"));
+	AddHeader(response.headers, "X-Cache", "MISS");
+	response.strBody = std::move(upstream.strBody);
+}
+
+void CRelayServer::handleInfo(const CRequest& request, const std::string& strHost, const std::string& strReferrer, CResponse& response) const
+{
+	// Same diagnostic as relay.php without url, the values come from the client
+	std::ostringstream oss;
+	oss << "ITN Converter relay\n" << EscapeHtml(request.strMethod) << '\n';
+
+	for (const auto& header : request.headers)
+	{
+		std::string strName = "HTTP_" + header.first;
+		stdx::string_helper::toupper(strName);
+		stdx::string_helper::replace(strName, '-', '_');
+
+		std::string strValue = header.second;
+		if (header.first == "host" && !strHost.empty())
+			strValue = strHost;
+		if (header.first == "referer" && !strReferrer.empty())
+			strValue = strReferrer;
+
+		oss << "<li>" << EscapeHtml(strName) << " = " << EscapeHtml(strValue) << "</li>\n";
+	}
+
+	response.headers.emplace_back("Content-Type", "text/html");
+	response.strBody = oss.str();
+}
+
+void CRelayServer::handleStub(const CRequest& request, const params_t& params, CResponse& response) const
+{
+	// Deterministic upstream for offline runs, the query drives the response:
+	// status=<code>, max-age=<seconds>, delay=<ms>, validators=0
+	m_Metrics.requests++;
+
+	const std::string* pDelay = FindParam(params, "delay");
+	if (pDelay && IsNumber(*pDelay, 5))
+		std::this_thread::sleep_for(std::chrono::milliseconds(std::stoul(*pDelay)));
+
+	const std::string* pStatus = FindParam(params, "status");
+	if (pStatus && pStatus->size() == 3 && IsNumber(*pStatus, 3))
+		response.ulStatus = std::stoul(*pStatus);
+
+	// Only digits go into the header, a decoded CR LF would inject lines
+	const std::string* pMaxAge = FindParam(params, "max-age");
+	if (pMaxAge && IsNumber(*pMaxAge, 10))
+		response.headers.emplace_back("Cache-Control", "max-age=" + *pMaxAge);
+
+	std::string strBody = "stub " + FindHeader(request.headers, "host") + request.strTarget + '\n';
+
+	const std::string* pValidators = FindParam(params, "validators");
+	if (!pValidators || *pValidators != "0")
+	{
+		std::ostringstream ossETag;
+		ossETag << '"' << std::hex << std::hash<std::string>()(strBody) << '"';
+		std::string strETag = ossETag.str();
+
+		response.headers.emplace_back("ETag", strETag);
+		response.headers.emplace_back("Last-Modified", StubLastModified);
+
+		if (response.ulStatus == 200 && FindHeader(request.headers, "if-none-match") == strETag)
+		{
+			response.ulStatus = 304;
+			return;
+		}
+	}
+
+	response.headers.emplace_back("Content-Type", "text/plain");
+	response.strBody = std::move(strBody);
+}
+
+void CRelayServer::handleMetrics(CResponse& response) const
+{
+	std::ostringstream oss;
+	m_Metrics.write(oss);
+
+	response.headers.emplace_back("Content-Type", "text/plain; version=0.0.4");
+	response.strBody = oss.str();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : HTTP front end of the relay, same query contract as web/src/relay.php
+ */
+
+#ifndef RELAY_SERVER_H_INCLUDED
+#define RELAY_SERVER_H_INCLUDED
+
+#include <winsock2.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "RelayMetrics.h"
+#include "stdx/concurrent_queue.h"
+
+class CRelayCache;
+class CUpstreamPool;
+struct CCacheEntry;
+
+struct CRelayOptions
+{
+	std::string strBind = "127.0.0.1";
+	unsigned short usPort = 8080;
+	size_t ulThreads = 16; // Client connections served at the same time, each for a bounded time
+	std::filesystem::path cacheDirectory = "RelayCache";
+	unsigned long long ullCacheSize = 512ULL * 1024 * 1024;
+	long long llDefaultTtl = 0; // Seconds, for responses without freshness information
+	size_t ulMaxPerOrigin = 6; // Concurrent upstream requests per origin
+	std::string strUpstream; // "host:port" receiving every upstream request, for offline runs
+	bool bStub = false; // Answer as a deterministic upstream instead of relaying
+};
+
+class CRelayServer
+{
+public:
+	explicit CRelayServer(const CRelayOptions& options);
+	~CRelayServer();
+
+	void run(); // Blocks until stop()
+	void stop();
+
+private:
+	typedef std::vector<std::pair<std::string, std::string>> params_t;
+
+	struct CRequest
+	{
+		std::string strMethod;
+		std::string strTarget;
+		std::string strVersion;
+		std::map<std::string, std::string> headers; // Lower case names
+	};
+
+	struct CResponse
+	{
+		unsigned long ulStatus = 200;
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string strBody;
+	};
+
+	// An upstream request shared by the clients asking for the same URL
+	struct CFlight
+	{
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool bDone = false;
+		CResponse response;
+	};
+
+	void worker();
+	void serveConnection(SOCKET hSocket);
+	bool readRequest(SOCKET hSocket, std::string& strBuffer, CRequest& request, std::chrono::steady_clock::time_point tpDeadline) const;
+	bool writeResponse(SOCKET hSocket, const CRequest& request, const CResponse& response, bool bKeepAlive) const;
+
+	void handle(const CRequest& request, CResponse& response);
+	void handleRelay(const std::string& strUrl, const std::string& strReferrer, CResponse& response);
+	void handleInfo(const CRequest& request, const std::string& strHost, const std::string& strReferrer, CResponse& response) const;
+	void handleStub(const CRequest& request, const params_t& params, CResponse& response) const;
+	void handleMetrics(CResponse& response) const;
+	void fetchUpstream(const std::string& strUrl, const std::string& strReferrer, const CCacheEntry* pEntry, CResponse& response);
+
+	CRelayServer(const CRelayServer&) = delete;
+	CRelayServer& operator=(const CRelayServer&) = delete;
+
+private:
+	CRelayOptions m_Options;
+	mutable CRelayMetrics m_Metrics;
+	std::unique_ptr<CRelayCache> m_pCache;
+	std::unique_ptr<CUpstreamPool> m_pUpstream;
+
+	SOCKET m_hListen;
+	std::atomic<bool> m_bRunning;
+	stdx::concurrent_queue<SOCKET> m_Connections;
+
+	std::mutex m_FlightsMutex;
+	std::map<std::string, std::shared_ptr<CFlight>> m_Flights;
+};
+
+#endif // !RELAY_SERVER_H_INCLUDED
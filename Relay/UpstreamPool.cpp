@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Keep-alive upstream sessions shared by the relay workers
+ */
+
+#include "UpstreamPool.h"
+#include "RelayMetrics.h"
+#include "stdx/guard.h"
+#include "stdx/string_helper.h"
+#include "stdx/uri_helper.h"
+
+namespace
+{
+	constexpr size_t UpstreamBufferSize = 64 * 1024;
+}
+
+std::string CUpstreamResponse::header(const std::string& strName) const
+{
+	auto it = headers.find(strName);
+	return it != headers.end() ? it->second : std::string();
+}
+
+void CUpstreamResponse::parseHeaders(const std::string& strRawHeaders, headers_t& headers)
+{
+	size_t ulPos = strRawHeaders.find("\r\n"); // Skip the status line
+	while (ulPos != std::string::npos)
+	{
+		ulPos += 2;
+		size_t ulEnd = strRawHeaders.find("\r\n", ulPos);
+		std::string strLine = strRawHeaders.substr(ulPos, ulEnd == std::string::npos ? std::string::npos : ulEnd - ulPos);
+		ulPos = ulEnd;
+
+		size_t ulColon = strLine.find(':');
+		if (ulColon == std::string::npos)
+			continue;
+
+		std::string strName = strLine.substr(0, ulColon);
+		std::string strValue = strLine.substr(ulColon + 1);
+		stdx::string_helper::trimright(strName, " \t");
+		stdx::string_helper::trimleft(strValue, " \t");
+		stdx::string_helper::trimright(strValue, " \t");
+		stdx::string_helper::tolower(strName);
+
+		std::string& strHeader = headers[strName];
+		if (!strHeader.empty())
+			strHeader += ", ";
+		strHeader += strValue;
+	}
+}
+
+CUpstreamPool::CUpstreamPool(CRelayMetrics& metrics, size_t ulMaxPerOrigin, const std::string& strOverride) :
+	m_Metrics(metrics),
+	m_ulMaxPerOrigin(ulMaxPerOrigin ? ulMaxPerOrigin : 1),
+	m_usOverridePort(CHttpSession::DefaultHttpPort)
+{
+	if (!strOverride.empty())
+	{
+		std::string strRequest;
+		bool bSecure;
+		stdx::url_helper::split(strOverride, m_strOverrideHost, m_usOverridePort, strRequest, bSecure);
+	}
+
+	CInternetConnection::setMaxConnectionsPerServer(static_cast<unsigned long>(m_ulMaxPerOrigin));
+}
+
+CUpstreamPool::~CUpstreamPool()
+{
+	// Sessions must be closed before the connection
+	m_Origins.clear();
+}
+
+CUpstreamPool::COrigin& CUpstreamPool::getOrigin(const std::string& strHost, unsigned short usPort, bool bSecure)
+{
+	std::string strKey = (bSecure ? "https://" : "http://") + strHost + ':' + std::to_string(usPort);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	std::unique_ptr<COrigin>& pOrigin = m_Origins[strKey];
+	if (!pOrigin)
+	{
+		pOrigin = std::make_unique<COrigin>();
+		pOrigin->strHost = strHost;
+		pOrigin->usPort = usPort;
+	}
+
+	return *pOrigin;
+}
+
+std::unique_ptr<CHttpSession> CUpstreamPool::acquire(COrigin& origin)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	origin.cv.wait(lock, [&]() { return origin.ulActive < m_ulMaxPerOrigin; });
+	origin.ulActive++;
+
+	if (!origin.idle.empty())
+	{
+		std::unique_ptr<CHttpSession> pSession = std::move(origin.idle.back());
+		origin.idle.pop_back();
+		m_Metrics.upstreamSessionsReused++;
+		return pSession;
+	}
+
+	lock.unlock();
+
+	try
+	{
+		auto pSession = std::make_unique<CHttpSession>(m_Connection.getHttpSession());
+		pSession->open(origin.strHost, origin.usPort);
+		m_Metrics.upstreamSessionsOpened++;
+		return pSession;
+	}
+	catch (...)
+	{
+		release(origin, nullptr);
+		throw;
+	}
+}
+
+void CUpstreamPool::release(COrigin& origin, std::unique_ptr<CHttpSession> pSession)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (pSession)
+			origin.idle.push_back(std::move(pSession));
+		origin.ulActive--;
+	}
+
+	origin.cv.notify_one();
+}
+
+CUpstreamResponse CUpstreamPool::fetch(const std::string& strUrl, const std::string& strReferrer, const std::map<std::string, std::string>& requestHeaders)
+{
+	std::string strHost;
+	unsigned short usPort;
+	std::string strRequest;
+	bool bSecure;
+	stdx::url_helper::split(strUrl, strHost, usPort, strRequest, bSecure);
+
+	bool bOverride = !m_strOverrideHost.empty();
+	COrigin& origin = bOverride ? getOrigin(m_strOverrideHost, m_usOverridePort, false) : getOrigin(strHost, usPort, bSecure);
+
+	m_Metrics.upstreamRequests++;
+	std::unique_ptr<CHttpSession> pSession;
+	try
+	{
+		pSession = acquire(origin);
+	}
+	catch (...)
+	{
+		m_Metrics.upstreamErrors++;
+		throw;
+	}
+
+	// A failed session is dropped, WinInet reopens the socket with the next one
+	stdx::function_guard releaseGuard([&]() { release(origin, std::move(pSession)); });
+
+	CUpstreamResponse response;
+	try
+	{
+		CHttpRequest httpRequest = pSession->getRequest();
+		httpRequest.setBufferSize(UpstreamBufferSize);
+		httpRequest.open(strRequest, bSecure && !bOverride, strReferrer, CHttpRequest::MethodGet);
+
+		if (bOverride)
+			httpRequest.addHeader("Host", strHost);
+		if (!requestHeaders.empty())
+			httpRequest.addHeaders(requestHeaders);
+
+		httpRequest.send(response.strBody);
+		httpRequest.wait();
+
+		response.ulStatus = httpRequest.getStatusCode();
+		CUpstreamResponse::parseHeaders(httpRequest.getResponseHeaders(), response.headers);
+	}
+	catch (...)
+	{
+		pSession.reset();
+		m_Metrics.upstreamErrors++;
+		throw;
+	}
+
+	m_Metrics.upstreamBytes += response.strBody.size();
+	return response;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Keep-alive upstream sessions shared by the relay workers
+ */
+
+#ifndef UPSTREAM_POOL_H_INCLUDED
+#define UPSTREAM_POOL_H_INCLUDED
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
+#include "ToolsLibrary/HttpClient.h"
+
+class CRelayMetrics;
+
+struct CUpstreamResponse
+{
+	typedef std::map<std::string, std::string> headers_t; // Lower case names
+
+	unsigned long ulStatus = 0;
+	headers_t headers;
+	std::string strBody;
+
+	std::string header(const std::string& strName) const;
+	static void parseHeaders(const std::string& strRawHeaders, headers_t& headers);
+};
+
+class CUpstreamPool
+{
+public:
+	// strOverride ("host:port") sends every request to that server instead, with the original Host header
+	CUpstreamPool(CRelayMetrics& metrics, size_t ulMaxPerOrigin, const std::string& strOverride = std::string());
+	~CUpstreamPool();
+
+	// Blocks while ulMaxPerOrigin requests are already in progress on the same origin
+	CUpstreamResponse fetch(const std::string& strUrl, const std::string& strReferrer, const std::map<std::string, std::string>& requestHeaders);
+
+private:
+	struct COrigin
+	{
+		std::string strHost;
+		unsigned short usPort = 0;
+		size_t ulActive = 0;
+		std::vector<std::unique_ptr<CHttpSession>> idle;
+		std::condition_variable cv;
+	};
+
+	COrigin& getOrigin(const std::string& strHost, unsigned short usPort, bool bSecure);
+	std::unique_ptr<CHttpSession> acquire(COrigin& origin);
+	void release(COrigin& origin, std::unique_ptr<CHttpSession> pSession);
+
+	CUpstreamPool(const CUpstreamPool&) = delete;
+	CUpstreamPool& operator=(const CUpstreamPool&) = delete;
+
+private:
+	CRelayMetrics& m_Metrics;
+	size_t m_ulMaxPerOrigin;
+	std::string m_strOverrideHost;
+	unsigned short m_usOverridePort;
+	CInternetConnection m_Connection;
+	std::mutex m_Mutex;
+	std::map<std::string, std::unique_ptr<COrigin>> m_Origins;
+};
+
+#endif // !UPSTREAM_POOL_H_INCLUDED
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Purpose : Caching relay daemon for the map page, replaces web/src/relay.php
+ */
+
+#include "RelayServer.h"
+#include "RelaySelfTest.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	CRelayServer* s_pServer = nullptr;
+
+	BOOL WINAPI ConsoleHandler(DWORD dwCtrlType)
+	{
+		if (dwCtrlType == CTRL_C_EVENT || dwCtrlType == CTRL_BREAK_EVENT || dwCtrlType == CTRL_CLOSE_EVENT)
+		{
+			if (s_pServer)
+				s_pServer->stop();
+			return TRUE;
+		}
+
+		return FALSE;
+	}
+
+	void Usage()
+	{
+		std::cout <<
+			"Usage: Relay [options]\n"
+			"  --bind <address>        Listening address (127.0.0.1)\n"
+			"  --port <port>           Listening port (8080)\n"
+			"  --threads <count>       Client connections served at once (16)\n"
+			"  --cache <directory>     Cache directory (RelayCache)\n"
+			"  --cache-size <MB>       Cache size limit (512)\n"
+			"  --default-ttl <seconds> Freshness of responses without caching headers (0)\n"
+			"  --max-per-origin <n>    Concurrent upstream requests per origin (6)\n"
+			"  --upstream <host:port>  Send every upstream request to this server\n"
+			"  --stub                  Answer as a deterministic upstream\n"
+			"  --self-test             Check the relay offline against a stub on port + 1\n"
+			"\n"
+			"Relay:   /?url=<url>[&ref=<referrer>][&host=<host>][&<param>=<value>...]\n"
+			"Metrics: /metrics\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	CRelayOptions options;
+	bool bSelfTest = false;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string strOption = argv[i];
+			bool bValue = i + 1 < argc;
+
+			if (strOption == "--stub")
+				options.bStub = true;
+			else if (strOption == "--self-test")
+				bSelfTest = true;
+			else if (strOption == "--bind" && bValue)
+				options.strBind = argv[++i];
+			else if (strOption == "--port" && bValue)
+				options.usPort = static_cast<unsigned short>(std::stoul(argv[++i]));
+			else if (strOption == "--threads" && bValue)
+				options.ulThreads = std::stoul(argv[++i]);
+			else if (strOption == "--cache" && bValue)
+				options.cacheDirectory = argv[++i];
+			else if (strOption == "--cache-size" && bValue)
+				options.ullCacheSize = std::stoull(argv[++i]) * 1024 * 1024;
+			else if (strOption == "--default-ttl" && bValue)
+				options.llDefaultTtl = std::stoll(argv[++i]);
+			else if (strOption == "--max-per-origin" && bValue)
+				options.ulMaxPerOrigin = std::stoul(argv[++i]);
+			else if (strOption == "--upstream" && bValue)
+				options.strUpstream = argv[++i];
+			else
+			{
+				Usage();
+				return strOption == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+			}
+		}
+
+		if (bSelfTest)
+			return RunSelfTest(options) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+		CRelayServer server(options);
+		s_pServer = &server;
+		SetConsoleCtrlHandler(ConsoleHandler, TRUE);
+
+		std::cout << (options.bStub ? "Stub upstream" : "Relay") << " listening on " << options.strBind << ':' << options.usPort << std::endl;
+		server.run();
+
+		s_pServer = nullptr;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stdafx.h"
+#include "AsyncExternalCall.h"
+#include "Javascript.h"
+#include "Navigator.h"
+
+const size_t CAsyncExternalCall::DefaultWorkers = 4;
+
+CAsyncExternalCall::CAsyncExternalCall(CNavigator& navigator, size_t ulWorkers) :
+	m_Navigator(navigator),
+	m_ullGeneration(0)
+{
+	for (size_t i = 0; i < std::max<size_t>(1, ulWorkers); ++i)
+		m_vecWorkers.push_back(std::async(std::launch::async, [this]() { Run(); }));
+}
+
+CAsyncExternalCall::~CAsyncExternalCall()
+{
+	m_Requests.clear();
+
+	// A request without work stops a worker, the calls in progress are waited for
+	for (size_t i = 0; i < m_vecWorkers.size(); ++i)
+		m_Requests.push_back(Request());
+
+	for (auto& future : m_vecWorkers)
+		future.wait();
+}
+
+void CAsyncExternalCall::PostRequest(const std::wstring& strChannel, const WorkFunction& Work, const CAutoVariant& vCallBack)
+{
+	if (!Work || vCallBack.type() != VT_DISPATCH)
+		return;
+
+	// The superseded callback is released here, on the UI thread, out of the lock
+	CAutoVariant vSuperseded;
+	unsigned long long ullGeneration;
+	{
+		std::lock_guard<std::mutex> mlg(m_Mutex);
+		Pending& pending = m_mapPending[strChannel];
+		vSuperseded = std::move(pending.vCallBack);
+		pending.vCallBack = vCallBack;
+		pending.ullGeneration = ullGeneration = ++m_ullGeneration;
+	}
+
+	m_Requests.push_back(Request(strChannel, ullGeneration, Work));
+}
+
+bool CAsyncExternalCall::isCurrent(const Request& request)
+{
+	std::lock_guard<std::mutex> mlg(m_Mutex);
+	auto it = m_mapPending.find(request.strChannel);
+	return it != m_mapPending.end() && it->second.ullGeneration == request.ullGeneration;
+}
+
+CVariant CAsyncExternalCall::takeCallBack(const Request& request)
+{
+	std::lock_guard<std::mutex> mlg(m_Mutex);
+	auto it = m_mapPending.find(request.strChannel);
+	if (it == m_mapPending.end() || it->second.ullGeneration != request.ullGeneration)
+		return CVariant();
+
+	// The reference goes to the script as is, the channel is done
+	CVariant vCallBack = it->second.vCallBack.release();
+	m_mapPending.erase(it);
+	return vCallBack;
+}
+
+void CAsyncExternalCall::Run()
+{
+	Request request;
+	while (m_Requests.pop_front(request) == stdx::cq_status::no_timeout && request.Work)
+	{
+		// Superseded while waiting in the queue
+		if (!isCurrent(request))
+			continue;
+
+		CAutoVariant vResult;
+		std::string strError;
+		try
+		{
+			vResult = request.Work();
+		}
+		catch (std::exception& e)
+		{
+			vResult.clear();
+			strError = *e.what() ? e.what() : "Error";
+		}
+		catch (...)
+		{
+			vResult.clear();
+			strError = "Error";
+		}
+
+		// Superseded during the call, the newer result only is given
+		CVariant vCallBack = takeCallBack(request);
+		if (vCallBack.type() != VT_DISPATCH)
+			continue;
+
+		try
+		{
+			// The script is run then destroyed by the UI thread, releasing the callback there
+			std::unique_ptr<CJavaScript> pScript = std::make_unique<CJavaScript>(vCallBack.asDispatch(), false);
+			pScript->arg(vResult.release());
+			if (!strError.empty())
+				pScript->arg(strError);
+			m_Navigator.PostJavaScript(pScript);
+		}
+		catch (...) {}
+	}
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ASYNC_EXTERNAL_CALL_H_
+#define __ASYNC_EXTERNAL_CALL_H_
+
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "stdx/concurrent_queue.h"
+#include "Variant.h"
+
+class CNavigator;
+
+// Run the network calls of the javascript bridge out of the UI thread.
+// The result is given to the javascript callback through the message loop of the navigator,
+// callback(result) on success and callback(undefined, error message) when the call failed.
+// A call supersedes the previous calls of its channel, their result is dropped.
+// The callbacks are script objects of the UI thread, the workers never add or release a reference.
+class CAsyncExternalCall
+{
+public:
+	static const size_t DefaultWorkers;
+
+	CAsyncExternalCall(CNavigator& navigator, size_t ulWorkers = DefaultWorkers);
+	~CAsyncExternalCall();
+
+	typedef std::function<CAutoVariant()> WorkFunction;
+
+	void PostRequest(const std::wstring& strChannel, const WorkFunction& Work, const CAutoVariant& vCallBack);
+
+private:
+	CAsyncExternalCall(CAsyncExternalCall&) = delete;
+	CAsyncExternalCall& operator=(CAsyncExternalCall&) = delete;
+
+	struct Request
+	{
+		std::wstring strChannel;
+		unsigned long long ullGeneration;
+		WorkFunction Work;
+
+		Request() : ullGeneration(0) { }
+
+		Request(const std::wstring& _strChannel, unsigned long long _ullGeneration, const WorkFunction& _Work) :
+			strChannel(_strChannel),
+			ullGeneration(_ullGeneration),
+			Work(_Work)
+		{
+		}
+	};
+
+	// The current call of a channel, removed once its result is posted
+	struct Pending
+	{
+		unsigned long long ullGeneration;
+		CAutoVariant vCallBack;
+
+		Pending() : ullGeneration(0) { }
+	};
+
+	bool isCurrent(const Request& request);
+	CVariant takeCallBack(const Request& request);
+	void Run();
+
+	CNavigator& m_Navigator;
+	std::mutex m_Mutex;
+	unsigned long long m_ullGeneration; // Shared by the channels, a removed channel cannot reuse a generation
+	std::map<std::wstring, Pending> m_mapPending;
+	stdx::concurrent_queue<Request> m_Requests;
+	std::vector<std::future<void>> m_vecWorkers;
+};
+
+#endif // __ASYNC_EXTERNAL_CALL_H_
@@ -62,6 +62,9 @@ namespace
 		{ IDS_FAVORITES, LVCFMT_LEFT, -1, CGpsPointView::E_RVCOL_ADDRESS },
 		{ 0            , 0          ,  0, CGpsPointView::E_RVCOL_ADDRESS }
 	};
+
+	const std::chrono::milliseconds SEARCH_DEADLINE(10000);
+	const std::chrono::milliseconds SEARCH_HEDGE(2500);
 }
 
 #define URL_JS_MAPS     _T(BASE_URL) _T("gglplanner.html")
@@ -73,6 +76,7 @@ namespace
 #define WM_IMPORT_FAV      WM_USER+2001
 #define WM_EXPORT_FAV      WM_USER+2002
 #define WM_CLEAR_FAV       WM_USER+2003
+#define WM_SEARCH_ANSWER   WM_USER+2004
 
 /////////////////////////////////////////////////////////////////////////////
 // CEditorDlg dialog
@@ -140,6 +144,7 @@ BEGIN_MESSAGE_MAP(CEditorDlg, CSizeableDialog)
 	ON_BN_CLICKED(IDC_SEARCH_LOCATION, OnSearchLocation)
 	ON_BN_CLICKED(IDC_SEARCH_PROXIMITY, OnSearchProximity)
 	ON_BN_CLICKED(IDC_DISPLAY_FAVORITE, OnDisplayFavorites)
+	ON_MESSAGE(WM_SEARCH_ANSWER, OnSearchAnswer)
 #ifdef IDC_BUTTON_PRINT
 	ON_BN_CLICKED(IDC_BUTTON_PRINT, OnButtonPrint)
 #endif
@@ -934,7 +939,7 @@ void CEditorDlg::OnButtonViewall()
 void CEditorDlg::OnButtonCalculate()
 {
 	ScopedWaitCursor swc(*this);
-	m_ListPoint.CalculateAll();
+	m_ListPoint.CalculateAll(true, true);
 }
 
 void CEditorDlg::OnButtonClearFavorites()
@@ -972,11 +977,11 @@ void CEditorDlg::OnButtonImportFavorites()
 		std::vector<CGpsPointArray*> vecGpsArray;
 		std::vector<CGpsPointArray*>::iterator it;
 
-		HRESULT hr = ReadGPX((LPCTSTR)cFileDialog.GetPathName(), vecGpsArray, false);
+		HRESULT hr = ReadGPX((LPCTSTR)cFileDialog.GetPathName(), vecGpsArray, false, std::pmr::get_default_resource()); // The favorites keep the points
 		if (hr == S_OK)
 		{
 			for (it = vecGpsArray.begin(); it != vecGpsArray.end(); ++it)
-				m_cFavorites += **it;
+				m_cFavorites += std::move(**it);
 
 			m_ListFavorites.Refresh();
 		}
@@ -1014,8 +1019,85 @@ void CEditorDlg::OnButtonExportFavorites()
 	}
 }
 
+void CEditorDlg::StartLocationSearch()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SearchMutex);
+		m_gSearchResults.clear();
+	}
+
+	m_cLocationResult.clear();
+	m_ListSearch.Refresh();
+	m_btSearch.EnableWindow(FALSE);
+
+	// All the providers are requested at once from a worker thread, the list is updated as each one answers
+	HWND hWnd = GetSafeHwnd();
+	m_futureSearch = std::async(std::launch::async, [this, hWnd, strText = m_strSearchText]()
+	{
+		geo::E_GEO_STATUS_CODE eStatus;
+		{
+			geo::CGeoSearchAggregator gSearch;
+			gSearch.addGeocoder(geo::E_GEO_PROVIDER_GOOGLE_API, strText, SEARCH_DEADLINE, SEARCH_HEDGE);
+			gSearch.addGeocoder(geo::E_GEO_PROVIDER_HERE_API, strText, SEARCH_DEADLINE, SEARCH_HEDGE);
+			gSearch.addLocalSearch(geo::E_GEO_PROVIDER_GOOGLE_API, strText, SEARCH_DEADLINE, SEARCH_HEDGE);
+
+			eStatus = gSearch.run([this, hWnd](geo::E_GEO_PROVIDER, geo::E_GEO_STATUS_CODE, const geo::CGeoLocations& gResults)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_SearchMutex);
+					m_gSearchResults = gResults;
+				}
+
+				::PostMessage(hWnd, WM_SEARCH_ANSWER, FALSE, 0);
+			});
+		} // Late requests are joined here
+
+		::PostMessage(hWnd, WM_SEARCH_ANSWER, TRUE, 0);
+		return eStatus;
+	});
+}
+
+LRESULT CEditorDlg::OnSearchAnswer(WPARAM wParam, LPARAM)
+{
+	if (!m_futureSearch.valid())
+		return 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_SearchMutex);
+		m_cLocationResult = m_gSearchResults;
+	}
+
+	m_ListSearch.Refresh();
+
+	// Last message of the search
+	if (!wParam)
+		return 0;
+
+	geo::E_GEO_STATUS_CODE eStatus = m_futureSearch.get();
+	if (eStatus > geo::E_HTTP_ERROR && HTTPErrorBox(eStatus - geo::E_HTTP_ERROR) == IDRETRY)
+	{
+		StartLocationSearch();
+		return 0;
+	}
+
+	m_btSearch.EnableWindow(TRUE);
+	m_ListSearch.SelectItem(m_cLocationResult.size() ? 0 : -1);
+
+	CString resStr;
+	if (eStatus != geo::E_GEO_OK)
+		resStr.Format(GetStringStatus(eStatus).c_str(), stdx::wstring_helper::from_utf8(m_strSearchText).c_str());
+
+	m_LabelStatus.SetWindowText(resStr);
+	UpdateResults();
+	return 0;
+}
+
 void CEditorDlg::OnSearch()
 {
+	// A location search is still running
+	if (m_futureSearch.valid())
+		return;
+
 	ScopedWaitCursor swc(*this);
 
 	int nRet = IDOK;
@@ -1029,45 +1111,10 @@ void CEditorDlg::OnSearch()
 
 	if (((CButton*)GetDlgItem(IDC_SEARCH_LOCATION))->GetCheck())
 	{
-		geo::CGeoLocalSearch gGoogleLocalSearch(geo::E_GEO_PROVIDER_GOOGLE_API);
-		geo::CGeoGeocoder gGoogleGeocoder(geo::E_GEO_PROVIDER_GOOGLE_API);
-		geo::CGeoGeocoder gHereGeocoder(geo::E_GEO_PROVIDER_HERE_API);
-
-		do
-		{
-			try
-			{
-				gGoogleLocalSearch->Load(searchText);
-				gGoogleGeocoder->Load(searchText);
-				gHereGeocoder->Load(searchText);
-				nRet = IDOK;
-			}
-			catch (CInternetException& e)
-			{
-				nRet = HTTPErrorBox(e.code());
-			}
-		} while (nRet == IDRETRY);
-
-		m_cLocationResult.clear();
-		if (nRet == IDOK)
-		{
-			if (gGoogleGeocoder->getStatus() == geo::E_GEO_OK)
-				m_cLocationResult += gGoogleGeocoder->getResults();
-
-			if (gHereGeocoder->getStatus() == geo::E_GEO_OK)
-				m_cLocationResult += gHereGeocoder->getResults();
-
-			if (gGoogleLocalSearch->getStatus() == geo::E_GEO_OK)
-				m_cLocationResult += gGoogleLocalSearch->getLocations();
-
-			m_cLocationResult.removeDuplicates();
-		}
-
-		m_ListSearch.Refresh();
-		m_ListSearch.SelectItem(m_cLocationResult.size() ? 0 : -1);
-
-		if (gGoogleGeocoder->getStatus() != geo::E_GEO_OK && gHereGeocoder->getStatus() != geo::E_GEO_OK && gGoogleLocalSearch->getStatus() != geo::E_GEO_OK)
-			resStr.Format(GetStringStatus(gGoogleGeocoder->getStatus()).c_str(), (LPCTSTR)m_csSearch);
+		// The results are displayed by OnSearchAnswer()
+		m_strSearchText = searchText;
+		StartLocationSearch();
+		return;
 	}
 	else
 	{
@@ -1269,7 +1316,7 @@ void CEditorDlg::OnButtonDelroute()
 	ScopedWaitCursor swc(*this);
 
 	m_ListPoint.DisableAutoCalc();
-	m_ListPoint.ClearDriving();
+	m_ListPoint.ClearDriving(true);
 }
 
 void CEditorDlg::OnButtonOptimise()
@@ -33,6 +33,8 @@
 #if !defined(AFX_EDITORDLG_H_INCLUDED_)
 #define AFX_EDITORDLG_H_INCLUDED_
 
+#include <future>
+#include <mutex>
 #include "ITN Tools.h"
 #include "NavRouteView.h"
 #include "SizeableDlg.h"
@@ -112,6 +114,7 @@ protected:
 	void OnButtonClearFavorites();
 	void OnButtonImportFavorites();
 	void OnButtonExportFavorites();
+	void StartLocationSearch();
 
 	// Implementation
 protected:
@@ -156,6 +159,7 @@ protected:
 	afx_msg void OnMouseMove(UINT nFlags, CPoint point);
 	afx_msg void OnLButtonUp(UINT nFlags, CPoint point);
 	afx_msg void OnButtonConfig();
+	afx_msg LRESULT OnSearchAnswer(WPARAM wParam, LPARAM lParam);
 	virtual void OnOK();
 	DECLARE_EVENTSINK_MAP()
 		//}}AFX_MSG
@@ -164,6 +168,12 @@ protected:
 private:
 	jsMapsInfos m_MapsInfos;
 	jsProvidersInfos m_ProvidersInfos;
+
+	// Location search running on a worker thread, the merged answers are posted to the dialog
+	std::string m_strSearchText;
+	std::mutex m_SearchMutex;
+	geo::CGeoLocations m_gSearchResults;
+	std::future<geo::E_GEO_STATUS_CODE> m_futureSearch; // Last member, waits for the search before the others are destroyed
 };
 
 //{{AFX_INSERT_LOCATION}}
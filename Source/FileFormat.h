@@ -28,13 +28,14 @@
 #ifndef FILE_FORMATS_H_INCLUDED
 #define FILE_FORMATS_H_INCLUDED
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 
 class CGpsPointArray;
 class CGpsRoute;
 
-typedef int _ReadFile(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+typedef int _ReadFile(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource); // The arrays are constructed on pResource
 typedef int _WriteFile(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD dwFlag, bool bCmdLine);
 
 struct FileFormatDesc
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stdafx.h"
+#include <algorithm>
+#include "GeoServices/GeoGeocoderFactory.h"
+#include "GpsPointArray.h"
+#include "GpsGeocoding.h"
+
+CGpsGeocoding::CGpsGeocoding(geo::E_GEO_PROVIDER eGeoProvider) :
+	m_eGeoProvider(eGeoProvider)
+{
+}
+
+void CGpsGeocoding::add(size_t ulIndex, const std::string& strAddress)
+{
+	m_vecIndexes.push_back(ulIndex);
+	m_vecAddresses.push_back(strAddress);
+}
+
+size_t CGpsGeocoding::run(CGpsPointArray& cGpsPointArray, bool bSetAddress, bool bRemoveUnresolved)
+{
+	if (m_vecIndexes.empty())
+		return 0;
+
+	geo::GeoGeocoderResults vecResults;
+
+	try
+	{
+		geo::CGeoGeocoder gGeocoder(m_eGeoProvider);
+		vecResults = gGeocoder->LoadBatch(m_vecAddresses.data(), m_vecAddresses.size()).get();
+	}
+	catch (std::invalid_argument&)
+	{
+		vecResults.assign(m_vecIndexes.size(), { geo::E_GEO_INVALID_REQUEST, geo::CGeoLocations() });
+	}
+
+	size_t ulResolved = 0;
+	std::vector<size_t> vecUnresolved;
+
+	for (size_t i = 0; i < m_vecIndexes.size(); ++i)
+	{
+		const geo::GeoGeocoderResult& gResult = vecResults[i];
+		CGpsPoint& cGpsPoint = cGpsPointArray.at(m_vecIndexes[i]);
+
+		if (gResult.eStatus == geo::E_GEO_OK && !gResult.gLocations.empty())
+		{
+			if (bSetAddress)
+				cGpsPoint = gResult.gLocations.front();
+			else
+				cGpsPoint = static_cast<const geo::CGeoLatLng&>(gResult.gLocations.front());
+
+			++ulResolved;
+		}
+		else
+		{
+			vecUnresolved.push_back(m_vecIndexes[i]);
+		}
+	}
+
+	if (bRemoveUnresolved)
+	{
+		std::sort(vecUnresolved.begin(), vecUnresolved.end());
+		for (auto it = vecUnresolved.rbegin(); it != vecUnresolved.rend(); ++it)
+			cGpsPointArray.erase(*it);
+	}
+
+	m_vecIndexes.clear();
+	m_vecAddresses.clear();
+
+	return ulResolved;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _GPSGEOCODING_H_INCLUDED_
+#define _GPSGEOCODING_H_INCLUDED_
+
+#include <string>
+#include <vector>
+#include "GeoServices/GeoApi.h"
+
+class CGpsPointArray;
+
+// Points read without coordinates are only flagged by the readers,
+// they are all geocoded at once when the file is parsed.
+class CGpsGeocoding
+{
+public:
+	explicit CGpsGeocoding(geo::E_GEO_PROVIDER eGeoProvider = geo::E_GEO_PROVIDER_GOOGLE_API);
+	~CGpsGeocoding() = default;
+
+	void add(size_t ulIndex, const std::string& strAddress);
+	bool empty() const { return m_vecIndexes.empty(); }
+
+	// Set the coordinates of the flagged points, and their address if bSetAddress.
+	// Unresolved points are removed if bRemoveUnresolved. Return the number of resolved points.
+	size_t run(CGpsPointArray& cGpsPointArray, bool bSetAddress, bool bRemoveUnresolved);
+
+private:
+	geo::E_GEO_PROVIDER m_eGeoProvider;
+	std::vector<size_t> m_vecIndexes;
+	std::vector<std::string> m_vecAddresses;
+};
+
+#endif // _GPSGEOCODING_H_INCLUDED_
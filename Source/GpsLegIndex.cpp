@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stdafx.h"
+#include <algorithm>
+#include "GpsLegIndex.h"
+#include "GpsPoint.h"
+
+CGpsLegIndex::Leg CGpsLegIndex::makeLeg(const CGpsPoint& cGpsPoint)
+{
+	const CRouteInfo* pcRouteInfo = cGpsPoint.routeInfo();
+	if (!pcRouteInfo || !pcRouteInfo->summary().isValid())
+		return { 0, 0, 1 };
+
+	return { pcRouteInfo->summary().distance(), pcRouteInfo->summary().duration(), 0 };
+}
+
+void CGpsLegIndex::build()
+{
+	// The first point has no leg
+	if (!m_vecLegs.empty())
+		m_vecLegs.front() = { 0, 0, 0 };
+
+	// Linear construction, each node is added to its parent
+	m_vecTree.assign(m_vecLegs.size() + 1, { 0, 0, 0 });
+	for (size_t i = 1; i < m_vecTree.size(); ++i)
+	{
+		m_vecTree[i] += m_vecLegs[i - 1];
+
+		size_t ulParent = i + (i & (~i + 1));
+		if (ulParent < m_vecTree.size())
+			m_vecTree[ulParent] += m_vecTree[i];
+	}
+}
+
+void CGpsLegIndex::update(size_t ulPoint, const CGpsPoint& cGpsPoint)
+{
+	if (ulPoint == 0 || ulPoint >= m_vecLegs.size())
+		return;
+
+	Leg leg = makeLeg(cGpsPoint);
+	Leg& oldLeg = m_vecLegs[ulPoint];
+
+	// Unsigned wrap around gives the difference
+	Leg delta = { leg.ulDistance - oldLeg.ulDistance, leg.ulDuration - oldLeg.ulDuration, leg.ulMissing - oldLeg.ulMissing };
+	oldLeg = leg;
+
+	for (size_t i = ulPoint + 1; i < m_vecTree.size(); i += i & (~i + 1))
+		m_vecTree[i] += delta;
+}
+
+void CGpsLegIndex::clear()
+{
+	m_vecLegs.clear();
+	m_vecTree.clear();
+}
+
+CGpsLegIndex::Leg CGpsLegIndex::sum(size_t ulPoint) const
+{
+	Leg leg = { 0, 0, 0 };
+	for (size_t i = std::min(ulPoint + 1, m_vecLegs.size()); i > 0; i -= i & (~i + 1))
+		leg += m_vecTree[i];
+
+	return leg;
+}
+
+size_t CGpsLegIndex::distance(size_t ulPoint) const
+{
+	return sum(ulPoint).ulDistance;
+}
+
+size_t CGpsLegIndex::duration(size_t ulPoint) const
+{
+	return sum(ulPoint).ulDuration;
+}
+
+bool CGpsLegIndex::complete(size_t ulPoint) const
+{
+	return !sum(ulPoint).ulMissing;
+}
+
+size_t CGpsLegIndex::distance(size_t ulFirst, size_t ulLast) const
+{
+	return ulLast > ulFirst ? distance(ulLast) - distance(ulFirst) : 0;
+}
+
+size_t CGpsLegIndex::duration(size_t ulFirst, size_t ulLast) const
+{
+	return ulLast > ulFirst ? duration(ulLast) - duration(ulFirst) : 0;
+}
+
+size_t CGpsLegIndex::totalDistance() const
+{
+	return m_vecLegs.empty() ? 0 : distance(m_vecLegs.size() - 1);
+}
+
+size_t CGpsLegIndex::totalDuration() const
+{
+	return m_vecLegs.empty() ? 0 : duration(m_vecLegs.size() - 1);
+}
+
+bool CGpsLegIndex::complete() const
+{
+	return m_vecLegs.empty() || complete(m_vecLegs.size() - 1);
+}
+
+size_t CGpsLegIndex::find(size_t Leg::* pValue, size_t ulValue) const
+{
+	size_t ulStep = 1;
+	while (ulStep * 2 < m_vecTree.size())
+		ulStep *= 2;
+
+	// Largest prefix whose sum is below the value
+	size_t ulPosition = 0;
+	for (; ulStep > 0; ulStep /= 2)
+	{
+		size_t ulNext = ulPosition + ulStep;
+		if (ulNext < m_vecTree.size() && m_vecTree[ulNext].*pValue < ulValue)
+		{
+			ulPosition = ulNext;
+			ulValue -= m_vecTree[ulNext].*pValue;
+		}
+	}
+
+	return ulPosition;
+}
+
+size_t CGpsLegIndex::findDistance(size_t ulDistance) const
+{
+	return find(&Leg::ulDistance, ulDistance);
+}
+
+size_t CGpsLegIndex::findDuration(size_t ulDuration) const
+{
+	return find(&Leg::ulDuration, ulDuration);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if !defined(_GPSLEGINDEX_H_INCLUDED_)
+#define _GPSLEGINDEX_H_INCLUDED_
+
+#include <vector>
+
+class CGpsPoint;
+
+// Prefix sums of the distance and duration of the legs of a route (Fenwick tree).
+// The leg of a point goes from the previous point, the first point has none.
+// A leg update and every query are in O(log n).
+class CGpsLegIndex
+{
+public:
+	CGpsLegIndex() = default;
+	~CGpsLegIndex() = default;
+
+	template <class InputIterator> void assign(InputIterator first, InputIterator last)
+	{
+		m_vecLegs.clear();
+		for (InputIterator it = first; it != last; ++it)
+			m_vecLegs.push_back(makeLeg(*it));
+
+		build();
+	}
+
+	void update(size_t ulPoint, const CGpsPoint& cGpsPoint);
+	void clear();
+
+	size_t size() const { return m_vecLegs.size(); }
+
+	// From the first point to ulPoint
+	size_t distance(size_t ulPoint) const;
+	size_t duration(size_t ulPoint) const;
+	bool complete(size_t ulPoint) const; // All the legs have a valid route
+
+	// From ulFirst to ulLast
+	size_t distance(size_t ulFirst, size_t ulLast) const;
+	size_t duration(size_t ulFirst, size_t ulLast) const;
+
+	size_t totalDistance() const;
+	size_t totalDuration() const;
+	bool complete() const;
+
+	// Point at the end of the leg containing a distance or a duration from the start, size() if beyond
+	size_t findDistance(size_t ulDistance) const;
+	size_t findDuration(size_t ulDuration) const;
+
+private:
+	struct Leg
+	{
+		size_t ulDistance;
+		size_t ulDuration;
+		size_t ulMissing;
+
+		Leg& operator+=(const Leg& leg) { ulDistance += leg.ulDistance; ulDuration += leg.ulDuration; ulMissing += leg.ulMissing; return *this; }
+	};
+
+	static Leg makeLeg(const CGpsPoint& cGpsPoint);
+
+	void build();
+	Leg sum(size_t ulPoint) const;
+	size_t find(size_t Leg::* pValue, size_t ulValue) const;
+
+	std::vector<Leg> m_vecLegs;
+	std::vector<Leg> m_vecTree; // 1-based
+};
+
+#endif // !defined(_GPSLEGINDEX_H_INCLUDED_)
@@ -33,6 +33,7 @@
 class CGpsPoiArray : public CGpsPointArray
 {
 public:
+	explicit CGpsPoiArray(std::pmr::memory_resource* pResource = std::pmr::get_default_resource()) : CGpsPointArray(pResource) {}
 	virtual ~CGpsPoiArray() {}
 
 	virtual E_ARRAY_TYPE getType() const { return E_ARRAY_POI; }
@@ -28,6 +28,25 @@
 #include "stdafx.h"
 #include "GpsPoint.h"
 
+const geo::CGeoPolylinePyramid& CRouteInfo::pyramid() const
+{
+	// Reset by every mutating accessor
+	if (!m_pgPyramid)
+		m_pgPyramid = std::make_shared<geo::CGeoPolylinePyramid>(m_pgRoute->polyline().getPath());
+
+	return *m_pgPyramid;
+}
+
+geo::CGeoRoute& CRouteInfo::detach()
+{
+	if (m_pgRoute.use_count() > 1)
+		m_pgRoute = std::make_shared<geo::CGeoRoute>(*m_pgRoute);
+
+	// The route may be changed through the returned reference
+	m_pgPyramid.reset();
+	return *m_pgRoute;
+}
+
 CGpsPoint::CGpsPoint() :
 	m_pcRouteInfo(nullptr)
 {
@@ -41,6 +60,13 @@ CGpsPoint::CGpsPoint(const CGpsPoint& gpsPoint) :
 		m_pcRouteInfo = new CRouteInfo(*(gpsPoint.m_pcRouteInfo));
 }
 
+CGpsPoint::CGpsPoint(CGpsPoint&& gpsPoint) noexcept :
+	geo::CGeoLocation(std::move(gpsPoint)),
+	m_pcRouteInfo(gpsPoint.m_pcRouteInfo)
+{
+	gpsPoint.m_pcRouteInfo = nullptr;
+}
+
 CGpsPoint::CGpsPoint(const geo::CGeoLocation& gLocation) :
 	geo::CGeoLocation(gLocation),
 	m_pcRouteInfo(nullptr)
@@ -82,6 +108,20 @@ CGpsPoint& CGpsPoint::operator=(const CGpsPoint& gpsPoint)
 	return *this;
 }
 
+CGpsPoint& CGpsPoint::operator=(CGpsPoint&& gpsPoint) noexcept
+{
+	if (&gpsPoint == this)
+		return *this;
+
+	geo::CGeoLocation::operator=(std::move(gpsPoint));
+	clearRouteInfo();
+
+	m_pcRouteInfo = gpsPoint.m_pcRouteInfo;
+	gpsPoint.m_pcRouteInfo = nullptr;
+
+	return *this;
+}
+
 void CGpsPoint::clear()
 {
 	geo::CGeoLocation::clear();
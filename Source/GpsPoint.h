@@ -28,24 +28,30 @@
 #if !defined(_GPSPOINT_H_INCLUDED_)
 #define _GPSPOINT_H_INCLUDED_
 
+#include <memory>
 #include "GeoServices/GeoServices.h"
+#include "GeoServices/GeoPolylinePyramid.h"
 
 class CRouteInfo
 {
 private:
 	size_t m_ulCumulativeDistance;
 	size_t m_ulCumulativeDuration;
-	geo::CGeoRoute m_gRoute;
+	std::shared_ptr<geo::CGeoRoute> m_pgRoute; // Shared between copies, copied on first change
+	mutable std::shared_ptr<const geo::CGeoPolylinePyramid> m_pgPyramid;
+
+	geo::CGeoRoute& detach(); // Unshares the route and resets the pyramid, used by all mutating accessors
 
 public:
 	CRouteInfo(const geo::CGeoRoute& gRoute) :
 		m_ulCumulativeDistance(0),
 		m_ulCumulativeDuration(0),
-		m_gRoute(gRoute) {}
+		m_pgRoute(std::make_shared<geo::CGeoRoute>(gRoute)) {}
 	CRouteInfo(const CRouteInfo& cRouteInfo) :
 		m_ulCumulativeDistance(cRouteInfo.m_ulCumulativeDistance),
 		m_ulCumulativeDuration(cRouteInfo.m_ulCumulativeDuration),
-		m_gRoute(cRouteInfo.m_gRoute) {}
+		m_pgRoute(cRouteInfo.m_pgRoute),
+		m_pgPyramid(cRouteInfo.m_pgPyramid) {}
 
 	virtual ~CRouteInfo() {}
 
@@ -55,14 +61,17 @@ public:
 	virtual size_t cumulativeDuration() const throw() { return m_ulCumulativeDuration; }
 	virtual size_t& cumulativeDuration() throw() { return m_ulCumulativeDuration; }
 
-	virtual const geo::CGeoRoute& route() const throw() { return m_gRoute; }
-	virtual geo::CGeoRoute& route() throw() { return m_gRoute; }
+	virtual const geo::CGeoRoute& route() const throw() { return *m_pgRoute; }
+	virtual geo::CGeoRoute& route() { return detach(); }
+
+	virtual const geo::CGeoSummary& summary() const throw() { return m_pgRoute->summary(); }
+	virtual geo::CGeoSummary& summary() { return detach().summary(); }
 
-	virtual const geo::CGeoSummary& summary() const throw() { return m_gRoute.summary(); }
-	virtual geo::CGeoSummary& summary() throw() { return m_gRoute.summary(); }
+	virtual const geo::CGeoPolyline& polyline() const throw() { return m_pgRoute->polyline(); }
+	virtual geo::CGeoPolyline& polyline() { return detach().polyline(); }
 
-	virtual const geo::CGeoPolyline& polyline() const throw() { return m_gRoute.polyline(); }
-	virtual geo::CGeoPolyline& polyline() throw() { return m_gRoute.polyline(); }
+	// Level of detail of the polyline for map display, built on first use
+	virtual const geo::CGeoPolylinePyramid& pyramid() const;
 };
 
 class CGpsPoint : public geo::CGeoLocation
@@ -73,17 +82,20 @@ private:
 public:
 	CGpsPoint();
 	CGpsPoint(const CGpsPoint& gpsPoint);
+	CGpsPoint(CGpsPoint&& gpsPoint) noexcept;
 	CGpsPoint(const geo::CGeoLocation& gLocation);
 	virtual ~CGpsPoint();
 
 	CGpsPoint& operator=(const geo::CGeoLatLng& gLatLng);
 	CGpsPoint& operator=(const geo::CGeoLocation& gLocation);
 	CGpsPoint& operator=(const CGpsPoint& gpsPoint);
+	CGpsPoint& operator=(CGpsPoint&& gpsPoint) noexcept;
 
 	virtual void clear();
 
 	virtual void setRouteInfo(const geo::CGeoRoute& gRoute);
 	virtual CRouteInfo* routeInfo() throw() { return m_pcRouteInfo; }
+	virtual const CRouteInfo* routeInfo() const throw() { return m_pcRouteInfo; }
 	virtual void clearRouteInfo();
 };
 
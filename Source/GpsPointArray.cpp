@@ -27,15 +27,13 @@
 
 #include "stdafx.h"
 #include <algorithm>
+#include <iterator>
 #include "GpsPointArray.h"
+#include "GeoServices/GeoLatLngSet.h"
+#include "GeoServices/GeoSimplifier.h"
 
 namespace
 {
-	bool uniquePred(const CGpsPoint& gpsPoint1, const CGpsPoint& gpsPoint2)
-	{
-		return static_cast<const geo::CGeoLatLng&>(gpsPoint1) == static_cast<const geo::CGeoLatLng&>(gpsPoint2);
-	}
-
 	bool sortPred(const CGpsPoint& gpsPoint1, const CGpsPoint& gpsPoint2)
 	{
 		return gpsPoint1.name() < gpsPoint2.name();
@@ -51,19 +49,31 @@ namespace
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-CGpsPointArray::CGpsPointArray() : std::deque<CGpsPoint>()
+CGpsPointArray::CGpsPointArray(std::pmr::memory_resource* pResource) :
+	std::pmr::deque<CGpsPoint>(pResource),
+	m_bLegIndexValid(false)
 {
 }
 
 CGpsPointArray::CGpsPointArray(const CGpsPointArray& array) :
-	std::deque<CGpsPoint>(array),
-	m_sName(array.m_sName)
+	std::pmr::deque<CGpsPoint>(array, std::pmr::get_default_resource()),
+	m_sName(array.m_sName),
+	m_bLegIndexValid(false)
 {
 }
 
+CGpsPointArray::CGpsPointArray(CGpsPointArray&& array) :
+	std::pmr::deque<CGpsPoint>(std::move(array), std::pmr::get_default_resource()), // Element-wise out of an arena
+	m_sName(std::move(array.m_sName)),
+	m_bLegIndexValid(false)
+{
+	array.invalidateLegs();
+}
+
 CGpsPointArray::CGpsPointArray(const CGpsPointArray& array, size_t begin, size_t count) :
-	std::deque<CGpsPoint>(),
-	m_sName(array.m_sName)
+	std::pmr::deque<CGpsPoint>(std::pmr::get_default_resource()),
+	m_sName(array.m_sName),
+	m_bLegIndexValid(false)
 {
 	const_iterator itFirst = array.begin();
 	const_iterator itLast = array.end();
@@ -86,12 +96,26 @@ CGpsPointArray& CGpsPointArray::operator=(const CGpsPointArray& array)
 
 	assign(array.begin(), array.end());
 	m_sName = array.m_sName;
+	invalidateLegs();
+	return *this;
+}
+
+CGpsPointArray& CGpsPointArray::operator=(CGpsPointArray&& array)
+{
+	if (&array == this)
+		return *this;
+
+	std::pmr::deque<CGpsPoint>::operator=(std::move(array));
+	m_sName = std::move(array.m_sName);
+	invalidateLegs();
+	array.invalidateLegs();
 	return *this;
 }
 
 CGpsPointArray& CGpsPointArray::operator=(const geo::CGeoLocations& gLocations)
 {
 	assign(gLocations.begin(), gLocations.end());
+	invalidateLegs();
 	return *this;
 }
 
@@ -104,6 +128,17 @@ CGpsPointArray& CGpsPointArray::operator+=(const CGpsPointArray& array)
 	return *this;
 }
 
+CGpsPointArray& CGpsPointArray::operator+=(CGpsPointArray&& array)
+{
+	if (&array == this)
+		return *this;
+
+	append(std::make_move_iterator(array.begin()), std::make_move_iterator(array.end()));
+	array.std::pmr::deque<CGpsPoint>::clear();
+	array.invalidateLegs();
+	return *this;
+}
+
 CGpsPointArray& CGpsPointArray::operator+=(const geo::CGeoLocations& gLocations)
 {
 	append(gLocations.begin(), gLocations.end());
@@ -118,7 +153,8 @@ bool CGpsPointArray::operator==(const CGpsPointArray& array) const
 void CGpsPointArray::clear()
 {
 	m_sName.clear();
-	std::deque<CGpsPoint>::clear();
+	std::pmr::deque<CGpsPoint>::clear();
+	invalidateLegs();
 }
 
 size_t CGpsPointArray::upper_bound() const
@@ -134,7 +170,20 @@ void CGpsPointArray::insert(size_t pos, const CGpsPoint& cGpsPoint)
 	iterator it = begin();
 	std::advance(it, pos);
 
-	std::deque<CGpsPoint>::insert(it, cGpsPoint);
+	std::pmr::deque<CGpsPoint>::insert(it, cGpsPoint);
+	invalidateLegs();
+}
+
+void CGpsPointArray::insert(size_t pos, CGpsPoint&& cGpsPoint)
+{
+	if (pos < size())
+		at(pos).clearRouteInfo();
+
+	iterator it = begin();
+	std::advance(it, pos);
+
+	std::pmr::deque<CGpsPoint>::insert(it, std::move(cGpsPoint));
+	invalidateLegs();
 }
 
 void CGpsPointArray::erase(size_t pos)
@@ -142,23 +191,25 @@ void CGpsPointArray::erase(size_t pos)
 	iterator it = begin();
 	std::advance(it, pos);
 
-	std::deque<CGpsPoint>::erase(it);
+	std::pmr::deque<CGpsPoint>::erase(it);
 
 	if (pos < size())
 		at(pos).clearRouteInfo();
+
+	invalidateLegs();
 }
 
 void CGpsPointArray::move(size_t posSrc, size_t posDst)
 {
 	if (posSrc != posDst)
 	{
-		CGpsPoint cGpsPoint(at(posSrc));
+		CGpsPoint cGpsPoint(std::move(at(posSrc)));
 		erase(posSrc);
 
 		if (posDst > posSrc)
 			posDst--;
 
-		insert(posDst, cGpsPoint);
+		insert(posDst, std::move(cGpsPoint));
 
 		iterator itSrc = begin();
 		iterator itDst = begin();
@@ -187,20 +238,117 @@ void CGpsPointArray::reverse()
 		it->clearRouteInfo();
 
 	std::reverse(begin(), end());
+	invalidateLegs();
 }
 
 void CGpsPointArray::sortByAddress()
 {
 	std::stable_sort(begin(), end(), sortPred);
+	invalidateLegs();
 }
 
-void CGpsPointArray::removeDuplicates()
+size_t CGpsPointArray::removeDuplicates(double dPrecision, std::vector<size_t>* pvecRemoved)
 {
-	std::stable_sort(begin(), end());
-	resize(std::unique(begin(), end(), uniquePred) - begin());
+	geo::CGeoLatLngSet gLatLngSet(dPrecision > 0 ? dPrecision : precision(), size());
+	iterator itDst = begin();
+	bool bRemoved = false;
+
+	for (iterator itSrc = begin(); itSrc != end(); ++itSrc)
+	{
+		if (!gLatLngSet.insert(*itSrc))
+		{
+			if (pvecRemoved)
+				pvecRemoved->push_back(static_cast<size_t>(itSrc - begin()));
+			bRemoved = true;
+			continue;
+		}
+
+		if (itDst != itSrc)
+			*itDst = std::move(*itSrc);
+
+		// The route from the previous point is no more valid
+		if (bRemoved)
+			itDst->clearRouteInfo();
+
+		bRemoved = false;
+		++itDst;
+	}
+
+	size_t ulRemoved = static_cast<size_t>(end() - itDst);
+	resize(size() - ulRemoved);
+	invalidateLegs();
+	return ulRemoved;
 }
 
 void CGpsPointArray::removeEmpties()
 {
 	resize(std::remove_if(begin(), end(), removePred) - begin());
+	invalidateLegs();
+}
+
+size_t CGpsPointArray::simplify(const geo::CGeoSimplifier& gSimplifier, const std::vector<size_t>& vecAnchors)
+{
+	geo::GeoCoordinates gCoordinates;
+	gCoordinates.reserve(size());
+	for (const_iterator cit = begin(); cit != end(); ++cit)
+		gCoordinates.push_back({ cit->lat(), cit->lng(), cit->alt() });
+
+	std::vector<size_t> vecKept;
+	gSimplifier.simplify(gCoordinates.data(), gCoordinates.size(), vecKept, vecAnchors);
+	if (vecKept.size() == size())
+		return 0;
+
+	iterator itDst = begin();
+	size_t ulPrevious = 0;
+
+	for (size_t ulKept : vecKept)
+	{
+		iterator itSrc = begin() + ulKept;
+		if (itDst != itSrc)
+			*itDst = std::move(*itSrc);
+
+		// The route from the previous point is no more valid
+		if (ulKept > ulPrevious + 1)
+			itDst->clearRouteInfo();
+
+		ulPrevious = ulKept;
+		++itDst;
+	}
+
+	size_t ulRemoved = static_cast<size_t>(end() - itDst);
+	resize(size() - ulRemoved);
+	invalidateLegs();
+	return ulRemoved;
+}
+
+double CGpsPointArray::precision() const
+{
+	double dPrecision = 0;
+	for (const_iterator cit = begin(); cit != end(); ++cit)
+		dPrecision = std::max(dPrecision, cit->precision());
+
+	return dPrecision;
+}
+
+const CGpsLegIndex& CGpsPointArray::legIndex() const
+{
+	// Points may also be added through the deque interface
+	if (!m_bLegIndexValid || m_LegIndex.size() != size())
+	{
+		m_LegIndex.assign(begin(), end());
+		m_bLegIndexValid = true;
+	}
+
+	return m_LegIndex;
+}
+
+void CGpsPointArray::updateLeg(size_t pos)
+{
+	if (m_bLegIndexValid && pos < size())
+		m_LegIndex.update(pos, at(pos));
+}
+
+void CGpsPointArray::invalidateLegs()
+{
+	m_bLegIndexValid = false;
 }
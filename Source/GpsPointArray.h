@@ -29,9 +29,19 @@
 #define _GPSPOINTARRAY_H_INCLUDED_
 
 #include <deque>
+#include <memory_resource>
+#include <vector>
 #include "GpsPoint.h"
+#include "GpsLegIndex.h"
 
-class CGpsPointArray : public std::deque<CGpsPoint>
+namespace geo
+{
+	class CGeoSimplifier;
+}
+
+// The points are allocated from the memory resource given at construction, readers get the arena of the file, see CGpsArena.
+// Copies and moves use the default resource.
+class CGpsPointArray : public std::pmr::deque<CGpsPoint>
 {
 public:
 	typedef enum
@@ -43,16 +53,19 @@ public:
 		E_ARRAY_NB
 	} E_ARRAY_TYPE;
 
-	CGpsPointArray();
+	explicit CGpsPointArray(std::pmr::memory_resource* pResource = std::pmr::get_default_resource());
 	CGpsPointArray(const CGpsPointArray& array);
+	CGpsPointArray(CGpsPointArray&& array);
 	CGpsPointArray(const CGpsPointArray& array, size_t begin, size_t count = 0);
-	template <class InputIterator> CGpsPointArray(InputIterator first, InputIterator last) : std::deque<CGpsPoint>(first, last) {}
+	template <class InputIterator> CGpsPointArray(InputIterator first, InputIterator last) : std::pmr::deque<CGpsPoint>(first, last, std::pmr::get_default_resource()), m_bLegIndexValid(false) {}
 	virtual ~CGpsPointArray() {}
 
 	virtual CGpsPointArray& operator= (const CGpsPointArray& array);
+	virtual CGpsPointArray& operator= (CGpsPointArray&& array);
 	virtual CGpsPointArray& operator= (const geo::CGeoLocations& gLocations);
 
 	virtual CGpsPointArray& operator+=(const CGpsPointArray& array);
+	virtual CGpsPointArray& operator+=(CGpsPointArray&& array); // Points are moved, the name is kept
 	virtual CGpsPointArray& operator+=(const geo::CGeoLocations& gLocations);
 
 	bool operator==(const CGpsPointArray& array) const;
@@ -64,6 +77,7 @@ public:
 
 	template <class InputIterator> void append(InputIterator first, InputIterator last)
 	{
+		invalidateLegs();
 		for (InputIterator it = first; it != last; ++it)
 			push_back(*it);
 	}
@@ -71,16 +85,30 @@ public:
 	virtual void clear();
 	virtual size_t upper_bound() const;
 	virtual void insert(size_t pos, const CGpsPoint& cGpsPoint);
+	virtual void insert(size_t pos, CGpsPoint&& cGpsPoint);
 	virtual void erase(size_t pos);
 	virtual void move(size_t posSrc, size_t posDst);
 	virtual void reverse();
 
 	virtual void sortByAddress();
-	virtual void removeDuplicates();
+	// Keep the first occurrence of each coordinate and the original order.
+	// A null precision means the largest precision of the points.
+	virtual size_t removeDuplicates(double dPrecision = 0, std::vector<size_t>* pvecRemoved = nullptr);
 	virtual void removeEmpties();
+	// Remove the points discarded by the simplifier, anchors are always kept.
+	virtual size_t simplify(const geo::CGeoSimplifier& gSimplifier, const std::vector<size_t>& vecAnchors = std::vector<size_t>());
+
+	virtual double precision() const;
+
+	// Distance and duration sums of the legs, rebuilt on first use after the points changed
+	const CGpsLegIndex& legIndex() const;
+	void updateLeg(size_t pos); // The route of the point changed
+	void invalidateLegs();
 
 private:
 	std::string m_sName;
+	mutable CGpsLegIndex m_LegIndex;
+	mutable bool m_bLegIndexValid;
 };
 
 #endif // !defined(_GPSPOINTARRAY_H_INCLUDED_)
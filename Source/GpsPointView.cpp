@@ -395,10 +395,12 @@ void CGpsPointView::Deplace(int nIndex, const geo::CGeoLatLng& cgLatLng)
 	CGpsPoint& cGpsPoint = m_pcGpsPointArray->at(nIndex);
 	cGpsPoint = cgLatLng;
 	cGpsPoint.clearRouteInfo();
+	m_pcGpsPointArray->updateLeg(nIndex);
 
 	if (nIndex + 1 < GetItemCount())
 	{
 		m_pcGpsPointArray->at(nIndex + 1).clearRouteInfo();
+		m_pcGpsPointArray->updateLeg(nIndex + 1);
 		OnRefresh(nIndex, 2);
 	}
 	else
@@ -33,8 +33,8 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-CGpsRoute::CGpsRoute() :
-	CGpsPointArray()
+CGpsRoute::CGpsRoute(std::pmr::memory_resource* pResource) :
+	CGpsPointArray(pResource)
 {
 }
 
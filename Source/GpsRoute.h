@@ -33,7 +33,7 @@
 class CGpsRoute : public CGpsPointArray
 {
 public:
-	CGpsRoute();
+	explicit CGpsRoute(std::pmr::memory_resource* pResource = std::pmr::get_default_resource());
 	CGpsRoute(const CGpsRoute& route);
 	CGpsRoute(const CGpsPointArray& array, size_t begin = 0, size_t count = static_cast<size_t>(-1));
 	virtual ~CGpsRoute() {}
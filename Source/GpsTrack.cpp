@@ -32,7 +32,7 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-CGpsTrack::CGpsTrack() : CGpsPointArray()
+CGpsTrack::CGpsTrack(std::pmr::memory_resource* pResource) : CGpsPointArray(pResource)
 {
 }
 
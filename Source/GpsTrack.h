@@ -33,7 +33,7 @@
 class CGpsTrack : public CGpsPointArray
 {
 public:
-	CGpsTrack();
+	explicit CGpsTrack(std::pmr::memory_resource* pResource = std::pmr::get_default_resource());
 	CGpsTrack(const CGpsTrack& cGpsTrack);
 	CGpsTrack(const CGpsPointArray& array, size_t begin = 0, size_t count = static_cast<size_t>(-1));
 	virtual ~CGpsTrack() {}
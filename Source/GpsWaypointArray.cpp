@@ -32,7 +32,7 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-CGpsWaypointArray::CGpsWaypointArray() : CGpsPointArray()
+CGpsWaypointArray::CGpsWaypointArray(std::pmr::memory_resource* pResource) : CGpsPointArray(pResource)
 {
 }
 
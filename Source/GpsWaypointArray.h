@@ -33,7 +33,7 @@
 class CGpsWaypointArray : public CGpsPointArray
 {
 public:
-	CGpsWaypointArray();
+	explicit CGpsWaypointArray(std::pmr::memory_resource* pResource = std::pmr::get_default_resource());
 	CGpsWaypointArray(const CGpsWaypointArray& wptArray);
 	CGpsWaypointArray(const CGpsPointArray& array, size_t begin = 0, size_t count = static_cast<size_t>(-1));
 	virtual ~CGpsWaypointArray() {}
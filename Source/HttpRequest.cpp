@@ -43,13 +43,13 @@ CAsyncHttpRequest::CAsyncHttpRequest(CNavigator& navigator) :
 			{
 				m_lpCallback->Release();
 				m_lpCallback = nullptr;
-				m_oss.str(std::string());
+				m_strResponse.clear();
 			};
 
 			try
 			{
 				std::unique_ptr<CJavaScript> pScript = std::make_unique<CJavaScript>(m_lpCallback);
-				pScript->arg(exception.code()).arg(std::move(m_oss.str()));
+				pScript->arg(exception.code()).arg(std::move(m_strResponse));
 				m_Navigator.PostJavaScript(pScript);
 			}
 			catch (...) {}
@@ -62,7 +62,7 @@ CAsyncHttpRequest::CAsyncHttpRequest(CNavigator& navigator) :
 				try
 				{
 					m_lpCallback = request.lpCallback;
-					m_inetHttpSession.send(m_oss, request.strRequest, std::string(), request.strReferrer, request.strHost);
+					m_inetHttpSession.send(m_strResponse, request.strRequest, std::string(), request.strReferrer, request.strHost);
 				}
 				catch (...)
 				{
@@ -90,7 +90,7 @@ void CAsyncHttpRequest::PostRequest(const std::string& strRequest, const std::st
 	if (!m_lpCallback) // No current request
 	{
 		m_lpCallback = lpCallback;
-		m_inetHttpSession.send(m_oss, strRequest, std::string(), strReferrer, strHost);
+		m_inetHttpSession.send(m_strResponse, strRequest, std::string(), strReferrer, strHost);
 	}
 	else
 	{
@@ -28,7 +28,7 @@
 #ifndef __HTTP_REQUEST_H_
 #define __HTTP_REQUEST_H_
 
-#include <sstream>
+#include <string>
 #include "stdx/concurrent_queue.h"
 #include "ToolsLibrary/Internet.h"
 
@@ -68,7 +68,7 @@ private:
 	std::mutex m_Mutex;
 	stdx::concurrent_queue<Request> m_Requests;
 	CInternetHttpSession m_inetHttpSession;
-	std::stringstream m_oss;
+	std::string m_strResponse;
 	IDispatch* m_lpCallback;
 };
 
@@ -30,6 +30,8 @@
 #include "ITN ConverterDlg.h"
 #include "ToolsLibrary/ToolsString.h"
 #include "storage/Registry.h"
+#include "GeoServices/GeoGazetteer.h"
+#include "GeoServices/SrtmElevation.h"
 
 #ifdef LOG_TO_FILE
 #include <iostream>
@@ -258,6 +260,18 @@ BOOL CITNConverterApp::InitInstance()
 
 	geo::CGeoProviders::instance().setDefaultProvider(geo::E_GEO_PROVIDER_BING_API);
 
+	// Offline country and place lookup and elevation tiles, if they are installed next to the executable
+	wchar_t szModulePath[MAX_PATH];
+	if (GetModuleFileNameW(nullptr, szModulePath, MAX_PATH))
+	{
+		std::wstring strModuleDirectory = CWToolsString::FileDirectory(std::wstring(szModulePath));
+		geo::CGeoGazetteer::instance().open(strModuleDirectory + L"gazetteer.idx");
+
+		DWORD dwAttributes = GetFileAttributesW((strModuleDirectory + L"dem").c_str());
+		if (dwAttributes != INVALID_FILE_ATTRIBUTES && (dwAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			geo::CSrtmElevation::setDirectory(strModuleDirectory + L"dem");
+	}
+
 	RegParam().Init(_T(REGISTRY_KEY));
 
 	// Set appropriate language
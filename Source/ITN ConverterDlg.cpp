@@ -29,6 +29,7 @@
 
 #include "stdafx.h"
 #include <algorithm>
+#include <stdexcept>
 #include "AboutDlg.h"
 #include "ITN ConverterDlg.h"
 #include "ITN FileDialog.h"
@@ -36,8 +37,11 @@
 #include "EditorDlg.h"
 #include "InsertModify.h"
 #include "ChooseArrayDlg.h"
+#include "GpsArena.h"
 #include "stdx/guard.h"
 #include "stdx/uri_helper.h"
+#include "GeoServices/GeoSimplifier.h"
+#include "GeoServices/GeoString.h"
 
 static CGpsPointView::RVCOLUMN sTabColumn[] =
 {
@@ -286,6 +290,11 @@ BOOL CITNConverterDlg::OnInitDialog()
 	pWnd = GetDlgItem(IDC_LABEL_EXPORT);
 	pWnd->SetWindowText(CWToolsString::Load(IDS_LABEL_EXPORT).c_str());
 	AddSizeableControl(pWnd, E_RESIZE_PROP_TOP);
+
+	pWnd = GetDlgItem(IDC_CHECK_SIMPLIFY);
+	pWnd->SetWindowText(CWToolsString::Load(IDS_SIMPLIFY_TRACK).c_str());
+	((CButton*)pWnd)->SetCheck(CITNConverterApp::RegParam().SimplifyTrack() ? BST_CHECKED : BST_UNCHECKED);
+	AddSizeableControl(pWnd, E_RESIZE_PROP_TOP | E_RESIZE_PROP_WIDTH);
 #ifdef IDB_EXPORT_BT_ON
 	m_bstExport.DrawTransparent(TRUE);
 	m_bstExport.DrawBorder(FALSE);
@@ -803,6 +812,7 @@ void CITNConverterDlg::Clear()
 {
 	m_cGpsRoute.clear();
 	m_strPathName.clear();
+	m_bTrack = false;
 }
 
 int CITNConverterDlg::OpenFile(const CString& sFileName, bool bAppend, bool bCmdLine)
@@ -831,6 +841,7 @@ int CITNConverterDlg::OpenFile(const CString& sFileName, bool bAppend, bool bCmd
 int CITNConverterDlg::ReadFile(_ReadFile* pReadFile, const CString& sFileName, bool bAppend, bool bCmdLine)
 {
 	HRESULT hr = ERROR_BAD_FORMAT;
+	CGpsArena gpsArena; // Released after the arrays
 	std::vector<CGpsPointArray*> vecGpsArray;
 	std::vector<CGpsPointArray*>::iterator it;
 
@@ -839,9 +850,14 @@ int CITNConverterDlg::ReadFile(_ReadFile* pReadFile, const CString& sFileName, b
 			// Delete Array list
 			for (it = vecGpsArray.begin(); it != vecGpsArray.end(); ++it)
 				delete* it;
+
+			// Release the names and comments of the points not kept
+			geo::CGeoStringPool::instance().purge();
 		});
 
-	hr = pReadFile((LPCTSTR)sFileName, vecGpsArray, bCmdLine);
+	// The points read are allocated from the arena, the selected ones are moved out of it
+	hr = pReadFile((LPCTSTR)sFileName, vecGpsArray, bCmdLine, gpsArena.resource());
+
 	if (hr != S_OK)
 		return hr;
 
@@ -879,9 +895,15 @@ int CITNConverterDlg::ReadFile(_ReadFile* pReadFile, const CString& sFileName, b
 			std::vector<CGpsPointArray*>::const_iterator cit;
 			const std::vector<CGpsPointArray*>& vecSelectedArray = dlg.GetSelectedArray();
 
+			// Points of routes and waypoint lists are user waypoints, they are never simplified
+			bool bTrack = m_bTrack || m_cGpsRoute.empty();
+			for (cit = vecSelectedArray.begin(); cit != vecSelectedArray.end(); ++cit)
+				bTrack = bTrack && (*cit)->getType() == CGpsPointArray::E_ARRAY_TRACK;
+			m_bTrack = bTrack;
+
 			for (cit = vecSelectedArray.begin(); cit != vecSelectedArray.end(); ++cit)
 			{
-				m_cGpsRoute += **cit;
+				m_cGpsRoute += std::move(**cit); // The read arrays are deleted afterwards
 				if (m_cGpsRoute.name().empty() && !(*cit)->name().empty())
 					m_cGpsRoute.name((*cit)->name());
 			}
@@ -959,7 +981,47 @@ int CITNConverterDlg::ExportFile(const CString& sFileName, const FileFormatDesc&
 	}
 #endif
 
-	HRESULT hr = (fileFormat.pWriteFile)((LPCTSTR)sFileName, m_cGpsRoute, dwFlag, bCmdLine);
+	CRegParam& regParam = CITNConverterApp::RegParam();
+	regParam.SimplifyTrack() = (((CButton*)GetDlgItem(IDC_CHECK_SIMPLIFY))->GetCheck() == BST_CHECKED);
+
+	// Only a track read from a file is simplified, the point budget applies to the whole track
+	geo::CGeoSimplifier gSimplifier;
+	if (m_bTrack && regParam.SimplifyTrack())
+	{
+		try
+		{
+			gSimplifier.algorithm(static_cast<geo::CGeoSimplifier::E_SIMPLIFY_ALGORITHM>(regParam.SimplifyAlgorithm()));
+			gSimplifier.tolerance(regParam.SimplifyTolerance());
+			gSimplifier.maxPoints(regParam.SimplifyMaxPoints());
+		}
+		catch (std::invalid_argument&)
+		{
+			AfxMessageBox(IDS_ERRSAVE, MB_OK | MB_ICONSTOP);
+			return E_INVALIDARG;
+		}
+	}
+
+	HRESULT hr;
+	if (gSimplifier.enabled())
+	{
+		// Export a simplified copy, points with a calculated route are kept
+		CGpsRoute cGpsRoute(m_cGpsRoute);
+		std::vector<size_t> vecAnchors;
+
+		for (size_t i = 0; i < cGpsRoute.size(); ++i)
+		{
+			if (cGpsRoute[i].routeInfo())
+				vecAnchors.push_back(i);
+		}
+
+		cGpsRoute.simplify(gSimplifier, vecAnchors);
+		hr = (fileFormat.pWriteFile)((LPCTSTR)sFileName, cGpsRoute, dwFlag, bCmdLine);
+	}
+	else
+	{
+		hr = (fileFormat.pWriteFile)((LPCTSTR)sFileName, m_cGpsRoute, dwFlag, bCmdLine);
+	}
+
 	if (hr == S_OK)
 		m_cGpsRoute.ClearModified();
 	else
@@ -1136,6 +1198,7 @@ void CITNConverterDlg::UpdateButtons(int nIndex)
 	GetDlgItem(IDC_BUTTON_ADD)->EnableWindow(m_ListPoint.GetSelectedCount() < 2 ? TRUE : FALSE);
 	GetDlgItem(IDC_BUTTON_INVERT)->EnableWindow((ulWayPointNumber > 1) ? TRUE : FALSE);
 	GetDlgItem(IDEXPORT)->EnableWindow(ulWayPointNumber ? TRUE : FALSE);
+	GetDlgItem(IDC_CHECK_SIMPLIFY)->EnableWindow((m_bTrack && ulWayPointNumber) ? TRUE : FALSE);
 
 	/* Refresh point number label */
 	resStr.Format(IDS_WAYPOINTS_NB, ulWayPointNumber);
@@ -1170,6 +1233,9 @@ void CITNConverterDlg::OnButtonAdd()
 
 	if (dlgInsert.DoModal(cGpsPoint) == IDOK && cGpsPoint)
 	{
+		// A point added by the user is a waypoint
+		m_bTrack = false;
+
 		POSITION pos = m_ListPoint.GetFirstSelectedItemPosition();
 		if (pos)
 			m_ListPoint.Insert(m_ListPoint.GetNextSelectedItem(pos), cGpsPoint);
@@ -1198,8 +1264,14 @@ void CITNConverterDlg::OnButtonModify()
 	while (pos)
 	{
 		if (CInsertModify().DoModal(m_cGpsRoute[m_ListPoint.GetNextSelectedItem(pos)]) == IDOK)
+		{
+			// A point changed by the user is a waypoint
+			m_bTrack = false;
 			m_ListPoint.Modify();
+		}
 	}
+
+	GetDlgItem(IDC_CHECK_SIMPLIFY)->EnableWindow((m_bTrack && !m_cGpsRoute.empty()) ? TRUE : FALSE);
 }
 
 void CITNConverterDlg::OnDblclkList(NMHDR*, LRESULT* pResult)
@@ -1428,7 +1500,10 @@ void CITNConverterDlg::OnButtonEditor()
 	{
 		ScopedWaitCursor swc(*this);
 
+		// Points added or moved in the editor are waypoints
+		const CGpsRoute cGpsRouteOrg(m_cGpsRoute);
 		CEditorDlg(m_cGpsRoute).DoModal();
+		m_bTrack = m_bTrack && m_cGpsRoute == cGpsRouteOrg;
 
 		/* Update route name */
 		m_EditName.SetWindowText(stdx::wstring_helper::from_utf8(m_cGpsRoute.name()).c_str());
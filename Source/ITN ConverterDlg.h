@@ -77,6 +77,7 @@ private:
 	};
 
 	CGpsRoute m_cGpsRoute;
+	bool m_bTrack; // Points read from tracks only, they can be simplified on export
 	std::wstring	m_strPathName;
 	CMenu m_PopupMenu;
 	CBitmap m_bmpMenuArray[BMP_MENU_NUMBER]; // bmp 16x16 pixels
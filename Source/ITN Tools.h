@@ -96,56 +96,56 @@
 #define TYPE_TTD  SET_TYPE(ttd)
 #define TYPE_HTM  SET_TYPE(html)
 
-int ReadITN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadRTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadAXE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadMPS(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadGDB(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadKML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadDAT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadRDN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadBCR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadOZI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadRT2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadPLT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadMAG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadXVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadTRP(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadURL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadLMX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadNVG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadNVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadITF(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadGPL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadFLK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadKRT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadTRL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadGCL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadWPT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadOSM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadTK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadXML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadROUTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadUPOI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadMPFCTR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadDaimlerGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
-int ReadCP10(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+int ReadITN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadRTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadAXE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadMPS(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadGDB(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadKML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadDAT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadRDN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadBCR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadOZI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadRT2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadPLT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadMAG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadXVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadTRP(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadURL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadLMX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadNVG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadNVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadITF(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadGPL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadFLK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadKRT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadTRL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadGCL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadWPT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadOSM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadTK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadXML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadROUTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadUPOI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadMPFCTR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadDaimlerGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
+int ReadCP10(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
 
 bool isGoogleURL(const std::wstring& strUrl);
-int ReadGoogleURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+int ReadGoogleURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
 
 bool isHereURL(const std::wstring& strUrl);
-int ReadHereURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+int ReadHereURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
 
 bool isViaMichelinURL(const std::wstring& strUrl);
-int ReadViaMichelinURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+int ReadViaMichelinURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
 
 bool isTomtomURL(const std::wstring& strUrl);
-int ReadTomtomURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine);
+int ReadTomtomURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource);
 
 int WriteITN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD dwFlag, bool bCmdLine);
 int WriteGPX(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD dwFlag, bool bCmdLine); // GPX format 1.0
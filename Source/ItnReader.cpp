@@ -36,7 +36,7 @@
 
 #define ITN_FACTOR   100000.
 
-int ReadITN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadITN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName);
 	if (!ifsFile)
@@ -44,7 +44,7 @@ int ReadITN(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 
 	bool bUtf8 = (stdx::bom::read(ifsFile) == stdx::bom::utf_8); // UTF-8
 
-	vecGpsArray.push_back(new CGpsRoute);
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::string strLine;
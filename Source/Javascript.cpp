@@ -47,7 +47,7 @@ namespace
 	}
 }
 
-CJavaScript::CJavaScript(IDispatch* pDispatch) : m_pDispatch(pDispatch), m_dispId(DISPID_VALUE), m_wFlag(DispatchMethod)
+CJavaScript::CJavaScript(IDispatch* pDispatch, bool bAddRef) : m_pDispatch(pDispatch, bAddRef), m_dispId(DISPID_VALUE), m_wFlag(DispatchMethod)
 {
 	if (!m_pDispatch)
 		throw CWinApiException(DISP_E_UNKNOWNINTERFACE);
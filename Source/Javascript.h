@@ -34,7 +34,7 @@
 class CJavaScript
 {
 public:
-	CJavaScript(IDispatch* pDispatch);
+	CJavaScript(IDispatch* pDispatch, bool bAddRef = true); // Without bAddRef, the script takes over the reference
 	CJavaScript(CJavaScript&& javascript);
 	~CJavaScript();
 
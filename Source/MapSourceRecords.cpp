@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stdafx.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include "MapSourceRecords.h"
+#include "GpsRoute.h"
+#include "GpsTrack.h"
+#include "GpsWaypointArray.h"
+
+namespace
+{
+	constexpr size_t RECORD_HEADER_SIZE = sizeof(unsigned int) + sizeof(unsigned char);
+	constexpr size_t WAYPOINT_CHUNK = 64; // Waypoints claimed at once by a worker
+
+	constexpr unsigned char TYPE_WAYPOINT = 'W';
+	constexpr unsigned char TYPE_TRACK = 'T';
+	constexpr unsigned char TYPE_ROUTE = 'R';
+
+	enum E_WAYPOINT_KIND : unsigned char
+	{
+		E_WAYPOINT_DAMAGED,
+		E_WAYPOINT_USER,
+		E_WAYPOINT_ROUTE // Only referenced by the routes
+	};
+
+	template <class F>
+	void ParallelDecode(size_t ulSize, size_t ulChunk, const F& decode)
+	{
+		std::atomic<size_t> ulNext(0);
+		auto worker = [&]()
+		{
+			for (size_t ulFirst = ulNext.fetch_add(ulChunk); ulFirst < ulSize; ulFirst = ulNext.fetch_add(ulChunk))
+			{
+				size_t ulLast = std::min(ulSize, ulFirst + ulChunk);
+				for (size_t i = ulFirst; i < ulLast; ++i)
+					decode(i);
+			}
+		};
+
+		size_t ulThreads = std::min<size_t>(std::max<size_t>(1, std::thread::hardware_concurrency()), (ulSize + ulChunk - 1) / ulChunk);
+		if (ulThreads > 1)
+		{
+			std::vector< std::future<void> > vecFutures;
+			for (size_t i = 1; i < ulThreads; ++i)
+				vecFutures.push_back(std::async(std::launch::async, worker));
+
+			worker();
+			for (std::future<void>& future : vecFutures)
+				future.get();
+		}
+		else
+		{
+			worker();
+		}
+	}
+}
+
+const char* CMapSourceCursor::string()
+{
+	const void* pEnd = memchr(m_lpPos, 0, remaining());
+	if (!pEnd)
+		throw std::out_of_range("Unterminated string");
+
+	const char* pszString = reinterpret_cast<const char*>(m_lpPos);
+	m_lpPos = static_cast<const unsigned char*>(pEnd) + 1;
+	return pszString;
+}
+
+const unsigned char* CMapSourceCursor::data(size_t ulSize)
+{
+	if (ulSize > remaining())
+		throw std::out_of_range("Record overflow");
+
+	const unsigned char* lpData = m_lpPos;
+	m_lpPos += ulSize;
+	return lpData;
+}
+
+MapSourceRecords IndexMapSourceRecords(const unsigned char* lpFirst, const unsigned char* lpEnd, const MapSourceTrailer& Trailer)
+{
+	MapSourceRecords records;
+
+	const unsigned char* lpPos = lpFirst;
+	while (lpPos < lpEnd && static_cast<size_t>(lpEnd - lpPos) >= RECORD_HEADER_SIZE)
+	{
+		unsigned int unLength;
+		memcpy(&unLength, lpPos, sizeof(unLength));
+
+		const unsigned char* lpData = lpPos + RECORD_HEADER_SIZE;
+		if (unLength > static_cast<size_t>(lpEnd - lpData))
+			break; // Truncated
+
+		unsigned char ucType = lpPos[sizeof(unsigned int)];
+		records.push_back({ ucType, lpData, lpData + unLength });
+		lpPos = lpData + unLength;
+
+		size_t ulTrailer = Trailer ? Trailer(ucType) : 0;
+		if (ulTrailer > static_cast<size_t>(lpEnd - lpPos))
+			break; // Truncated
+
+		lpPos += ulTrailer;
+	}
+
+	return records;
+}
+
+void DecodeMapSourceRecords(const MapSourceRecords& records, const MapSourceDecoders& decoders, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource)
+{
+	struct Track
+	{
+		CGpsPointArray* pGpsTrack;
+		CMapSourceCursor cursor;
+		size_t ulRead;
+	};
+
+	std::vector<const MapSourceRecord*> vecWaypointRecords;
+	std::vector<const MapSourceRecord*> vecRouteRecords;
+	std::vector<Track> vecTracks;
+	std::vector<CGpsPointArray*> vecRouteArrays;
+
+	vecGpsArray.push_back(new CGpsWaypointArray(pResource));
+	CGpsPointArray& cGpsWaypointsArray = *vecGpsArray.back();
+
+	// Arrays are created in the order of the file, tracks pre-sized from their header
+	for (const MapSourceRecord& record : records)
+	{
+		switch (record.ucType)
+		{
+		case TYPE_WAYPOINT:
+			vecWaypointRecords.push_back(&record);
+			break;
+
+		case TYPE_TRACK:
+			{
+				vecGpsArray.push_back(new CGpsTrack(pResource));
+				Track track = { vecGpsArray.back(), CMapSourceCursor(record), 0 };
+
+				try
+				{
+					// A point takes more than one byte, a damaged count cannot exhaust the memory
+					size_t ulSize = decoders.trackHeader(track.cursor, *track.pGpsTrack);
+					track.pGpsTrack->resize(std::min(ulSize, track.cursor.remaining()));
+					vecTracks.push_back(track);
+				}
+				catch (const std::out_of_range&)
+				{
+				}
+			}
+			break;
+
+		case TYPE_ROUTE:
+			vecGpsArray.push_back(new CGpsRoute(pResource));
+			vecRouteArrays.push_back(vecGpsArray.back());
+			vecRouteRecords.push_back(&record);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	std::vector<CGpsPoint> vecWaypoints(vecWaypointRecords.size());
+	std::vector<E_WAYPOINT_KIND> vecKinds(vecWaypointRecords.size(), E_WAYPOINT_DAMAGED);
+	std::vector< std::vector<std::string> > vecRoutes(vecRouteRecords.size());
+
+	// Tracks and routes one at a time, they can be long
+	ParallelDecode(vecTracks.size() + vecRoutes.size(), 1, [&](size_t ulJob)
+		{
+			try
+			{
+				if (ulJob < vecTracks.size())
+				{
+					Track& track = vecTracks[ulJob];
+					for (; track.ulRead < track.pGpsTrack->size(); ++track.ulRead)
+						decoders.trackPoint(track.cursor, (*track.pGpsTrack)[track.ulRead]);
+				}
+				else
+				{
+					size_t ulRoute = ulJob - vecTracks.size();
+					CMapSourceCursor cursor(*vecRouteRecords[ulRoute]);
+					decoders.route(cursor, vecRoutes[ulRoute]);
+				}
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		});
+
+	ParallelDecode(vecWaypoints.size(), WAYPOINT_CHUNK, [&](size_t ulWaypoint)
+		{
+			try
+			{
+				CMapSourceCursor cursor(*vecWaypointRecords[ulWaypoint]);
+				int nClass = decoders.waypoint(cursor, vecWaypoints[ulWaypoint]);
+				vecKinds[ulWaypoint] = nClass ? E_WAYPOINT_ROUTE : E_WAYPOINT_USER;
+			}
+			catch (const std::out_of_range&)
+			{
+			}
+		});
+
+	for (Track& track : vecTracks)
+		track.pGpsTrack->resize(track.ulRead);
+
+	// Route points by name with their record position, the first one wins
+	std::vector<CGpsPoint> vecRoutePoints;
+	std::vector<size_t> vecRoutePointRecords;
+	for (size_t i = 0; i < vecWaypoints.size(); ++i)
+	{
+		if (vecKinds[i] == E_WAYPOINT_USER)
+		{
+			cGpsWaypointsArray.push_back(std::move(vecWaypoints[i]));
+		}
+		else if (vecKinds[i] == E_WAYPOINT_ROUTE)
+		{
+			vecRoutePoints.push_back(std::move(vecWaypoints[i]));
+			vecRoutePointRecords.push_back(static_cast<size_t>(vecWaypointRecords[i] - records.data()));
+		}
+	}
+
+	std::unordered_map<std::string_view, size_t> mapRoutePoints;
+	for (size_t i = 0; i < vecRoutePoints.size(); ++i)
+		mapRoutePoints.emplace(vecRoutePoints[i].name(), i);
+
+	for (size_t ulRoute = 0; ulRoute < vecRoutes.size(); ++ulRoute)
+	{
+		const std::vector<std::string>& vecRoute = vecRoutes[ulRoute];
+		CGpsPointArray* pGpsRoute = vecRouteArrays[ulRoute];
+
+		if (vecRoute.empty())
+		{
+			vecGpsArray.erase(std::find(vecGpsArray.begin(), vecGpsArray.end(), pGpsRoute));
+			delete pGpsRoute;
+			continue;
+		}
+
+		pGpsRoute->name(vecRoute.front());
+
+		// As in a sequential read, only the points read before the route record are known
+		size_t ulRouteRecord = static_cast<size_t>(vecRouteRecords[ulRoute] - records.data());
+		for (size_t i = 1; i < vecRoute.size(); ++i)
+		{
+			auto it = mapRoutePoints.find(vecRoute[i]);
+			if (it != mapRoutePoints.end() && vecRoutePointRecords[it->second] < ulRouteRecord)
+				pGpsRoute->push_back(vecRoutePoints[it->second]);
+		}
+	}
+}
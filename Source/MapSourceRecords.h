@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, Benichou Software
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the author nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if !defined(_MAPSOURCERECORDS_H_INCLUDED_)
+#define _MAPSOURCERECORDS_H_INCLUDED_
+
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+class CGpsPoint;
+class CGpsPointArray;
+
+// Record of a Garmin MapSource database (GDB) or exchange file (MPS):
+// a 32 bits length and a type followed by the record data.
+struct MapSourceRecord
+{
+	unsigned char ucType;
+	const unsigned char* lpBegin;
+	const unsigned char* lpEnd;
+};
+
+typedef std::vector<MapSourceRecord> MapSourceRecords;
+
+// Bounds checked reads in a record, std::out_of_range is thrown when a read overflows the record
+class CMapSourceCursor
+{
+public:
+	explicit CMapSourceCursor(const MapSourceRecord& record) : m_lpPos(record.lpBegin), m_lpEnd(record.lpEnd) {}
+
+	template <class T> T read()
+	{
+		T value;
+		memcpy(&value, data(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	const char* string(); // Null terminated
+	void skip(size_t ulSize) { data(ulSize); }
+
+	size_t remaining() const { return static_cast<size_t>(m_lpEnd - m_lpPos); }
+
+private:
+	const unsigned char* data(size_t ulSize);
+
+private:
+	const unsigned char* m_lpPos;
+	const unsigned char* m_lpEnd;
+};
+
+// Format specific decoding of the records, called concurrently except trackHeader
+struct MapSourceDecoders
+{
+	std::function<int(CMapSourceCursor&, CGpsPoint&)> waypoint; // Returns the waypoint class
+	std::function<size_t(CMapSourceCursor&, CGpsPointArray&)> trackHeader; // Returns the number of points
+	std::function<void(CMapSourceCursor&, CGpsPoint&)> trackPoint;
+	std::function<void(CMapSourceCursor&, std::vector<std::string>&)> route; // Route name, then the waypoint names
+};
+
+// Bytes following a record of the given type that its length does not cover
+typedef std::function<size_t(unsigned char)> MapSourceTrailer;
+
+// First pass: index the records from lpFirst, the records overflowing lpEnd are dropped
+MapSourceRecords IndexMapSourceRecords(const unsigned char* lpFirst, const unsigned char* lpEnd, const MapSourceTrailer& Trailer = nullptr);
+
+// Second pass: decode the waypoint, track and route records on all the cores into pre-sized arrays.
+// Waypoints of class 0 fill the first array, the others resolve by name the waypoints of the routes recorded after them.
+// Tracks and routes follow in the order of the file, a damaged record keeps what was read before the damage.
+void DecodeMapSourceRecords(const MapSourceRecords& records, const MapSourceDecoders& decoders, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
+
+#endif // !defined(_MAPSOURCERECORDS_H_INCLUDED_)
@@ -34,6 +34,7 @@ CNavPointView::CNavPointView() : CGpsPointView()
 	m_pNavigator = nullptr;
 	m_nTabIndex = -1;
 	m_eViewType = E_VIEW_TYPE_DEFAULT;
+	m_bLoading = false;
 }
 
 CNavPointView::~CNavPointView()
@@ -74,7 +75,13 @@ void CNavPointView::Refresh()
 {
 	if (m_pNavigator)
 		m_pNavigator->JavaScript_ClearPushPins(m_nTabIndex);
+
+	m_bLoading = true;
 	CGpsPointView::Refresh();
+	m_bLoading = false;
+
+	if (m_pNavigator)
+		m_pNavigator->JavaScript_LoadPushPins(m_nTabIndex);
 }
 
 void CNavPointView::Clear()
@@ -94,7 +101,7 @@ void CNavPointView::OnRefresh(int nFirstIndex, int nNumber)
 bool CNavPointView::OnInsert(int nIndex)
 {
 	CGpsPointView::OnInsert(nIndex);
-	if (m_pNavigator)
+	if (m_pNavigator && !m_bLoading)
 		m_pNavigator->JavaScript_InsertPushPin(m_nTabIndex, nIndex);
 
 	return true;
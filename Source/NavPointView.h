@@ -51,6 +51,7 @@ public:
 	// Implementation
 private:
 	E_VIEW_TYPE m_eViewType;
+	bool m_bLoading; // Push pins are loaded at once by the map after a refresh
 
 protected:
 	CNavigator* m_pNavigator;
@@ -26,6 +26,8 @@
  */
 
 #include "stdafx.h"
+#include <atomic>
+#include <future>
 #include "stdx/format.h"
 #include "stdx/string_helper.h"
 #include "GeoServices/GeoServices.h"
@@ -33,12 +35,21 @@
 #include "NavRouteView.h"
 #include "travel.h"
 
+#define WM_INTERMEDIATE_STEPS WM_USER+3001
+
+BEGIN_MESSAGE_MAP(CNavRouteView, CNavPointView)
+	ON_MESSAGE(WM_INTERMEDIATE_STEPS, OnIntermediateSteps)
+END_MESSAGE_MAP()
+
 CNavRouteView::CNavRouteView() : CNavPointView()
 {
 	m_pInfoLabel = nullptr;
 	m_pDistanceLabel = nullptr;
 	m_bTempAutoCalc = false;
 	m_bRefreshAll = false;
+	m_bIntermediateProgress = false;
+	m_nIntermediateIndex = 0;
+	m_ulIntermediateSize = 0;
 }
 
 CNavRouteView::~CNavRouteView()
@@ -133,12 +144,16 @@ void CNavRouteView::DisableAutoCalc()
 	m_bTempAutoCalc = false;
 }
 
-void CNavRouteView::ClearDriving()
+void CNavRouteView::ClearDriving(bool bInvalidate)
 {
 	CGpsPointArray::iterator it;
 
+	if (bInvalidate)
+		InvalidateLegCache(true);
+
 	for (it = m_pcGpsPointArray->begin(); it != m_pcGpsPointArray->end(); ++it)
 		it->clearRouteInfo();
+	m_pcGpsPointArray->invalidateLegs();
 
 	if (m_pDistanceLabel)
 		m_pDistanceLabel->SetWindowText(_T(""));
@@ -192,36 +207,47 @@ int CNavRouteView::AddIntermediate(int nSrcIndex, int nDstIndex)
 
 	if (eStatusCode == geo::E_GEO_OK)
 	{
-		geo::CGeoRvsGeocoder gGeocoder(geo::CGeoProviders::instance().getDefaultProvider());
-
 		const geo::CGeoRoute& gRoute = gDirections->getRoutes().front();
-		size_t i = 0;
-		geo::CGeoRoute::const_iterator it;
+		std::unique_ptr<CIntermediateSteps> pSteps(new CIntermediateSteps(nSrcIndex, nDstIndex, cSrcGpsPoint, cDstGpsPoint));
+		std::vector<geo::CGeoLatLng> vecLatLngs;
 
-		for (it = gRoute.begin(); it != gRoute.end(); ++it)
+		for (geo::CGeoRoute::const_iterator it = gRoute.begin(); it != gRoute.end(); ++it)
 		{
 			CGpsPoint gpsPoint(*it);
 
 			if (gpsPoint != cSrcGpsPoint && gpsPoint != cDstGpsPoint)
 			{
-				gGeocoder->Load(gpsPoint);
-				if (gGeocoder->getStatus() == geo::E_GEO_OK && !gGeocoder->getResults().empty())
-					gpsPoint.name(gGeocoder->getResults().front().name());
-
-				m_pcGpsPointArray->insert(nDstIndex + i++, gpsPoint);
+				pSteps->vecGpsPoints.push_back(gpsPoint);
+				vecLatLngs.push_back(gpsPoint);
 			}
 		}
 
-		if (m_pInfoLabel)
+		if (vecLatLngs.empty())
 		{
-			// Display end of calculation
-			strProgress = stdx::wformat(CWToolsString::Load(IDS_INTERMEDIATE_SUCESS))(stdx::wstring_helper::from_utf8(cSrcGpsPoint.name()))(stdx::wstring_helper::from_utf8(cDstGpsPoint.name()));
-			m_pInfoLabel->SetWindowText(strProgress.c_str());
+			InsertIntermediate(*pSteps, geo::GeoRvsGeocoderResults());
+			return S_OK;
 		}
+
+		// Name all the steps at once, requests are sent concurrently and the view is notified when the last name is received.
+		// The steps outlive the batch, their future is destroyed first and waits for it.
+		CIntermediateSteps* pRawSteps = pSteps.get();
+		HWND hWnd = GetSafeHwnd();
+
+		pRawSteps->ulPending = vecLatLngs.size();
+		geo::CGeoRvsGeocoder gGeocoder(geo::CGeoProviders::instance().getDefaultProvider());
+		pRawSteps->futureResults = gGeocoder->LoadBatch(vecLatLngs.data(), vecLatLngs.size(), [pRawSteps, hWnd](size_t, const geo::GeoRvsGeocoderResult&)
+			{
+				if (--pRawSteps->ulPending == 0)
+					::PostMessage(hWnd, WM_INTERMEDIATE_STEPS, 0, 0);
+			});
+
+		m_pIntermediateSteps = std::move(pSteps);
+		return E_PENDING;
 	}
 	else if (m_pInfoLabel)
 	{
 		cDstGpsPoint.clearRouteInfo();
+		m_pcGpsPointArray->updateLeg(nDstIndex);
 
 		// Display routing error
 		strProgress = stdx::wformat(CWToolsString::Load(IDS_ROUTING_ERROR))(stdx::wstring_helper::from_utf8(cSrcGpsPoint.name()))(stdx::wstring_helper::from_utf8(cDstGpsPoint.name()));
@@ -234,6 +260,49 @@ int CNavRouteView::AddIntermediate(int nSrcIndex, int nDstIndex)
 	return S_OK;
 }
 
+void CNavRouteView::InsertIntermediate(const CIntermediateSteps& steps, const geo::GeoRvsGeocoderResults& vecResults)
+{
+	for (size_t i = 0; i < steps.vecGpsPoints.size(); ++i)
+	{
+		CGpsPoint gpsPoint(steps.vecGpsPoints[i]);
+
+		if (i < vecResults.size() && (vecResults[i].eStatus == geo::E_GEO_OK || vecResults[i].eStatus == geo::E_GEO_APPROXIMATE) && !vecResults[i].gLocations.empty())
+			gpsPoint.name(vecResults[i].gLocations.front().name());
+
+		m_pcGpsPointArray->insert(steps.nDstIndex + i, gpsPoint);
+	}
+
+	if (m_pInfoLabel)
+	{
+		// Display end of calculation
+		std::wstring strProgress = stdx::wformat(CWToolsString::Load(IDS_INTERMEDIATE_SUCESS))(stdx::wstring_helper::from_utf8(steps.cSrcGpsPoint.name()))(stdx::wstring_helper::from_utf8(steps.cDstGpsPoint.name()));
+		m_pInfoLabel->SetWindowText(strProgress.c_str());
+	}
+}
+
+LRESULT CNavRouteView::OnIntermediateSteps(WPARAM, LPARAM)
+{
+	std::unique_ptr<CIntermediateSteps> pSteps(std::move(m_pIntermediateSteps));
+	if (!pSteps)
+		return 0;
+
+	// The last name is received, the batch is returning
+	geo::GeoRvsGeocoderResults vecResults = pSteps->futureResults.get();
+
+	// The points may have been changed while the names were requested
+	if (static_cast<size_t>(pSteps->nDstIndex) >= m_pcGpsPointArray->size() ||
+		m_pcGpsPointArray->at(pSteps->nSrcIndex) != pSteps->cSrcGpsPoint ||
+		m_pcGpsPointArray->at(pSteps->nDstIndex) != pSteps->cDstGpsPoint)
+	{
+		EndIntermediateAll(S_FALSE);
+		return 0;
+	}
+
+	InsertIntermediate(*pSteps, vecResults);
+	NextIntermediate();
+	return 0;
+}
+
 int CNavRouteView::DrivingInstruction(int nSrcIndex, int nDstIndex)
 {
 	CGpsPoint& cSrcGpsPoint = m_pcGpsPointArray->at(nSrcIndex);
@@ -253,14 +322,14 @@ int CNavRouteView::DrivingInstruction(int nSrcIndex, int nDstIndex)
 		geo::E_GEO_PROVIDER eGeoProvider = CITNConverterApp::RegParam().RouteProvider();
 		geo::CGeoDirections gDirections(eGeoProvider);
 		geo::E_GEO_STATUS_CODE eStatusCode = geo::E_GEO_UNKNOWN_ERROR;
+		geo::CGeoRoute gRoute;
 
 		int nRet;
 		do
 		{
 			nRet = IDOK;
 
-			gDirections->Load(cSrcGpsPoint, cDstGpsPoint, vehicleType, *cgOptions);
-			eStatusCode = gDirections->getStatus();
+			eStatusCode = geo::CGeoLegCache::instance().Load(*gDirections, { cSrcGpsPoint, cDstGpsPoint }, vehicleType, *cgOptions, gRoute);
 			if (eStatusCode > geo::E_HTTP_ERROR)
 				nRet = HTTPErrorBox(eStatusCode - geo::E_HTTP_ERROR);
 		} while (nRet == IDRETRY);
@@ -270,7 +339,8 @@ int CNavRouteView::DrivingInstruction(int nSrcIndex, int nDstIndex)
 
 		if (eStatusCode == geo::E_GEO_OK)
 		{
-			cDstGpsPoint.setRouteInfo(gDirections->getRoutes().front());
+			cDstGpsPoint.setRouteInfo(gRoute);
+			m_pcGpsPointArray->updateLeg(nDstIndex);
 			if (m_pNavigator)
 				m_pNavigator->JavaScript_AddRoute(m_nTabIndex, nDstIndex);
 
@@ -284,6 +354,7 @@ int CNavRouteView::DrivingInstruction(int nSrcIndex, int nDstIndex)
 		else if (m_pInfoLabel)
 		{
 			cDstGpsPoint.clearRouteInfo();
+			m_pcGpsPointArray->updateLeg(nDstIndex);
 
 			// Display routing error
 			strProgress = stdx::wformat(CWToolsString::Load(IDS_ROUTING_ERROR))(stdx::wstring_helper::from_utf8(cSrcGpsPoint.name()))(stdx::wstring_helper::from_utf8(cDstGpsPoint.name()));
@@ -297,54 +368,140 @@ int CNavRouteView::DrivingInstruction(int nSrcIndex, int nDstIndex)
 	return S_OK;
 }
 
-int CNavRouteView::UpdateSummary()
+void CNavRouteView::InvalidateLegCache(bool bAll)
 {
-	if (!m_pNavigator)
-		return S_FALSE;
+	// Forget the cached routes of the legs, they are requested again
+	geo::CGeoDirections gDirections(CITNConverterApp::RegParam().RouteProvider(), std::nothrow);
+	if (!gDirections)
+		return;
 
-	size_t i;
-	bool bBreak = false;
-	size_t ulCumulativeDistance = 0;
-	size_t ulCumulativeDuration = 0;
+	std::unique_ptr<geo::CGeoRouteOptions> cgOptions;
+	geo::GeoVehicleType::type_t vehicleType = FillRouteOptionsWithSettings(cgOptions);
 
-	for (i = 1; i < m_pcGpsPointArray->size(); i++)
+	for (size_t i = 1; i < m_pcGpsPointArray->size(); i++)
 	{
-		CRouteInfo* pcRouteInfo = m_pcGpsPointArray->at(i).routeInfo();
+		if (bAll || !m_pcGpsPointArray->at(i).routeInfo())
+			geo::CGeoLegCache::instance().erase(gDirections->getProvider(), { m_pcGpsPointArray->at(i - 1), m_pcGpsPointArray->at(i) }, vehicleType, *cgOptions);
+	}
+}
+
+bool CNavRouteView::PrefetchDriving(bool bUseProgressDlg)
+{
+	// Only the legs invalidated by an edit have no route, the unchanged ones are kept
+	std::vector<size_t> vecIndexes;
+	geo::GeoLegs gLegs;
 
-		if (pcRouteInfo)
+	for (size_t i = 1; i < m_pcGpsPointArray->size(); i++)
+	{
+		if (!m_pcGpsPointArray->at(i).routeInfo())
 		{
-			if (!pcRouteInfo->summary().isValid())
-				bBreak = true;
+			vecIndexes.push_back(i);
+			gLegs.push_back({ m_pcGpsPointArray->at(i - 1), m_pcGpsPointArray->at(i) });
+		}
+	}
 
-			if (!bBreak)
-			{
-				ulCumulativeDistance += pcRouteInfo->summary().distance();
-				ulCumulativeDuration += pcRouteInfo->summary().duration();
+	// A single leg is calculated by DrivingInstruction
+	if (gLegs.size() < 2)
+		return true;
 
-				pcRouteInfo->cumulativeDistance() = ulCumulativeDistance;
-				pcRouteInfo->cumulativeDuration() = ulCumulativeDuration;
-			}
-			else
-			{
-				pcRouteInfo->cumulativeDistance() = 0;
-				pcRouteInfo->cumulativeDuration() = 0;
-			}
+	std::unique_ptr<geo::CGeoRouteOptions> cgOptions;
+	geo::GeoVehicleType::type_t vehicleType = FillRouteOptionsWithSettings(cgOptions);
+
+	geo::CGeoDirections gDirections(CITNConverterApp::RegParam().RouteProvider(), std::nothrow);
+	if (!gDirections)
+		return true;
+
+	// Cached legs are immediate, the others are requested concurrently
+	geo::E_GEO_PROVIDER eGeoProvider = gDirections->getProvider();
+	std::atomic<bool> bCancel(false);
+	std::atomic<int> nResolved(0);
+	std::future<geo::GeoLegResults> fResults = std::async(std::launch::async, [&]()
+		{
+			return geo::CGeoLegCache::instance().LoadBatch(eGeoProvider, gLegs, vehicleType, *cgOptions, &bCancel, [&nResolved](size_t, const geo::GeoLegResult& gResult)
+				{
+					if (gResult.eStatus == geo::E_GEO_OK)
+						++nResolved;
+				});
+		});
+
+	// The progress bar steps for each resolved leg, failed ones step in CalculateAll
+	int nStepped = 0;
+	auto stepProgress = [&]()
+	{
+		for (int nCount = nResolved; nStepped < nCount; ++nStepped)
+			m_cProgressDlg.StepIt();
+	};
+
+	while (fResults.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+	{
+		if (bUseProgressDlg)
+		{
+			stepProgress();
+			if (!bCancel && m_cProgressDlg.DoEvents())
+				bCancel = true;
 		}
 		else
 		{
-			bBreak = true;
+			// No dialog to pump the messages, the window must stay responsive all the same
+			MSG msg;
+			while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+				DispatchMessage(&msg);
 		}
 	}
 
+	if (bUseProgressDlg)
+		stepProgress();
+
+	// Failed legs are left to DrivingInstruction, which reports the errors
+	geo::GeoLegResults gResults = fResults.get();
+	for (size_t i = 0; i < gResults.size(); i++)
+	{
+		// The route may have been edited while the messages were pumped
+		size_t ulIndex = vecIndexes[i];
+		if (ulIndex >= m_pcGpsPointArray->size() || m_pcGpsPointArray->at(ulIndex).routeInfo() ||
+			gLegs[i].gFrom != m_pcGpsPointArray->at(ulIndex - 1) || gLegs[i].gTo != m_pcGpsPointArray->at(ulIndex))
+			continue;
+
+		if (gResults[i].eStatus == geo::E_GEO_OK)
+		{
+			m_pcGpsPointArray->at(ulIndex).setRouteInfo(gResults[i].gRoute);
+			m_pcGpsPointArray->updateLeg(ulIndex);
+			if (m_pNavigator)
+				m_pNavigator->JavaScript_AddRoute(m_nTabIndex, static_cast<int>(ulIndex));
+		}
+	}
+
+	return !bCancel;
+}
+
+int CNavRouteView::UpdateSummary()
+{
+	if (!m_pNavigator)
+		return S_FALSE;
+
+	const CGpsLegIndex& legIndex = m_pcGpsPointArray->legIndex();
+
+	// Cumulative values stop at the first leg without a valid route
+	for (size_t i = 1; i < m_pcGpsPointArray->size(); i++)
+	{
+		CRouteInfo* pcRouteInfo = m_pcGpsPointArray->at(i).routeInfo();
+		if (!pcRouteInfo)
+			continue;
+
+		bool bComplete = legIndex.complete(i);
+		pcRouteInfo->cumulativeDistance() = bComplete ? legIndex.distance(i) : 0;
+		pcRouteInfo->cumulativeDuration() = bComplete ? legIndex.duration(i) : 0;
+	}
+
 	if (m_pDistanceLabel)
 	{
 		std::wstring strSummary;
 
-		if (!bBreak)
+		if (legIndex.complete())
 		{
-			strSummary = CWToolsString::Load(IDS_SUMMARY) + GetStringDistance(ulCumulativeDistance, CITNConverterApp::RegParam().DistMiles());
-			if (ulCumulativeDuration)
-				strSummary += stdx::wformat(_T(" (%s)"))(GetStringDuration(ulCumulativeDuration)).str();
+			strSummary = CWToolsString::Load(IDS_SUMMARY) + GetStringDistance(legIndex.totalDistance(), CITNConverterApp::RegParam().DistMiles());
+			if (legIndex.totalDuration())
+				strSummary += stdx::wformat(_T(" (%s)"))(GetStringDuration(legIndex.totalDuration())).str();
 		}
 
 		m_pDistanceLabel->SetWindowText(strSummary.c_str());
@@ -402,9 +559,9 @@ geo::CGeoLatLngs CNavRouteView::GetRoutePreview(int nIndex, const geo::CGeoLatLn
 
 void CNavRouteView::AddIntermediateAll(bool bUseProgressDlg)
 {
-	int i = 0;
-	int nWayPointNumber = m_pcGpsPointArray->upper_bound();
-	HRESULT hr = S_OK;
+	// Already running
+	if (m_pIntermediateSteps)
+		return;
 
 	if (m_pNavigator)
 		m_pNavigator->JavaScript_CloseInfoWindow();
@@ -414,27 +571,51 @@ void CNavRouteView::AddIntermediateAll(bool bUseProgressDlg)
 		std::wstring strProgress = stdx::wformat(CWToolsString::Load(IDS_INTERMEDIATE_PROGRESS))(stdx::wstring_helper::from_utf8(m_pcGpsPointArray->front().name()))(stdx::wstring_helper::from_utf8(m_pcGpsPointArray->back().name()));
 
 		m_cProgressDlg.Display(strProgress.c_str(), true, this);
-		m_cProgressDlg.SetRange(0, nWayPointNumber);
+		m_cProgressDlg.SetRange(0, m_pcGpsPointArray->upper_bound());
 	}
 
-	while (i < nWayPointNumber)
-	{
-		hr = AddIntermediate(i, i + 1);
-		if (hr != S_OK)
-			break;
+	m_bIntermediateProgress = bUseProgressDlg;
+	m_nIntermediateIndex = 0;
+	NextIntermediate(false);
+}
 
-		i += m_pcGpsPointArray->size() - nWayPointNumber;
-		nWayPointNumber = m_pcGpsPointArray->upper_bound();
+void CNavRouteView::NextIntermediate(bool bStep)
+{
+	// Legs are calculated until the names of some steps are requested, OnIntermediateSteps() resumes here
+	HRESULT hr = S_OK;
 
-		if (bUseProgressDlg)
+	for (;; bStep = true)
+	{
+		if (bStep)
 		{
-			m_cProgressDlg.StepIt();
-			if (m_cProgressDlg.DoEvents())
-				break;
+			// Skip the steps inserted in the previous leg
+			m_nIntermediateIndex += static_cast<int>(m_pcGpsPointArray->size() - m_ulIntermediateSize) + 1;
+
+			if (m_bIntermediateProgress)
+			{
+				m_cProgressDlg.StepIt();
+				if (m_cProgressDlg.DoEvents())
+					break;
+			}
 		}
+
+		if (m_nIntermediateIndex >= m_pcGpsPointArray->upper_bound())
+			break;
+
+		m_ulIntermediateSize = m_pcGpsPointArray->size();
+		hr = AddIntermediate(m_nIntermediateIndex, m_nIntermediateIndex + 1);
+		if (hr == E_PENDING)
+			return;
+		if (hr != S_OK)
+			break;
 	}
 
-	if (bUseProgressDlg)
+	EndIntermediateAll(hr);
+}
+
+void CNavRouteView::EndIntermediateAll(HRESULT hr)
+{
+	if (m_bIntermediateProgress)
 		m_cProgressDlg.Close();
 
 	if (m_pInfoLabel && hr == S_OK)
@@ -447,7 +628,7 @@ void CNavRouteView::AddIntermediateAll(bool bUseProgressDlg)
 	Refresh();
 }
 
-void CNavRouteView::CalculateAll(bool bUseProgressDlg)
+void CNavRouteView::CalculateAll(bool bUseProgressDlg, bool bRefresh)
 {
 	int nWayPointNumber = m_pcGpsPointArray->upper_bound();
 	HRESULT hr = S_OK;
@@ -456,6 +637,9 @@ void CNavRouteView::CalculateAll(bool bUseProgressDlg)
 	if (m_pcGpsPointArray->empty())
 		return;
 
+	if (bRefresh)
+		InvalidateLegCache(false);
+
 	if (m_pNavigator)
 		m_pNavigator->JavaScript_CloseInfoWindow();
 
@@ -466,6 +650,15 @@ void CNavRouteView::CalculateAll(bool bUseProgressDlg)
 		m_cProgressDlg.Display(strProgress.c_str(), true, this);
 		m_cProgressDlg.SetRange(0, nWayPointNumber);
 
+		// The legs kept from a previous calculation are already done
+		int nCalculated = 0;
+		for (int i = 1; i <= nWayPointNumber; i++)
+		{
+			if (m_pcGpsPointArray->at(i).routeInfo())
+				nCalculated++;
+		}
+		m_cProgressDlg.SetPos(nCalculated);
+
 		switch (CITNConverterApp::RegParam().RouteProvider())
 		{
 #ifdef IDB_GOOGLE
@@ -514,15 +707,20 @@ void CNavRouteView::CalculateAll(bool bUseProgressDlg)
 		}
 	}
 
-	for (int i = 0; i < nWayPointNumber; i++)
+	bool bCancelled = !PrefetchDriving(bUseProgressDlg);
+
+	for (int i = 0; i < nWayPointNumber && !bCancelled; i++)
 	{
+		bool bCalculate = !m_pcGpsPointArray->at(i + 1).routeInfo();
+
 		hr = DrivingInstruction(i, i + 1);
 		if (hr != S_OK)
 			break;
 
 		if (bUseProgressDlg)
 		{
-			m_cProgressDlg.StepIt();
+			if (bCalculate)
+				m_cProgressDlg.StepIt();
 			if (m_cProgressDlg.DoEvents())
 				break;
 		}
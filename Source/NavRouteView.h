@@ -28,6 +28,9 @@
 #if !defined(AFX_NAVROUTEVIEW_H_INCLUDED_)
 #define AFX_NAVROUTEVIEW_H_INCLUDED_
 
+#include <atomic>
+#include <future>
+#include <memory>
 #include "NavPointView.h"
 #include "Navigator.h"
 #include "ProgressDlg.h"
@@ -53,9 +56,9 @@ public:
 
 	geo::CGeoLatLngs GetRoutePreview(int nIndex, const geo::CGeoLatLng& gLatLng, bool bStep);
 	void AddIntermediateAll(bool bUseProgressDlg = true);
-	void CalculateAll(bool bUseProgressDlg = true);
+	void CalculateAll(bool bUseProgressDlg = true, bool bRefresh = false); // bRefresh: bypass the leg cache
 	void DisableAutoCalc();
-	void ClearDriving();
+	void ClearDriving(bool bInvalidate = false); // bInvalidate: forget the cached legs too
 	void RefreshDriving();
 	void CalculateSegment(int nIndex);
 	void Optimize();
@@ -65,8 +68,28 @@ protected:
 	virtual bool OnInsert(int nIndex);
 
 private:
-	int AddIntermediate(int nSrcIndex, int nDstIndex);
+	// Steps of a leg waiting for their names
+	struct CIntermediateSteps
+	{
+		CIntermediateSteps(int nSrc, int nDst, const CGpsPoint& cSrc, const CGpsPoint& cDst) :
+			nSrcIndex(nSrc), nDstIndex(nDst), cSrcGpsPoint(cSrc), cDstGpsPoint(cDst), ulPending(0) {}
+
+		int nSrcIndex;
+		int nDstIndex;
+		CGpsPoint cSrcGpsPoint;
+		CGpsPoint cDstGpsPoint;
+		std::vector<CGpsPoint> vecGpsPoints;
+		std::atomic<size_t> ulPending;
+		std::future<geo::GeoRvsGeocoderResults> futureResults; // Last member, waits for the batch before the others are destroyed
+	};
+
+	int AddIntermediate(int nSrcIndex, int nDstIndex); // E_PENDING when the names of the steps are requested
+	void InsertIntermediate(const CIntermediateSteps& steps, const geo::GeoRvsGeocoderResults& vecResults);
+	void NextIntermediate(bool bStep = true);
+	void EndIntermediateAll(HRESULT hr);
 	int DrivingInstruction(int nSrcIndex, int nDstIndex);
+	bool PrefetchDriving(bool bUseProgressDlg);
+	void InvalidateLegCache(bool bAll);
 	int UpdateSummary();
 
 private:
@@ -75,6 +98,14 @@ private:
 	CStatic* m_pDistanceLabel;
 	bool m_bTempAutoCalc;
 	bool m_bRefreshAll;
+	bool m_bIntermediateProgress;
+	int m_nIntermediateIndex;
+	size_t m_ulIntermediateSize; // Number of points before the current leg
+	std::unique_ptr<CIntermediateSteps> m_pIntermediateSteps;
+
+protected:
+	afx_msg LRESULT OnIntermediateSteps(WPARAM wParam, LPARAM lParam);
+	DECLARE_MESSAGE_MAP()
 };
 
 #endif // !defined(AFX_NAVROUTEVIEW_H_INCLUDED_)
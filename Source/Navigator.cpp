@@ -137,6 +137,11 @@ void CNavigator::JavaScript_InsertPushPin(int nTabIndex, int nItemIndex)
 	NO_THROW(CJavaScript(m_pScript).method(L"InsertPushPin").arg(nTabIndex).arg(nItemIndex).execute());
 }
 
+void CNavigator::JavaScript_LoadPushPins(int nTabIndex)
+{
+	NO_THROW(CJavaScript(m_pScript).method(L"LoadPushPins").arg(nTabIndex).execute());
+}
+
 void CNavigator::JavaScript_MapClickEnabled(bool bEnabled)
 {
 	NO_THROW(CJavaScript(m_pScript).method(L"MapClickEnabled").arg(bEnabled).execute());
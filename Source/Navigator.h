@@ -186,6 +186,7 @@ public:
 	void JavaScript_ViewPushPin(int nTabIndex, int nItemIndex);
 	void JavaScript_DelPushPin(int nTabIndex, int nItemIndex);
 	void JavaScript_InsertPushPin(int nTabIndex, int nItemIndex);
+	void JavaScript_LoadPushPins(int nTabIndex);
 	void JavaScript_MapClickEnabled(bool bEnabled = true);
 	void JavaScript_InitMap(const std::string& strParameters);
 	std::string JavaScript_GetMaps();
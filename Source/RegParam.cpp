@@ -67,6 +67,10 @@ namespace
 	const std::wstring sTruckWeightAxle(_T("TruckWeightAxle"));
 	const std::wstring sTruckCategory(_T("TruckCategory"));
 	const std::wstring sUserId(_T("UserID"));
+	const std::wstring sSimplifyTrack(_T("SimplifyTrack"));
+	const std::wstring sSimplifyAlgorithm(_T("SimplifyAlgorithm"));
+	const std::wstring sSimplifyTolerance(_T("SimplifyTolerance"));
+	const std::wstring sSimplifyMaxPoints(_T("SimplifyMaxPoints"));
 
 	std::string favoritesToUtf8(const std::string& ss)
 	{
@@ -163,6 +167,10 @@ void CRegParam::ToRegistry()
 	StorageFolder[sTruckWeightAxle] = m_strTruckWeightAxle;
 	StorageFolder[sTruckCategory] = m_strTruckCategory;
 	StorageFolder[sUserId] = m_UserId;
+	StorageFolder[sSimplifyTrack] = m_bSimplifyTrack;
+	StorageFolder[sSimplifyAlgorithm] = m_uiSimplifyAlgorithm;
+	StorageFolder[sSimplifyTolerance] = m_uiSimplifyTolerance;
+	StorageFolder[sSimplifyMaxPoints] = m_uiSimplifyMaxPoints;
 
 	std::string strReg(reinterpret_cast<char*>(&m_curMap.second), sizeof(int32_t));
 	strReg += m_curMap.first;
@@ -197,6 +205,10 @@ void CRegParam::FromRegistry()
 	m_strTruckWeightAxle = StorageFolder[sTruckWeightAxle](50);
 	m_strTruckCategory = StorageFolder[sTruckCategory](geo::GeoTruckCategoryType::no_catory);
 	m_UserId = StorageFolder[sUserId](std::wstring());
+	m_bSimplifyTrack = StorageFolder[sSimplifyTrack](false);
+	m_uiSimplifyAlgorithm = StorageFolder[sSimplifyAlgorithm](0);
+	m_uiSimplifyTolerance = StorageFolder[sSimplifyTolerance](5);
+	m_uiSimplifyMaxPoints = StorageFolder[sSimplifyMaxPoints](0);
 
 	std::vector<unsigned char> valueReg = StorageFolder[sDefaultMap].asBinary(std::vector<unsigned char>());
 	if (valueReg.size() > sizeof(uint32_t))
@@ -151,6 +151,19 @@ public:
 	const std::wstring& UserId() const { return m_UserId; }
 	std::wstring& UserId() { return m_UserId; }
 
+	// Simplification of the exported tracks, disabled when both tolerance (meters) and max points are null
+	bool SimplifyTrack() const { return m_bSimplifyTrack; }
+	bool& SimplifyTrack() { return m_bSimplifyTrack; }
+
+	unsigned int SimplifyAlgorithm() const { return m_uiSimplifyAlgorithm; }
+	unsigned int& SimplifyAlgorithm() { return m_uiSimplifyAlgorithm; }
+
+	unsigned int SimplifyTolerance() const { return m_uiSimplifyTolerance; }
+	unsigned int& SimplifyTolerance() { return m_uiSimplifyTolerance; }
+
+	unsigned int SimplifyMaxPoints() const { return m_uiSimplifyMaxPoints; }
+	unsigned int& SimplifyMaxPoints() { return m_uiSimplifyMaxPoints; }
+
 private:
 	// Serialize
 	void ToRegistry();
@@ -184,6 +197,10 @@ private:
 	unsigned int m_strTruckWeightAxle;
 	geo::GeoTruckCategoryType::type_t m_strTruckCategory;
 	std::wstring m_UserId;
+	bool m_bSimplifyTrack;
+	unsigned int m_uiSimplifyAlgorithm;
+	unsigned int m_uiSimplifyTolerance;
+	unsigned int m_uiSimplifyMaxPoints;
 };
 
 #endif // _REGPARAM_H_INCLUDED_
@@ -48,7 +48,8 @@ namespace
 		DISPID_TRAVEL_MODE,
 		DISPID_ROUTE_PROVIDER,
 		DISPID_POINTS,
-		DISPID_COLOR
+		DISPID_COLOR,
+		DISPID_COUNT
 	};
 
 	const std::wstring c_strDistance(L"distance");
@@ -59,6 +60,7 @@ namespace
 	const std::wstring c_strProvider(L"provider");
 	const std::wstring c_strPoints(L"points");
 	const std::wstring c_strColor(L"color");
+	const std::wstring c_strCount(L"count");
 }
 
 CRouteDispatch::CRouteDispatch(CRouteInfo* pcRouteInfo, bool bDelete) :
@@ -107,6 +109,8 @@ HRESULT STDMETHODCALLTYPE CRouteDispatch::GetIDsOfNames(
 		*rgDispId = DISPID_POINTS;
 	else if (strName == c_strColor && m_pcRouteInfo->polyline().getColor() != 0xFFFFFF)
 		*rgDispId = DISPID_COLOR;
+	else if (strName == c_strCount)
+		*rgDispId = DISPID_COUNT;
 	else
 		return DISP_E_UNKNOWNNAME;
 
@@ -193,6 +197,10 @@ HRESULT STDMETHODCALLTYPE CRouteDispatch::Invoke(
 		*pVarResult = CVariant(stdx::wformat(_T("#%06X"))(m_pcRouteInfo->polyline().getColor()).str()).variant();
 		break;
 
+	case DISPID_COUNT:
+		*pVarResult = CVariant(static_cast<int>(m_pcRouteInfo->polyline().getPath().size())).variant();
+		break;
+
 	default:
 		return DISP_E_MEMBERNOTFOUND;
 	}
@@ -58,7 +58,7 @@ public:
 		/* [out] */ UINT* puArgErr);
 
 private:
-	CRouteInfo* m_pcRouteInfo;
+	const CRouteInfo* m_pcRouteInfo;
 	bool m_bDelete;
 };
 
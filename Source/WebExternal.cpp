@@ -34,6 +34,9 @@
 #include "ToolsLibrary/HttpClient.h"
 #include "GeoServices/GoogleStreetView.h"
 #include "GeoServices/GoogleApiElevation.h"
+#include "GeoServices/SrtmElevation.h"
+#include "GeoServices/GeoPolylineCodec.h"
+#include "GeoServices/GeoRvsGeocoderCache.h"
 #include "sendtogps.h"
 #include "WebExternal.h"
 #include "Javascript.h"
@@ -46,6 +49,8 @@
 #include "Utf8Dispatch.h"
 #include "RouteDispatch.h"
 #include "AsyncRouteCalculation.h"
+#include "AsyncExternalCall.h"
+#include "jsonParser/JsonParser.h"
 
 IMPLEMENT_OLETYPELIB(CWebExternal, GUID_NULL, 1, 0);
 
@@ -77,7 +82,10 @@ namespace
 		DISPID_BASE64,
 		DISPID_UTF8,
 		DISPID_GET_STR_COORDS,
-		DISPID_SET_CURRENT_MAP
+		DISPID_SET_CURRENT_MAP,
+		DISPID_GET_ROUTE_GEOMETRY,
+		DISPID_GET_POINTS,
+		DISPID_GET_ELEVATIONS
 	};
 
 	const std::wstring c_strTrace(L"Trace");
@@ -105,6 +113,16 @@ namespace
 	const std::wstring c_strUtf8(L"Utf8");
 	const std::wstring c_strGetStrCoords(L"GetStrCoords");
 	const std::wstring c_strSetCurrentMap(L"SetCurrentMap");
+	const std::wstring c_strGetRouteGeometry(L"GetRouteGeometry");
+	const std::wstring c_strGetPoints(L"GetPoints");
+	const std::wstring c_strGetElevations(L"GetElevations");
+
+	CAutoVariant PointResult(const geo::CGeoLocation& cgLocation)
+	{
+		CAutoVariant vResult;
+		vResult = static_cast<IDispatch*>(new CPointDispatch(new CGpsPoint(cgLocation), CNavPointView::E_VIEW_TYPE_MARKER));
+		return vResult;
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -112,7 +130,8 @@ namespace
 
 CWebExternal::CWebExternal(CNavigator& navigator) :
 	m_Navigator(navigator),
-	m_AsyncRouteCalculation(new CAsyncRouteCalculation)
+	m_AsyncRouteCalculation(new CAsyncRouteCalculation),
+	m_AsyncExternalCall(new CAsyncExternalCall(navigator))
 {
 	EnableTypeLib();
 }
@@ -188,6 +207,12 @@ HRESULT STDMETHODCALLTYPE CWebExternal::GetIDsOfNames(
 		*rgDispId = DISPID_GET_STR_COORDS;
 	else if (strName == c_strSetCurrentMap)
 		*rgDispId = DISPID_SET_CURRENT_MAP;
+	else if (strName == c_strGetRouteGeometry)
+		*rgDispId = DISPID_GET_ROUTE_GEOMETRY;
+	else if (strName == c_strGetPoints)
+		*rgDispId = DISPID_GET_POINTS;
+	else if (strName == c_strGetElevations)
+		*rgDispId = DISPID_GET_ELEVATIONS;
 	else
 		return DISP_E_UNKNOWNNAME;
 
@@ -283,6 +308,15 @@ HRESULT STDMETHODCALLTYPE CWebExternal::Invoke(
 		case DISPID_SET_CURRENT_MAP:
 			SetCurrentMap(pDispParams, pVarResult);
 			break;
+		case DISPID_GET_ROUTE_GEOMETRY:
+			GetRouteGeometry(pDispParams, pVarResult);
+			break;
+		case DISPID_GET_POINTS:
+			GetPoints(pDispParams, pVarResult);
+			break;
+		case DISPID_GET_ELEVATIONS:
+			GetElevations(pDispParams, pVarResult);
+			break;
 		default:
 			throw CWinApiException(DISP_E_MEMBERNOTFOUND);
 		}
@@ -403,9 +437,11 @@ geo::CGeoLocation CWebExternal::GetLocation(const geo::CGeoLatLng& cgLatLng)
 	try
 	{
 		geo::CGeoRvsGeocoder gGeocoder(eGeoProvider);
-		gGeocoder->Load(cgLatLng);
-		if (gGeocoder->getStatus() == geo::E_GEO_OK && gGeocoder->getResults().size())
-			return gGeocoder->getResults().front();
+		geo::CGeoLocations gLocations;
+
+		geo::E_GEO_STATUS_CODE eStatus = geo::CGeoRvsGeocoderCache::instance().Load(*gGeocoder, cgLatLng, gLocations);
+		if ((eStatus == geo::E_GEO_OK || eStatus == geo::E_GEO_APPROXIMATE) && !gLocations.empty())
+			return gLocations.front();
 	}
 	catch (std::invalid_argument&)
 	{
@@ -448,6 +484,14 @@ geo::CGeoLocation CWebExternal::GetStreetViewLocation(const geo::CGeoLatLng& cgL
 
 geo::CGeoLatLng CWebExternal::GetElevation(const geo::CGeoLatLng& cgLatLng)
 {
+	// Local tiles first, Google for the areas without tile
+	if (geo::CSrtmElevation::available())
+	{
+		geo::CSrtmElevation geoSrtmElevation(cgLatLng);
+		if (geoSrtmElevation.getStatus() == geo::E_GEO_OK)
+			return geoSrtmElevation.getResults().front();
+	}
+
 	geo::CGoogleApiElevation geoGoogleApiElevation(cgLatLng);
 
 	if (geoGoogleApiElevation.getStatus() == geo::E_GEO_OK)
@@ -456,6 +500,45 @@ geo::CGeoLatLng CWebExternal::GetElevation(const geo::CGeoLatLng& cgLatLng)
 		return cgLatLng;
 }
 
+void CWebExternal::GetElevation(geo::CGeoLatLngs& cgLatLngs)
+{
+	std::vector<bool> vecFound(cgLatLngs.size(), false);
+
+	// Local tiles first, the uncovered locations are sent to Google in a single batch
+	if (geo::CSrtmElevation::available())
+	{
+		geo::CSrtmElevation geoSrtmElevation;
+		if (geoSrtmElevation.Load(cgLatLngs) == geo::E_GEO_OK)
+		{
+			cgLatLngs = geoSrtmElevation.getResults();
+			vecFound = geoSrtmElevation.getFound();
+		}
+	}
+
+	geo::CGeoLatLngs cgMissing;
+	std::vector<bool>::const_iterator itFound = vecFound.begin();
+	for (geo::CGeoLatLngs::const_iterator it = cgLatLngs.begin(); it != cgLatLngs.end(); ++it, ++itFound)
+	{
+		if (!*itFound)
+			cgMissing.push_back(*it);
+	}
+
+	if (cgMissing.empty())
+		return;
+
+	geo::CGoogleApiElevation geoGoogleApiElevation;
+	if (geoGoogleApiElevation.Load(cgMissing) != geo::E_GEO_OK)
+		return;
+
+	geo::CGeoLatLngs::const_iterator itResult = geoGoogleApiElevation.getResults().begin();
+	itFound = vecFound.begin();
+	for (geo::CGeoLatLngs::iterator it = cgLatLngs.begin(); it != cgLatLngs.end(); ++it, ++itFound)
+	{
+		if (!*itFound)
+			*it = *itResult++;
+	}
+}
+
 CNavPointView* CWebExternal::RetrieveView(DISPPARAMS* pDispParams, int& nIndex)
 {
 	if (pDispParams->cArgs < 2)
@@ -517,6 +600,25 @@ geo::CGeoLatLng CWebExternal::GetLatLngFromVariant(const CVariant& variant)
 		GetDoubleFromVariant(CJavaScript(dispatch.get()).method(L"lng").execute()));
 }
 
+// The ulArgs arguments are followed by an optional callback and its queue, a number or a string.
+// With a callback the call is done by a worker, a newer call of the same queue supersedes it.
+// The callback gets the result, or undefined and the error message when the call failed.
+bool CWebExternal::PostAsyncCall(const std::wstring& strMethod, const CVariantList& args, size_t ulArgs, const std::function<CAutoVariant()>& Work)
+{
+	if (args.size() <= ulArgs || args[ulArgs].type() != VT_DISPATCH)
+		return false;
+
+	std::wstring strQueue;
+	if (args.size() > ulArgs + 1)
+	{
+		CAutoVariant vQueue(args[ulArgs + 1]);
+		NO_THROW(strQueue = vQueue.changeType(VT_BSTR).asWString());
+	}
+
+	m_AsyncExternalCall->PostRequest(strMethod + L'#' + strQueue, Work, args[ulArgs]);
+	return true;
+}
+
 geo::CGeoLocation CWebExternal::GetLocationFromVariant(const CVariant& varLatLng, const CVariant& varAddress)
 {
 	if (varLatLng.type() != VT_DISPATCH || varAddress.type() != VT_BSTR)
@@ -535,6 +637,44 @@ void CWebExternal::GetPoint(DISPPARAMS* pDispParams, VARIANT* retval)
 	*retval = CVariant(new CPointDispatch(pNavPointView->GpsPointArray().at(nIndex), pNavPointView->GetType(nIndex))).variant();
 }
 
+void CWebExternal::GetPoints(DISPPARAMS* pDispParams, VARIANT* retval)
+{
+	if (!retval)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	int nFirst;
+	CNavPointView* pNavPointView = RetrieveView(pDispParams, nFirst);
+	const CGpsPointArray& cGpsPointArray = pNavPointView->GpsPointArray();
+
+	if (static_cast<size_t>(nFirst) > cGpsPointArray.size())
+		throw CWinApiException(DISP_E_BADINDEX);
+
+	// Optional count, all the following points by default
+	size_t ulLast = cGpsPointArray.size();
+	if (pDispParams->cArgs > 2 && pDispParams->rgvarg[pDispParams->cArgs - 3].vt == VT_I4 && pDispParams->rgvarg[pDispParams->cArgs - 3].intVal >= 0)
+		ulLast = std::min(ulLast, static_cast<size_t>(nFirst) + pDispParams->rgvarg[pDispParams->cArgs - 3].intVal);
+
+	// Same properties as CPointDispatch, the route is only flagged and must be requested with GetPoint
+	CJsonParser jsPoints;
+	CJsonArray& jsArray = jsPoints.setType(CJsonParser::JSON_TYPE_ARRAY);
+
+	for (size_t i = nFirst; i < ulLast; ++i)
+	{
+		CGpsPoint& cGpsPoint = pNavPointView->GpsPointArray().at(i);
+
+		CJsonObject& jsPoint = jsArray.add().setType(CJsonValue::JSON_TYPE_OBJECT);
+		jsPoint.add("lat") = cGpsPoint.lat();
+		jsPoint.add("lng") = cGpsPoint.lng();
+		jsPoint.add("alt") = cGpsPoint.alt();
+		jsPoint.add("address") = cGpsPoint.name();
+		jsPoint.add("snippet") = cGpsPoint.comment();
+		jsPoint.add("type") = static_cast<int>(pNavPointView->GetType(static_cast<int>(i)));
+		jsPoint.add("route") = cGpsPoint.routeInfo() != nullptr;
+	}
+
+	*retval = CVariant(jsPoints.str()).variant();
+}
+
 void CWebExternal::SelectPoint(DISPPARAMS* pDispParams, VARIANT* /*retval*/)
 {
 	int nIndex;
@@ -660,46 +800,90 @@ void CWebExternal::SendToGps(DISPPARAMS* pDispParams, VARIANT* /*retval*/)
 
 void CWebExternal::GetLocation(DISPPARAMS* pDispParams, VARIANT* retval)
 {
-	if (!retval || pDispParams->cArgs < 1)
+	if (pDispParams->cArgs < 1)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(args[0]));
+	auto Work = [this, cgLatLng]() { return PointResult(GetLocation(cgLatLng)); };
+
+	if (PostAsyncCall(c_strGetLocation, args, 1, Work))
+		return;
+
+	if (!retval)
 		throw CWinApiException(DISP_E_BADPARAMCOUNT);
 
-	*retval = CVariant(new CPointDispatch(new CGpsPoint(GetLocation(GetLatLngFromVariant(pDispParams->rgvarg[0]))), CNavPointView::E_VIEW_TYPE_MARKER)).variant();
+	*retval = Work().release().variant();
 }
 
 void CWebExternal::GetRoadLocation(DISPPARAMS* pDispParams, VARIANT* retval)
 {
-	if (!retval || pDispParams->cArgs < 1)
+	if (pDispParams->cArgs < 1)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(args[0]));
+	auto Work = [this, cgLatLng]() { return PointResult(GetRoadLocation(cgLatLng)); };
+
+	if (PostAsyncCall(c_strGetRoadLocation, args, 1, Work))
+		return;
+
+	if (!retval)
 		throw CWinApiException(DISP_E_BADPARAMCOUNT);
 
-	*retval = CVariant(new CPointDispatch(new CGpsPoint(GetRoadLocation(GetLatLngFromVariant(pDispParams->rgvarg[0]))), CNavPointView::E_VIEW_TYPE_MARKER)).variant();
+	*retval = Work().release().variant();
 }
 
 void CWebExternal::GetStreetViewLocation(DISPPARAMS* pDispParams, VARIANT* retval)
 {
-	if (!retval || pDispParams->cArgs < 1)
+	if (pDispParams->cArgs < 1)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(args[0]));
+	auto Work = [this, cgLatLng]() { return PointResult(GetStreetViewLocation(cgLatLng)); };
+
+	if (PostAsyncCall(c_strGetStreetViewLocation, args, 1, Work))
+		return;
+
+	if (!retval)
 		throw CWinApiException(DISP_E_BADPARAMCOUNT);
 
-	*retval = CVariant(new CPointDispatch(new CGpsPoint(GetStreetViewLocation(GetLatLngFromVariant(pDispParams->rgvarg[0]))), CNavPointView::E_VIEW_TYPE_MARKER)).variant();
+	*retval = Work().release().variant();
 }
 
 void CWebExternal::ReverseGeocoding(DISPPARAMS* pDispParams, VARIANT* retval)
 {
-	if (!retval || pDispParams->cArgs < 1)
+	if (pDispParams->cArgs < 1)
 		throw CWinApiException(DISP_E_BADPARAMCOUNT);
 
-	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(pDispParams->rgvarg[0]));
-	geo::CGeoLocation cgLocation;
+	CVariantList args(*pDispParams);
+	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(args[0]));
+	bool bForceRoad = CITNConverterApp::RegParam().RouteProvider() != geo::E_GEO_PROVIDER_INTERNAL && CITNConverterApp::RegParam().ForceRoad();
+
+	auto Work = [this, cgLatLng, bForceRoad]()
+	{
+		geo::CGeoLocation cgLocation;
+
+		if (bForceRoad)
+			cgLocation = GetRoadLocation(cgLatLng);
 
-	if (CITNConverterApp::RegParam().RouteProvider() != geo::E_GEO_PROVIDER_INTERNAL && CITNConverterApp::RegParam().ForceRoad())
-		cgLocation = GetRoadLocation(cgLatLng);
+		if (!cgLocation)
+			cgLocation = cgLatLng;
 
-	if (!cgLocation)
-		cgLocation = cgLatLng;
+		if (cgLocation.name().empty())
+			cgLocation.name(GetLocation(cgLocation).name());
+
+		return PointResult(cgLocation);
+	};
 
-	if (cgLocation.name().empty())
-		cgLocation.name(GetLocation(cgLocation).name());
+	if (PostAsyncCall(c_strReverseGeocoding, args, 1, Work))
+		return;
 
-	*retval = CVariant(new CPointDispatch(new CGpsPoint(cgLocation), CNavPointView::E_VIEW_TYPE_MARKER)).variant();
+	if (!retval)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	*retval = Work().release().variant();
 }
 
 void CWebExternal::GetRoutePreview(DISPPARAMS* pDispParams, VARIANT* retval)
@@ -766,12 +950,92 @@ void CWebExternal::GetRoutePreview(DISPPARAMS* pDispParams, VARIANT* retval)
 	}
 }
 
+void CWebExternal::GetRouteGeometry(DISPPARAMS* pDispParams, VARIANT* retval)
+{
+	if (!retval || pDispParams->cArgs < 7)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+
+	int nIndex;
+	CNavPointView* pNavPointView = RetrieveView(pDispParams, nIndex);
+	CRouteInfo* pRouteInfo = pNavPointView->GpsPointArray().at(nIndex).routeInfo();
+	if (!pRouteInfo)
+		return;
+
+	unsigned int uiZoom = static_cast<unsigned int>(std::max(0.0, GetDoubleFromVariant(args[2])));
+	geo::CGeoLatLng gSouthWest(GetDoubleFromVariant(args[3]), GetDoubleFromVariant(args[4]));
+	geo::CGeoLatLng gNorthEast(GetDoubleFromVariant(args[5]), GetDoubleFromVariant(args[6]));
+
+	std::vector<geo::GeoCoordinates> vecRuns;
+	pRouteInfo->pyramid().query(uiZoom, gSouthWest, gNorthEast, vecRuns);
+
+	// Encoded polylines never contain spaces, runs are separated by a space
+	std::string strGeometry;
+	for (const geo::GeoCoordinates& gRun : vecRuns)
+	{
+		if (!strGeometry.empty())
+			strGeometry += ' ';
+		geo::encodePolyline(gRun.data(), gRun.size(), 5, strGeometry);
+	}
+
+	*retval = CVariant(strGeometry).variant();
+}
+
 void CWebExternal::GetElevation(DISPPARAMS* pDispParams, VARIANT* retval)
 {
-	if (!retval || pDispParams->cArgs < 1)
+	if (pDispParams->cArgs < 1)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+	geo::CGeoLatLng cgLatLng(GetLatLngFromVariant(args[0]));
+	auto Work = [this, cgLatLng]() { return PointResult(GetElevation(cgLatLng)); };
+
+	if (PostAsyncCall(c_strGetElevation, args, 1, Work))
+		return;
+
+	if (!retval)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	*retval = Work().release().variant();
+}
+
+void CWebExternal::GetElevations(DISPPARAMS* pDispParams, VARIANT* retval)
+{
+	if (pDispParams->cArgs < 1)
+		throw CWinApiException(DISP_E_BADPARAMCOUNT);
+
+	CVariantList args(*pDispParams);
+
+	// Locations as an encoded polyline, altitudes returned as a JSON array in the same order
+	geo::GeoCoordinates gCoordinates;
+	if (!geo::decodePolyline(args[0].asString(), 5, gCoordinates))
+		throw CWinApiException(DISP_E_BADVARTYPE);
+
+	geo::CGeoLatLngs cgLatLngs;
+	geo::toLatLngs(gCoordinates, cgLatLngs);
+
+	auto Work = [this, cgLatLngs]() mutable
+	{
+		GetElevation(cgLatLngs);
+
+		CJsonParser jsAltitudes;
+		CJsonArray& jsArray = jsAltitudes.setType(CJsonParser::JSON_TYPE_ARRAY);
+		for (const geo::CGeoLatLng& cgLatLng : cgLatLngs)
+			jsArray.add() = cgLatLng.alt();
+
+		CAutoVariant vResult;
+		vResult = jsAltitudes.str();
+		return vResult;
+	};
+
+	if (PostAsyncCall(c_strGetElevations, args, 1, Work))
+		return;
+
+	if (!retval)
 		throw CWinApiException(DISP_E_BADPARAMCOUNT);
 
-	*retval = CVariant(new CPointDispatch(new CGpsPoint(GetElevation(GetLatLngFromVariant(pDispParams->rgvarg[0]))), CNavPointView::E_VIEW_TYPE_MARKER)).variant();
+	*retval = Work().release().variant();
 }
 
 void CWebExternal::GetSettings(DISPPARAMS* pDispParams, VARIANT* retval)
@@ -30,18 +30,24 @@
 #ifndef __WEB_EXTERNAL_H_
 #define __WEB_EXTERNAL_H_
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <string>
 
 class CNavPointView;
 class CVariant;
+class CAutoVariant;
+class CVariantList;
 class CNavigator;
 class CAsyncHttpRequest;
 class CAsyncRouteCalculation;
+class CAsyncExternalCall;
 
 namespace geo
 {
 	class CGeoLatLng;
+	class CGeoLatLngs;
 	class CGeoLocation;
 }
 
@@ -111,11 +117,13 @@ private: // Implementation
 	geo::CGeoLocation GetRoadLocation(const geo::CGeoLatLng& cgLatLng);
 	geo::CGeoLocation GetStreetViewLocation(const geo::CGeoLatLng& cgLatLng);
 	geo::CGeoLatLng GetElevation(const geo::CGeoLatLng& cgLatLng);
+	void GetElevation(geo::CGeoLatLngs& cgLatLngs);
 	CNavPointView* RetrieveView(DISPPARAMS* pDispParams, int& nIndex);
 	double GetDoubleFromVariant(const CVariant& variant);
 	geo::CGeoLatLng GetLatLngFromVariant(const CVariant& variant);
 	geo::CGeoLocation GetLocationFromVariant(const CVariant& varLatLng, const CVariant& varAddress);
 	void AddPointToView(int nViewIndex, DISPPARAMS* pDispParams);
+	bool PostAsyncCall(const std::wstring& strMethod, const CVariantList& args, size_t ulArgs, const std::function<CAutoVariant()>& Work);
 
 	void Trace(/*[in]*/ VARIANT& LOG, /*[out, retval]*/ VARIANT* retval);
 	void MessageBox(/*[in]*/ VARIANT& MSG, /*[out, retval]*/ VARIANT* retval);
@@ -123,6 +131,7 @@ private: // Implementation
 	void AsyncHttpRequest(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void HttpDownload(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void GetPoint(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
+	void GetPoints(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void SelectPoint(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void DeletePoint(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void RenamePoint(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
@@ -137,7 +146,9 @@ private: // Implementation
 	void GetStreetViewLocation(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void ReverseGeocoding(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void GetElevation(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
+	void GetElevations(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void GetRoutePreview(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
+	void GetRouteGeometry(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void GetSettings(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void UseBase64(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
 	void UseUtf8(/*[in]*/ DISPPARAMS* pDispParams, /*[out, retval]*/ VARIANT* retval);
@@ -148,6 +159,7 @@ private:
 	CNavigator& m_Navigator;
 	std::map<size_t, std::unique_ptr<CAsyncHttpRequest>> m_AsyncHttpRequests;
 	std::unique_ptr<CAsyncRouteCalculation> m_AsyncRouteCalculation;
+	std::unique_ptr<CAsyncExternalCall> m_AsyncExternalCall;
 	std::map<int, CNavPointView*> m_mapNavPointView;
 };
 
@@ -220,7 +220,7 @@ DWORD ReadVersion(LPBYTE pBuffer, DWORD /*dwLength*/)
 	return 0;
 }
 
-int ReadAXE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadAXE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	LPBYTE pStreamContent = nullptr;
 	DWORD dwLength = 0;
@@ -234,7 +234,7 @@ int ReadAXE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	DWORD dwWayPointNumber = 0;
 	DWORD i = 0;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	/* Read file version */
@@ -50,7 +50,7 @@
 
 #define VALUE_ERROR           _T("R_ERROR")
 
-int ReadBCR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadBCR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	int i;
 	std::wstring strReadString;
@@ -61,7 +61,7 @@ int ReadBCR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!strReadString.compare(VALUE_ERROR))
 		return GetLastError();
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	// Read Route name
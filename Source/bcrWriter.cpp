@@ -31,6 +31,7 @@
 #include "stdafx.h"
 #include "ITN Tools.h"
 #include "stdx/string_helper.h"
+#include "stdx/static_format.h"
 
 #define SECTION_CLIENT        "CLIENT"
 #define SECTION_COORDINATES   "COORDINATES"
@@ -41,17 +42,20 @@
 #define KEY_ROUTENAME         "ROUTENAME"
 #define KEY_DESCRIPTIONLINES  "DESCRIPTIONLINES"
 #define KEY_DESCRIPTION       "DESCRIPTION%d"
-#define KEY_STATION           "STATION%d"
 #define KEY_ROUTERECT         "ROUTERECT"
 
 #define VALUE_REQUEST         "TRUE"
 #define VALUE_STATION_CLIENT  "Standort,999999999"
-#define VALUE_STATION_COORDS  "%d,%d"
 #define VALUE_ROUTERECT       "%d,%d,%d,%d"
 
+static constexpr stdx::static_format KEY_STATION("STATION%d");
+static constexpr stdx::static_format VALUE_STATION_COORDS("%d,%d");
+
 int WriteBCR(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
 	size_t i;
+	std::string strKey;
+	std::string strValue;
 	std::string szPathName = stdx::string_helper::narrow(strPathName);
 
 	// Write request
@@ -65,7 +69,8 @@ int WriteBCR(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 	// Write Client Station
 	for (i = 0; i < cGpsRoute.size(); i++)
 	{
-		if (!WritePrivateProfileStringA(SECTION_CLIENT, stdx::format(KEY_STATION)(i + 1).str().c_str(), VALUE_STATION_CLIENT, szPathName.c_str()))
+		strKey.clear();
+		if (!WritePrivateProfileStringA(SECTION_CLIENT, stdx::format_append<KEY_STATION>(strKey, i + 1).c_str(), VALUE_STATION_CLIENT, szPathName.c_str()))
 			return GetLastError();
 	}
 
@@ -76,14 +81,17 @@ int WriteBCR(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 
 		geo::CGeoMercatorXY gMercatorXY(cGpsPoint);
 
-		if (!WritePrivateProfileStringA(SECTION_COORDINATES, stdx::format(KEY_STATION)(i + 1).str().c_str(), stdx::format(VALUE_STATION_COORDS)(gMercatorXY.x())(gMercatorXY.y()).str().c_str(), szPathName.c_str()))
+		strKey.clear();
+		strValue.clear();
+		if (!WritePrivateProfileStringA(SECTION_COORDINATES, stdx::format_append<KEY_STATION>(strKey, i + 1).c_str(), stdx::format_append<VALUE_STATION_COORDS>(strValue, gMercatorXY.x(), gMercatorXY.y()).c_str(), szPathName.c_str()))
 			return GetLastError();
 	}
 
 	// Write Descriptions
 	for (i = 0; i < cGpsRoute.size(); i++)
 	{
-		if (!WritePrivateProfileStringA(SECTION_DESCRIPTION, stdx::format(KEY_STATION)(i + 1).str().c_str(), stdx::string_helper::from_utf8(cGpsRoute[i].name()).c_str(), szPathName.c_str()))
+		strKey.clear();
+		if (!WritePrivateProfileStringA(SECTION_DESCRIPTION, stdx::format_append<KEY_STATION>(strKey, i + 1).c_str(), stdx::string_helper::from_utf8(cGpsRoute[i].name()).c_str(), szPathName.c_str()))
 			return GetLastError();
 	}
 
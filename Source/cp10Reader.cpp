@@ -39,7 +39,7 @@ namespace
 	constexpr double TRP_FACTOR = 1000000.;
 }
 
-int ReadCP10(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadCP10(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str(), std::ios_base::binary);
 	if (!ifsFile)
@@ -51,7 +51,7 @@ int ReadCP10(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecG
 		ifsFile >> jsParser;
 		const CJsonObject& jsonTrip = jsParser("Trip");
 
-		vecGpsArray.push_back(new CGpsRoute());
+		vecGpsArray.push_back(new CGpsRoute(pResource));
 		CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 		cGpsRoute.name(jsonTrip("Name"));
 
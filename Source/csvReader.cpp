@@ -32,10 +32,11 @@
 #include <fstream>
 #include "ITN Tools.h"
 #include "CsvDlg.h"
+#include "GpsGeocoding.h"
 #include "stdx/string_helper.h"
 #include "stdx/bom.h"
 
-int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine)
+int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource)
 {
 	CCsvDlg::_CSV_CONFIG csvConfig;
 	CCsvDlg csvDlg(csvConfig, true);
@@ -52,8 +53,10 @@ int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	for (int i = 0; i < 5; i++)
 		(csvConfig.ntabCol[i])--;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
+	CGpsGeocoding cGeocoding;
+	const std::wstring strAddressHeader = CWToolsString::Load(IDS_ADDRESS);
 
 	std::wstring separators(L"\"");
 	int i = 0;
@@ -150,8 +153,18 @@ int ReadCSV(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 		}
 
 		if (cGpsPoint)
+		{
+			cGpsRoute.push_back(cGpsPoint);
+		}
+		else if (csvConfig.nColLatitude == -1 && csvConfig.nColLongitude == -1 && !cGpsPoint.name().empty() && vecResult[csvConfig.nColAddress] != strAddressHeader)
+		{
+			// Only an address, find it once the file is read
+			cGeocoding.add(cGpsRoute.size(), cGpsPoint.name());
 			cGpsRoute.push_back(cGpsPoint);
+		}
 	}
 
+	cGeocoding.run(cGpsRoute, false, true);
+
 	return S_OK;
 }
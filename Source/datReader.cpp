@@ -32,7 +32,7 @@
 #include "ITN Tools.h"
 #include "stdx/string_helper.h"
 
-int ReadDAT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadDAT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_OK;
 	DWORD dwFileSize = 0;
@@ -72,7 +72,7 @@ int ReadDAT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!dwFileSize)
 		goto end_function;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	pEndFile = pMapFile + dwFileSize;
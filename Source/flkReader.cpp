@@ -40,12 +40,12 @@
 
 #define VALUE_ERROR   _T("R_ERROR")
 
-int ReadFLK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadFLK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	int i = 0;
 	std::wstring strReadString;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	// Read Route name
@@ -59,7 +59,7 @@ static void SearchField(const std::string& strLine, const std::string& strField,
 	}
 }
 
-int ReadGCL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadGCL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName, std::ios_base::binary);
 	if (!ifsFile)
@@ -67,7 +67,7 @@ int ReadGCL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 
 	bool bUtf8 = (stdx::bom::read(ifsFile) == stdx::bom::utf_8); // UTF-8
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::string strLine;
@@ -30,6 +30,7 @@
 
 #include "stdafx.h"
 #include "ITN Tools.h"
+#include "MapSourceRecords.h"
 
 #pragma pack(push, 1) // packing is now 1
 typedef struct
@@ -50,6 +51,7 @@ typedef struct
 
 #define GDB_SIZE_OF_SIGNATURE    6
 #define GDB_DEFAULT_SIGNATURE    "MsRcf\0"
+#define GDB_SIZE_OF_VERSION_END  10 // "MapSource\0" after the file version record
 
 #define GDB_TYPE_FILE_FORMAT     'D'
 #define GDB_TYPE_FILE_VERSION    'A'
@@ -61,326 +63,189 @@ typedef struct
 
 #define GDB_COORD_TO_DEGREE(x)	static_cast<float>((x*180.)/0x80000000UL)
 
-static int ReadTrack(CGpsPointArray& cGpsTrack, LPBYTE lpTrack, int nVersion)
+static std::string ReadString(CMapSourceCursor& cursor, int nVersion)
 {
-	/* Read Name */
-	char* pszName = reinterpret_cast<char*>(lpTrack);
-	lpTrack += strlen(pszName) + 1;
+	const char* pszString = cursor.string();
 
 	if (nVersion > 2)
-		cGpsTrack.name(pszName);
+		return pszString;
 	else
-		cGpsTrack.name(stdx::string_helper::to_utf8(pszName));
+		return stdx::string_helper::to_utf8(pszString);
+}
+
+static void BypassPoint(CMapSourceCursor& cursor)
+{
+	if (cursor.read<_GPS_POINT>().bAltitude)
+		cursor.skip(sizeof(double));
+}
+
+static size_t ReadTrackHeader(CMapSourceCursor& cursor, CGpsPointArray& cGpsTrack, int nVersion)
+{
+	/* Read Name */
+	cGpsTrack.name(ReadString(cursor, nVersion));
 
 	/* Bypass display Flag */
-	lpTrack += sizeof(unsigned char);
+	cursor.skip(sizeof(unsigned char));
 
 	/* Bypass Color */
-	lpTrack += sizeof(unsigned int);
+	cursor.skip(sizeof(unsigned int));
 
 	/* Read waypoint number */
-	unsigned int unNumber = *reinterpret_cast<unsigned int*>(lpTrack);
-	lpTrack += sizeof(unsigned int);
-
-	for (unsigned int i = 0; i < unNumber; i++)
-	{
-		CGpsPoint cGpsPoint;
-
-		/* Read coordinates */
-		P_GPS_POINT pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpTrack);
-		lpTrack += sizeof(_GPS_POINT);
-
-		cGpsPoint.lat(GDB_COORD_TO_DEGREE(pGpsPoint->nLatitude));
-		cGpsPoint.lng(GDB_COORD_TO_DEGREE(pGpsPoint->nLongitude));
+	return cursor.read<unsigned int>();
+}
 
-		if (pGpsPoint->bAltitude)
-		{
-			cGpsPoint.alt(*reinterpret_cast<double*>(lpTrack));
-			lpTrack += sizeof(double);
-		}
+static void ReadTrackPoint(CMapSourceCursor& cursor, CGpsPoint& cGpsPoint)
+{
+	/* Read coordinates */
+	_GPS_POINT sGpsPoint = cursor.read<_GPS_POINT>();
 
-		unsigned char bFlag = *static_cast<unsigned char*>(lpTrack);
-		lpTrack += sizeof(unsigned char);
-		if (bFlag)
-			lpTrack += sizeof(unsigned int); // Heure
+	cGpsPoint.lat(GDB_COORD_TO_DEGREE(sGpsPoint.nLatitude));
+	cGpsPoint.lng(GDB_COORD_TO_DEGREE(sGpsPoint.nLongitude));
 
-		bFlag = *static_cast<unsigned char*>(lpTrack);
-		lpTrack += sizeof(unsigned char);
-		if (bFlag)
-			lpTrack += sizeof(double); // Profondeur
+	if (sGpsPoint.bAltitude)
+		cGpsPoint.alt(cursor.read<double>());
 
-		bFlag = *static_cast<unsigned char*>(lpTrack);
-		lpTrack += sizeof(unsigned char);
-		if (bFlag)
-			lpTrack += sizeof(double); // Temperature
+	if (cursor.read<unsigned char>())
+		cursor.skip(sizeof(unsigned int)); // Heure
 
-		cGpsTrack.push_back(cGpsPoint);
-	}
+	if (cursor.read<unsigned char>())
+		cursor.skip(sizeof(double)); // Profondeur
 
-	return S_OK;
+	if (cursor.read<unsigned char>())
+		cursor.skip(sizeof(double)); // Temperature
 }
 
-static int ReadRoute(std::vector<std::string>& vecRoute, LPBYTE lpRoute, int nVersion)
+static void ReadRoute(CMapSourceCursor& cursor, std::vector<std::string>& vecRoute, int nVersion)
 {
-	P_GPS_POINT pGpsPoint;
-	char* pszName;
 	unsigned int unNumber = 0;
 	unsigned int unLinkNumber = 0;
-	unsigned char bFlag;
 	unsigned int i, j;
 
 	/* Read Name */
-	pszName = reinterpret_cast<char*>(lpRoute);
-	lpRoute += strlen(pszName) + 1;
-
-	if (nVersion > 2)
-		vecRoute.push_back(pszName);
-	else
-		vecRoute.push_back(stdx::string_helper::to_utf8(pszName));
+	vecRoute.push_back(ReadString(cursor, nVersion));
 
 	/* Bypass Automate Flag */
-	lpRoute += sizeof(unsigned char);
+	cursor.skip(sizeof(unsigned char));
 
 	/* Min/Max Flag */
-	bFlag = *static_cast<unsigned char*>(lpRoute);
-	lpRoute += sizeof(unsigned char);
-
-	if (!bFlag)
+	if (!cursor.read<unsigned char>())
 	{
-		/* Bypass max coordinates */
-		pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-		lpRoute += sizeof(_GPS_POINT);
-
-		if (pGpsPoint->bAltitude)
-			lpRoute += sizeof(double);
-
-		/* Bypass min coordinates */
-		pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-		lpRoute += sizeof(_GPS_POINT);
-
-		if (pGpsPoint->bAltitude)
-			lpRoute += sizeof(double);
+		/* Bypass max and min coordinates */
+		BypassPoint(cursor);
+		BypassPoint(cursor);
 	}
 
 	/* Read waypoint number */
-	unNumber = *reinterpret_cast<unsigned int*>(lpRoute);
-	lpRoute += sizeof(unsigned int);
+	unNumber = cursor.read<unsigned int>();
 
 	for (i = 0; i < unNumber; i++)
 	{
 		/* Read Name */
-		pszName = reinterpret_cast<char*>(lpRoute);
-		lpRoute += strlen(pszName) + 1;
-
-		if (nVersion > 2)
-			vecRoute.push_back(pszName);
-		else
-			vecRoute.push_back(stdx::string_helper::to_utf8(pszName));
+		std::string strName = ReadString(cursor, nVersion);
 
 		/* Bypass class */
-		lpRoute += sizeof(int);
+		cursor.skip(sizeof(int));
 
 		/* Bypass Country */
-		lpRoute += strlen(reinterpret_cast<char*>(lpRoute)) + 1;
+		cursor.string();
 
 		/* Bypass subclass */
-		lpRoute += 22;
+		cursor.skip(22);
 
-		if (*lpRoute)
-		{
-			lpRoute += 8;
-			if (nVersion > 2)
-				lpRoute += 8;
-		}
-		lpRoute++;
+		if (cursor.read<unsigned char>())
+			cursor.skip(nVersion > 2 ? 16 : 8);
 
 		/* Bypass unkown data */
-		lpRoute += 18;
+		cursor.skip(18);
 
 		/* Read Link number */
-		unLinkNumber = *reinterpret_cast<unsigned int*>(lpRoute);
-		lpRoute += sizeof(unsigned int);
+		unLinkNumber = cursor.read<unsigned int>();
 
 		/* Bypass links waypoints */
 		for (j = 0; j < unLinkNumber; j++)
-		{
-			pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-			lpRoute += sizeof(_GPS_POINT);
-
-			if (pGpsPoint->bAltitude)
-				lpRoute += sizeof(double);
-		}
+			BypassPoint(cursor);
 
 		/* End Flag */
-		bFlag = *static_cast<unsigned char*>(lpRoute);
-		lpRoute += sizeof(unsigned char);
-
-		if (!bFlag)
+		if (!cursor.read<unsigned char>())
 		{
-			/* Bypass max coordinates */
-			pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-			lpRoute += sizeof(_GPS_POINT);
-
-			if (pGpsPoint->bAltitude)
-				lpRoute += sizeof(double);
-
-			/* Bypass min coordinates */
-			pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-			lpRoute += sizeof(_GPS_POINT);
-
-			if (pGpsPoint->bAltitude)
-				lpRoute += sizeof(double);
+			/* Bypass max and min coordinates */
+			BypassPoint(cursor);
+			BypassPoint(cursor);
 		}
 
 		if (nVersion > 1)
-		{
-			lpRoute += 8;
-			if (nVersion > 2)
-				lpRoute += 2;
-		}
-	}
+			cursor.skip(nVersion > 2 ? 10 : 8);
 
-	return S_OK;
+		// Only complete waypoints are kept
+		vecRoute.push_back(std::move(strName));
+	}
 }
 
-static int ReadWayPoint(CGpsPointArray& cGpsWaypointsArray, CGpsPointArray& cGpsRoutePoints, LPBYTE lpWaypoint, int nVersion)
+static int ReadWayPoint(CMapSourceCursor& cursor, CGpsPoint& cGpsPoint, int nVersion)
 {
-	P_GPS_POINT pGpsPoint;
-	char* pszName;
-	char* pszText;
 	double fAltitude = 0;
-	int nClass;
 
 	/* Read Name*/
-	pszName = reinterpret_cast<char*>(lpWaypoint);
-	lpWaypoint += strlen(pszName) + 1;
+	std::string strName = ReadString(cursor, nVersion);
 
 	/* Read class */
-	nClass = *reinterpret_cast<int*>(lpWaypoint);
-	lpWaypoint += sizeof(int);
+	int nClass = cursor.read<int>();
 
 	/* Bypass Country */
-	lpWaypoint += strlen(reinterpret_cast<char*>(lpWaypoint)) + 1;
+	cursor.string();
 
 	/* Bypass subclass */
-	lpWaypoint += 22;
+	cursor.skip(22);
 
 	/* Read coordinates */
-	pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpWaypoint);
-	lpWaypoint += sizeof(_GPS_POINT);
+	_GPS_POINT sGpsPoint = cursor.read<_GPS_POINT>();
 
-	if (pGpsPoint->bAltitude)
-	{
-		fAltitude = *reinterpret_cast<double*>(lpWaypoint);
-		lpWaypoint += sizeof(double);
-	}
+	if (sGpsPoint.bAltitude)
+		fAltitude = cursor.read<double>();
 
 	/* Read text */
-	pszText = reinterpret_cast<char*>(lpWaypoint);
-	lpWaypoint += strlen(pszText) + 1;
-
-	CGpsPoint cGpsPoint;
-
-	if (nVersion > 2)
-	{
-		cGpsPoint.name(pszName);
-		cGpsPoint.comment(pszText);
-	}
-	else
-	{
-		cGpsPoint.name(stdx::string_helper::to_utf8(pszName));
-		cGpsPoint.comment(stdx::string_helper::to_utf8(pszText));
-	}
+	cGpsPoint.comment(ReadString(cursor, nVersion));
+	cGpsPoint.name(strName);
 
-	cGpsPoint.coords(GDB_COORD_TO_DEGREE(pGpsPoint->nLatitude), GDB_COORD_TO_DEGREE(pGpsPoint->nLongitude), fAltitude);
+	cGpsPoint.coords(GDB_COORD_TO_DEGREE(sGpsPoint.nLatitude), GDB_COORD_TO_DEGREE(sGpsPoint.nLongitude), fAltitude);
 
-	if (!nClass)
-		cGpsWaypointsArray.push_back(cGpsPoint);
-	else
-		cGpsRoutePoints.push_back(cGpsPoint);
-
-	return S_OK;
+	return nClass;
 }
 
-static int _ReadGDB(LPBYTE lpFile, DWORD dwFileSize, std::vector<CGpsPointArray*>& vecGpsArray)
+static int _ReadGDB(LPBYTE lpFile, DWORD dwFileSize, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource)
 {
-	P_RECORD_HEADER pRecordHeader;
-	LPBYTE lpPos = lpFile;
-	LPBYTE lpEnd = lpFile + dwFileSize;
 	int nVersion = 0;
-	CGpsWaypointArray cGpsRoutePoints;
-	std::vector<std::string> vecRoute;
-	CGpsWaypointArray::iterator it;
-	size_t i;
 
 	// Check signature
-	if (memcmp(lpFile, GDB_DEFAULT_SIGNATURE, GDB_SIZE_OF_SIGNATURE))
+	if (dwFileSize < GDB_SIZE_OF_SIGNATURE || memcmp(lpFile, GDB_DEFAULT_SIGNATURE, GDB_SIZE_OF_SIGNATURE))
 		return E_INVALIDARG;
 
-	vecGpsArray.push_back(new CGpsWaypointArray);
-	CGpsPointArray& cGpsWaypointsArray = *vecGpsArray.back();
-
-	pRecordHeader = (P_RECORD_HEADER)(lpPos + GDB_SIZE_OF_SIGNATURE);
+	// First pass: record index
+	MapSourceRecords records = IndexMapSourceRecords(lpFile + GDB_SIZE_OF_SIGNATURE, lpFile + dwFileSize,
+		[](unsigned char ucType) { return ucType == GDB_TYPE_FILE_VERSION ? GDB_SIZE_OF_VERSION_END : 0; });
 
-	while ((LPBYTE)pRecordHeader < lpEnd)
+	for (const MapSourceRecord& record : records)
 	{
-		lpPos = (LPBYTE)pRecordHeader + sizeof(_RECORD_HEADER);
-		switch (pRecordHeader->ucType)
+		if (record.ucType == GDB_TYPE_FILE_FORMAT && record.lpBegin < record.lpEnd) // File format version
 		{
-		case GDB_TYPE_FILE_FORMAT:    // File format version
-			nVersion = *lpPos - 'k' + 1;
-			break;
-
-		case GDB_TYPE_FILE_VERSION:   // File version
-			lpPos += 10; // MapSource\0
-			break;
-
-		case GDB_TYPE_WAYPOINT: // Waypoint
-			ReadWayPoint(cGpsWaypointsArray, cGpsRoutePoints, lpPos, nVersion);
-			break;
-
-		case GDB_TYPE_TRACK:    // Track
-			vecGpsArray.push_back(new CGpsTrack());
-			ReadTrack(*vecGpsArray.back(), lpPos, nVersion);
-			break;
-
-		case GDB_TYPE_ROUTE:    // Route
-			vecRoute.clear();
-			ReadRoute(vecRoute, lpPos, nVersion);
-			if (vecRoute.size())
-			{
-				vecGpsArray.push_back(new CGpsRoute());
-				CGpsPointArray& cGpsPointArray = *vecGpsArray.back();
-
-				cGpsPointArray.name(vecRoute[0]);
-
-				for (i = 1; i < vecRoute.size(); i++)
-				{
-					std::string& strAddress = vecRoute[i];
-					for (it = cGpsRoutePoints.begin(); it != cGpsRoutePoints.end(); ++it)
-					{
-						if (strAddress == it->name())
-						{
-							cGpsPointArray.push_back(*it);
-							break;
-						}
-					}
-				}
-			}
-			break;
-
-		default:
+			nVersion = *record.lpBegin - 'k' + 1;
 			break;
 		}
-
-		pRecordHeader = (P_RECORD_HEADER)(lpPos + pRecordHeader->unLength);
 	}
 
+	// Second pass: records decoding
+	MapSourceDecoders decoders;
+	decoders.waypoint = [nVersion](CMapSourceCursor& cursor, CGpsPoint& cGpsPoint) { return ReadWayPoint(cursor, cGpsPoint, nVersion); };
+	decoders.trackHeader = [nVersion](CMapSourceCursor& cursor, CGpsPointArray& cGpsTrack) { return ReadTrackHeader(cursor, cGpsTrack, nVersion); };
+	decoders.trackPoint = ReadTrackPoint;
+	decoders.route = [nVersion](CMapSourceCursor& cursor, std::vector<std::string>& vecRoute) { ReadRoute(cursor, vecRoute, nVersion); };
+
+	DecodeMapSourceRecords(records, decoders, vecGpsArray, pResource);
 
 	return S_OK;
 }
 
-int ReadGDB(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadGDB(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_FALSE;
 	DWORD dwFileSize = 0;
@@ -414,7 +279,7 @@ int ReadGDB(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!dwFileSize)
 		goto end_function;
 
-	hr = _ReadGDB(pMapFile, dwFileSize, vecGpsArray);
+	hr = _ReadGDB(pMapFile, dwFileSize, vecGpsArray, pResource);
 
 end_function:
 	if (pMapFile) UnmapViewOfFile(pMapFile);
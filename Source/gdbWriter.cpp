@@ -312,6 +312,45 @@ static int WriteWayPoint(const CGpsPointArray& cGpsPointArray, size_t nIndex, HA
 	return S_OK;
 }
 
+#ifdef _DEBUG
+// The written file must read back: the route with all its points (an empty route is dropped),
+// its waypoints are not of class 0 and there is no track
+static void CheckWrittenGDB(const std::wstring& strPathName, const CGpsRoute& cGpsRoute)
+{
+	std::vector<CGpsPointArray*> vecGpsArray;
+	int hr = ReadGDB(strPathName, vecGpsArray, true, std::pmr::get_default_resource());
+
+	size_t ulWaypoints = 0, ulTracks = 0, ulRoutes = 0, ulRoutePoints = 0;
+	for (CGpsPointArray* pGpsArray : vecGpsArray)
+	{
+		switch (pGpsArray->getType())
+		{
+		case CGpsPointArray::E_ARRAY_WPT:
+			ulWaypoints += pGpsArray->size();
+			break;
+
+		case CGpsPointArray::E_ARRAY_TRACK:
+			ulTracks++;
+			break;
+
+		case CGpsPointArray::E_ARRAY_ROUTE:
+			ulRoutes++;
+			ulRoutePoints += pGpsArray->size();
+			break;
+
+		default:
+			break;
+		}
+
+		delete pGpsArray;
+	}
+
+	ASSERT(hr == S_OK);
+	ASSERT(!ulWaypoints && !ulTracks);
+	ASSERT(ulRoutes == (cGpsRoute.empty() ? 0 : 1) && ulRoutePoints == cGpsRoute.size());
+}
+#endif
+
 int WriteGDB(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
 	HANDLE pFile = nullptr;
@@ -365,6 +404,10 @@ int WriteGDB(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 
 	CloseHandle(pFile);
 
+#ifdef _DEBUG
+	CheckWrittenGDB(strPathName, cGpsRoute);
+#endif
+
 	return S_OK;
 }
 
@@ -37,7 +37,7 @@ bool isGoogleURL(const std::wstring& strUrl)
 	return geo::CGoogleUrl::isValidUrl(stdx::wstring_helper::to_utf8(strUrl));
 }
 
-int ReadGoogleURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadGoogleURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	if (!isGoogleURL(strUrl))
 		return S_FALSE;
@@ -46,7 +46,7 @@ int ReadGoogleURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecG
 	geo::CGoogleUrl::UrlToLocations(stdx::wstring_helper::to_utf8(strUrl), gLocations);
 	gLocations.removeEmpties();
 
-	vecGpsArray.push_back(new CGpsRoute);
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	vecGpsArray.back()->assign(gLocations.begin(), gLocations.end());
 	vecGpsArray.back()->name(CToolsString::Load(IDS_PROVIDER_GOOGLE_MAP));
 
@@ -53,8 +53,9 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-GPXDaimlerContentHandler::GPXDaimlerContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+GPXDaimlerContentHandler::GPXDaimlerContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_pGpsCurrentArray(nullptr),
 	m_pGpsWayPointArray(nullptr),
 	m_bOnPoint(false)
@@ -105,7 +106,7 @@ void GPXDaimlerContentHandler::OnStartElement(const XML_Char* name, const XML_Ch
 	if ((str == XML_MK_WPT || str == XML_MK_GPXP "" XML_MK_WPT) && !m_pGpsCurrentArray)
 	{
 		if (!m_pGpsWayPointArray)
-			m_pGpsWayPointArray = new CGpsWaypointArray();
+			m_pGpsWayPointArray = new CGpsWaypointArray(m_pResource);
 
 		m_pGpsCurrentArray = m_pGpsWayPointArray;
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_WPT && m_strCurrentTag.empty())
@@ -136,7 +137,7 @@ void GPXDaimlerContentHandler::OnStartElement(const XML_Char* name, const XML_Ch
 		if (m_pGpsCurrentArray != m_pGpsWayPointArray)
 			delete m_pGpsCurrentArray;
 
-		m_pGpsCurrentArray = new CGpsRoute();
+		m_pGpsCurrentArray = new CGpsRoute(m_pResource);
 
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_ROUTE)
 			m_strCurrentTag = XML_MK_RTEPT;
@@ -146,7 +147,7 @@ void GPXDaimlerContentHandler::OnStartElement(const XML_Char* name, const XML_Ch
 		if (m_pGpsCurrentArray != m_pGpsWayPointArray)
 			delete m_pGpsCurrentArray;
 
-		m_pGpsCurrentArray = new CGpsTrack();
+		m_pGpsCurrentArray = new CGpsTrack(m_pResource);
 
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_TRACK)
 			m_strCurrentTag = XML_MK_TRKPT;
@@ -210,7 +211,7 @@ void GPXDaimlerContentHandler::OnCharacterData(const XML_Char* data, int len)
 	m_strData.append(data, len);
 }
 
-int ReadDaimlerGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadDaimlerGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return GPXDaimlerContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return GPXDaimlerContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
@@ -36,7 +36,7 @@
 class GPXDaimlerContentHandler : private CSAXParser
 {
 public:
-	GPXDaimlerContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	GPXDaimlerContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~GPXDaimlerContentHandler();
 
 	bool Parse(std::istream& iss);
@@ -49,6 +49,7 @@ private:
 
 private:
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	CGpsPointArray* m_pGpsCurrentArray;
 	CGpsPointArray* m_pGpsWayPointArray;
 	CGpsPoint m_cGpsPoint;
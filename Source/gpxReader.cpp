@@ -51,8 +51,9 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-GPXContentHandler::GPXContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+GPXContentHandler::GPXContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_pGpsCurrentArray(nullptr),
 	m_pGpsWayPointArray(nullptr),
 	m_bOnPoint(false)
@@ -103,7 +104,7 @@ void GPXContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 	if (str == XML_MK_WPT && !m_pGpsCurrentArray)
 	{
 		if (!m_pGpsWayPointArray)
-			m_pGpsWayPointArray = new CGpsWaypointArray();
+			m_pGpsWayPointArray = new CGpsWaypointArray(m_pResource);
 
 		m_pGpsCurrentArray = m_pGpsWayPointArray;
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_WPT && m_strCurrentTag.empty())
@@ -134,7 +135,7 @@ void GPXContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 		if (m_pGpsCurrentArray != m_pGpsWayPointArray)
 			delete m_pGpsCurrentArray;
 
-		m_pGpsCurrentArray = new CGpsRoute();
+		m_pGpsCurrentArray = new CGpsRoute(m_pResource);
 
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_ROUTE)
 			m_strCurrentTag = XML_MK_RTEPT;
@@ -144,7 +145,7 @@ void GPXContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 		if (m_pGpsCurrentArray != m_pGpsWayPointArray)
 			delete m_pGpsCurrentArray;
 
-		m_pGpsCurrentArray = new CGpsTrack();
+		m_pGpsCurrentArray = new CGpsTrack(m_pResource);
 
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_TRACK)
 			m_strCurrentTag = XML_MK_TRKPT;
@@ -208,7 +209,7 @@ void GPXContentHandler::OnCharacterData(const XML_Char* data, int len)
 	m_strData.append(data, len);
 }
 
-int ReadGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadGPX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return GPXContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return GPXContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
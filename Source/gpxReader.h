@@ -38,6 +38,7 @@ class GPXContentHandler : private CSAXParser
 {
 private:
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	CGpsPointArray* m_pGpsCurrentArray;
 	CGpsPointArray* m_pGpsWayPointArray;
 	CGpsPoint m_cGpsPoint;
@@ -51,7 +52,7 @@ private:
 	virtual void OnCharacterData(const XML_Char* data, int len);
 
 public:
-	GPXContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	GPXContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~GPXContentHandler();
 
 	bool Parse(std::istream& iss);
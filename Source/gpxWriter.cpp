@@ -90,7 +90,7 @@ int WriteGPX(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD
 			(sSystemTime.wDay)
 			(sSystemTime.wHour)
 			(sSystemTime.wMinute)
-			(sSystemTime.wSecond));
+			(sSystemTime.wSecond).str());
 
 		xmlWriter.tag("bounds")
 			.attribute("minlat", stdx::string_helper::to_string(fMinLat))
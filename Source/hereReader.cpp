@@ -37,7 +37,7 @@ bool isHereURL(const std::wstring& strUrl)
 	return geo::CHereUrl::isValidUrl(stdx::wstring_helper::to_utf8(strUrl));
 }
 
-int ReadHereURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadHereURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	if (!isHereURL(strUrl))
 		return S_FALSE;
@@ -46,7 +46,7 @@ int ReadHereURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGps
 	geo::CHereUrl::UrlToLocations(stdx::wstring_helper::to_utf8(strUrl), gLocations);
 	gLocations.removeEmpties();
 
-	vecGpsArray.push_back(new CGpsRoute);
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	vecGpsArray.back()->assign(gLocations.begin(), gLocations.end());
 	vecGpsArray.back()->name(CToolsString::Load(IDS_PROVIDER_HERE_API));
 
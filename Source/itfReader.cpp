@@ -37,14 +37,14 @@ const uint32_t SygicMcGuider::HDR_SIGNATURE = 0x03C32B55;
 const uint32_t SygicMcGuider::HDR_PADDING = 0xFFFF0000;
 const int SygicMcGuider::COORDS_FACTOR = 100000;
 
-static HRESULT ReadMcGuiderFormat(const ifmstream& ifmsFile, std::vector<CGpsPointArray*>& vecGpsArray)
+static HRESULT ReadMcGuiderFormat(const ifmstream& ifmsFile, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource)
 {
 	const SygicMcGuider::ITF_HEADER* pHeader = reinterpret_cast<const SygicMcGuider::ITF_HEADER*>(ifmsFile.data());
 
 	if (pHeader->uiSignature != SygicMcGuider::HDR_SIGNATURE || !pHeader->usPointNumber2)
 		return S_FALSE;
 
-	std::unique_ptr<CGpsRoute> pRoute(new CGpsRoute);
+	std::unique_ptr<CGpsRoute> pRoute(new CGpsRoute(pResource));
 	const SygicMcGuider::ITF_POINT* pPoint = reinterpret_cast<const SygicMcGuider::ITF_POINT*>(reinterpret_cast<const char*>(pHeader) + sizeof(SygicMcGuider::ITF_HEADER));
 
 	for (int i = 0; i < pHeader->usPointNumber2; ++i)
@@ -78,7 +78,7 @@ const int SygicGpsNavigation::COORDS_FACTOR = 100000;
 
 #define SIZEOF_STRING(pStr) (sizeof(uint16_t) + (pStr->usLength) * 2)
 
-static HRESULT ReadGpsNavigationFormat(const ifmstream& ifmsFile, std::vector<CGpsPointArray*>& vecGpsArray)
+static HRESULT ReadGpsNavigationFormat(const ifmstream& ifmsFile, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource)
 {
 	const void* pEnd = reinterpret_cast<const char*>(ifmsFile.data()) + ifmsFile.size();
 	const SygicGpsNavigation::ITF_HEADER* pHeader = reinterpret_cast<const SygicGpsNavigation::ITF_HEADER*>(ifmsFile.data());
@@ -86,7 +86,7 @@ static HRESULT ReadGpsNavigationFormat(const ifmstream& ifmsFile, std::vector<CG
 	if (pHeader->uiSignature != SygicGpsNavigation::HDR_SIGNATURE)
 		return S_FALSE;
 
-	std::unique_ptr<CGpsRoute> pRoute(new CGpsRoute);
+	std::unique_ptr<CGpsRoute> pRoute(new CGpsRoute(pResource));
 
 	const SygicGpsNavigation::ITF_STRING* pString = reinterpret_cast<const SygicGpsNavigation::ITF_STRING*>(reinterpret_cast<const char*>(pHeader) + sizeof(SygicGpsNavigation::ITF_HEADER));
 	pRoute->name(stdx::wstring_helper::to_utf8(std::wstring(&(pString->wString), pString->usLength)));
@@ -148,16 +148,16 @@ static HRESULT ReadGpsNavigationFormat(const ifmstream& ifmsFile, std::vector<CG
 	return S_OK;
 }
 
-int ReadITF(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadITF(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	ifmstream ifmsFile(strPathName.c_str());
 	if (!ifmsFile)
 		return S_FALSE;
 
 	if (*reinterpret_cast<const uint32_t*>(ifmsFile.data()) == SygicMcGuider::HDR_SIGNATURE)
-		ReadMcGuiderFormat(ifmsFile, vecGpsArray);
+		ReadMcGuiderFormat(ifmsFile, vecGpsArray, pResource);
 	else
-		ReadGpsNavigationFormat(ifmsFile, vecGpsArray);
+		ReadGpsNavigationFormat(ifmsFile, vecGpsArray, pResource);
 
 	return S_OK;
 }
@@ -29,12 +29,12 @@
  */
 
 #include "stdafx.h"
-#include <fstream>
-#include "stdx/format.h"
+#include "ToolsLibrary/fmstream.h"
+#include "stdx/static_format.h"
 #include "ITN Tools.h"
 
-#define ITN_LINE     "%06d|%07d|%s|%d|\r\n"
 #define ITN_FACTOR   100000
+#define ITN_LINE_LEN 48 // Estimated length of a line
 
 #define TT_WAYPOINT             0 // Waypoint
 #define TT_WAYPOINT_DISABLED    1 // Waypoint disabled (will be skipped when navigating the itinerary, appears dimmed in the itinerary overview)
@@ -44,6 +44,8 @@
 
 namespace
 {
+	constexpr stdx::static_format ITN_LINE("%06d|%07d|%s|%d|\r\n");
+
 	inline long DoubleToLong(double dDouble)
 	{
 		return static_cast<long>(floor(dDouble * ITN_FACTOR) + 0.5);
@@ -52,11 +54,12 @@ namespace
 
 int WriteOneITN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute)
 {
-	std::ofstream ofsFile(strPathName.c_str(), std::ios_base::binary);
+	ofmstream ofsFile(strPathName.c_str(), cGpsRoute.size() * ITN_LINE_LEN);
 	if (!ofsFile)
 		return S_FALSE;
 
 	int nFlag;
+	std::string strLine;
 
 	for (size_t i = 0; i < cGpsRoute.size(); i++)
 	{
@@ -69,9 +72,12 @@ int WriteOneITN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute)
 		else
 			nFlag = TT_WAYPOINT;
 
-		ofsFile << stdx::format(ITN_LINE)(DoubleToLong(cGpsPoint.lng()))(DoubleToLong(cGpsPoint.lat()))(stdx::string_helper::from_utf8(cGpsPoint.name()))(nFlag);
+		strLine.clear();
+		ofsFile << stdx::format_append<ITN_LINE>(strLine, DoubleToLong(cGpsPoint.lng()), DoubleToLong(cGpsPoint.lat()), stdx::string_helper::from_utf8(cGpsPoint.name()), nFlag);
 	}
-	return S_OK;
+
+	ofsFile.commit();
+	return ofsFile.good() ? S_OK : S_FALSE;
 }
 
 int WriteITN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD dwFlag, bool)
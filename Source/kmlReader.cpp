@@ -55,8 +55,9 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-KMLContentHandler::KMLContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+KMLContentHandler::KMLContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_bOnPlacemark(false),
 	m_bOnFlyTo(false),
 	m_bOnLineString(false)
@@ -102,12 +103,12 @@ void KMLContentHandler::OnStartElement(const XML_Char* name, const XML_Char**)
 
 	if (str == XML_MK_DOCUMENT || str == XML_MK_FOLDER)
 	{
-		sttGpsPointArray gpsPointArray = { str, new CGpsWaypointArray() };
+		sttGpsPointArray gpsPointArray = { str, new CGpsWaypointArray(m_pResource) };
 		m_stkDocument.push(gpsPointArray);
 	}
 	else if (str == XML_MK_GXTOUR)
 	{
-		sttGpsPointArray gpsPointArray = { str, new CGpsRoute() };
+		sttGpsPointArray gpsPointArray = { str, new CGpsRoute(m_pResource) };
 		m_stkDocument.push(gpsPointArray);
 	}
 	else if (str == XML_MK_PLACEMARK)
@@ -151,7 +152,7 @@ void KMLContentHandler::OnEndElement(const XML_Char* name)
 			}
 			else if (str == XML_MK_COORDS)
 			{
-				std::unique_ptr<CGpsPointArray> pGpsTrak(new CGpsTrack);
+				std::unique_ptr<CGpsPointArray> pGpsTrak(new CGpsTrack(m_pResource));
 				pGpsTrak->name(m_cGpsPoint.name());
 
 				stdx::string_helper::vector vecStrResult;
@@ -252,7 +253,7 @@ void KMLContentHandler::OnCharacterData(const XML_Char* data, int len)
 	m_strData.append(data, len);
 }
 
-int ReadKML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadKML(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return KMLContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return KMLContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
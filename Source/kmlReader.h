@@ -45,6 +45,7 @@ private:
 	} sttGpsPointArray;
 
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	std::stack<sttGpsPointArray> m_stkDocument;
 	CGpsPoint m_cGpsPoint;
 	std::string m_strData;
@@ -58,7 +59,7 @@ private:
 	virtual void OnCharacterData(const XML_Char* data, int len);
 
 public:
-	KMLContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	KMLContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~KMLContentHandler();
 
 	bool Parse(const wchar_t* szFileName);
@@ -32,6 +32,13 @@
 #include <fstream>
 #include "ITN Tools.h"
 #include "SAXParser/SAXWriter.h"
+#include "stdx/static_format.h"
+
+namespace
+{
+	constexpr stdx::static_format KML_ROAD_COORDINATES("%f,%f,0 ");
+	constexpr stdx::static_format KML_POINT_COORDINATES("%f,%f,%f");
+}
 
 int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
@@ -43,6 +50,8 @@ int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 		SAXWriter xmlWriter(ofsFile);
 		xmlWriter.declaration();
 
+		std::string strCoordinates;
+
 		// Header
 		SAXWriter::Tag tagKml = std::move(xmlWriter.tag("kml").attribute("xmlns", "http://www.opengis.net/kml/2.2").attribute("xmlns:gx", "http://www.google.com/kml/ext/2.2"));
 		SAXWriter::Tag tagDocument = std::move(xmlWriter.tag("Document").attribute("id", "DOC"));
@@ -54,7 +63,7 @@ int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 		// Road
 		{
 			SAXWriter::Tag tagPlacemark = xmlWriter.tag("Placemark");
-			xmlWriter.tag("name").content(stdx::format("Route (%d waypoints)")(cGpsRoute.size()));
+			xmlWriter.tag("name").content(stdx::format("Route (%d waypoints)")(cGpsRoute.size()).str());
 			xmlWriter.tag("styleUrl").content("#roadStyle");
 
 			SAXWriter::Tag tagMultiGeometry = xmlWriter.tag("MultiGeometry");
@@ -62,7 +71,10 @@ int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 			SAXWriter::Tag tagCoordinates = xmlWriter.tag("coordinates");
 
 			for (CGpsRoute::const_iterator it = cGpsRoute.begin(); it != cGpsRoute.end(); ++it)
-				tagCoordinates.content(stdx::format("%f,%f,0 ")(it->lng())(it->lat()));
+			{
+				strCoordinates.clear();
+				tagCoordinates.content(stdx::format_append<KML_ROAD_COORDINATES>(strCoordinates, it->lng(), it->lat()));
+			}
 		}
 
 		// Write Waypoints
@@ -75,7 +87,7 @@ int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 
 		for (CGpsRoute::const_iterator it = itFirstElement; it != cGpsRoute.end(); ++it)
 		{
-			auto writePlacemark = [&xmlWriter](const CGpsPoint& cGpsPoint, const std::string& styleUrl)
+			auto writePlacemark = [&xmlWriter, &strCoordinates](const CGpsPoint& cGpsPoint, const std::string& styleUrl)
 			{
 				SAXWriter::Tag tagPlacemark = xmlWriter.tag("Placemark");
 
@@ -87,7 +99,8 @@ int WriteKML(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 				xmlWriter.tag("styleUrl").content(styleUrl);
 
 				SAXWriter::Tag tagPoint = xmlWriter.tag("Point");
-				xmlWriter.tag("coordinates").content(stdx::format("%f,%f,%f")(cGpsPoint.lng())(cGpsPoint.lat())(cGpsPoint.alt()));
+				strCoordinates.clear();
+				xmlWriter.tag("coordinates").content(stdx::format_append<KML_POINT_COORDINATES>(strCoordinates, cGpsPoint.lng(), cGpsPoint.lat(), cGpsPoint.alt()));
 			};
 
 			if (it == itFirstElement)
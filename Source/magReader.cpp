@@ -115,7 +115,7 @@ static int ParseWaypoint(const stdx::string_helper::vector& vecResults, CGpsPoin
 	return S_OK;
 }
 
-int ReadMAG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadMAG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	CGpsWaypointArray cGpsPointArray;
 	int nExplorist = 0;
@@ -124,7 +124,7 @@ int ReadMAG(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::string strLine;
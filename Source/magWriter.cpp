@@ -30,15 +30,9 @@
 
 #include "stdafx.h"
 #include "ITN Tools.h"
+#include "stdx/static_format.h"
 #include <fstream>
 
-#define PMGNWPL      "$PMGNWPL,%08.03f,%c,%09.03f,%c,%07.f,M,WPT%03d,%s,a"
-#define PMGNRTE_1    "$PMGNRTE,%d,%d,c,1,WPT%03d,a"
-#define PMGNRTE_2    "$PMGNRTE,%d,%d,c,1,WPT%03d,a,WPT%03d,a"
-#define PMGNRTE_EX_1 "$PMGNRTE,%d,%d,c,1,%s,WPT%03d,a"
-#define PMGNRTE_EX_2 "$PMGNRTE,%d,%d,c,1,%s,WPT%03d,a,WPT%03d,a"
-#define CHECKSUM     "%s*%02X\r\n"
-
 #define NORTH  'N'   // +
 #define SOUTH  'S'   // -
 #define EAST   'E'   // +
@@ -46,6 +40,13 @@
 
 namespace
 {
+	constexpr stdx::static_format PMGNWPL("$PMGNWPL,%08.03f,%c,%09.03f,%c,%07.f,M,WPT%03d,%s,a");
+	constexpr stdx::static_format PMGNRTE_1("$PMGNRTE,%d,%d,c,1,WPT%03d,a");
+	constexpr stdx::static_format PMGNRTE_2("$PMGNRTE,%d,%d,c,1,WPT%03d,a,WPT%03d,a");
+	constexpr stdx::static_format PMGNRTE_EX_1("$PMGNRTE,%d,%d,c,1,%s,WPT%03d,a");
+	constexpr stdx::static_format PMGNRTE_EX_2("$PMGNRTE,%d,%d,c,1,%s,WPT%03d,a,WPT%03d,a");
+	constexpr stdx::static_format CHECKSUM("*%02X\r\n");
+
 	double DegToMag(double dDeg)
 	{
 		double dMag = ((dDeg - static_cast<int>(dDeg)) * 60) + (static_cast<int>(dDeg) * 100);
@@ -69,6 +70,8 @@ int WriteMAG(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD
 	if (!ofsFile)
 		return S_FALSE;
 
+	std::string strLine;
+
 	// Write Waypoints
 	for (size_t i = 0; i < cGpsRoute.size(); i++)
 	{
@@ -78,16 +81,17 @@ int WriteMAG(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD
 		std::string strTmpText = stdx::string_helper::from_utf8(cGpsPoint.name());
 		stdx::string_helper::remove(strTmpText, ',');
 
-		std::string strline = stdx::format(PMGNWPL)
-			(DegToMag(cGpsPoint.lat()))
-			((cGpsPoint.lat() < 0) ? SOUTH : NORTH)
-			(DegToMag(cGpsPoint.lng()))
-			((cGpsPoint.lng() < 0) ? WEAST : EAST)
-			(cGpsPoint.alt())
-			(i + 1)
-			(strTmpText);
-
-		ofsFile << stdx::format(CHECKSUM)(strline)(getChecksum(strline));
+		strLine.clear();
+		stdx::format_append<PMGNWPL>(strLine,
+			DegToMag(cGpsPoint.lat()),
+			(cGpsPoint.lat() < 0) ? SOUTH : NORTH,
+			DegToMag(cGpsPoint.lng()),
+			(cGpsPoint.lng() < 0) ? WEAST : EAST,
+			cGpsPoint.alt(),
+			i + 1,
+			strTmpText);
+
+		ofsFile << stdx::format_append<CHECKSUM>(strLine, getChecksum(strLine));
 	}
 
 	size_t nRouteNumber = (cGpsRoute.size() / 2) + (cGpsRoute.size() % 2);
@@ -103,26 +107,26 @@ int WriteMAG(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD
 	// Write Route
 	for (size_t i = 0; i < nRouteNumber; i++)
 	{
-		std::string strline;
+		strLine.clear();
 
 		if (i + 1 == nRouteNumber && cGpsRoute.size() % 2)
 		{
 			if (dwFlag)
 				// eXplorist format
-				strline = stdx::format(PMGNRTE_EX_1)(nRouteNumber)(i + 1)(strTmpText)((i * 2) + 1);
+				stdx::format_append<PMGNRTE_EX_1>(strLine, nRouteNumber, i + 1, strTmpText, (i * 2) + 1);
 			else
-				strline = stdx::format(PMGNRTE_1)(nRouteNumber)(i + 1)((i * 2) + 1);
+				stdx::format_append<PMGNRTE_1>(strLine, nRouteNumber, i + 1, (i * 2) + 1);
 		}
 		else
 		{
 			if (dwFlag)
 				// eXplorist format
-				strline = stdx::format(PMGNRTE_EX_2)(nRouteNumber)(i + 1)(strTmpText)((i * 2) + 1)((i * 2) + 2);
+				stdx::format_append<PMGNRTE_EX_2>(strLine, nRouteNumber, i + 1, strTmpText, (i * 2) + 1, (i * 2) + 2);
 			else
-				strline = stdx::format(PMGNRTE_2)(nRouteNumber)(i + 1)((i * 2) + 1)((i * 2) + 2);
+				stdx::format_append<PMGNRTE_2>(strLine, nRouteNumber, i + 1, (i * 2) + 1, (i * 2) + 2);
 		}
 
-		ofsFile << stdx::format(CHECKSUM)(strline)(getChecksum(strline));
+		ofsFile << stdx::format_append<CHECKSUM>(strLine, getChecksum(strLine));
 	}
 
 	ofsFile.close();
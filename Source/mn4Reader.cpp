@@ -31,13 +31,13 @@
 #include "stdafx.h"
 #include <fstream>
 #include "ITN Tools.h"
-#include "GeoServices/GeoServices.h"
+#include "GpsGeocoding.h"
 #include "stdx/string_helper.h"
 #include "stdx/bom.h"
 
 namespace
 {
-	int ParseMN4(stdx::string_helper::vector& vecStrResult, CGpsRoute& cGpsRoute, bool bUtf8)
+	int ParseMN4(stdx::string_helper::vector& vecStrResult, CGpsRoute& cGpsRoute, CGpsGeocoding& cGeocoding, bool bUtf8)
 	{
 		HRESULT hr = S_OK;
 		std::string strPostalCode;
@@ -65,19 +65,9 @@ namespace
 			cGpsPoint.lat(stdx::string_helper::string_to<double>(vecStrResult[11]));
 		}
 
-		// If coordinates are empty, find on Google
+		// If coordinates are empty, find on Google once the file is read
 		if (!cGpsPoint)
-		{
-			geo::CGeoGeocoder gGeocoder(geo::E_GEO_PROVIDER_GOOGLE_API);
-
-			gGeocoder->Load(strPostalCode);
-			if (gGeocoder->getStatus() == geo::E_GEO_OK)
-			{
-				const geo::CGeoLocations& geoResults = gGeocoder->getResults();
-				if (geoResults.size())
-					cGpsPoint = geoResults.front();
-			}
-		}
+			cGeocoding.add(cGpsRoute.size(), bUtf8 ? strPostalCode : stdx::string_helper::to_utf8(strPostalCode));
 
 		cGpsRoute.push_back(cGpsPoint);
 
@@ -129,7 +119,7 @@ namespace
 	}
 }
 
-int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str());
 	if (!ifsFile)
@@ -137,8 +127,9 @@ int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 
 	bool bUtf8 = (stdx::bom::read(ifsFile) == stdx::bom::utf_8); // UTF-8
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
+	CGpsGeocoding cGeocoding(geo::E_GEO_PROVIDER_GOOGLE_API);
 
 	std::string strLine;
 	while (std::getline(ifsFile, strLine))
@@ -154,10 +145,11 @@ int ReadMNX(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 				else
 					ParseMN7(vecStrResult, cGpsRoute, bUtf8);
 			else
-				ParseMN4(vecStrResult, cGpsRoute, bUtf8);
+				ParseMN4(vecStrResult, cGpsRoute, cGeocoding, bUtf8);
 		}
 	}
 
+	cGeocoding.run(cGpsRoute, true, false);
 	cGpsRoute.removeEmpties();
 
 	return S_OK;
@@ -39,7 +39,7 @@
 class MapFactorContentHandler : private CSAXParser
 {
 public:
-	MapFactorContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	MapFactorContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~MapFactorContentHandler();
 
 	bool Parse(const wchar_t* szFileName);
@@ -50,6 +50,7 @@ private:
 
 private:
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	std::unique_ptr<CGpsPointArray> m_pGpsCurrentArray;
 	CGpsPoint m_cGpsPoint;
 	bool m_bOnRoutingPoints;
@@ -48,8 +48,9 @@ const int MapFactor::COORDS_FACTOR(3600000);
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-MapFactorContentHandler::MapFactorContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+MapFactorContentHandler::MapFactorContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_bOnRoutingPoints(false),
 	m_bOnPoint(false)
 {
@@ -92,7 +93,7 @@ void MapFactorContentHandler::OnStartElement(const XML_Char* name, const XML_Cha
 	}
 	else if (m_bOnRoutingPoints && str == MapFactor::MK_SET)
 	{
-		m_pGpsCurrentArray.reset(new CGpsRoute);
+		m_pGpsCurrentArray.reset(new CGpsRoute(m_pResource));
 	}
 	else if (m_pGpsCurrentArray.get() && (str == MapFactor::MK_DEPARTURE || str == MapFactor::MK_WAYPOINT || str == MapFactor::MK_DESTINATION))
 	{
@@ -139,7 +140,7 @@ void MapFactorContentHandler::OnEndElement(const XML_Char* name)
 	}
 }
 
-int ReadMPFCTR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadMPFCTR(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return MapFactorContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return MapFactorContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
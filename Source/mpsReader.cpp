@@ -30,6 +30,8 @@
 
 #include "stdafx.h"
 #include "ITN Tools.h"
+#include <stdexcept>
+#include "MapSourceRecords.h"
 
 #pragma pack(push, 1) // packing is now 1
 typedef struct
@@ -62,259 +64,168 @@ typedef struct
 
 #define MPS_COORD_TO_DEGREE(x)	static_cast<float>((x*180.)/0x80000000UL)
 
-static int ReadTrack(CGpsPointArray& cGpsTrack, LPBYTE lpTrack)
+static size_t ReadTrackHeader(CMapSourceCursor& cursor, CGpsPointArray& cGpsTrack)
 {
-	P_GPS_POINT pGpsPoint;
-	unsigned int unNumber = 0;
-	unsigned int i;
-
 	/* Read Name */
-	cGpsTrack.name(stdx::string_helper::to_utf8(reinterpret_cast<char*>(lpTrack)));
-	lpTrack += strlen(reinterpret_cast<char*>(lpTrack)) + 1;
+	cGpsTrack.name(stdx::string_helper::to_utf8(cursor.string()));
 
 	/* Bypass display Flag */
-	lpTrack += sizeof(unsigned char);
+	cursor.skip(sizeof(unsigned char));
 
 	/* Bypass Color */
-	lpTrack += sizeof(unsigned int);
+	cursor.skip(sizeof(unsigned int));
 
 	/* Read waypoint number */
-	unNumber = *reinterpret_cast<unsigned int*>(lpTrack);
-	lpTrack += sizeof(unsigned int);
-
-	for (i = 0; i < unNumber; i++)
-	{
-		CGpsPoint cGpsPoint;
-
-		/* Read coordinates */
-		pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpTrack);
-		lpTrack += sizeof(_GPS_POINT);
-
-		cGpsPoint.coords(MPS_COORD_TO_DEGREE(pGpsPoint->nLatitude), MPS_COORD_TO_DEGREE(pGpsPoint->nLongitude), pGpsPoint->fAltitude);
+	return cursor.read<unsigned int>();
+}
 
-		lpTrack += sizeof(unsigned char) + sizeof(unsigned int); // Heure
-		lpTrack += sizeof(unsigned char) + sizeof(double); // Profondeur
+static void ReadTrackPoint(CMapSourceCursor& cursor, CGpsPoint& cGpsPoint)
+{
+	/* Read coordinates */
+	_GPS_POINT sGpsPoint = cursor.read<_GPS_POINT>();
 
-		cGpsTrack.push_back(cGpsPoint);
-	}
+	cGpsPoint.coords(MPS_COORD_TO_DEGREE(sGpsPoint.nLatitude), MPS_COORD_TO_DEGREE(sGpsPoint.nLongitude), sGpsPoint.fAltitude);
 
-	return S_OK;
+	cursor.skip(sizeof(unsigned char) + sizeof(unsigned int)); // Heure
+	cursor.skip(sizeof(unsigned char) + sizeof(double)); // Profondeur
 }
 
-static int ReadRoute(std::vector<std::string>& vecRoute, LPBYTE lpRoute, int nVersion)
+static void ReadRoute(CMapSourceCursor& cursor, std::vector<std::string>& vecRoute, int nVersion)
 {
-	P_GPS_POINT pGpsPoint;
-	char* pszName;
 	unsigned int unNumber = 0;
 	unsigned int unLinkNumber = 0;
-	unsigned char bFlag;
 	unsigned int i;
 
 	/* Read Name */
-	pszName = reinterpret_cast<char*>(lpRoute);
-	lpRoute += strlen(pszName) + 1;
-
-	vecRoute.push_back(stdx::string_helper::to_utf8(pszName));
+	vecRoute.push_back(stdx::string_helper::to_utf8(cursor.string()));
 
 	/* Bypass Automate Flag */
-	lpRoute += sizeof(unsigned char);
+	cursor.skip(sizeof(unsigned char));
 
 	/* Min/Max Flag */
-	bFlag = *static_cast<unsigned char*>(lpRoute);
-	lpRoute += sizeof(unsigned char);
-
-	if (!bFlag)
+	if (!cursor.read<unsigned char>())
 	{
-		/* Bypass max coordinates */
-		pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-		lpRoute += sizeof(_GPS_POINT);
-
-		/* Bypass min coordinates */
-		pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-		lpRoute += sizeof(_GPS_POINT);
+		/* Bypass max and min coordinates */
+		cursor.skip(2 * sizeof(_GPS_POINT));
 	}
 
 	/* Read waypoint number */
-	unNumber = *reinterpret_cast<unsigned int*>(lpRoute);
-	lpRoute += sizeof(unsigned int);
+	unNumber = cursor.read<unsigned int>();
 
 	for (i = 0; i < unNumber; i++)
 	{
 		/* Read Name */
-		pszName = reinterpret_cast<char*>(lpRoute);
-		lpRoute += strlen(pszName) + 1;
-
-		vecRoute.push_back(stdx::string_helper::to_utf8(pszName));
+		std::string strName = stdx::string_helper::to_utf8(cursor.string());
 
 		/* Bypass class */
-		lpRoute += sizeof(int);
+		cursor.skip(sizeof(int));
 
 		/* Bypass Country */
-		lpRoute += strlen(reinterpret_cast<char*>(lpRoute)) + 1;
+		cursor.string();
 
 		/* Bypass subclass */
-		lpRoute += 17;
+		cursor.skip(17);
 		if (nVersion > 3)
 		{
-			lpRoute += 5;
+			cursor.skip(5);
 
 			/* Bypass unkown string */
-			lpRoute += strlen(reinterpret_cast<char*>(lpRoute)) + 1;
+			cursor.string();
 		}
 
 		/* Bypass unkown data */
-		lpRoute += 18;
+		cursor.skip(18);
 
 		/* Read Link number */
-		unLinkNumber = *reinterpret_cast<unsigned int*>(lpRoute);
-		lpRoute += sizeof(unsigned int);
+		unLinkNumber = cursor.read<unsigned int>();
 
 		/* Bypass links waypoints */
-		lpRoute += unLinkNumber * sizeof(_GPS_POINT);
+		if (unLinkNumber > cursor.remaining() / sizeof(_GPS_POINT))
+			throw std::out_of_range("Link number");
+		cursor.skip(unLinkNumber * sizeof(_GPS_POINT));
 
 		/* End Flag */
-		bFlag = *static_cast<unsigned char*>(lpRoute);
-		lpRoute += sizeof(unsigned char);
-
-		if (!bFlag)
+		if (!cursor.read<unsigned char>())
 		{
-			/* Bypass max coordinates */
-			pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-			lpRoute += sizeof(_GPS_POINT);
-
-			/* Bypass min coordinates */
-			pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpRoute);
-			lpRoute += sizeof(_GPS_POINT);
+			/* Bypass max and min coordinates */
+			cursor.skip(2 * sizeof(_GPS_POINT));
 		}
-	}
 
-	return S_OK;
+		// Only complete waypoints are kept
+		vecRoute.push_back(std::move(strName));
+	}
 }
 
-static int ReadWayPoint(CGpsPointArray& cGpsWaypointsArray, CGpsPointArray& cGpsRoutePoints, LPBYTE lpWaypoint, int nVersion)
+static int ReadWayPoint(CMapSourceCursor& cursor, CGpsPoint& cGpsPoint, int nVersion)
 {
-	P_GPS_POINT pGpsPoint;
-	CGpsPoint cGpsPoint;
-	int nClass;
-
 	/* Read Name*/
-	cGpsPoint.name(stdx::string_helper::to_utf8(reinterpret_cast<char*>(lpWaypoint)));
-	lpWaypoint += strlen(reinterpret_cast<char*>(lpWaypoint)) + 1;
+	std::string strName = stdx::string_helper::to_utf8(cursor.string());
 
 	/* Read class */
-	nClass = *reinterpret_cast<int*>(lpWaypoint);
-	lpWaypoint += sizeof(int);
+	int nClass = cursor.read<int>();
 
 	/* Bypass Country */
-	lpWaypoint += strlen(reinterpret_cast<char*>(lpWaypoint)) + 1;
+	cursor.string();
 
 	/* Bypass subclass */
-	lpWaypoint += 17;
+	cursor.skip(17);
 	if (nVersion > 3)
-		lpWaypoint += 5;
+		cursor.skip(5);
 
 	/* Read coordinates */
-	pGpsPoint = reinterpret_cast<P_GPS_POINT>(lpWaypoint);
-	lpWaypoint += sizeof(_GPS_POINT);
+	_GPS_POINT sGpsPoint = cursor.read<_GPS_POINT>();
 
 	/* Read text */
-	cGpsPoint.comment(stdx::string_helper::to_utf8(reinterpret_cast<char*>(lpWaypoint)));
-	lpWaypoint += strlen(reinterpret_cast<char*>(lpWaypoint)) + 1;
+	cGpsPoint.comment(stdx::string_helper::to_utf8(cursor.string()));
+	cGpsPoint.name(strName);
 
-	cGpsPoint.coords(MPS_COORD_TO_DEGREE(pGpsPoint->nLatitude), MPS_COORD_TO_DEGREE(pGpsPoint->nLongitude), pGpsPoint->fAltitude);
+	cGpsPoint.coords(MPS_COORD_TO_DEGREE(sGpsPoint.nLatitude), MPS_COORD_TO_DEGREE(sGpsPoint.nLongitude), sGpsPoint.fAltitude);
 
-	if (!nClass)
-		cGpsWaypointsArray.push_back(cGpsPoint);
-	else
-		cGpsRoutePoints.push_back(cGpsPoint);
-
-	return S_OK;
+	return nClass;
 }
 
-static int _ReadMPS(LPBYTE lpFile, DWORD dwFileSize, std::vector<CGpsPointArray*>& vecGpsArray)
+static int _ReadMPS(LPBYTE lpFile, DWORD dwFileSize, std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource)
 {
-	P_RECORD_HEADER pRecordHeader;
-	LPBYTE lpPos = lpFile;
-	LPBYTE lpEnd = lpFile + dwFileSize;
 	int nVersion = 0;
-	CGpsWaypointArray cGpsRoutePoints;
-	std::vector<std::string> vecRoute;
-	CGpsWaypointArray::iterator it;
-	size_t i;
 
 	// Check signature
-	if (memcmp(lpFile, MPS_DEFAULT_SIGNATURE, MPS_SIZE_OF_SIGNATURE))
+	if (dwFileSize < MPS_SIZE_OF_SIGNATURE || memcmp(lpFile, MPS_DEFAULT_SIGNATURE, MPS_SIZE_OF_SIGNATURE))
 		return E_INVALIDARG;
 
-	vecGpsArray.push_back(new CGpsWaypointArray);
-	CGpsPointArray& cGpsWaypointsArray = *vecGpsArray.back();
+	// First pass: record index
+	MapSourceRecords records = IndexMapSourceRecords(lpFile + MPS_SIZE_OF_SIGNATURE, lpFile + dwFileSize);
 
-	pRecordHeader = (P_RECORD_HEADER)(lpPos + MPS_SIZE_OF_SIGNATURE);
-
-	while ((LPBYTE)pRecordHeader < lpEnd)
+	for (const MapSourceRecord& record : records)
 	{
-		lpPos = (LPBYTE)pRecordHeader + sizeof(_RECORD_HEADER);
-		switch (pRecordHeader->ucType)
+		if (record.ucType == MPS_TYPE_FILE_FORMAT) // File format version
 		{
-		case MPS_TYPE_FILE_FORMAT:    // File format version
-			if (*lpPos == 'd')
+			if (record.lpBegin == record.lpEnd)
+				return E_NOTIMPL;
+			else if (*record.lpBegin == 'd')
 				nVersion = 3;
-			else if (*lpPos > 'd' && *lpPos < 'i')
+			else if (*record.lpBegin > 'd' && *record.lpBegin < 'i')
 				nVersion = 4;
-			else if (*lpPos == 'i')
+			else if (*record.lpBegin == 'i')
 				nVersion = 5;
 			else
 				return E_NOTIMPL;
 			break;
-
-		case MPS_TYPE_FILE_VERSION:   // File version
-			break;
-
-		case MPS_TYPE_WAYPOINT: // Waypoint
-			ReadWayPoint(cGpsWaypointsArray, cGpsRoutePoints, lpPos, nVersion);
-			break;
-
-		case MPS_TYPE_TRACK:    // Track
-			vecGpsArray.push_back(new CGpsTrack());
-			ReadTrack(*vecGpsArray.back(), lpPos);
-			break;
-
-		case MPS_TYPE_ROUTE:    // Route
-			vecRoute.clear();
-			ReadRoute(vecRoute, lpPos, nVersion);
-			if (vecRoute.size())
-			{
-				vecGpsArray.push_back(new CGpsRoute());
-				CGpsPointArray& cGpsPointArray = *vecGpsArray.back();
-
-				cGpsPointArray.name(vecRoute[0]);
-
-				for (i = 1; i < vecRoute.size(); i++)
-				{
-					std::string& strAddress = vecRoute[i];
-					for (it = cGpsRoutePoints.begin(); it != cGpsRoutePoints.end(); ++it)
-					{
-						if (strAddress == it->name())
-						{
-							cGpsPointArray.push_back(*it);
-							break;
-						}
-					}
-				}
-			}
-			break;
-
-		default:
-			break;
 		}
-
-		pRecordHeader = (P_RECORD_HEADER)(lpPos + pRecordHeader->unLength);
 	}
 
+	// Second pass: records decoding
+	MapSourceDecoders decoders;
+	decoders.waypoint = [nVersion](CMapSourceCursor& cursor, CGpsPoint& cGpsPoint) { return ReadWayPoint(cursor, cGpsPoint, nVersion); };
+	decoders.trackHeader = ReadTrackHeader;
+	decoders.trackPoint = ReadTrackPoint;
+	decoders.route = [nVersion](CMapSourceCursor& cursor, std::vector<std::string>& vecRoute) { ReadRoute(cursor, vecRoute, nVersion); };
+
+	DecodeMapSourceRecords(records, decoders, vecGpsArray, pResource);
+
 	return S_OK;
 }
 
-int ReadMPS(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadMPS(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_FALSE;
 	DWORD dwFileSize = 0;
@@ -348,7 +259,7 @@ int ReadMPS(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!dwFileSize)
 		goto end_function;
 
-	hr = _ReadMPS(pMapFile, dwFileSize, vecGpsArray);
+	hr = _ReadMPS(pMapFile, dwFileSize, vecGpsArray, pResource);
 
 end_function:
 	if (pMapFile) UnmapViewOfFile(pMapFile);
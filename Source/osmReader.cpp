@@ -57,8 +57,9 @@ namespace
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-OSMContentHandler::OSMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+OSMContentHandler::OSMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_bOnNode(false),
 	m_bOnWay(false),
 	m_pointIndex(0)
@@ -73,7 +74,7 @@ bool OSMContentHandler::Parse(std::istream& iss)
 {
 	m_bOnNode = false;
 	m_bOnWay = false;
-	m_pGpsWayPointArray.reset(new CGpsWaypointArray);
+	m_pGpsWayPointArray.reset(new CGpsWaypointArray(m_pResource));
 	m_mapIndex.clear();
 
 	try
@@ -122,7 +123,7 @@ void OSMContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 		getAttributes(attrs, mapAttributes);
 
 		m_bOnWay = true;
-		m_vecGpsArray.push_back(new CGpsRoute);
+		m_vecGpsArray.push_back(new CGpsRoute(m_pResource));
 		m_vecGpsArray.back()->name(mapAttributes[XML_VL_ID]);
 	}
 	else if (str == XML_MK_TAG)
@@ -175,7 +176,7 @@ void OSMContentHandler::OnEndElement(const XML_Char* name)
 	}
 }
 
-int ReadOSM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadOSM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return OSMContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return OSMContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
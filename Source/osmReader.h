@@ -39,7 +39,7 @@
 class OSMContentHandler : private CSAXParser
 {
 public:
-	OSMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	OSMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~OSMContentHandler();
 
 	bool Parse(std::istream& iss);
@@ -51,6 +51,7 @@ private:
 
 private:
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	std::unique_ptr<CGpsPointArray> m_pGpsWayPointArray;
 	std::map<long long, CGpsPoint*> m_mapIndex;
 	CGpsPoint m_cGpsPoint;
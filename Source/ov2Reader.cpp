@@ -45,24 +45,30 @@
 
 #define POI_FACTOR    100000.
 
-int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+#define POI_WINDOW    (64 * 1024 * 1024)
+
+int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	ifmstream ifmsFile(strPathName.c_str());
+	// Large POI files are read through a sliding window
+	ifmstream ifmsFile;
+	ifmsFile.open_window(strPathName.c_str(), POI_WINDOW, filemapping::sequential);
 	if (!ifmsFile)
 		return S_FALSE;
 
-	const char* pBuffer = static_cast<const char*>(ifmsFile.data());
-	const void* pEnd = pBuffer + ifmsFile.size();
+	const std::streamoff FileSize = ifmsFile.file_size();
+	std::streamoff Offset = 0;
 
 	uint32_t unRecordLength = 0;
 	int32_t nCoordinate = 0;
 
-	vecGpsArray.push_back(new CGpsPoiArray());
+	vecGpsArray.push_back(new CGpsPoiArray(pResource));
 
-	while (pBuffer < pEnd)
+	while (Offset < FileSize)
 	{
+		const char* pBuffer = static_cast<const char*>(ifmsFile.view(Offset, POI_OFFSET_LON));
+
 		// Read Type
-		switch (*pBuffer)
+		switch (pBuffer ? *pBuffer : -1)
 		{
 		case POI_DELETED:
 			memcpy(&unRecordLength, pBuffer + POI_OFFSET_LEN, sizeof(uint32_t));
@@ -71,6 +77,13 @@ int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 		case POI_EXTENDED:
 		{
 			memcpy(&unRecordLength, pBuffer + POI_OFFSET_LEN, sizeof(uint32_t));
+			if (unRecordLength < POI_OFFSET_NAME)
+				return S_FALSE;
+
+			// Map the whole record, the window may move
+			pBuffer = static_cast<const char*>(ifmsFile.view(Offset, unRecordLength));
+			if (!pBuffer)
+				return S_FALSE;
 
 			CGpsPoint cGpsPoint;
 
@@ -80,7 +93,9 @@ int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 			memcpy(&nCoordinate, pBuffer + POI_OFFSET_LAT, sizeof(int32_t));
 			cGpsPoint.lat(nCoordinate / POI_FACTOR);
 
-			cGpsPoint.name(stdx::string_helper::to_utf8(pBuffer + POI_OFFSET_NAME));
+			const char* pName = pBuffer + POI_OFFSET_NAME;
+			const char* pNameEnd = static_cast<const char*>(memchr(pName, '\0', unRecordLength - POI_OFFSET_NAME));
+			cGpsPoint.name(stdx::string_helper::to_utf8(std::string(pName, pNameEnd ? pNameEnd : pBuffer + unRecordLength)));
 
 			vecGpsArray.back()->push_back(cGpsPoint);
 		}
@@ -94,7 +109,10 @@ int ReadOV2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 			return S_FALSE;
 		}
 
-		pBuffer += unRecordLength;
+		if (!unRecordLength)
+			return S_FALSE;
+
+		Offset += unRecordLength;
 	}
 
 	return S_OK;
@@ -29,12 +29,13 @@
  */
 
 #include "stdafx.h"
-#include <fstream>
+#include "ToolsLibrary/fmstream.h"
 #include "ITN Tools.h"
 
 #define POI_SIMPLE     0x02
 #define POI_HEADER_LEN 13
 #define POI_FACTOR     100000
+#define POI_NAME_LEN   32 // Estimated length of a name
 
 static inline int32_t DoubleToInt32(double dDouble)
 {
@@ -43,7 +44,7 @@ static inline int32_t DoubleToInt32(double dDouble)
 
 int WriteOV2(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
-	std::ofstream ofsFile(strPathName, std::ios_base::binary);
+	ofmstream ofsFile(strPathName.c_str(), cGpsRoute.size() * (POI_HEADER_LEN + POI_NAME_LEN));
 	if (!ofsFile)
 		return S_FALSE;
 
@@ -68,6 +69,6 @@ int WriteOV2(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 		ofsFile.write(strName.c_str(), strName.size() + 1);
 	}
 
-	ofsFile.close();
+	ofsFile.commit();
 	return ofsFile.good() ? S_OK : S_FALSE;
 }
@@ -68,7 +68,7 @@ static int ParseWaypoint(const stdx::string_helper::vector& vecResults, CGpsPoin
 	return S_OK;
 }
 
-int ReadOZI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadOZI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_FALSE;
 	int nRoute = -1;
@@ -94,7 +94,7 @@ int ReadOZI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 			{
 				if (!vecStrResult.front().compare(OZI_ROUTE))
 				{
-					vecGpsArray.push_back(new CGpsRoute());
+					vecGpsArray.push_back(new CGpsRoute(pResource));
 					nRoute = ParseRoute(vecStrResult, *static_cast<CGpsRoute*>(vecGpsArray.back()));
 				}
 				else if (!vecStrResult.front().compare(OZI_WAYPOINT) && !vecGpsArray.empty())
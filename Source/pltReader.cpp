@@ -34,13 +34,13 @@
 
 #define HEADER_LINE  7
 
-int ReadPLT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadPLT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str());
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsTrack);
+	vecGpsArray.push_back(new CGpsTrack(pResource));
 
 	std::string strLine;
 	size_t index = 0;
@@ -52,8 +52,8 @@ int WriteRDN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 			SAXWriter::Tag tagEntete = xmlWriter.tag("ENTETE");
 			xmlWriter.tag("VERSION_XML").content("1.1");
 			xmlWriter.tag("VERSION_BASE").content("IHA03AA");
-			xmlWriter.tag("DATE").content(stdx::format("%02d/%02d/%04d")(sSystemTime.wDay)(sSystemTime.wMonth)(sSystemTime.wYear));
-			xmlWriter.tag("HEURE").content(stdx::format("%02d:%02d:%02d")(sSystemTime.wHour)(sSystemTime.wMinute)(sSystemTime.wSecond));
+			xmlWriter.tag("DATE").content(stdx::format("%02d/%02d/%04d")(sSystemTime.wDay)(sSystemTime.wMonth)(sSystemTime.wYear).str());
+			xmlWriter.tag("HEURE").content(stdx::format("%02d:%02d:%02d")(sSystemTime.wHour)(sSystemTime.wMinute)(sSystemTime.wSecond).str());
 		}
 		{
 			SAXWriter::Tag tagInfos = xmlWriter.tag("INFORMATIONS");
@@ -67,7 +67,7 @@ int WriteRDN(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 
 			SAXWriter::Tag tagEtape = xmlWriter.tag("ETAPE");
 
-			xmlWriter.tag("POSITION").content(stdx::format("%f,%f")(cGpsPoint.lat())(cGpsPoint.lng()));
+			xmlWriter.tag("POSITION").content(stdx::format("%f,%f")(cGpsPoint.lat())(cGpsPoint.lng()).str());
 			xmlWriter.tag("ALTITUDE").content(stdx::string_helper::to_string(cGpsPoint.alt()));
 
 			if (!cGpsPoint.name().empty())
@@ -200,6 +200,7 @@
 #define IDC_CHECK_DISPLAY_NUMBER        1101
 #define IDC_STATIC_VEHICLE_TYPE         1102
 #define IDC_COMBO_VEHICLE_TYPE          1103
+#define IDC_CHECK_SIMPLIFY              1104
 
 // IDD_PROGRESS_DLG
 #define IDC_PROGRESS_BAR                1001
@@ -559,3 +560,4 @@
 #define IDS_CLEAR_FAV                   377
 #define IDS_CONFIRM_CLEAR_FAV           378
 #define IDS_URLSYGICFILTERS             379
+#define IDS_SIMPLIFY_TRACK              380
@@ -142,7 +142,7 @@ namespace
 	}
 }
 
-int ReadROUTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadROUTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	ifmstream ifmsFile(strPathName.c_str());
 	if (!ifmsFile)
@@ -172,7 +172,7 @@ int ReadROUTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vec
 	const _HEADER* pHeader = reinterpret_cast<const _HEADER*>(pBuffer);
 	pBuffer += sizeof(_HEADER);
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	// Lecture des points
@@ -58,7 +58,7 @@ static int ParseWaypoint(const stdx::string_helper::vector& vecResults, CGpsPoin
 	return S_OK;
 }
 
-int ReadRT2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadRT2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_FALSE;
 
@@ -83,7 +83,7 @@ int ReadRT2(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 			{
 				if (!vecStrResult.front().compare(RT2_ROUTE))
 				{
-					vecGpsArray.push_back(new CGpsRoute());
+					vecGpsArray.push_back(new CGpsRoute(pResource));
 					ParseRoute(vecStrResult, *static_cast<CGpsRoute*>(vecGpsArray.back()));
 				}
 				else if (!vecStrResult.front().compare(RT2_WAYPOINT) && !vecGpsArray.empty())
@@ -281,7 +281,7 @@ int ParseLineLL(std::string& strLine, CGpsPointArray& cGpsPointArray, sOffset* p
 	return S_OK;
 }
 
-int ReadRTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadRTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	HRESULT hr = S_FALSE;
 	char nUnit = UNIT_DEG;
@@ -293,7 +293,7 @@ int ReadRTE(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::string strLine;
@@ -30,6 +30,7 @@
 
 #include "stdafx.h"
 #include "ITN Tools.h"
+#include "stdx/static_format.h"
 #include <fstream>
 
 #define RTE_NAME     "H  SOFTWARE NAME & VERSION\r\nI  PCX5 2.09 by " SOFT_FULL_NAME " (" SOFT_URL ")\r\n"
@@ -38,10 +39,6 @@
 #define RTE_HEAD3    "\r\nH  COORDINATE SYSTEM\r\nU  LAT LON DEG\r\n"
 #define RTE_INDEX    "\r\nR  01 %s\r\n"
 #define RTE_HEADER   "\r\nH  IDNT     LATITUDE    LONGITUDE    DATE      TIME     ALT   DESCRIPTION                              PROXIMITY     SYMBOL ;waypts\r\n"
-#define RTE_RECORD   "W  WPT%05d %s %s %s %s %s %s 0.00000e+000  00018\r\n"
-#define CRD_LAT      "%+011.7f"
-#define CRD_LONG     "%+012.7f"
-#define CRD_ALT      "%05.f"
 
 #define NORTH  'N'   // +
 #define SOUTH  'S'   // -
@@ -54,13 +51,19 @@
 
 static char* szMonth[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC", nullptr };
 
+static constexpr stdx::static_format RTE_RECORD("W  WPT%05d %c%s %c%s %s %s %s %s 0.00000e+000  00018\r\n");
+static constexpr stdx::static_format CRD_LAT("%010.7f");
+static constexpr stdx::static_format CRD_LONG("%011.7f");
+static constexpr stdx::static_format CRD_ALT("%05.f");
+
 int WriteRTE(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
 	std::string strDate;
 	std::string strTime;
-	char szLatitude[12];
-	char szLongitude[13];
-	char szAltitude[6];
+	std::string strLatitude;
+	std::string strLongitude;
+	std::string strAltitude;
+	std::string strLine;
 	SYSTEMTIME sSystemTime;
 
 	GetSystemTime(&sSystemTime);
@@ -85,27 +88,28 @@ int WriteRTE(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 	{
 		const CGpsPoint& cGpsPoint = cGpsRoute[i];
 
-		sprintf(szLatitude, CRD_LAT, cGpsPoint.lat());
-		if (szLatitude[0] == '-')
-			szLatitude[0] = SOUTH;
-		else
-			szLatitude[0] = NORTH;
+		// The sign is replaced by the hemisphere
+		strLatitude.clear();
+		stdx::format_append<CRD_LAT>(strLatitude, fabs(cGpsPoint.lat()));
 
-		sprintf(szLongitude, CRD_LONG, cGpsPoint.lng());
-		if (szLongitude[0] == '-')
-			szLongitude[0] = WEAST;
-		else
-			szLongitude[0] = EAST;
+		strLongitude.clear();
+		stdx::format_append<CRD_LONG>(strLongitude, fabs(cGpsPoint.lng()));
 
+		strAltitude.clear();
 		if (cGpsPoint.alt() != 0)
-			sprintf(szAltitude, CRD_ALT, cGpsPoint.alt());
+			stdx::format_append<CRD_ALT>(strAltitude, cGpsPoint.alt());
 		else
-			strcpy(szAltitude, DEF_ALT);
+			strAltitude = DEF_ALT;
 
 		std::string strAddress = stdx::string_helper::from_utf8(cGpsPoint.name());
 		strAddress.resize(MAX_DESC_LEN, 0x20);
 
-		ofsFile << stdx::format(RTE_RECORD)(i + 1)(szLatitude)(szLongitude)(strDate)(strTime)(szAltitude)(strAddress);
+		strLine.clear();
+		ofsFile << stdx::format_append<RTE_RECORD>(strLine,
+			i + 1,
+			(cGpsPoint.lat() < 0) ? SOUTH : NORTH, strLatitude,
+			(cGpsPoint.lng() < 0) ? WEAST : EAST, strLongitude,
+			strDate, strTime, strAltitude, strAddress);
 	}
 
 	ofsFile.close();
@@ -32,13 +32,13 @@
 #include <fstream>
 #include "ITN Tools.h"
 
-int ReadTK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadTK(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str());
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsRoute);
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::string strLine;
@@ -33,13 +33,13 @@
 #include "trlHeader.h"
 #include "ITN Tools.h"
 
-int ReadTRL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadTRL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str());
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	TRL_POINT sTrlPoint;
 
 	while (!ifsFile.eof())
@@ -29,13 +29,13 @@
  */
 
 #include "stdafx.h"
-#include <fstream>
+#include "ToolsLibrary/fmstream.h"
 #include "trlHeader.h"
 #include "ITN Tools.h"
 
 int WriteTRL(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD, bool)
 {
-	std::ofstream ofsFile(strPathName.c_str(), std::ios_base::binary);
+	ofmstream ofsFile(strPathName.c_str(), cGpsRoute.size() * sizeof(TRL_POINT));
 	if (ofsFile)
 	{
 		CGpsRoute::const_iterator it;
@@ -58,7 +58,7 @@ int WriteTRL(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, DWORD,
 			ofsFile.write(reinterpret_cast<char*>(&sTrlPoint), sizeof(TRL_POINT));
 		}
 
-		ofsFile.close();
+		ofsFile.commit();
 	}
 
 	return ofsFile.good() ? S_OK : S_FALSE;
@@ -50,7 +50,7 @@ namespace
 	constexpr double TRP_FACTOR = 1000000.;
 }
 
-int ReadTRP(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadTRP(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::wifstream ifsFile(strPathName.c_str(), std::ios_base::binary);
 	if (!ifsFile)
@@ -58,7 +58,7 @@ int ReadTRP(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGp
 
 	stdx::wbom::imbue(ifsFile);
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	bool bPoint = false;
@@ -37,7 +37,7 @@ bool isTomtomURL(const std::wstring& strUrl)
 	return geo::CTomtomUrl::isValidUrl(stdx::wstring_helper::to_utf8(strUrl));
 }
 
-int ReadTomtomURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadTomtomURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	if (!isTomtomURL(strUrl))
 		return S_FALSE;
@@ -46,7 +46,7 @@ int ReadTomtomURL(const std::wstring& strUrl, std::vector<CGpsPointArray*>& vecG
 	geo::CTomtomUrl::UrlToLocations(stdx::wstring_helper::to_utf8(strUrl), gLocations);
 	gLocations.removeEmpties();
 
-	vecGpsArray.push_back(new CGpsRoute);
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	vecGpsArray.back()->assign(gLocations.begin(), gLocations.end());
 	vecGpsArray.back()->name(CToolsString::Load(IDS_PROVIDER_TOMTOM));
 
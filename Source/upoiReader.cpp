@@ -34,7 +34,7 @@
 #include "stdx/string_helper.h"
 #include "stdx/bom.h"
 
-int ReadUPOI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadUPOI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::wifstream ifsFile(strPathName.c_str(), std::ios_base::binary);
 	if (!ifsFile)
@@ -42,7 +42,7 @@ int ReadUPOI(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecG
 
 	stdx::wbom::imbue(ifsFile, stdx::wbom::read(ifsFile));
 
-	vecGpsArray.push_back(new CGpsRoute());
+	vecGpsArray.push_back(new CGpsRoute(pResource));
 	CGpsRoute& cGpsRoute = *static_cast<CGpsRoute*>(vecGpsArray.back());
 
 	std::wstring strLine;
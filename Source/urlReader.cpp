@@ -30,19 +30,19 @@
 #include "stdafx.h"
 #include "ITN Tools.h"
 
-int ReadURL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine)
+int ReadURL(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool bCmdLine, std::pmr::memory_resource* pResource)
 {
 	std::wstring strUrl;
 	GetPrivateProfileStdString(_T("InternetShortcut"), _T("URL"), strPathName, strUrl);
 
-	if (ReadGoogleURL(strUrl, vecGpsArray, bCmdLine) == S_OK)
+	if (ReadGoogleURL(strUrl, vecGpsArray, bCmdLine, pResource) == S_OK)
 		return S_OK;
 
-	if (ReadHereURL(strUrl, vecGpsArray, bCmdLine) == S_OK)
+	if (ReadHereURL(strUrl, vecGpsArray, bCmdLine, pResource) == S_OK)
 		return S_OK;
 
-	if (ReadViaMichelinURL(strUrl, vecGpsArray, bCmdLine) == S_OK)
+	if (ReadViaMichelinURL(strUrl, vecGpsArray, bCmdLine, pResource) == S_OK)
 		return S_OK;
 
-	return ReadTomtomURL(strUrl, vecGpsArray, bCmdLine);
+	return ReadTomtomURL(strUrl, vecGpsArray, bCmdLine, pResource);
 }
@@ -62,7 +62,7 @@ int WriteSygicUrl(const std::wstring& strPathName, const CGpsRoute& cGpsRoute, D
 		SAXWriter::Tag tagBody = std::move(htmlWriter.tag("body"));
 		htmlWriter.tag("p").content("Generated by ").tag("a").attribute("href", SOFT_URL).content(SOFT_FULL_NAME);
 
-		htmlWriter.tag("p").attribute("style", "font-size: 1.5em;").content(stdx::format("Route name: %s, %d waypoints")(cGpsRoute.name())(cGpsRoute.size()));
+		htmlWriter.tag("p").attribute("style", "font-size: 1.5em;").content(stdx::format("Route name: %s, %d waypoints")(cGpsRoute.name())(cGpsRoute.size()).str());
 		htmlWriter.tag("a").attribute("style", "font-size: 2em;").attribute("href", oss.str()).content("Click to open the route in Sygic");
 	}
 
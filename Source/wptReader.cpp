@@ -34,13 +34,13 @@
 
 #define HEADER_LINE  4
 
-int ReadWPT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadWPT(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
 	std::ifstream ifsFile(strPathName.c_str());
 	if (!ifsFile)
 		return S_FALSE;
 
-	vecGpsArray.push_back(new CGpsWaypointArray);
+	vecGpsArray.push_back(new CGpsWaypointArray(pResource));
 
 	std::string strLine;
 	size_t index = 0;
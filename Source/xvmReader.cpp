@@ -47,8 +47,9 @@
  // Construction/Destruction
  //////////////////////////////////////////////////////////////////////
 
-XVMContentHandler::XVMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray) :
+XVMContentHandler::XVMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource) :
 	m_vecGpsArray(vecGpsArray),
+	m_pResource(pResource),
 	m_pGpsCurrentArray(nullptr),
 	m_pGpsWayPointArray(nullptr)
 {
@@ -92,7 +93,7 @@ void XVMContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 	if (str == XVM_MK_POI && !m_pGpsCurrentArray)
 	{
 		if (!m_pGpsWayPointArray)
-			m_pGpsWayPointArray = new CGpsPoiArray();
+			m_pGpsWayPointArray = new CGpsPoiArray(m_pResource);
 
 		m_pGpsCurrentArray = m_pGpsWayPointArray;
 		if (m_pGpsCurrentArray->getType() == CGpsPointArray::E_ARRAY_POI && m_strCurrentTag.empty())
@@ -124,7 +125,7 @@ void XVMContentHandler::OnStartElement(const XML_Char* name, const XML_Char** at
 		if (m_pGpsCurrentArray != m_pGpsWayPointArray)
 			delete m_pGpsCurrentArray;
 
-		m_pGpsCurrentArray = new CGpsRoute();
+		m_pGpsCurrentArray = new CGpsRoute(m_pResource);
 
 		const XML_Char** it_attrs = attrs;
 		while (*it_attrs)
@@ -184,7 +185,7 @@ void XVMContentHandler::OnCharacterData(const XML_Char* data, int len)
 	m_strData.append(data, len);
 }
 
-int ReadXVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool)
+int ReadXVM(const std::wstring& strPathName, std::vector<CGpsPointArray*>& vecGpsArray, bool, std::pmr::memory_resource* pResource)
 {
-	return XVMContentHandler(vecGpsArray).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
+	return XVMContentHandler(vecGpsArray, pResource).Parse(strPathName.c_str()) ? S_OK : S_FALSE;
 }
@@ -38,6 +38,7 @@ class XVMContentHandler : private CSAXParser
 {
 private:
 	std::vector<CGpsPointArray*>& m_vecGpsArray;
+	std::pmr::memory_resource* m_pResource; // Of the arrays read
 	CGpsPointArray* m_pGpsCurrentArray;
 	CGpsPointArray* m_pGpsWayPointArray;
 	CGpsPoint m_cGpsPoint;
@@ -50,7 +51,7 @@ private:
 	virtual void OnCharacterData(const XML_Char* data, int len);
 
 public:
-	XVMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray);
+	XVMContentHandler(std::vector<CGpsPointArray*>& vecGpsArray, std::pmr::memory_resource* pResource);
 	virtual ~XVMContentHandler();
 
 	bool Parse(const wchar_t* szFileName);
@@ -43,6 +43,104 @@ LoadScript("scripts/vtraffic/meteo.js");
 
 var scExtrasCountry = ["AT","AD","BE","BG","BA","BR","CA","CH","CY","CZ","DE","DK","ES","FI","FR","GB","GR","HU","HR","IT","IL","IE","IS","KW","LU","LI","LT","MT","MA","NL","NO","NZ","OM","PT","PL","RO","RU","SE","SK","SI","RS","TN","TR","UA","AE","US","ZA"];
 
+// Routes with more points are drawn from the level of detail of the current zoom and viewport
+var _LOD_MIN_POINTS = 2000;
+var _lodRoutes = [];
+
+function DecodePolyline(encoded)
+{
+	var path = [];
+	var index = 0;
+	var lat = 0;
+	var lng = 0;
+
+	while(index < encoded.length)
+	{
+		var values = [0, 0];
+		for(var v = 0; v < 2; v++)
+		{
+			var shift = 0;
+			var result = 0;
+			var b;
+
+			do {
+				b = encoded.charCodeAt(index++) - 63;
+				result |= (b & 0x1f) << shift;
+				shift += 5;
+			} while(b >= 0x20);
+
+			values[v] = (result & 1) ? ~(result >> 1) : (result >> 1);
+		}
+
+		lat += values[0];
+		lng += values[1];
+		path.push(new google.maps.LatLng(lat * 1e-5, lng * 1e-5));
+	}
+
+	return path;
+}
+
+function EncodePolyline(path)
+{
+	var encoded = '';
+	var prevLat = 0;
+	var prevLng = 0;
+
+	for(var i = 0; i < path.length; i++)
+	{
+		var lat = Math.round(path[i].lat() * 1e5);
+		var lng = Math.round(path[i].lng() * 1e5);
+		var values = [lat - prevLat, lng - prevLng];
+
+		for(var v = 0; v < 2; v++)
+		{
+			var value = (values[v] < 0) ? ~(values[v] << 1) : (values[v] << 1);
+			while(value >= 0x20)
+			{
+				encoded += String.fromCharCode((0x20 | (value & 0x1f)) + 63);
+				value >>= 5;
+			}
+			encoded += String.fromCharCode(value + 63);
+		}
+
+		prevLat = lat;
+		prevLng = lng;
+	}
+
+	return encoded;
+}
+
+function RegisterLodRoute(pushpin)
+{
+	UnregisterLodRoute(pushpin);
+	_lodRoutes.push(pushpin);
+}
+
+function UnregisterLodRoute(pushpin)
+{
+	for(var i = 0; i < _lodRoutes.length; i++)
+	{
+		if(_lodRoutes[i] === pushpin)
+		{
+			_lodRoutes.splice(i, 1);
+			break;
+		}
+	}
+}
+
+function RefreshLodRoutes()
+{
+	for(var i = 0; i < _lodRoutes.length; i++)
+	{
+		try {
+			_lodRoutes[i].refreshRoute();
+		}
+		catch(ex) {
+			Trace('RefreshLodRoutes', ex);
+		}
+	}
+}
+
 function getLanguage()
 {
 	return (navigator.language || navigator.userLanguage).substr(0, 2);
@@ -83,6 +83,23 @@ function geoCode(point)
 	return geoRoute;
 }
 
+// Same as geoCode without waiting for the provider, a newer call of the same queue supersedes this one.
+// When the geocoding fails the callback gets null and the error message.
+function geoCodeAsync(point, callback, queue)
+{
+	window.external.ReverseGeocoding(point, function(location, error)
+	{
+		if(error !== undefined) {
+			callback(null, error);
+			return;
+		}
+
+		var geoRoute = new google.maps.LatLng(location.lat(), location.lng());
+		geoRoute.address = location.address() || tabLang.user;
+		callback(geoRoute);
+	}, queue || '');
+}
+
 function HttpRelay(query, host, referrer)
 {
 	var relayQuery = 'http://benitools.info/relay.php?';
@@ -153,7 +170,21 @@ function SelectPoint(tab, item)
 
 function MovePoint(tab, item, latlng)
 {
-	window.external.MovePoint(tab, item, geoCode(latlng));
+	var version = tabPinVersion[tab];
+	geoCodeAsync(latlng, function(geoLocation, error)
+	{
+		if(!geoLocation)
+			Trace('MovePoint', error);
+
+		// The list changed during the geocoding, the item may be another point: drop the move and put the pins back
+		if(!geoLocation || version != tabPinVersion[tab]) {
+			if(tabPin[tab].length)
+				RefreshPushPins(tab, 0, tabPin[tab].length);
+			return;
+		}
+
+		window.external.MovePoint(tab, item, geoLocation);
+	}, 'MovePoint' + tab + '_' + item);
 }
 
 function RenamePoint(tab, item, name)
@@ -171,6 +202,64 @@ function GetPoint(tab, item)
 	return window.external.GetPoint(tab, item);
 }
 
+// Properties of a range of points in a single call, count is optional
+function GetPoints(tab, first, count)
+{
+	if(count === undefined)
+		count = -1;
+
+	return JSON.parse(window.external.GetPoints(tab, first, count));
+}
+
+function GetRouteGeometry(tab, item)
+{
+	var bounds = map.getBounds();
+	if(!bounds) {
+		return [];
+	}
+
+	var sw = bounds.getSouthWest();
+	var ne = bounds.getNorthEast();
+	var geometry = window.external.GetRouteGeometry(tab, item, map.getZoom(), sw.lat(), sw.lng(), ne.lat(), ne.lng());
+
+	var paths = [];
+	if(geometry)
+	{
+		var runs = geometry.split(' ');
+		for(var i = 0; i < runs.length; i++) {
+			paths.push(DecodePolyline(runs[i]));
+		}
+	}
+
+	return paths;
+}
+
+// Altitudes of a path, in meters and in the same order
+function GetElevations(path)
+{
+	if(!path.length) {
+		return [];
+	}
+
+	return JSON.parse(window.external.GetElevations(EncodePolyline(path)));
+}
+
+function GetElevationsAsync(path, callback, queue)
+{
+	if(!path.length) {
+		callback([]);
+		return;
+	}
+
+	window.external.GetElevations(EncodePolyline(path), function(altitudes, error)
+	{
+		if(error !== undefined)
+			callback(null, error);
+		else
+			callback(JSON.parse(altitudes));
+	}, queue || '');
+}
+
 function GetStrCoords(latlng)
 {
 	return window.external.GetStrCoords(latlng);
@@ -338,7 +338,7 @@ PushPin.prototype.onClick = function(latlng)
 };
 PushPin.prototype.onEndMove = function(latlng)
 {
-	MovePoint(this.tab, this.item, geoCode(latlng));
+	MovePoint(this.tab, this.item, latlng);
 };
 PushPin.prototype.getInfoExtra = function()
 {
@@ -357,16 +357,22 @@ PushPin.prototype.setRemove = function()
 {
 	DeletePoint(this.tab, this.item);
 };
-PushPin.prototype.Refresh = function(tab, item)
+PushPin.prototype.Refresh = function(tab, item, gpsPoint)
 {
 	this.tab = tab;
 	this.item = item;
 
-	var gpsPoint = GetPoint(this.tab, this.item);
-	this.marker.setTitle(CheckName(gpsPoint.address));
+	if(!gpsPoint) {
+		gpsPoint = GetPoint(this.tab, this.item);
+	}
+
+	var title = CheckName(gpsPoint.address);
+	if(title != this.marker.getTitle()) {
+		this.marker.setTitle(title);
+	}
 
 	var gpsPos = new google.maps.LatLng(gpsPoint.lat, gpsPoint.lng);
-	if(gpsPos != this.marker.getPosition()) {
+	if(!gpsPos.equals(this.marker.getPosition())) {
 		this.setPosition(gpsPos);
 	}
 };
@@ -434,9 +440,11 @@ SearchPushPin.prototype.getInfoTitle = function()
 	return '<table><tr><td><a href="http://www.google.com/cse?cx=partner-pub-4881128809765041%3Aspp08h-sqhq&q=' + this.marker.getTitle() + '"><img class="icon" src="images/search.jpg" width="21" height="21" alt="Google Search" /></a></td><td><div class="title">' + this.marker.getTitle() + '</div></td></tr></table>';
 };
 
-function NewPushPin(tab, item)
+function NewPushPin(tab, item, gpsPoint)
 {
-	var gpsPoint = GetPoint(tab, item);
+	if(!gpsPoint) {
+		gpsPoint = GetPoint(tab, item);
+	}
 	
 	switch(gpsPoint.type)
 	{
@@ -74,6 +74,7 @@ LoadScript("scripts/map/TFMap.js");
 var gTmpMarker = null;
 var gPolylineMarker = null;
 var tabPin = [];
+var tabPinVersion = []; // Changes with the pin list of a tab, the items of a pending call may no longer match
 
 function ShowUpdateWindow()
 {
@@ -295,6 +296,7 @@ function InitMap(jsOptions)
 		gPolylineMarker = new PolylinePushPin();
 
 		google.maps.event.addListener(map, "zoom_changed", SetZoomLabel);
+		google.maps.event.addListener(map, "idle", RefreshLodRoutes);
 
 		Signal('I', "");
 	}
@@ -312,6 +314,7 @@ function initialize()
 function NewPinList(tab)
 {
 	tabPin[tab] = [];
+	tabPinVersion[tab] = 0;
 }
 
 function CloseInfoWindow()
@@ -358,6 +361,7 @@ function DelPushPin(tab, item)
 {
 	try
 	{
+		tabPinVersion[tab]++;
 		tabPin[tab][item].remove();
 		tabPin[tab][item] = null;
 		tabPin[tab].splice(item, 1);
@@ -372,6 +376,7 @@ function InsertPushPin(tab, item)
 {
 	try
 	{
+		tabPinVersion[tab]++;
 		tabPin[tab].splice(item, 0, NewPushPin(tab, item));
 	}
 	catch(ex)
@@ -380,12 +385,30 @@ function InsertPushPin(tab, item)
 	}
 }
 
+function LoadPushPins(tab)
+{
+	try
+	{
+		tabPinVersion[tab]++;
+		var points = GetPoints(tab, 0);
+		for(var i = 0; i < points.length; i++) {
+			tabPin[tab].push(NewPushPin(tab, i, points[i]));
+		}
+	}
+	catch(ex)
+	{
+		ReportError(tab, -1, 'LoadPushPins', ex);
+	}
+}
+
 function RefreshPushPins(tab, item, counter)
 {
 	try
 	{
-		for(var i=item;i<item+counter;i++) {
-			tabPin[tab][i].Refresh(tab, i);
+		tabPinVersion[tab]++;
+		var points = GetPoints(tab, item, counter);
+		for(var i = 0; i < points.length; i++) {
+			tabPin[tab][item + i].Refresh(tab, item + i, points[i]);
 		}
 	}
 	catch(ex)
@@ -398,6 +421,7 @@ function ClearPushPins(tab)
 {
 	try
 	{
+		tabPinVersion[tab]++;
 		for(var i in tabPin[tab])
 		{
 			tabPin[tab][i].remove();
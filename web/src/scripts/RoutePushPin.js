@@ -62,7 +62,10 @@ function RoutePushPin(tab, item, gpsPoint)
 		else {
 			this.number = null;
 		}
-		this.addRoute();
+
+		if(gpsPoint.route) {
+			this.addRoute();
+		}
 	}
 }
 
@@ -116,10 +119,13 @@ RoutePushPin.prototype.delPreviewRoute = function()
 		this.previewRoute = null;
 	}
 };
-RoutePushPin.prototype.Refresh = function(tab, item)
+RoutePushPin.prototype.Refresh = function(tab, item, gpsPoint)
 {
-	PushPin.prototype.Refresh.call(this, tab, item);
-	var gpsPoint = GetPoint(this.tab, this.item);
+	if(!gpsPoint) {
+		gpsPoint = GetPoint(tab, item);
+	}
+
+	PushPin.prototype.Refresh.call(this, tab, item, gpsPoint);
 
 	this.color = GetRoutePushPinColor(gpsPoint.type);
 
@@ -194,16 +200,40 @@ RoutePushPin.prototype.addRoute = function()
 	var ptRoute = GetPoint(this.tab, this.item).route;
 	if(ptRoute)
 	{
-		this.route = new google.maps.Polyline({
+		this.routeColor = ptRoute.color();
+		this.route = [];
+
+		if(ptRoute.count() > _LOD_MIN_POINTS)
+		{
+			this.drawRoute(GetRouteGeometry(this.tab, this.item));
+			RegisterLodRoute(this);
+		}
+		else
+		{
+			this.drawRoute([ExtractRoutePath(ptRoute)]);
+		}
+	}
+};
+RoutePushPin.prototype.drawRoute = function(paths)
+{
+	for(var i in this.route) {
+		this.route[i].setMap(null);
+	}
+
+	this.route = [];
+
+	var lRoute = this;
+	for(var p = 0; p < paths.length; p++)
+	{
+		var polyline = new google.maps.Polyline({
 			map: map,
-			path: ExtractRoutePath(ptRoute),
-			strokeColor: ptRoute.color(),
+			path: paths[p],
+			strokeColor: this.routeColor,
 			strokeOpacity: 0.5,
 			strokeWidth: 5
 		});
 
-		var lRoute = this;
-		google.maps.event.addListener(this.route, "click", function(event)
+		google.maps.event.addListener(polyline, "click", function(event)
 		{
 			if(Settings().AutoAddStep())
 			{
@@ -216,8 +246,13 @@ RoutePushPin.prototype.addRoute = function()
 			}
 		});
 
-		google.maps.event.addListener(this.route, "mouseover", function(event) {
-		});
+		this.route.push(polyline);
+	}
+};
+RoutePushPin.prototype.refreshRoute = function()
+{
+	if(this.route) {
+		this.drawRoute(GetRouteGeometry(this.tab, this.item));
 	}
 };
 RoutePushPin.prototype.delRoute = function()
@@ -225,8 +260,12 @@ RoutePushPin.prototype.delRoute = function()
 	if(this.route)
 	{
 		gPolylineMarker.remove();
+		UnregisterLodRoute(this);
+
+		for(var i in this.route) {
+			this.route[i].setMap(null);
+		}
 
-		this.route.setMap(null);
 		this.route = null;
 	}
 };